@@ -0,0 +1,6 @@
+#include <comms_lora_ebyte_e32/AUXMonitor.hpp>
+
+using namespace comms_lora_ebyte_e32;
+
+AUXMonitor::~AUXMonitor() {
+}
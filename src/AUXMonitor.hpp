@@ -0,0 +1,27 @@
+#ifndef COMMS_LORA_EBYTE_E32_AUXMONITOR_HPP
+#define COMMS_LORA_EBYTE_E32_AUXMONITOR_HPP
+
+#include <base/Time.hpp>
+
+namespace comms_lora_ebyte_e32 {
+    /** Interface to the module's AUX line
+     *
+     * The module drives AUX low while it has data in its internal buffer or
+     * is busy transmitting, and high when it is ready to accept more data
+     */
+    class AUXMonitor {
+    public:
+        virtual ~AUXMonitor();
+
+        /** Whether AUX is currently high */
+        virtual bool isReady() = 0;
+
+        /** Wait for AUX to be high
+         *
+         * @return true if AUX was high before the timeout, false otherwise
+         */
+        virtual bool waitReady(base::Time const& timeout) = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,213 @@
+#include <comms_lora_ebyte_e32/AsyncDriver.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+AsyncDriver::AsyncDriver(Driver& driver)
+    : m_driver(driver) {
+}
+
+Driver& AsyncDriver::getDriver() {
+    return m_driver;
+}
+
+int AsyncDriver::getFileDescriptor() const {
+    return m_driver.getFileDescriptor();
+}
+
+void AsyncDriver::readVersion(VersionCallback callback, ErrorCallback error) {
+    Command command;
+    command.type = COMMAND_READ_VERSION;
+    command.buffer[0] = command.buffer[1] = command.buffer[2] = 0xc3;
+    command.size = 3;
+    command.reply_size = Driver::VERSION_REPLY_SIZE;
+    command.version_callback = callback;
+    command.error_callback = error;
+    queue(command);
+}
+
+void AsyncDriver::readConfiguration(ConfigurationCallback callback,
+                                    ErrorCallback error) {
+    Command command;
+    command.type = COMMAND_READ_CONFIGURATION;
+    command.buffer[0] = command.buffer[1] = command.buffer[2] = 0xc1;
+    command.size = 3;
+    command.reply_size = Driver::CONFIGURATION_REPLY_SIZE;
+    command.configuration_callback = callback;
+    command.error_callback = error;
+    queue(command);
+}
+
+void AsyncDriver::writeConfiguration(Configuration const& conf, bool save,
+                                     WriteCallback callback,
+                                     ErrorCallback error) {
+    Command command;
+    command.type = COMMAND_WRITE_CONFIGURATION;
+    Driver::encodeConfigurationCommand(command.buffer, conf, save);
+    command.size = Driver::CONFIGURATION_COMMAND_SIZE;
+    command.reply_size = 0;
+    command.configuration = conf;
+    command.save = save;
+    command.write_callback = callback;
+    command.error_callback = error;
+    queue(command);
+}
+
+void AsyncDriver::setReceiveCallback(ReceiveCallback callback) {
+    m_receive_callback = callback;
+}
+
+bool AsyncDriver::hasPendingCommands() const {
+    return !m_commands.empty();
+}
+
+base::Time AsyncDriver::getDeadline() const {
+    if (!m_command_in_flight) {
+        return base::Time();
+    }
+    return m_commands.front().deadline;
+}
+
+void AsyncDriver::queue(Command const& command) {
+    m_commands.push_back(command);
+    if (!m_command_in_flight) {
+        startNextCommand(base::Time::now());
+    }
+}
+
+void AsyncDriver::startNextCommand(base::Time const& now) {
+    Command& command = m_commands.front();
+    m_reply_size = 0;
+    m_command_in_flight = true;
+    command.start = now;
+    command.deadline = now + m_driver.getCommandTimeout();
+    m_driver.writePacket(command.buffer, command.size);
+    if (CaptureLog* log = m_driver.getCaptureLog()) {
+        log->record(CaptureLog::RECORD_COMMAND, command.buffer, command.size);
+    }
+}
+
+void AsyncDriver::completeCommand(exception_ptr error) {
+    Command command = m_commands.front();
+    m_commands.pop_front();
+    m_command_in_flight = false;
+
+    if (error) {
+        if (!command.error_callback) {
+            rethrow_exception(error);
+        }
+        command.error_callback(error);
+        return;
+    }
+
+    switch (command.type) {
+        case COMMAND_READ_VERSION:
+            if (command.version_callback) {
+                command.version_callback(command.version);
+            }
+            break;
+        case COMMAND_READ_CONFIGURATION:
+            if (command.configuration_callback) {
+                command.configuration_callback(command.configuration);
+            }
+            break;
+        case COMMAND_WRITE_CONFIGURATION:
+            if (command.write_callback) {
+                command.write_callback();
+            }
+            break;
+    }
+}
+
+bool AsyncDriver::processReply() {
+    Command& command = m_commands.front();
+    if (m_reply_size < command.reply_size) {
+        m_reply_size += m_driver.readRaw(
+            m_reply + m_reply_size, command.reply_size - m_reply_size,
+            base::Time(), base::Time()
+        );
+        if (m_reply_size < command.reply_size) {
+            return false;
+        }
+    }
+
+    auto& statistics = m_driver.getStatisticsRecorder();
+    exception_ptr error;
+    if (command.type == COMMAND_WRITE_CONFIGURATION) {
+        try {
+            m_driver.completeConfigurationWrite(command.configuration, command.save);
+        }
+        catch (std::exception const&) {
+            error = current_exception();
+        }
+    }
+    else {
+        try {
+            if (command.type == COMMAND_READ_VERSION) {
+                command.version = Driver::decodeVersionReply(m_reply);
+            }
+            else {
+                command.configuration = Driver::decodeConfigurationReply(m_reply);
+                m_driver.completeConfigurationRead(command.configuration);
+            }
+        }
+        catch (std::exception const&) {
+            statistics.recordMalformedReply();
+            error = current_exception();
+        }
+    }
+
+    if (!error && command.reply_size) {
+        statistics.recordCommandLatency(base::Time::now() - command.start);
+    }
+    completeCommand(error);
+    return true;
+}
+
+bool AsyncDriver::processReceivedData() {
+    if (m_driver.getPacketMode() == Driver::PACKET_MODE_LENGTH_PREFIXED) {
+        int size = m_driver.tryReadPacket(m_rx_buffer, Driver::MAX_PACKET_SIZE);
+        if (size && m_receive_callback) {
+            m_receive_callback(m_rx_buffer, size);
+        }
+        return size != 0;
+    }
+
+    int size = m_driver.readRaw(
+        m_rx_buffer, Driver::MAX_PACKET_SIZE, base::Time(), base::Time()
+    );
+    if (size && m_receive_callback) {
+        m_receive_callback(m_rx_buffer, size);
+    }
+    return size != 0;
+}
+
+void AsyncDriver::process(base::Time const& now) {
+    while (true) {
+        if (!m_command_in_flight && !m_commands.empty()) {
+            startNextCommand(now);
+        }
+
+        bool progress;
+        if (m_command_in_flight) {
+            progress = processReply();
+            if (!progress && now >= m_commands.front().deadline) {
+                auto type = m_reply_size == 0
+                    ? iodrivers_base::TimeoutError::FIRST_BYTE
+                    : iodrivers_base::TimeoutError::PACKET;
+                m_driver.getStatisticsRecorder().recordTimeout(type);
+                completeCommand(make_exception_ptr(iodrivers_base::TimeoutError(
+                    type, "comms_lora_ebyte_e32::AsyncDriver: did not receive reply"
+                )));
+                progress = true;
+            }
+        }
+        else {
+            progress = processReceivedData();
+        }
+
+        if (!progress) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef COMMS_LORA_EBYTE_E32_ASYNCDRIVER_HPP
+#define COMMS_LORA_EBYTE_E32_ASYNCDRIVER_HPP
+
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <deque>
+#include <exception>
+#include <functional>
+
+namespace comms_lora_ebyte_e32 {
+    /** Non-blocking front-end to Driver, meant to be integrated in an event
+     * loop
+     *
+     * Commands are queued and sent one at a time. Replies, timeouts and
+     * received data are reported through callbacks, called from process().
+     * The event loop must call process() when the driver's file descriptor
+     * is readable, and when the deadline returned by getDeadline() is
+     * reached.
+     *
+     * The underlying driver must not be read from outside of this class.
+     */
+    class AsyncDriver {
+    public:
+        typedef std::function<void (std::exception_ptr)> ErrorCallback;
+        typedef std::function<void (Version const&)> VersionCallback;
+        typedef std::function<void (Configuration const&)> ConfigurationCallback;
+        typedef std::function<void ()> WriteCallback;
+        typedef std::function<void (uint8_t const*, int)> ReceiveCallback;
+
+    private:
+        enum CommandType {
+            COMMAND_READ_VERSION,
+            COMMAND_READ_CONFIGURATION,
+            COMMAND_WRITE_CONFIGURATION
+        };
+
+        struct Command {
+            CommandType type;
+            uint8_t buffer[Driver::CONFIGURATION_COMMAND_SIZE];
+            int size = 0;
+            int reply_size = 0;
+            Version version;
+            Configuration configuration;
+            bool save = false;
+            VersionCallback version_callback;
+            ConfigurationCallback configuration_callback;
+            WriteCallback write_callback;
+            ErrorCallback error_callback;
+            base::Time start;
+            base::Time deadline;
+        };
+
+        Driver& m_driver;
+        std::deque<Command> m_commands;
+        bool m_command_in_flight = false;
+        uint8_t m_reply[Driver::CONFIGURATION_REPLY_SIZE];
+        int m_reply_size = 0;
+        ReceiveCallback m_receive_callback;
+        uint8_t m_rx_buffer[Driver::MAX_PACKET_SIZE];
+
+        void queue(Command const& command);
+        void startNextCommand(base::Time const& now);
+        bool processReply();
+        bool processReceivedData();
+        void completeCommand(std::exception_ptr error);
+
+    public:
+        explicit AsyncDriver(Driver& driver);
+
+        /** The underlying driver */
+        Driver& getDriver();
+
+        /** The file descriptor that should be watched for readability */
+        int getFileDescriptor() const;
+
+        /** Queue a version read */
+        void readVersion(VersionCallback callback,
+                         ErrorCallback error = ErrorCallback());
+
+        /** Queue a configuration read */
+        void readConfiguration(ConfigurationCallback callback,
+                               ErrorCallback error = ErrorCallback());
+
+        /** Queue a configuration write
+         *
+         * The module does not acknowledge it. The callback is called once the
+         * command is written, and the driver updated as
+         * Driver::writeConfiguration does (see
+         * Driver::completeConfigurationWrite). If the UART rate changes, this
+         * blocks while the module applies the configuration.
+         */
+        void writeConfiguration(Configuration const& conf, bool save,
+                                WriteCallback callback = WriteCallback(),
+                                ErrorCallback error = ErrorCallback());
+
+        /** Set the callback called with data received while no command is in
+         * flight
+         *
+         * In Driver::PACKET_MODE_LENGTH_PREFIXED, it is called once per
+         * frame. Otherwise, it is called with the bytes as they come.
+         */
+        void setReceiveCallback(ReceiveCallback callback);
+
+        /** Whether some commands are queued or waiting for their reply */
+        bool hasPendingCommands() const;
+
+        /** The time at which the command in flight times out
+         *
+         * It is null if there is no command in flight
+         */
+        base::Time getDeadline() const;
+
+        /** Advance the state machine
+         *
+         * It never blocks. Errors are reported to the command's error
+         * callback. If there is none, they are thrown from this method, after
+         * the command has been removed from the queue.
+         */
+        void process(base::Time const& now = base::Time::now());
+    };
+}
+
+#endif
@@ -0,0 +1,13 @@
+#include <comms_lora_ebyte_e32/CRC.hpp>
+
+using namespace comms_lora_ebyte_e32;
+
+uint16_t comms_lora_ebyte_e32::crc16(uint8_t const* data, int size, uint16_t crc) {
+    for (int i = 0; i < size; ++i) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
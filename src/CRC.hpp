@@ -0,0 +1,15 @@
+#ifndef COMMS_LORA_EBYTE_E32_CRC_HPP
+#define COMMS_LORA_EBYTE_E32_CRC_HPP
+
+#include <cstdint>
+
+namespace comms_lora_ebyte_e32 {
+    /** CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xffff)
+     *
+     * @arg crc the CRC of the previous data, to compute the CRC of
+     *   non-contiguous buffers
+     */
+    uint16_t crc16(uint8_t const* data, int size, uint16_t crc = 0xffff);
+}
+
+#endif
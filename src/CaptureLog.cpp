@@ -0,0 +1,219 @@
+#include <comms_lora_ebyte_e32/CaptureLog.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const char CaptureLog::MAGIC[8] = { 'E', '3', '2', 'C', 'A', 'P', 0, 0 };
+const uint32_t CaptureLog::FORMAT_VERSION;
+const int CaptureLog::FILE_HEADER_SIZE;
+const int CaptureLog::RECORD_HEADER_SIZE;
+const int CaptureLog::MAX_RECORD_SIZE;
+const int CaptureLog::DEFAULT_RING_SIZE;
+
+static const memory_order RELAXED = memory_order_relaxed;
+
+/** Offset of the end offset in the file header */
+static const int END_OFFSET = 16;
+
+/** Minimum size by which the file and its mapping grow */
+static const size_t MAP_INCREMENT = 1 << 20;
+
+/** How long the background thread sleeps when there is nothing to write */
+static const chrono::milliseconds WRITE_PERIOD(5);
+
+static void encodeLE(uint8_t* buffer, uint64_t value, int size) {
+    for (int i = 0; i < size; ++i) {
+        buffer[i] = (value >> (8 * i)) & 0xff;
+    }
+}
+
+CaptureLog::CaptureLog(string const& path, int ring_size)
+    : m_path(path)
+    , m_ring(std::max(ring_size, 0))
+    , m_quit(false)
+    , m_failed(false)
+    , m_pushed(0)
+    , m_processed(0)
+    , m_written(0)
+    , m_written_bytes(0)
+    , m_dropped(0)
+    , m_dropped_bytes(0)
+    , m_file_size(0) {
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureLog: failed to open " + path
+        );
+    }
+
+    try {
+        reserve(FILE_HEADER_SIZE);
+    }
+    catch (...) {
+        ::close(m_fd);
+        throw;
+    }
+    memcpy(m_map, MAGIC, sizeof(MAGIC));
+    encodeLE(m_map + 8, FORMAT_VERSION, 4);
+    encodeLE(m_map + 12, 0, 4);
+    m_end = FILE_HEADER_SIZE;
+    encodeLE(m_map + END_OFFSET, m_end, 8);
+    m_file_size.store(m_end, RELAXED);
+
+    m_thread = thread([this]() { run(); });
+}
+
+CaptureLog::~CaptureLog() {
+    m_quit.store(true, memory_order_release);
+    m_thread.join();
+
+    if (m_map) {
+        ::munmap(m_map, m_map_size);
+    }
+    // Drop the preallocated tail. If it fails, the end offset in the header
+    // still delimits the records
+    int ret = ::ftruncate(m_fd, m_end);
+    (void)ret;
+    ::close(m_fd);
+}
+
+string const& CaptureLog::getPath() const {
+    return m_path;
+}
+
+void CaptureLog::reserve(size_t size) {
+    if (m_end + size <= m_map_size) {
+        return;
+    }
+
+    size_t new_size = std::max(m_map_size * 2, m_map_size + MAP_INCREMENT);
+    new_size = std::max(new_size, m_end + size);
+    if (m_map) {
+        ::munmap(m_map, m_map_size);
+        m_map = nullptr;
+    }
+    if (::ftruncate(m_fd, new_size) != 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureLog: failed to grow " + m_path
+        );
+    }
+    void* map = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       m_fd, 0);
+    if (map == MAP_FAILED) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureLog: failed to map " + m_path
+        );
+    }
+    m_map = static_cast<uint8_t*>(map);
+    m_map_size = new_size;
+}
+
+void CaptureLog::record(RecordType type, uint8_t const* data, int size,
+                        base::Time const& time) {
+    while (size > 0) {
+        int chunk = std::min(size, MAX_RECORD_SIZE);
+        Record* record = m_ring.beginPush();
+        if (!record) {
+            m_dropped.fetch_add(1, RELAXED);
+            m_dropped_bytes.fetch_add(chunk, RELAXED);
+        }
+        else {
+            record->type = type;
+            record->size = chunk;
+            record->time = time;
+            memcpy(record->data, data, chunk);
+            m_ring.commitPush();
+            m_pushed.fetch_add(1, memory_order_release);
+        }
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+bool CaptureLog::writeRecords() {
+    bool written = false;
+    while (Record* record = m_ring.front()) {
+        reserve(RECORD_HEADER_SIZE + record->size);
+        uint8_t* header = m_map + m_end;
+        encodeLE(header, record->time.toMicroseconds(), 8);
+        header[8] = record->type;
+        header[9] = 0;
+        encodeLE(header + 10, record->size, 2);
+        memcpy(header + RECORD_HEADER_SIZE, record->data, record->size);
+        m_end += RECORD_HEADER_SIZE + record->size;
+
+        m_written_bytes.fetch_add(record->size, RELAXED);
+        m_written.fetch_add(1, RELAXED);
+        m_ring.pop();
+        m_processed.fetch_add(1, memory_order_release);
+        written = true;
+    }
+
+    if (written) {
+        encodeLE(m_map + END_OFFSET, m_end, 8);
+        m_file_size.store(m_end, RELAXED);
+    }
+    return written;
+}
+
+void CaptureLog::discardRecords() {
+    while (Record* record = m_ring.front()) {
+        m_dropped.fetch_add(1, RELAXED);
+        m_dropped_bytes.fetch_add(record->size, RELAXED);
+        m_ring.pop();
+        m_processed.fetch_add(1, memory_order_release);
+    }
+}
+
+void CaptureLog::run() {
+    while (true) {
+        // Read the flag first, so that the records pushed before the
+        // destructor was called are written by the last iteration
+        bool quit = m_quit.load(memory_order_acquire);
+        bool written = false;
+        if (m_failed.load(RELAXED)) {
+            discardRecords();
+        }
+        else {
+            try {
+                written = writeRecords();
+            }
+            catch (std::exception const&) {
+                m_failed.store(true, RELAXED);
+            }
+        }
+
+        if (quit) {
+            return;
+        }
+        else if (!written) {
+            this_thread::sleep_for(WRITE_PERIOD);
+        }
+    }
+}
+
+void CaptureLog::flush() {
+    uint64_t pushed = m_pushed.load(memory_order_acquire);
+    while (m_processed.load(memory_order_acquire) < pushed) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+}
+
+CaptureLog::Statistics CaptureLog::getStatistics() const {
+    Statistics stats;
+    stats.records = m_written.load(RELAXED);
+    stats.bytes = m_written_bytes.load(RELAXED);
+    stats.dropped_records = m_dropped.load(RELAXED);
+    stats.dropped_bytes = m_dropped_bytes.load(RELAXED);
+    stats.file_size = m_file_size.load(RELAXED);
+    stats.ring_high_water_mark = m_ring.getHighWaterMark();
+    stats.failed = m_failed.load(RELAXED);
+    return stats;
+}
@@ -0,0 +1,163 @@
+#ifndef COMMS_LORA_EBYTE_E32_CAPTURELOG_HPP
+#define COMMS_LORA_EBYTE_E32_CAPTURELOG_HPP
+
+#include <base/Time.hpp>
+#include <comms_lora_ebyte_e32/SPSCRing.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace comms_lora_ebyte_e32 {
+    /** Append-only binary log of the traffic between a driver and its module
+     *
+     * Once attached with Driver::setCaptureLog, the driver records each chunk
+     * of bytes it writes or reads, timestamped, with configuration commands
+     * and their replies told apart from data. record() only copies the chunk
+     * into a lock-free ring (see SPSCRing). A background thread appends the
+     * records to a memory-mapped file, so that capturing never blocks the
+     * I/O path. When the ring is full, records are dropped and counted
+     * rather than waited for.
+     *
+     * The file starts with a 24-byte header: the "E32CAP\0\0" magic, the
+     * format version (uint32), reserved bytes (uint32), and the offset of the
+     * end of the committed records (uint64). Each record is a 12-byte header,
+     * the time in microseconds since the epoch (int64), the RecordType
+     * (uint8), a reserved byte and the data size (uint16), followed by the
+     * data. All integers are little-endian. The end offset is updated after
+     * each batch of records, so a log whose writer crashed is still readable
+     * up to its last batch. Use CaptureReader to read it, and CaptureReplay
+     * to feed it back to a driver.
+     *
+     * record() must always be called from the same thread, i.e. a log is fed
+     * by a single driver. It may be called from another thread than the one
+     * that created the log.
+     */
+    class CaptureLog {
+    public:
+        enum RecordType {
+            /** Data written to the module */
+            RECORD_TX = 0,
+            /** Data read from the module */
+            RECORD_RX = 1,
+            /** Configuration command written to the module */
+            RECORD_COMMAND = 2,
+            /** Reply to a configuration command */
+            RECORD_REPLY = 3
+        };
+
+        /** The file magic */
+        static const char MAGIC[8];
+        /** The file format version */
+        static const uint32_t FORMAT_VERSION = 1;
+        /** Size of the file header */
+        static const int FILE_HEADER_SIZE = 24;
+        /** Size of each record's header */
+        static const int RECORD_HEADER_SIZE = 12;
+        /** Maximum data size of a record. Longer chunks are split */
+        static const int MAX_RECORD_SIZE = 512;
+        /** Default number of records that may wait for the background
+         * thread
+         */
+        static const int DEFAULT_RING_SIZE = 256;
+
+        struct Statistics {
+            /** Records written to the file */
+            uint64_t records = 0;
+            /** Data bytes written to the file, excluding headers */
+            uint64_t bytes = 0;
+            /** Records dropped because the ring was full, or because writing
+             * the file failed
+             */
+            uint64_t dropped_records = 0;
+            /** Data bytes of the dropped records */
+            uint64_t dropped_bytes = 0;
+            /** Size of the committed part of the file */
+            uint64_t file_size = 0;
+            /** Largest number of records that waited for the background
+             * thread
+             */
+            size_t ring_high_water_mark = 0;
+            /** Whether writing the file failed, e.g. because the disk is
+             * full. All later records are dropped
+             */
+            bool failed = false;
+        };
+
+    private:
+        struct Record {
+            RecordType type = RECORD_TX;
+            int size = 0;
+            base::Time time;
+            uint8_t data[MAX_RECORD_SIZE];
+        };
+
+        std::string m_path;
+        int m_fd = -1;
+        uint8_t* m_map = nullptr;
+        size_t m_map_size = 0;
+        /** End of the records written so far, owned by the background
+         * thread
+         */
+        size_t m_end = 0;
+
+        SPSCRing<Record> m_ring;
+        std::thread m_thread;
+        std::atomic<bool> m_quit;
+        std::atomic<bool> m_failed;
+
+        std::atomic<uint64_t> m_pushed;
+        /** Records written or dropped by the background thread */
+        std::atomic<uint64_t> m_processed;
+        std::atomic<uint64_t> m_written;
+        std::atomic<uint64_t> m_written_bytes;
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<uint64_t> m_dropped_bytes;
+        std::atomic<uint64_t> m_file_size;
+
+        void run();
+        bool writeRecords();
+        void discardRecords();
+        void reserve(size_t size);
+
+    public:
+        /** Create the log, truncating the file if it exists, and start the
+         * background thread
+         *
+         * @arg ring_size the number of records that may wait for the
+         *   background thread before new ones get dropped
+         */
+        explicit CaptureLog(std::string const& path,
+                            int ring_size = DEFAULT_RING_SIZE);
+
+        /** Write the pending records and close the file */
+        ~CaptureLog();
+
+        CaptureLog(CaptureLog const&) = delete;
+        CaptureLog& operator=(CaptureLog const&) = delete;
+
+        /** The path of the log file */
+        std::string const& getPath() const;
+
+        /** Queue a chunk of traffic
+         *
+         * It never blocks. Chunks larger than MAX_RECORD_SIZE are split in
+         * several records with the same time.
+         */
+        void record(RecordType type, uint8_t const* data, int size,
+                    base::Time const& time = base::Time::now());
+
+        /** Wait for the background thread to process all the records
+         * queued so far
+         */
+        void flush();
+
+        /** Snapshot of the log counters
+         *
+         * It may be called from any thread
+         */
+        Statistics getStatistics() const;
+    };
+}
+
+#endif
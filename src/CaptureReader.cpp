@@ -0,0 +1,105 @@
+#include <comms_lora_ebyte_e32/CaptureReader.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Offset of the end offset in the file header */
+static const int END_OFFSET = 16;
+
+static uint64_t decodeLE(uint8_t const* buffer, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; ++i) {
+        value |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+    }
+    return value;
+}
+
+CaptureReader::CaptureReader(string const& path)
+    : m_path(path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureReader: failed to open " + path
+        );
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureReader: failed to stat " + path
+        );
+    }
+    m_map_size = st.st_size;
+    if (m_map_size < static_cast<size_t>(CaptureLog::FILE_HEADER_SIZE)) {
+        ::close(fd);
+        throw std::runtime_error(
+            "comms_lora_ebyte_e32::CaptureReader: " + path + " is too short "
+            "to be a capture log"
+        );
+    }
+
+    void* map = ::mmap(nullptr, m_map_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureReader: failed to map " + path
+        );
+    }
+    m_map = static_cast<uint8_t const*>(map);
+
+    if (memcmp(m_map, CaptureLog::MAGIC, sizeof(CaptureLog::MAGIC)) != 0 ||
+        decodeLE(m_map + 8, 4) != CaptureLog::FORMAT_VERSION) {
+        ::munmap(const_cast<uint8_t*>(m_map), m_map_size);
+        throw std::runtime_error(
+            "comms_lora_ebyte_e32::CaptureReader: " + path + " is not a "
+            "capture log, or has an unsupported format version"
+        );
+    }
+    m_end = std::min<uint64_t>(decodeLE(m_map + END_OFFSET, 8), m_map_size);
+    m_offset = CaptureLog::FILE_HEADER_SIZE;
+}
+
+CaptureReader::~CaptureReader() {
+    ::munmap(const_cast<uint8_t*>(m_map), m_map_size);
+}
+
+bool CaptureReader::next(Record& record) {
+    if (m_offset >= m_end) {
+        return false;
+    }
+
+    uint8_t const* header = m_map + m_offset;
+    size_t size = decodeLE(header + 10, 2);
+    if (m_offset + CaptureLog::RECORD_HEADER_SIZE + size > m_end) {
+        throw std::runtime_error(
+            "comms_lora_ebyte_e32::CaptureReader: truncated record at offset " +
+            std::to_string(m_offset) + " in " + m_path
+        );
+    }
+
+    record.time = base::Time::fromMicroseconds(
+        static_cast<int64_t>(decodeLE(header, 8))
+    );
+    record.type = static_cast<CaptureLog::RecordType>(header[8]);
+    record.data = header + CaptureLog::RECORD_HEADER_SIZE;
+    record.size = size;
+    m_offset += CaptureLog::RECORD_HEADER_SIZE + size;
+    return true;
+}
+
+void CaptureReader::rewind() {
+    m_offset = CaptureLog::FILE_HEADER_SIZE;
+}
+
+size_t CaptureReader::getSize() const {
+    return m_end;
+}
@@ -0,0 +1,58 @@
+#ifndef COMMS_LORA_EBYTE_E32_CAPTUREREADER_HPP
+#define COMMS_LORA_EBYTE_E32_CAPTUREREADER_HPP
+
+#include <comms_lora_ebyte_e32/CaptureLog.hpp>
+#include <string>
+
+namespace comms_lora_ebyte_e32 {
+    /** Sequential access to the records of a CaptureLog file
+     *
+     * The file is memory-mapped, and the records point into the mapping
+     * rather than being copied. Only the committed records are read, i.e. a
+     * log may be read while it is being written, up to its last committed
+     * batch at the time the reader was created.
+     */
+    class CaptureReader {
+    public:
+        struct Record {
+            CaptureLog::RecordType type = CaptureLog::RECORD_TX;
+            base::Time time;
+            /** The record data. It is valid as long as the reader is */
+            uint8_t const* data = nullptr;
+            int size = 0;
+        };
+
+    private:
+        std::string m_path;
+        uint8_t const* m_map = nullptr;
+        size_t m_map_size = 0;
+        size_t m_end = 0;
+        size_t m_offset = 0;
+
+    public:
+        /** Open a log
+         *
+         * @throw std::runtime_error if the file is not a capture log
+         */
+        explicit CaptureReader(std::string const& path);
+        ~CaptureReader();
+
+        CaptureReader(CaptureReader const&) = delete;
+        CaptureReader& operator=(CaptureReader const&) = delete;
+
+        /** Read the next record
+         *
+         * @return false at the end of the log
+         * @throw std::runtime_error if a record is truncated
+         */
+        bool next(Record& record);
+
+        /** Go back to the first record */
+        void rewind();
+
+        /** Size of the committed part of the log, headers included */
+        size_t getSize() const;
+    };
+}
+
+#endif
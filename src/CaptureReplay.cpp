@@ -0,0 +1,253 @@
+#include <comms_lora_ebyte_e32/CaptureReplay.hpp>
+#include <base-logging/Logging.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Longest time the replay thread waits without checking whether it should
+ * stop
+ */
+static const base::Time MAX_WAIT = base::Time::fromMilliseconds(10);
+
+static bool isTX(CaptureLog::RecordType type) {
+    return type == CaptureLog::RECORD_TX || type == CaptureLog::RECORD_COMMAND;
+}
+
+CaptureReplay::CaptureReplay(string const& path)
+    : m_reader(new CaptureReader(path)) {
+    CaptureReader::Record record;
+    while (m_reader->next(record)) {
+        if (isTX(record.type)) {
+            m_expected_tx.insert(m_expected_tx.end(),
+                                 record.data, record.data + record.size);
+        }
+    }
+    m_statistics.expected_tx_bytes = m_expected_tx.size();
+
+    m_master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureReplay: failed to create pty"
+        );
+    }
+    m_device_path = ptsname(m_master);
+
+    // Keep the slave open so that the master does not hang up when the
+    // driver closes its side
+    m_slave = ::open(m_device_path.c_str(), O_RDWR | O_NOCTTY);
+    if (m_slave < 0) {
+        ::close(m_master);
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureReplay: failed to open " + m_device_path
+        );
+    }
+    termios tio;
+    tcgetattr(m_slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(m_slave, TCSANOW, &tio);
+}
+
+CaptureReplay::~CaptureReplay() {
+    stop();
+    ::close(m_master);
+    ::close(m_slave);
+}
+
+void CaptureReplay::setSpeed(double speed) {
+    if (speed < 0) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::CaptureReplay::setSpeed: speed cannot be "
+            "negative"
+        );
+    }
+    m_speed = speed;
+}
+
+void CaptureReplay::setReplyTimeout(base::Time const& timeout) {
+    m_reply_timeout = timeout;
+}
+
+string CaptureReplay::getDevicePath() const {
+    return m_device_path;
+}
+
+int CaptureReplay::openDevice() const {
+    int fd = ::open(m_device_path.c_str(), O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::CaptureReplay::openDevice: failed to open " +
+            m_device_path
+        );
+    }
+    return fd;
+}
+
+void CaptureReplay::start() {
+    if (m_thread.joinable()) {
+        return;
+    }
+
+    m_quit = false;
+    m_finished = false;
+    m_thread = thread([this]() {
+        try {
+            run();
+        }
+        catch (std::exception const& e) {
+            LOG_ERROR_S << "comms_lora_ebyte_e32::CaptureReplay: replay "
+                        << "stopped: " << e.what() << std::endl;
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_finished = true;
+            }
+            m_finished_signal.notify_all();
+        }
+    });
+}
+
+void CaptureReplay::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_thread.join();
+}
+
+bool CaptureReplay::isFinished() const {
+    lock_guard<mutex> lock(m_mutex);
+    return m_finished;
+}
+
+bool CaptureReplay::waitFinished(base::Time const& timeout) {
+    unique_lock<mutex> lock(m_mutex);
+    return m_finished_signal.wait_for(
+        lock, chrono::microseconds(timeout.toMicroseconds()),
+        [this] { return m_finished; }
+    );
+}
+
+CaptureReplay::Statistics CaptureReplay::getStatistics() const {
+    lock_guard<mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+bool CaptureReplay::readDriver(base::Time const& deadline) {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (m_quit) {
+            return false;
+        }
+    }
+
+    base::Time wait = std::min(deadline - base::Time::now(), MAX_WAIT);
+    if (wait > base::Time()) {
+        timespec ts = { static_cast<time_t>(wait.toMicroseconds() / 1000000),
+                        static_cast<long>(wait.toMicroseconds() % 1000000) * 1000 };
+        pollfd pfd = { m_master, POLLIN, 0 };
+        ::ppoll(&pfd, 1, &ts, nullptr);
+    }
+
+    uint8_t buffer[512];
+    while (true) {
+        ssize_t size = ::read(m_master, buffer, sizeof(buffer));
+        if (size <= 0) {
+            return true;
+        }
+
+        lock_guard<mutex> lock(m_mutex);
+        for (ssize_t i = 0; i < size; ++i) {
+            uint64_t offset = m_statistics.tx_bytes++;
+            if (offset >= m_expected_tx.size() || m_expected_tx[offset] != buffer[i]) {
+                m_statistics.tx_mismatches++;
+            }
+        }
+    }
+}
+
+void CaptureReplay::writeDriver(uint8_t const* data, int size) {
+    while (size > 0) {
+        ssize_t ret = ::write(m_master, data, size);
+        if (ret > 0) {
+            data += ret;
+            size -= ret;
+            continue;
+        }
+        else if (ret < 0 && errno != EAGAIN && errno != EINTR) {
+            throw iodrivers_base::UnixError(
+                "comms_lora_ebyte_e32::CaptureReplay: failed to write to the pty"
+            );
+        }
+
+        // The driver does not read. Keep consuming what it writes meanwhile
+        if (!readDriver(base::Time::now() + MAX_WAIT)) {
+            return;
+        }
+    }
+}
+
+void CaptureReplay::run() {
+    m_reader->rewind();
+    base::Time real_start = base::Time::now();
+    base::Time first;
+    uint64_t expected_tx = 0;
+
+    CaptureReader::Record record;
+    while (m_reader->next(record)) {
+        if (first.isNull()) {
+            first = record.time;
+        }
+        if (isTX(record.type)) {
+            expected_tx += record.size;
+            continue;
+        }
+
+        base::Time due = base::Time::now();
+        if (m_speed > 0) {
+            due = real_start + base::Time::fromSeconds(
+                (record.time - first).toSeconds() / m_speed
+            );
+        }
+        while (base::Time::now() < due) {
+            if (!readDriver(due)) {
+                return;
+            }
+        }
+
+        if (record.type == CaptureLog::RECORD_REPLY) {
+            base::Time deadline = base::Time::now() + m_reply_timeout;
+            while (getStatistics().tx_bytes < expected_tx &&
+                   base::Time::now() < deadline) {
+                if (!readDriver(deadline)) {
+                    return;
+                }
+            }
+        }
+
+        writeDriver(record.data, record.size);
+        base::Time lag = base::Time::now() - due;
+        lock_guard<mutex> lock(m_mutex);
+        m_statistics.replayed_records++;
+        m_statistics.rx_bytes += record.size;
+        m_statistics.max_lag = std::max(m_statistics.max_lag, lag);
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_finished = true;
+    }
+    m_finished_signal.notify_all();
+
+    while (readDriver(base::Time::now() + MAX_WAIT)) {
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef COMMS_LORA_EBYTE_E32_CAPTUREREPLAY_HPP
+#define COMMS_LORA_EBYTE_E32_CAPTUREREPLAY_HPP
+
+#include <comms_lora_ebyte_e32/CaptureReader.hpp>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** Play a CaptureLog back to a driver, in place of the module
+     *
+     * The replay exposes a pty, to be opened by the driver (see
+     * openDevice()). A background thread writes the received data and
+     * command replies of the log to the pty, at the pace at which they were
+     * captured, scaled by the replay speed. Replies wait for the driver to
+     * have written the commands that preceded them in the log, so that
+     * command exchanges are reproduced even at high speeds.
+     *
+     * What the driver writes is compared with the data and commands of the
+     * log, which makes a replay usable as a regression test as well as a
+     * benchmark.
+     */
+    class CaptureReplay {
+    public:
+        struct Statistics {
+            /** Received data and reply records written to the driver */
+            uint64_t replayed_records = 0;
+            /** Bytes written to the driver */
+            uint64_t rx_bytes = 0;
+            /** Bytes written by the driver */
+            uint64_t tx_bytes = 0;
+            /** Data and command bytes of the whole log */
+            uint64_t expected_tx_bytes = 0;
+            /** Bytes written by the driver that differ from the log, or go
+             * beyond its end
+             */
+            uint64_t tx_mismatches = 0;
+            /** Largest delay between the time at which a record was due and
+             * the time at which it was written
+             */
+            base::Time max_lag;
+        };
+
+    private:
+        std::unique_ptr<CaptureReader> m_reader;
+        /** Data and commands of the whole log, concatenated */
+        std::vector<uint8_t> m_expected_tx;
+        double m_speed = 1;
+        base::Time m_reply_timeout = base::Time::fromSeconds(1);
+
+        int m_master = -1;
+        int m_slave = -1;
+        std::string m_device_path;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_finished_signal;
+        std::thread m_thread;
+        bool m_quit = false;
+        bool m_finished = false;
+        Statistics m_statistics;
+
+        void run();
+        bool readDriver(base::Time const& deadline);
+        void writeDriver(uint8_t const* data, int size);
+
+    public:
+        /** Open a log for replay
+         *
+         * @throw std::runtime_error if the file is not a valid capture log
+         */
+        explicit CaptureReplay(std::string const& path);
+        ~CaptureReplay();
+
+        /** Set the replay speed
+         *
+         * 1 replays in real time, 10 ten times faster. Zero replays as fast
+         * as possible. It must be set before start()
+         */
+        void setSpeed(double speed);
+
+        /** How long a reply waits for the driver to write the commands that
+         * preceded it before it is written anyway
+         *
+         * Defaults to one second
+         */
+        void setReplyTimeout(base::Time const& timeout);
+
+        /** The path of the pty */
+        std::string getDevicePath() const;
+
+        /** Open a new file descriptor on the pty, for
+         * Driver::setFileDescriptor
+         */
+        int openDevice() const;
+
+        /** Start the replay thread */
+        void start();
+
+        /** Stop the replay thread */
+        void stop();
+
+        /** Whether all records have been replayed */
+        bool isFinished() const;
+
+        /** Wait for all records to be replayed
+         *
+         * @return false on timeout
+         */
+        bool waitFinished(base::Time const& timeout);
+
+        Statistics getStatistics() const;
+    };
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include <comms_lora_ebyte_e32/ChannelPlan.hpp>
+#include <comms_lora_ebyte_e32/ConfigurationCodec.hpp>
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+ChannelPlan::ChannelPlan(int node_count, vector<uint8_t> const& channels)
+    : m_channels(channels) {
+    if (node_count < 1) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::ChannelPlan: needs at least one node"
+        );
+    }
+    else if (channels.empty()) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::ChannelPlan: needs at least one channel"
+        );
+    }
+    for (size_t i = 0; i < channels.size(); ++i) {
+        if (channels[i] > MAX_CHANNEL) {
+            throw std::invalid_argument(
+                "comms_lora_ebyte_e32::ChannelPlan: channel " +
+                std::to_string(channels[i]) + " is out of range"
+            );
+        }
+        else if (find(channels.begin(), channels.begin() + i, channels[i]) !=
+                 channels.begin() + i) {
+            throw std::invalid_argument(
+                "comms_lora_ebyte_e32::ChannelPlan: channel " +
+                std::to_string(channels[i]) + " is listed twice"
+            );
+        }
+    }
+
+    vector<int> nodes_per_channel(channels.size(), 0);
+    for (int i = 0; i < node_count; ++i) {
+        m_node_channels.push_back(channels[i % channels.size()]);
+        nodes_per_channel[i % channels.size()]++;
+    }
+
+    // Build the list of transmissions so that consecutive entries belong to
+    // different nodes and target different channels, which lets the greedy
+    // packing below fill each slot with parallel transmissions
+    list<Transmission> pending;
+    for (size_t round = 0; round < channels.size(); ++round) {
+        for (int node = 0; node < node_count; ++node) {
+            size_t home = node % channels.size();
+            size_t target = (home + round + 1) % channels.size();
+            int receivers = nodes_per_channel[target] - (target == home ? 1 : 0);
+            if (receivers > 0) {
+                pending.push_back(Transmission{ node, channels[target] });
+            }
+        }
+    }
+
+    while (!pending.empty()) {
+        vector<Transmission> slot;
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (canAdd(slot, *it)) {
+                slot.push_back(*it);
+                it = pending.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        m_slots.push_back(slot);
+    }
+    if (m_slots.empty()) {
+        // A single node has nobody to talk to, but can still broadcast
+        m_slots.push_back(vector<Transmission>{ { 0, channels[0] } });
+    }
+}
+
+bool ChannelPlan::canAdd(vector<Transmission> const& slot,
+                         Transmission const& transmission) const {
+    uint8_t home = m_node_channels[transmission.node];
+    for (auto const& other : slot) {
+        uint8_t other_home = m_node_channels[other.node];
+        if (other.node == transmission.node ||
+            other.channel == transmission.channel) {
+            return false;
+        }
+        // Half-duplex: a node must not transmit while something is sent to
+        // its home channel
+        else if (home == other.channel || other_home == transmission.channel) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int ChannelPlan::getNodeCount() const {
+    return m_node_channels.size();
+}
+
+vector<uint8_t> const& ChannelPlan::getChannels() const {
+    return m_channels;
+}
+
+uint8_t ChannelPlan::getNodeChannel(int node) const {
+    return m_node_channels.at(node);
+}
+
+int ChannelPlan::getSlotCount() const {
+    return m_slots.size();
+}
+
+vector<ChannelPlan::Transmission> const& ChannelPlan::getSlot(int slot) const {
+    return m_slots.at(slot);
+}
+
+int ChannelPlan::getTransmitChannel(int node, int slot) const {
+    for (auto const& transmission : m_slots.at(slot)) {
+        if (transmission.node == node) {
+            return transmission.channel;
+        }
+    }
+    return -1;
+}
+
+bool ChannelPlan::canReach(int node, uint8_t channel) const {
+    for (auto const& slot : m_slots) {
+        for (auto const& transmission : slot) {
+            if (transmission.node == node && transmission.channel == channel) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
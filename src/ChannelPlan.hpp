@@ -0,0 +1,75 @@
+#ifndef COMMS_LORA_EBYTE_E32_CHANNELPLAN_HPP
+#define COMMS_LORA_EBYTE_E32_CHANNELPLAN_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** Assignment of the nodes of a network to time slots and channels
+     *
+     * A module only receives on the channel of its configuration, but it can
+     * send each fixed-transmission frame on any channel. The plan therefore
+     * gives each node a home channel, to be set in its configuration, and
+     * builds a superframe of slots in which each node transmits on the home
+     * channel of the nodes it wants to reach. Over a superframe, each node
+     * gets one slot on each channel that hosts at least one other node.
+     *
+     * Within a slot, a channel carries at most one transmission, and no node
+     * transmits while a frame is being sent on its home channel (the
+     * modules are half-duplex), except when it is the sender of that frame.
+     * Transmissions on different channels happen in parallel, which is what
+     * makes the aggregate throughput grow with the number of channels.
+     *
+     * The plan only depends on the node count and channel list, so every
+     * node computes the same one without any coordination.
+     */
+    class ChannelPlan {
+    public:
+        struct Transmission {
+            int node;
+            uint8_t channel;
+        };
+
+    private:
+        std::vector<uint8_t> m_channels;
+        std::vector<uint8_t> m_node_channels;
+        std::vector<std::vector<Transmission>> m_slots;
+
+        bool canAdd(std::vector<Transmission> const& slot,
+                    Transmission const& transmission) const;
+
+    public:
+        /**
+         * @arg node_count the number of nodes in the network
+         * @arg channels the channels to use (0 to 31). Nodes are spread over
+         *   them in a round-robin manner.
+         */
+        ChannelPlan(int node_count, std::vector<uint8_t> const& channels);
+
+        int getNodeCount() const;
+
+        /** The channels the plan uses */
+        std::vector<uint8_t> const& getChannels() const;
+
+        /** The channel the node must be configured on to receive */
+        uint8_t getNodeChannel(int node) const;
+
+        /** Number of slots in a superframe */
+        int getSlotCount() const;
+
+        /** The transmissions that take place in a slot */
+        std::vector<Transmission> const& getSlot(int slot) const;
+
+        /** The channel the node sends on in a slot
+         *
+         * @return the channel, or -1 if the node does not transmit in this
+         *   slot
+         */
+        int getTransmitChannel(int node, int slot) const;
+
+        /** Whether the node has a slot on the given channel */
+        bool canReach(int node, uint8_t channel) const;
+    };
+}
+
+#endif
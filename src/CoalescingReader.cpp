@@ -0,0 +1,72 @@
+#include <comms_lora_ebyte_e32/CoalescingReader.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <cstring>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+CoalescingReader::CoalescingReader(Driver& driver)
+    : m_driver(driver) {
+    m_driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+}
+
+bool CoalescingReader::split(uint8_t const* batch, int size,
+                             vector<vector<uint8_t>>& messages) {
+    // Validate first, to leave messages untouched on error
+    int count = 0;
+    for (int pos = 0; pos < size; pos += 1 + batch[pos]) {
+        if (pos + 1 + batch[pos] > size) {
+            return false;
+        }
+        ++count;
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    for (int pos = 0; pos < size; pos += 1 + batch[pos]) {
+        messages.push_back(
+            vector<uint8_t>(batch + pos + 1, batch + pos + 1 + batch[pos])
+        );
+    }
+    return true;
+}
+
+int CoalescingReader::receive(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    uint8_t packet[Driver::MAX_PACKET_SIZE];
+    vector<vector<uint8_t>> messages;
+    while (m_messages.empty()) {
+        base::Time now = base::Time::now();
+        base::Time remaining = deadline > now ? deadline - now : base::Time();
+        int size = m_driver.readPacket(packet, Driver::MAX_PACKET_SIZE, remaining);
+
+        m_stats.frames++;
+        messages.clear();
+        if (!split(packet + Driver::FRAME_HEADER_SIZE,
+                   size - Driver::FRAME_HEADER_SIZE, messages)) {
+            m_stats.invalid_frames++;
+            continue;
+        }
+        m_stats.messages += messages.size();
+        for (auto& message : messages) {
+            m_messages.push_back(std::move(message));
+        }
+    }
+
+    vector<uint8_t> message = std::move(m_messages.front());
+    m_messages.pop_front();
+    if (static_cast<int>(message.size()) > bufsize) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::CoalescingReader::receive: received a " +
+            std::to_string(message.size()) + " bytes message in a " +
+            std::to_string(bufsize) + " bytes buffer"
+        );
+    }
+    memcpy(buffer, message.data(), message.size());
+    return message.size();
+}
+
+CoalescingReader::Statistics CoalescingReader::getStatistics() const {
+    return m_stats;
+}
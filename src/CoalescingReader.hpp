@@ -0,0 +1,55 @@
+#ifndef COMMS_LORA_EBYTE_E32_COALESCINGREADER_HPP
+#define COMMS_LORA_EBYTE_E32_COALESCINGREADER_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Receive the messages batched by a CoalescingWriter
+     *
+     * The driver is put in PACKET_MODE_LENGTH_PREFIXED
+     */
+    class CoalescingReader {
+    public:
+        struct Statistics {
+            uint64_t frames = 0;
+            uint64_t messages = 0;
+            /** Frames whose message sizes do not add up to the frame size */
+            uint64_t invalid_frames = 0;
+        };
+
+    private:
+        Driver& m_driver;
+        std::deque<std::vector<uint8_t>> m_messages;
+        Statistics m_stats;
+
+    public:
+        explicit CoalescingReader(Driver& driver);
+
+        /** Split a batch into messages
+         *
+         * @return false if the batch is invalid, in which case no message is
+         *   added
+         */
+        static bool split(uint8_t const* batch, int size,
+                          std::vector<std::vector<uint8_t>>& messages);
+
+        /** Wait for a message
+         *
+         * @return the message size
+         * @throw iodrivers_base::TimeoutError if no message was received
+         *   within the timeout
+         * @throw std::invalid_argument if the buffer is too small for the
+         *   message. The message is dropped.
+         */
+        int receive(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
+        Statistics getStatistics() const;
+    };
+}
+
+#endif
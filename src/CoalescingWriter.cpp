@@ -0,0 +1,166 @@
+#include <comms_lora_ebyte_e32/CoalescingWriter.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const int CoalescingWriter::DEFAULT_MAX_BATCH_SIZE;
+
+/** Batch key of the transparent transmission mode, outside of the range of
+ * the target and channel keys
+ */
+static const uint32_t TRANSPARENT_KEY = 1 << 24;
+
+double CoalescingWriter::Statistics::getBatchingRatio() const {
+    return frames ? static_cast<double>(messages) / frames : 0;
+}
+
+CoalescingWriter::CoalescingWriter(Driver& driver, int max_batch_size,
+                                   base::Time const& max_latency)
+    : m_driver(driver)
+    , m_max_latency(max_latency) {
+    setMaxBatchSize(max_batch_size);
+}
+
+void CoalescingWriter::setMaxBatchSize(int size) {
+    if (size < 2 || size > Driver::MAX_FRAME_PAYLOAD_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::CoalescingWriter: the batch size must be "
+            "between 2 and " + std::to_string(Driver::MAX_FRAME_PAYLOAD_SIZE)
+        );
+    }
+    m_max_batch_size = size;
+}
+
+int CoalescingWriter::getMaxBatchSize() const {
+    return m_max_batch_size;
+}
+
+int CoalescingWriter::getMaxMessageSize() const {
+    return m_max_batch_size - 1;
+}
+
+void CoalescingWriter::setMaxLatency(base::Time const& latency) {
+    m_max_latency = latency;
+}
+
+base::Time CoalescingWriter::getMaxLatency() const {
+    return m_max_latency;
+}
+
+void CoalescingWriter::write(uint8_t const* message, int size) {
+    write(TRANSPARENT_KEY, false, 0, 0, message, size);
+}
+
+void CoalescingWriter::write(uint16_t target, uint8_t channel,
+                             uint8_t const* message, int size) {
+    write((static_cast<uint32_t>(target) << 8) | channel, true,
+          target, channel, message, size);
+}
+
+void CoalescingWriter::write(uint32_t key, bool fixed, uint16_t target,
+                             uint8_t channel, uint8_t const* message, int size) {
+    if (size > getMaxMessageSize()) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::CoalescingWriter::write: messages are "
+            "limited to " + std::to_string(getMaxMessageSize()) + " bytes"
+        );
+    }
+
+    base::Time now = base::Time::now();
+    process(now);
+
+    Batch& batch = m_batches[key];
+    batch.fixed = fixed;
+    batch.target = target;
+    batch.channel = channel;
+    if (static_cast<int>(batch.data.size()) + 1 + size > m_max_batch_size) {
+        m_stats.size_flushes++;
+        flush(batch);
+    }
+    if (batch.messages == 0) {
+        batch.deadline = now + m_max_latency;
+    }
+    batch.data.push_back(size);
+    batch.data.insert(batch.data.end(), message, message + size);
+    batch.messages++;
+    m_stats.messages++;
+    m_stats.message_bytes += size;
+
+    // Not even room for a 1-byte message
+    if (static_cast<int>(batch.data.size()) + 2 > m_max_batch_size) {
+        m_stats.size_flushes++;
+        flush(batch);
+    }
+}
+
+void CoalescingWriter::flush(Batch& batch) {
+    if (batch.messages == 0) {
+        return;
+    }
+
+    int written;
+    if (batch.fixed) {
+        // Batches to different targets are flushed back-to-back, the UART
+        // must go idle in-between for the module to see the new header
+        m_driver.waitFixedTransmissionGap();
+        written = m_driver.writeFrame(batch.target, batch.channel,
+                                      batch.data.data(), batch.data.size());
+    }
+    else {
+        written = m_driver.writeFrame(batch.data.data(), batch.data.size());
+    }
+    if (written == 0) {
+        throw iodrivers_base::TimeoutError(
+            iodrivers_base::TimeoutError::PACKET,
+            "comms_lora_ebyte_e32::CoalescingWriter: timed out writing a frame"
+        );
+    }
+
+    m_stats.frames++;
+    m_stats.frame_bytes += batch.data.size();
+    batch.data.clear();
+    batch.messages = 0;
+}
+
+void CoalescingWriter::process(base::Time const& now) {
+    for (auto& entry : m_batches) {
+        Batch& batch = entry.second;
+        if (batch.messages && batch.deadline <= now) {
+            m_stats.deadline_flushes++;
+            flush(batch);
+        }
+    }
+}
+
+void CoalescingWriter::flush() {
+    for (auto& entry : m_batches) {
+        flush(entry.second);
+    }
+}
+
+base::Time CoalescingWriter::getNextDeadline() const {
+    base::Time deadline = base::Time::max();
+    for (auto const& entry : m_batches) {
+        if (entry.second.messages) {
+            deadline = std::min(deadline, entry.second.deadline);
+        }
+    }
+    return deadline;
+}
+
+int CoalescingWriter::getPendingMessages() const {
+    int count = 0;
+    for (auto const& entry : m_batches) {
+        count += entry.second.messages;
+    }
+    return count;
+}
+
+CoalescingWriter::Statistics CoalescingWriter::getStatistics() const {
+    return m_stats;
+}
+
+void CoalescingWriter::resetStatistics() {
+    m_stats = Statistics();
+}
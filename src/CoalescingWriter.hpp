@@ -0,0 +1,134 @@
+#ifndef COMMS_LORA_EBYTE_E32_COALESCINGWRITER_HPP
+#define COMMS_LORA_EBYTE_E32_COALESCINGWRITER_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Gather small messages into shared frames
+     *
+     * Each frame sent on air pays the fixed transmission header, the driver's
+     * frame header and the module's per-transmission overhead. This writer
+     * appends messages to a batch per target and channel, and sends the batch
+     * as one length-prefixed frame (see Driver::writeFrame) when the next
+     * message would not fit, or when its oldest message waited for the
+     * maximum latency.
+     *
+     * Within the frame, each message is preceded by its size (1 byte). Use a
+     * CoalescingReader to split them on the receiving side.
+     *
+     * Deadlines are only checked in write() and process(), which must be
+     * called regularly. In fixed transmission mode, flushing a batch waits
+     * for the driver's fixed transmission gap (see
+     * Driver::setFixedTransmissionGap).
+     */
+    class CoalescingWriter {
+    public:
+        /** Default batch size
+         *
+         * It is the largest frame payload that fits in one sub-packet in fixed
+         * transmission mode
+         */
+        static const int DEFAULT_MAX_BATCH_SIZE = 53;
+
+        struct Statistics {
+            uint64_t messages = 0;
+            uint64_t message_bytes = 0;
+            /** Frames sent, i.e. batches */
+            uint64_t frames = 0;
+            /** Frame payload bytes, including the message sizes */
+            uint64_t frame_bytes = 0;
+            /** Batches sent because the next message did not fit */
+            uint64_t size_flushes = 0;
+            /** Batches sent because their latency deadline was reached */
+            uint64_t deadline_flushes = 0;
+
+            /** Average number of messages per frame */
+            double getBatchingRatio() const;
+        };
+
+    private:
+        struct Batch {
+            bool fixed = false;
+            uint16_t target = 0;
+            uint8_t channel = 0;
+            std::vector<uint8_t> data;
+            int messages = 0;
+            base::Time deadline;
+        };
+
+        Driver& m_driver;
+        int m_max_batch_size;
+        base::Time m_max_latency;
+        std::map<uint32_t, Batch> m_batches;
+        Statistics m_stats;
+
+        void write(uint32_t key, bool fixed, uint16_t target, uint8_t channel,
+                   uint8_t const* message, int size);
+        void flush(Batch& batch);
+
+    public:
+        /**
+         * @arg driver the driver
+         * @arg max_batch_size the maximum frame payload size, up to
+         *   Driver::MAX_FRAME_PAYLOAD_SIZE
+         * @arg max_latency the maximum time a message waits in a batch
+         */
+        explicit CoalescingWriter(
+            Driver& driver,
+            int max_batch_size = DEFAULT_MAX_BATCH_SIZE,
+            base::Time const& max_latency = base::Time::fromMilliseconds(20)
+        );
+
+        void setMaxBatchSize(int size);
+        int getMaxBatchSize() const;
+
+        /** The largest message, i.e. the batch size minus the size byte */
+        int getMaxMessageSize() const;
+
+        void setMaxLatency(base::Time const& latency);
+        base::Time getMaxLatency() const;
+
+        /** Queue a message for transparent transmission
+         *
+         * @throw std::invalid_argument if the message is larger than
+         *   getMaxMessageSize()
+         * @throw iodrivers_base::TimeoutError if a frame could not be written
+         *   within the driver's write timeout
+         */
+        void write(uint8_t const* message, int size);
+
+        /** Queue a message for a target and channel in fixed transmission
+         * mode
+         *
+         * @throw std::invalid_argument if the message is larger than
+         *   getMaxMessageSize()
+         * @throw iodrivers_base::TimeoutError if a frame could not be written
+         *   within the driver's write timeout
+         */
+        void write(uint16_t target, uint8_t channel, uint8_t const* message, int size);
+
+        /** Send the batches whose deadline is reached */
+        void process(base::Time const& now = base::Time::now());
+
+        /** Send all pending batches */
+        void flush();
+
+        /** The earliest batch deadline, or base::Time::max() if there are no
+         * pending messages
+         */
+        base::Time getNextDeadline() const;
+
+        /** Number of messages waiting in batches */
+        int getPendingMessages() const;
+
+        Statistics getStatistics() const;
+        void resetStatistics();
+    };
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include <comms_lora_ebyte_e32/CompressedLink.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <cstring>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const uint8_t CompressedLink::FLAG_UNCOMPRESSED;
+const uint8_t CompressedLink::FLAG_COMPRESSED;
+
+CompressedLink::CompressedLink(Driver& driver, vector<uint8_t> const& dictionary,
+                               int max_packet_size)
+    : m_driver(driver)
+    , m_compressor(dictionary)
+    , m_max_packet_size(max_packet_size)
+    , m_frame(Driver::MAX_FRAME_PAYLOAD_SIZE)
+    , m_buffer(max_packet_size) {
+    if (max_packet_size > Compressor::MAX_PAYLOAD_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::CompressedLink: packets are limited to " +
+            std::to_string(Compressor::MAX_PAYLOAD_SIZE) + " bytes"
+        );
+    }
+    m_driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+}
+
+int CompressedLink::getMaxPacketSize() const {
+    return m_max_packet_size;
+}
+
+int CompressedLink::encode(uint8_t const* packet, int size) {
+    if (size > m_max_packet_size) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::CompressedLink::send: packets are limited "
+            "to " + std::to_string(m_max_packet_size) + " bytes"
+        );
+    }
+
+    int compressed_size = m_compressor.compress(
+        packet, size, m_frame.data() + 1, std::min<int>(size, m_frame.size() - 1)
+    );
+    if (compressed_size >= 0 && compressed_size < size) {
+        m_frame[0] = FLAG_COMPRESSED;
+        m_stats.compressed_packets++;
+        return compressed_size + 1;
+    }
+    if (size + 1 > static_cast<int>(m_frame.size())) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::CompressedLink::send: packet does not "
+            "compress enough to fit in a frame"
+        );
+    }
+    m_frame[0] = FLAG_UNCOMPRESSED;
+    memcpy(m_frame.data() + 1, packet, size);
+    return size + 1;
+}
+
+static void checkWritten(int written) {
+    if (written == 0) {
+        throw iodrivers_base::TimeoutError(
+            iodrivers_base::TimeoutError::PACKET,
+            "comms_lora_ebyte_e32::CompressedLink::send: "
+            "timed out writing a frame"
+        );
+    }
+}
+
+void CompressedLink::send(uint8_t const* packet, int size) {
+    int frame_size = encode(packet, size);
+    checkWritten(m_driver.writeFrame(m_frame.data(), frame_size));
+    m_stats.sent_packets++;
+    m_stats.sent_bytes += size;
+    m_stats.sent_frame_bytes += frame_size;
+}
+
+void CompressedLink::send(uint16_t target, uint8_t channel,
+                          uint8_t const* packet, int size) {
+    int frame_size = encode(packet, size);
+    checkWritten(m_driver.writeFrame(target, channel, m_frame.data(), frame_size));
+    m_stats.sent_packets++;
+    m_stats.sent_bytes += size;
+    m_stats.sent_frame_bytes += frame_size;
+}
+
+int CompressedLink::receive(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    uint8_t packet[Driver::MAX_PACKET_SIZE];
+    while (true) {
+        base::Time now = base::Time::now();
+        base::Time remaining = deadline > now ? deadline - now : base::Time();
+        int size = m_driver.readPacket(packet, Driver::MAX_PACKET_SIZE, remaining) -
+                   Driver::FRAME_HEADER_SIZE;
+        uint8_t const* frame = packet + Driver::FRAME_HEADER_SIZE;
+        if (size < 1) {
+            m_stats.invalid_frames++;
+            continue;
+        }
+
+        uint8_t const* payload = frame + 1;
+        int payload_size = size - 1;
+        if (frame[0] == FLAG_COMPRESSED) {
+            try {
+                payload_size = m_compressor.decompress(
+                    frame + 1, size - 1, m_buffer.data(), m_buffer.size()
+                );
+            }
+            catch (std::invalid_argument const&) {
+                m_stats.invalid_frames++;
+                continue;
+            }
+            payload = m_buffer.data();
+        }
+        else if (frame[0] != FLAG_UNCOMPRESSED) {
+            m_stats.invalid_frames++;
+            continue;
+        }
+
+        m_stats.received_packets++;
+        m_stats.received_bytes += payload_size;
+        m_stats.received_frame_bytes += size;
+        if (payload_size > bufsize) {
+            throw std::invalid_argument(
+                "comms_lora_ebyte_e32::CompressedLink::receive: received a " +
+                std::to_string(payload_size) + " bytes packet in a " +
+                std::to_string(bufsize) + " bytes buffer"
+            );
+        }
+        memcpy(buffer, payload, payload_size);
+        return payload_size;
+    }
+}
+
+void CompressedLink::resetStatistics() {
+    m_stats = Statistics();
+}
+
+CompressedLink::Statistics CompressedLink::getStatistics() const {
+    return m_stats;
+}
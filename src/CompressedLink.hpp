@@ -0,0 +1,103 @@
+#ifndef COMMS_LORA_EBYTE_E32_COMPRESSEDLINK_HPP
+#define COMMS_LORA_EBYTE_E32_COMPRESSEDLINK_HPP
+
+#include <comms_lora_ebyte_e32/Compressor.hpp>
+#include <base/Time.hpp>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Send and receive packets compressed by a Compressor
+     *
+     * Each packet is sent as a length-prefixed frame (see Driver::writeFrame)
+     * whose first byte tells whether the rest of the frame is compressed. A
+     * packet is sent uncompressed when compression would not make it smaller.
+     * On the receiving side, the driver is put in PACKET_MODE_LENGTH_PREFIXED.
+     *
+     * Both ends must use the same compression dictionary.
+     */
+    class CompressedLink {
+    public:
+        static const uint8_t FLAG_UNCOMPRESSED = 0;
+        static const uint8_t FLAG_COMPRESSED = 1;
+
+        struct Statistics {
+            uint64_t sent_packets = 0;
+            /** Packets that were sent compressed */
+            uint64_t compressed_packets = 0;
+            /** Size of the sent packets before compression */
+            uint64_t sent_bytes = 0;
+            /** Size of the frame payloads, including the flag byte */
+            uint64_t sent_frame_bytes = 0;
+            uint64_t received_packets = 0;
+            /** Size of the received packets after decompression */
+            uint64_t received_bytes = 0;
+            /** Size of the received frame payloads */
+            uint64_t received_frame_bytes = 0;
+            /** Frames with an unknown flag or that failed to decompress */
+            uint64_t invalid_frames = 0;
+        };
+
+    private:
+        Driver& m_driver;
+        Compressor m_compressor;
+        int m_max_packet_size;
+        std::vector<uint8_t> m_frame;
+        std::vector<uint8_t> m_buffer;
+        Statistics m_stats;
+
+        int encode(uint8_t const* packet, int size);
+
+    public:
+        /**
+         * @arg driver the driver. Its packet mode is changed to
+         *   PACKET_MODE_LENGTH_PREFIXED
+         * @arg dictionary the compression dictionary (see Compressor::train)
+         * @arg max_packet_size the largest packet that can be sent or
+         *   received. Packets that do not compress must still fit in a frame.
+         */
+        explicit CompressedLink(Driver& driver,
+                                std::vector<uint8_t> const& dictionary = {},
+                                int max_packet_size = 1024);
+
+        /** The largest packet that can be sent or received */
+        int getMaxPacketSize() const;
+
+        /** Send a packet in transparent transmission mode
+         *
+         * @throw std::invalid_argument if the packet is larger than
+         *   getMaxPacketSize() or does not compress enough to fit in a frame
+         * @throw iodrivers_base::TimeoutError if the frame could not be
+         *   written within the driver's write timeout
+         */
+        void send(uint8_t const* packet, int size);
+
+        /** Send a packet in fixed transmission mode
+         *
+         * @throw std::invalid_argument if the packet is larger than
+         *   getMaxPacketSize() or does not compress enough to fit in a frame
+         * @throw iodrivers_base::TimeoutError if the frame could not be
+         *   written within the driver's write timeout
+         */
+        void send(uint16_t target, uint8_t channel, uint8_t const* packet, int size);
+
+        /** Wait for a packet
+         *
+         * Invalid frames are counted in the statistics and skipped
+         *
+         * @return the packet size
+         * @throw iodrivers_base::TimeoutError if no packet was received within
+         *   the timeout
+         * @throw std::invalid_argument if the buffer is too small for the
+         *   packet. The packet is dropped.
+         */
+        int receive(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
+        /** Reset the statistics */
+        void resetStatistics();
+
+        Statistics getStatistics() const;
+    };
+}
+
+#endif
@@ -0,0 +1,275 @@
+#include <comms_lora_ebyte_e32/Compressor.hpp>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const int Compressor::MIN_MATCH;
+const int Compressor::MAX_DICTIONARY_SIZE;
+const int Compressor::MAX_PAYLOAD_SIZE;
+const int Compressor::HASH_BITS;
+
+/** Length of the sequences counted by train() */
+static const int TRAINING_GRAM_SIZE = 8;
+
+Compressor::Compressor(vector<uint8_t> const& dictionary)
+    : m_dictionary(dictionary)
+    , m_dictionary_hash(1 << HASH_BITS, -1)
+    , m_window(dictionary)
+    , m_hash(1 << HASH_BITS) {
+    if (dictionary.size() > MAX_DICTIONARY_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::Compressor: the dictionary is larger than " +
+            std::to_string(MAX_DICTIONARY_SIZE) + " bytes"
+        );
+    }
+    for (int i = 0; i + MIN_MATCH <= static_cast<int>(dictionary.size()); ++i) {
+        m_dictionary_hash[hash(dictionary.data() + i)] = i;
+    }
+}
+
+vector<uint8_t> const& Compressor::getDictionary() const {
+    return m_dictionary;
+}
+
+uint32_t Compressor::hash(uint8_t const* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+int Compressor::getMaxCompressedSize(int size) {
+    return size + size / 255 + 16;
+}
+
+static bool writeLength(uint8_t*& out, uint8_t* out_end, int length) {
+    while (length >= 255) {
+        if (out == out_end) {
+            return false;
+        }
+        *out++ = 255;
+        length -= 255;
+    }
+    if (out == out_end) {
+        return false;
+    }
+    *out++ = length;
+    return true;
+}
+
+static bool writeBlock(uint8_t*& out, uint8_t* out_end,
+                       uint8_t const* literals, int literal_count,
+                       int offset, int match_length) {
+    int match_code = offset ? match_length - Compressor::MIN_MATCH : 0;
+    if (out == out_end) {
+        return false;
+    }
+    *out++ = (std::min(literal_count, 15) << 4) | std::min(match_code, 15);
+    if (literal_count >= 15 && !writeLength(out, out_end, literal_count - 15)) {
+        return false;
+    }
+    if (out_end - out < literal_count) {
+        return false;
+    }
+    memcpy(out, literals, literal_count);
+    out += literal_count;
+    if (!offset) {
+        return true;
+    }
+
+    if (out_end - out < 2) {
+        return false;
+    }
+    *out++ = offset & 0xff;
+    *out++ = offset >> 8;
+    return match_code < 15 || writeLength(out, out_end, match_code - 15);
+}
+
+int Compressor::compress(uint8_t const* data, int size, uint8_t* out, int out_size) {
+    if (size > MAX_PAYLOAD_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::Compressor::compress: payloads are limited "
+            "to " + std::to_string(MAX_PAYLOAD_SIZE) + " bytes"
+        );
+    }
+
+    int start = m_dictionary.size();
+    int end = start + size;
+    m_window.resize(end);
+    memcpy(m_window.data() + start, data, size);
+    m_hash = m_dictionary_hash;
+    uint8_t const* window = m_window.data();
+
+    uint8_t* out_start = out;
+    uint8_t* out_end = out + out_size;
+    int anchor = start;
+    int pos = start;
+    while (pos + MIN_MATCH <= end) {
+        uint32_t h = hash(window + pos);
+        int candidate = m_hash[h];
+        m_hash[h] = pos;
+        if (candidate < 0 || memcmp(window + candidate, window + pos, MIN_MATCH)) {
+            ++pos;
+            continue;
+        }
+
+        int length = MIN_MATCH;
+        while (pos + length < end && window[candidate + length] == window[pos + length]) {
+            ++length;
+        }
+        if (!writeBlock(out, out_end, window + anchor, pos - anchor,
+                        pos - candidate, length)) {
+            return -1;
+        }
+        for (int i = pos + 1; i < pos + length && i + MIN_MATCH <= end; ++i) {
+            m_hash[hash(window + i)] = i;
+        }
+        pos += length;
+        anchor = pos;
+    }
+
+    if (anchor < end &&
+        !writeBlock(out, out_end, window + anchor, end - anchor, 0, 0)) {
+        return -1;
+    }
+    return out - out_start;
+}
+
+static int readLength(uint8_t const*& data, uint8_t const* end, int length) {
+    if (length < 15) {
+        return length;
+    }
+    while (true) {
+        if (data == end) {
+            throw std::invalid_argument(
+                "comms_lora_ebyte_e32::Compressor::decompress: truncated length"
+            );
+        }
+        uint8_t byte = *data++;
+        length += byte;
+        if (byte != 255) {
+            return length;
+        }
+    }
+}
+
+int Compressor::decompress(uint8_t const* data, int size,
+                           uint8_t* out, int out_size) const {
+    uint8_t const* end = data + size;
+    int dictionary_size = m_dictionary.size();
+    int pos = 0;
+    while (data != end) {
+        uint8_t token = *data++;
+        int literal_count = readLength(data, end, token >> 4);
+        if (end - data < literal_count || out_size - pos < literal_count) {
+            throw std::invalid_argument(
+                "comms_lora_ebyte_e32::Compressor::decompress: literals "
+                "overflow the input or output"
+            );
+        }
+        memcpy(out + pos, data, literal_count);
+        data += literal_count;
+        pos += literal_count;
+        if (data == end) {
+            break;
+        }
+
+        if (end - data < 2) {
+            throw std::invalid_argument(
+                "comms_lora_ebyte_e32::Compressor::decompress: truncated offset"
+            );
+        }
+        int offset = data[0] | (data[1] << 8);
+        data += 2;
+        int length = readLength(data, end, token & 0xf) + MIN_MATCH;
+        if (offset == 0 || offset > pos + dictionary_size ||
+            out_size - pos < length) {
+            throw std::invalid_argument(
+                "comms_lora_ebyte_e32::Compressor::decompress: invalid match"
+            );
+        }
+        for (int i = 0; i < length; ++i, ++pos) {
+            int from = pos - offset;
+            out[pos] = from < 0 ? m_dictionary[dictionary_size + from] : out[from];
+        }
+    }
+    return pos;
+}
+
+vector<uint8_t> Compressor::train(vector<vector<uint8_t>> const& samples, int size) {
+    // Count the samples each sequence appears in
+    unordered_map<string, int> counts;
+    for (auto const& sample : samples) {
+        unordered_set<string> seen;
+        for (int i = 0; i + TRAINING_GRAM_SIZE <= static_cast<int>(sample.size()); ++i) {
+            string gram(sample.begin() + i, sample.begin() + i + TRAINING_GRAM_SIZE);
+            if (seen.insert(gram).second) {
+                counts[gram]++;
+            }
+        }
+    }
+
+    // Merge overlapping sequences that appear in at least half of the
+    // samples into segments, scored by the average number of samples their
+    // sequences appear in
+    int threshold = std::max<int>(2, samples.size() / 2);
+    map<string, double> segments;
+    for (auto const& sample : samples) {
+        int i = 0;
+        int sample_size = sample.size();
+        while (i + TRAINING_GRAM_SIZE <= sample_size) {
+            int total = 0;
+            int j = i;
+            for (; j + TRAINING_GRAM_SIZE <= sample_size; ++j) {
+                string gram(sample.begin() + j, sample.begin() + j + TRAINING_GRAM_SIZE);
+                int count = counts[gram];
+                if (count < threshold) {
+                    break;
+                }
+                total += count;
+            }
+            if (j == i) {
+                ++i;
+                continue;
+            }
+            string segment(sample.begin() + i, sample.begin() + j + TRAINING_GRAM_SIZE - 1);
+            segments[segment] = static_cast<double>(total) / (j - i);
+            i = j;
+        }
+    }
+
+    vector<pair<double, string>> sorted;
+    for (auto const& segment : segments) {
+        sorted.push_back(make_pair(segment.second, segment.first));
+    }
+    sort(sorted.begin(), sorted.end(), [](pair<double, string> const& a,
+                                          pair<double, string> const& b) {
+        return a.first > b.first;
+    });
+
+    // Select the most common segments, and place them last where the
+    // compressor finds them first
+    vector<string> selected;
+    string content;
+    for (auto const& segment : sorted) {
+        if (content.find(segment.second) != string::npos) {
+            continue;
+        }
+        if (static_cast<int>(content.size() + segment.second.size()) > size) {
+            continue;
+        }
+        selected.push_back(segment.second);
+        content += segment.second;
+    }
+    vector<uint8_t> dictionary;
+    for (auto it = selected.rbegin(); it != selected.rend(); ++it) {
+        dictionary.insert(dictionary.end(), it->begin(), it->end());
+    }
+    return dictionary;
+}
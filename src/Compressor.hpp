@@ -0,0 +1,89 @@
+#ifndef COMMS_LORA_EBYTE_E32_COMPRESSOR_HPP
+#define COMMS_LORA_EBYTE_E32_COMPRESSOR_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** LZ77 compression of small payloads with a preset dictionary
+     *
+     * Each payload is compressed independently, so that losing a frame does
+     * not prevent decoding the next ones. Small payloads barely compress on
+     * their own. The dictionary, shared by both ends of the link, holds
+     * content typical of the payloads (e.g. field names) that matches can
+     * refer to. Use train() to build one from sample payloads.
+     *
+     * The compressed data is a sequence of blocks, laid out as LZ4 blocks:
+     *
+     * - a token byte. The high nibble is the literal count, the low nibble
+     *   the match length minus MIN_MATCH. A nibble of 15 is followed by
+     *   bytes that are added to it, until one is lower than 255
+     * - the literals
+     * - the match offset (2 bytes, little endian), i.e. the distance back
+     *   from the current position in the dictionary followed by the output
+     *
+     * The last block has no match. The data ends after its literals.
+     */
+    class Compressor {
+    public:
+        /** Shortest match */
+        static const int MIN_MATCH = 4;
+
+        /** Largest dictionary, bound by the size of the match offset */
+        static const int MAX_DICTIONARY_SIZE = 32768;
+
+        /** Largest payload, bound by the size of the match offset */
+        static const int MAX_PAYLOAD_SIZE = 32767;
+
+    private:
+        static const int HASH_BITS = 12;
+
+        std::vector<uint8_t> m_dictionary;
+        std::vector<int32_t> m_dictionary_hash;
+        std::vector<uint8_t> m_window;
+        std::vector<int32_t> m_hash;
+
+        static uint32_t hash(uint8_t const* data);
+
+    public:
+        /** @arg dictionary the preset dictionary, at most MAX_DICTIONARY_SIZE
+         *   bytes. Both ends of the link must use the same.
+         */
+        explicit Compressor(std::vector<uint8_t> const& dictionary = {});
+
+        std::vector<uint8_t> const& getDictionary() const;
+
+        /** The compressed size of incompressible data */
+        static int getMaxCompressedSize(int size);
+
+        /** Compress a payload
+         *
+         * @return the compressed size, or -1 if it does not fit in out_size
+         * @throw std::invalid_argument if size is larger than
+         *   MAX_PAYLOAD_SIZE
+         */
+        int compress(uint8_t const* data, int size, uint8_t* out, int out_size);
+
+        /** Decompress a payload
+         *
+         * @return the decompressed size
+         * @throw std::invalid_argument if the data is corrupted or does not
+         *   fit in out_size
+         */
+        int decompress(uint8_t const* data, int size,
+                       uint8_t* out, int out_size) const;
+
+        /** Build a dictionary from sample payloads
+         *
+         * The dictionary is made of the sequences that are common to most
+         * samples, the most common last.
+         *
+         * @arg size the maximum dictionary size
+         */
+        static std::vector<uint8_t> train(
+            std::vector<std::vector<uint8_t>> const& samples, int size
+        );
+    };
+}
+
+#endif
@@ -1,9 +1,29 @@
 #ifndef COMMS_LORA_EBYTE_E32_CONFIGURATION_HPP
 #define COMMS_LORA_EBYTE_E32_CONFIGURATION_HPP
 
+#include <cstdint>
+
 namespace comms_lora_ebyte_e32 {
     struct Configuration {
-        uint16_t address;
+        /** Flags identifying the configuration fields
+         *
+         * @see differences
+         */
+        enum Field {
+            FIELD_ADDRESS = 0x001,
+            FIELD_UART_PARITY = 0x002,
+            FIELD_UART_RATE = 0x004,
+            FIELD_AIR_RATE = 0x008,
+            FIELD_CHANNEL = 0x010,
+            FIELD_TRANSMISSION_MODE = 0x020,
+            FIELD_IO_DRIVE_MODE = 0x040,
+            FIELD_WIRELESS_WAKE_UP_TIME = 0x080,
+            FIELD_ERROR_CORRECTION = 0x100,
+            FIELD_TRANSMISSION_POWER = 0x200,
+            FIELD_ALL = 0x3ff
+        };
+
+        uint16_t address = 0;
 
         enum UARTParity {
             PARITY_8N1,
@@ -84,6 +104,26 @@ namespace comms_lora_ebyte_e32 {
         };
 
         TransmissionPower transmission_power = POWER_30dBm;
+
+        /** The set of fields that differ between this configuration and
+         * another one, as a combination of Field flags
+         */
+        int differences(Configuration const& other) const {
+            return (address != other.address ? FIELD_ADDRESS : 0) |
+                (uart_parity != other.uart_parity ? FIELD_UART_PARITY : 0) |
+                (uart_rate != other.uart_rate ? FIELD_UART_RATE : 0) |
+                (air_rate != other.air_rate ? FIELD_AIR_RATE : 0) |
+                (channel != other.channel ? FIELD_CHANNEL : 0) |
+                (transparent_transmission != other.transparent_transmission ?
+                    FIELD_TRANSMISSION_MODE : 0) |
+                (io_drive_mode != other.io_drive_mode ? FIELD_IO_DRIVE_MODE : 0) |
+                (wireless_wake_up_time != other.wireless_wake_up_time ?
+                    FIELD_WIRELESS_WAKE_UP_TIME : 0) |
+                (error_correction_enabled != other.error_correction_enabled ?
+                    FIELD_ERROR_CORRECTION : 0) |
+                (transmission_power != other.transmission_power ?
+                    FIELD_TRANSMISSION_POWER : 0);
+        }
     };
 }
 
@@ -0,0 +1,219 @@
+#ifndef COMMS_LORA_EBYTE_E32_CONFIGURATIONCODEC_HPP
+#define COMMS_LORA_EBYTE_E32_CONFIGURATIONCODEC_HPP
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <comms_lora_ebyte_e32/Configuration.hpp>
+
+namespace comms_lora_ebyte_e32 {
+    /** Size of the raw configuration representation */
+    static const int CONFIGURATION_SIZE = 5;
+
+    /** Size of a configuration write command */
+    static const int CONFIGURATION_COMMAND_SIZE = CONFIGURATION_SIZE + 1;
+
+    /** A complete configuration write command */
+    typedef std::array<uint8_t, CONFIGURATION_COMMAND_SIZE> ConfigurationCommand;
+
+    /** Maximum value of Configuration::channel */
+    static const uint8_t MAX_CHANNEL = 0x1f;
+
+    /** Maximum value of Configuration::wireless_wake_up_time */
+    static const uint8_t MAX_WIRELESS_WAKE_UP_TIME = 7;
+
+    /** Whether all fields of the configuration are within the ranges the
+     * module accepts
+     */
+    constexpr bool isValid(Configuration const& conf) noexcept {
+        return conf.channel <= MAX_CHANNEL &&
+               conf.wireless_wake_up_time <= MAX_WIRELESS_WAKE_UP_TIME;
+    }
+
+    /** Compute one byte of the configuration raw representation
+     *
+     * @param index the byte index, between 0 and CONFIGURATION_SIZE - 1
+     */
+    constexpr uint8_t encodeConfigurationByte(Configuration const& conf,
+                                              int index) noexcept {
+        switch (index) {
+            case 0:
+                return (conf.address >> 8) & 0xff;
+            case 1:
+                return (conf.address >> 0) & 0xff;
+            case 2:
+                return (conf.uart_parity << 6) |
+                       (conf.uart_rate << 3) |
+                       (conf.air_rate << 0);
+            case 3:
+                return conf.channel;
+            case 4:
+                return ((conf.transparent_transmission ? 0 : 1) << 7) |
+                       ((conf.io_drive_mode == Configuration::IO_PUSH_PULL) << 6) |
+                       ((conf.wireless_wake_up_time & 0b111) << 3) |
+                       ((conf.error_correction_enabled ? 1 : 0) << 2) |
+                       (conf.transmission_power << 0);
+            default:
+                return 0;
+        }
+    }
+
+    /** Encode the configuration raw representation
+     *
+     * @param buffer CONFIGURATION_SIZE bytes will be written to it
+     */
+    constexpr void encodeConfiguration(uint8_t* buffer,
+                                       Configuration const& conf) noexcept {
+        for (int i = 0; i < CONFIGURATION_SIZE; ++i) {
+            buffer[i] = encodeConfigurationByte(conf, i);
+        }
+    }
+
+    /** Build the configuration write command
+     *
+     * Used in a constexpr context, it produces the command blob at compile
+     * time:
+     *
+     * <code>
+     * constexpr auto command = makeConfigurationCommand(
+     *     ConfigurationBuilder().channel(12).build(), false
+     * );
+     * </code>
+     *
+     * @param save whether the configuration should be saved in the module's
+     *   non-volatile memory
+     */
+    constexpr ConfigurationCommand makeConfigurationCommand(
+        Configuration const& conf, bool save
+    ) noexcept {
+        return ConfigurationCommand {{
+            static_cast<uint8_t>(save ? 0xc0 : 0xc2),
+            encodeConfigurationByte(conf, 0),
+            encodeConfigurationByte(conf, 1),
+            encodeConfigurationByte(conf, 2),
+            encodeConfigurationByte(conf, 3),
+            encodeConfigurationByte(conf, 4)
+        }};
+    }
+
+    /** Decode the configuration raw representation
+     *
+     * @param data CONFIGURATION_SIZE bytes
+     */
+    constexpr Configuration decodeConfiguration(uint8_t const* data) noexcept {
+        Configuration conf;
+        uint16_t address_msb = data[0];
+        uint16_t address_lsb = data[1];
+        uint8_t uart_parity_raw = (data[2] >> 6) & 0b11;
+        if (uart_parity_raw == 3) {
+            uart_parity_raw = 0;
+        }
+        uint8_t uart_rate_raw = (data[2] >> 3) & 0b111;
+        uint8_t air_rate_raw = (data[2] >> 0) & 0b111;
+        if (air_rate_raw > Configuration::AIR_RATE_19200) {
+            air_rate_raw = Configuration::AIR_RATE_19200;
+        }
+        uint8_t transmission_mode_raw = (data[4] >> 7) & 0b1;
+        uint8_t io_drive_mode_raw = (data[4] >> 6) & 0b1;
+        uint8_t wireless_wakeup_time_raw = (data[4] >> 3) & 0b111;
+        uint8_t error_correction_enabled = (data[4] >> 2) & 0b1;
+        uint8_t transmission_power_raw = (data[4] >> 0) & 0b11;
+
+        conf.address = address_msb << 8 | address_lsb;
+        conf.uart_parity = static_cast<Configuration::UARTParity>(uart_parity_raw);
+        conf.uart_rate = static_cast<Configuration::UARTRate>(uart_rate_raw);
+        conf.air_rate = static_cast<Configuration::AirRate>(air_rate_raw);
+        conf.channel = data[3];
+        conf.transparent_transmission = transmission_mode_raw == 0;
+        conf.io_drive_mode = io_drive_mode_raw ? Configuration::IO_PUSH_PULL :
+                                                 Configuration::IO_OPEN_DRAIN;
+        conf.wireless_wake_up_time = wireless_wakeup_time_raw;
+        conf.error_correction_enabled = error_correction_enabled;
+        conf.transmission_power = static_cast<Configuration::TransmissionPower>(
+            transmission_power_raw
+        );
+        return conf;
+    }
+
+    /** Build a Configuration with range checks
+     *
+     * The setters throw std::out_of_range when given a value the module does
+     * not accept. In a constexpr context, this turns range errors into
+     * compilation errors.
+     */
+    class ConfigurationBuilder {
+        Configuration m_conf;
+
+    public:
+        constexpr ConfigurationBuilder() = default;
+        constexpr explicit ConfigurationBuilder(Configuration const& conf)
+            : m_conf(conf) {
+        }
+
+        constexpr ConfigurationBuilder& address(uint16_t address) {
+            m_conf.address = address;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& uartParity(Configuration::UARTParity parity) {
+            m_conf.uart_parity = parity;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& uartRate(Configuration::UARTRate rate) {
+            m_conf.uart_rate = rate;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& airRate(Configuration::AirRate rate) {
+            m_conf.air_rate = rate;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& channel(int channel) {
+            if (channel < 0 || channel > MAX_CHANNEL) {
+                throw std::out_of_range("channel must be between 0 and 31");
+            }
+            m_conf.channel = channel;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& transparentTransmission(bool enabled) {
+            m_conf.transparent_transmission = enabled;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& ioDriveMode(Configuration::IODriveMode mode) {
+            m_conf.io_drive_mode = mode;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& wirelessWakeUpTime(int time) {
+            if (time < 0 || time > MAX_WIRELESS_WAKE_UP_TIME) {
+                throw std::out_of_range(
+                    "wireless wake-up time must be between 0 and 7"
+                );
+            }
+            m_conf.wireless_wake_up_time = time;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& errorCorrection(bool enabled) {
+            m_conf.error_correction_enabled = enabled;
+            return *this;
+        }
+
+        constexpr ConfigurationBuilder& transmissionPower(
+            Configuration::TransmissionPower power
+        ) {
+            m_conf.transmission_power = power;
+            return *this;
+        }
+
+        constexpr Configuration build() const noexcept {
+            return m_conf;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef COMMS_LORA_EBYTE_E32_CONFIGURATIONSAVESTATISTICS_HPP
+#define COMMS_LORA_EBYTE_E32_CONFIGURATIONSAVESTATISTICS_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+
+namespace comms_lora_ebyte_e32 {
+    /** Counters of Driver::saveConfiguration */
+    struct ConfigurationSaveStatistics {
+        /** Configurations written to the module's non-volatile memory */
+        uint64_t saves = 0;
+
+        /** Saves that were not needed because the module already had the
+         * configuration
+         */
+        uint64_t skipped_saves = 0;
+
+        /** Configuration reads that were not needed because the saved
+         * configuration cache already had the answer
+         */
+        uint64_t skipped_reads = 0;
+
+        /** Estimate of the time the skipped commands would have taken
+         *
+         * It is the UART transfer time of the commands and of their
+         * replies, and as such a lower bound
+         */
+        base::Time avoided_time;
+    };
+}
+
+#endif
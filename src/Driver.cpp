@@ -1,37 +1,332 @@
 #include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
 #include <base-logging/Logging.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <poll.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <thread>
+#include <vector>
 
 using namespace comms_lora_ebyte_e32;
 using std::to_string;
 
+const int Driver::FIXED_TRANSMISSION_HEADER_SIZE;
+const uint8_t Driver::FRAME_SYNC;
+const int Driver::FRAME_HEADER_SIZE;
+const int Driver::MAX_FRAME_PAYLOAD_SIZE;
+const int Driver::MAX_PACKET_SIZE;
+const int Driver::VERSION_REPLY_SIZE;
+const int Driver::CONFIGURATION_REPLY_SIZE;
+const int Driver::CONFIGURATION_COMMAND_SIZE;
+
 Driver::Driver()
-    : iodrivers_base::Driver(512) {
+    : iodrivers_base::Driver(MAX_PACKET_SIZE)
+    , m_rx_listener(*this) {
+    addListener(&m_rx_listener);
+}
+
+Driver::~Driver() {
+    // iodrivers_base deletes the listeners it still has
+    removeListener(&m_rx_listener);
+}
+
+void Driver::setCommandTimeout(base::Time const& timeout) {
+    m_command_timeout = timeout;
+}
+
+base::Time Driver::getCommandTimeout() const {
+    return m_command_timeout;
+}
+
+void Driver::setPacketMode(PacketMode mode) {
+    m_packet_mode = mode;
+}
+
+Driver::PacketMode Driver::getPacketMode() const {
+    return m_packet_mode;
+}
+
+void Driver::setLinkConfiguration(Configuration const& conf) {
+    m_link_configuration = conf;
+    m_statistics.setLinkConfiguration(conf);
+}
+
+Configuration const& Driver::getLinkConfiguration() const {
+    return m_link_configuration;
+}
+
+void Driver::setAUXMonitor(AUXMonitor* monitor) {
+    m_aux_monitor = monitor;
+    m_module_buffer_usage = 0;
+}
+
+AUXMonitor* Driver::getAUXMonitor() const {
+    return m_aux_monitor;
+}
+
+FlowControlStatistics Driver::getFlowControlStatistics() const {
+    return m_flow_control_stats;
+}
+
+DriverStatistics Driver::getStatistics() const {
+    return m_statistics.snapshot();
+}
+
+void Driver::resetStatistics() {
+    m_statistics.reset();
+}
+
+DriverStatisticsRecorder& Driver::getStatisticsRecorder() {
+    return m_statistics;
+}
+
+void Driver::setCaptureLog(CaptureLog* log) {
+    m_capture_log = log;
+}
+
+CaptureLog* Driver::getCaptureLog() const {
+    return m_capture_log;
+}
+
+void Driver::capture(CaptureLog::RecordType type,
+                     uint8_t const* data, int size) const {
+    if (m_capture_log && size > 0) {
+        m_capture_log->record(type, data, size);
+    }
+}
+
+void Driver::received(uint8_t const* data, int size) {
+    capture(m_rx_record_type, data, size);
+    if (m_rx_record_type == CaptureLog::RECORD_RX) {
+        m_statistics.recordRX(size, false);
+    }
+}
+
+Driver::RXListener::RXListener(Driver& driver)
+    : m_driver(driver) {
+}
+
+void Driver::RXListener::writeData(uint8_t const*, size_t) {
+    // Writes are recorded by the driver itself, which knows whether the
+    // bytes are data or a command
+}
+
+void Driver::RXListener::readData(uint8_t const* data, size_t size) {
+    m_driver.received(data, size);
+}
+
+int Driver::readReply(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    m_rx_record_type = CaptureLog::RECORD_REPLY;
+    try {
+        int size = iodrivers_base::Driver::readRaw(
+            buffer, bufsize, timeout, timeout, timeout
+        );
+        m_rx_record_type = CaptureLog::RECORD_RX;
+        return size;
+    }
+    catch (...) {
+        m_rx_record_type = CaptureLog::RECORD_RX;
+        throw;
+    }
+}
+
+int Driver::readPacket(uint8_t* buffer, int bufsize) {
+    return readPacket(buffer, bufsize, getReadTimeout());
+}
+
+int Driver::readPacket(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    return readPacket(buffer, bufsize, timeout, timeout);
+}
+
+int Driver::readPacket(uint8_t* buffer, int bufsize,
+                       base::Time const& packet_timeout,
+                       base::Time const& first_byte_timeout) {
+    int size;
+    try {
+        size = iodrivers_base::Driver::readPacket(
+            buffer, bufsize, packet_timeout, first_byte_timeout
+        );
+    }
+    catch (iodrivers_base::TimeoutError const& e) {
+        m_statistics.recordTimeout(e.type);
+        throw;
+    }
+    m_statistics.recordRX(0, true);
+    return size;
+}
+
+int Driver::tryReadPacket(uint8_t* buffer, int bufsize) {
+    int fd = getFileDescriptor();
+    if (!hasPacket() && fd != INVALID_FD) {
+        pollfd pfd = { fd, POLLIN, 0 };
+        if (::poll(&pfd, 1, 0) <= 0) {
+            return 0;
+        }
+    }
+
+    try {
+        int size = iodrivers_base::Driver::readPacket(
+            buffer, bufsize, base::Time(), base::Time()
+        );
+        m_statistics.recordRX(0, true);
+        return size;
+    }
+    catch (iodrivers_base::TimeoutError const&) {
+        return 0;
+    }
+}
+
+/** Time the module needs to apply a configuration command, before the host
+ * may switch to a new UART rate
+ */
+static const base::Time UART_RATE_SWITCH_DELAY = base::Time::fromMilliseconds(20);
+
+int Driver::reserveModuleBuffer(int bytes, int min_bytes,
+                                base::Time const& timeout) {
+    if (!m_aux_monitor) {
+        return bytes;
+    }
+
+    // The module cannot hold more than its buffer, waiting for more room
+    // would only run into the timeout
+    int requested = bytes;
+    bytes = std::min(bytes, MODULE_BUFFER_SIZE);
+    min_bytes = std::min(min_bytes, MODULE_BUFFER_SIZE);
+
+    base::Time start = base::Time::now();
+    base::Time deadline = start + timeout;
+    bool waited = false;
+    while (true) {
+        // AUX only reflects our last write once the bytes went through the
+        // UART and the module reacted. Until then, a high AUX is stale.
+        base::Time now = base::Time::now();
+        base::Time settled = m_last_module_write + getAUXReactionTime() +
+            getUARTTransferTime(m_link_configuration, m_module_buffer_usage);
+        if (m_module_buffer_usage && now >= settled && m_aux_monitor->isReady()) {
+            m_module_buffer_usage = 0;
+        }
+
+        int available = MODULE_BUFFER_SIZE - m_module_buffer_usage;
+        if (available >= bytes || now >= deadline) {
+            if (waited) {
+                m_flow_control_stats.busy_time += now - start;
+            }
+
+            int allowed = std::min(available, bytes);
+            if (allowed < min_bytes) {
+                allowed = 0;
+            }
+            if (allowed < requested) {
+                m_flow_control_stats.short_writes++;
+                m_flow_control_stats.refused_bytes += requested - allowed;
+            }
+            return allowed;
+        }
+
+        if (!waited) {
+            m_flow_control_stats.busy_waits++;
+            waited = true;
+        }
+        if (now < settled) {
+            base::Time wait = std::min(settled, deadline) - now;
+            std::this_thread::sleep_for(
+                std::chrono::microseconds(wait.toMicroseconds())
+            );
+        }
+        else {
+            m_aux_monitor->waitReady(deadline - now);
+        }
+    }
+}
+
+void Driver::commitModuleBuffer(int bytes) {
+    if (bytes > 0) {
+        m_statistics.recordTX(bytes, getAirtime(m_link_configuration, bytes));
+    }
+    m_flow_control_stats.tx_bytes += bytes;
+    if (m_aux_monitor && bytes > 0) {
+        m_module_buffer_usage += bytes;
+        m_last_module_write = base::Time::now();
+    }
 }
 
 int Driver::extractPacket(uint8_t const* buffer, size_t buffer_size) const {
-    throw std::logic_error("this drivers should only be used in raw mode");
+    if (m_packet_mode == PACKET_MODE_RAW) {
+        throw std::logic_error("this drivers should only be used in raw mode");
+    }
+    else if (m_packet_mode == PACKET_MODE_GAP) {
+        throw std::logic_error(
+            "readPacket cannot be used in PACKET_MODE_GAP, use readFrame"
+        );
+    }
+
+    if (buffer[0] != FRAME_SYNC) {
+        uint8_t const* sync = std::find(buffer + 1, buffer + buffer_size, FRAME_SYNC);
+        return -(sync - buffer);
+    }
+    else if (buffer_size < FRAME_HEADER_SIZE) {
+        return 0;
+    }
+
+    size_t frame_size = FRAME_HEADER_SIZE + buffer[1];
+    if (buffer[1] == 0) {
+        return -1;
+    }
+    else if (buffer_size < frame_size) {
+        return 0;
+    }
+    return frame_size;
+}
+
+int Driver::readFrame(uint8_t* buffer, int bufsize,
+                      base::Time const& first_byte_timeout) {
+    base::Time gap = getPacketGap(m_link_configuration);
+    base::Time packet_timeout =
+        first_byte_timeout + getAirtime(m_link_configuration, bufsize) + gap;
+    int size = iodrivers_base::Driver::readRaw(
+        buffer, bufsize, packet_timeout, first_byte_timeout, gap
+    );
+    if (size > 0) {
+        m_statistics.recordRX(0, true);
+    }
+    return size;
 }
 
 Version Driver::readVersion() {
+    ModeController::Transaction transaction = beginConfigurationTransaction();
     uint8_t cmd[3] = { 0xc3, 0xc3, 0xc3 };
+    base::Time start = base::Time::now();
     iodrivers_base::Driver::writePacket(cmd, 3);
+    capture(CaptureLog::RECORD_COMMAND, cmd, 3);
 
-    uint8_t reply[4];
-    int i = iodrivers_base::Driver::readRaw(
-        reply, 4,
-        base::Time::fromSeconds(1),
-        base::Time::fromSeconds(1),
-        base::Time::fromSeconds(1)
-    );
-    if (i != 4) {
+    uint8_t reply[VERSION_REPLY_SIZE];
+    int i = readReply(reply, VERSION_REPLY_SIZE, m_command_timeout);
+    if (i != VERSION_REPLY_SIZE) {
+        auto type = i == 0 ? iodrivers_base::TimeoutError::FIRST_BYTE
+                           : iodrivers_base::TimeoutError::PACKET;
+        m_statistics.recordTimeout(type);
         throw iodrivers_base::TimeoutError(
-            i == 0 ? iodrivers_base::TimeoutError::FIRST_BYTE
-                   : iodrivers_base::TimeoutError::PACKET,
-            "comms_lora_ebyte_e32::Driver::readVersion: did not receive reply"
+            type, "comms_lora_ebyte_e32::Driver::readVersion: did not receive reply"
         );
     }
 
+    Version version;
+    try {
+        version = decodeVersionReply(reply);
+    }
+    catch (std::runtime_error const&) {
+        m_statistics.recordMalformedReply();
+        throw;
+    }
+    m_statistics.recordCommandLatency(base::Time::now() - start);
+    return version;
+}
+
+Version Driver::decodeVersionReply(uint8_t const* reply) {
     if (reply[0] != 0xc3) {
         throw std::runtime_error(
             "unexpected first byte in reply to readVersion, expected " +
@@ -70,65 +365,47 @@ Version Driver::readVersion() {
     return version;
 }
 
-Configuration Driver::decodeConfiguration(uint8_t const* data) {
-    Configuration conf;
-    uint16_t address_msb = data[0];
-    uint16_t address_lsb = data[1];
-    uint8_t uart_parity_raw = (data[2] >> 6) & 0b11;
-    if (uart_parity_raw == 3) {
-        uart_parity_raw = 0;
-    }
-    uint8_t uart_rate_raw = (data[2] >> 3) & 0b111;
-    uint8_t air_rate_raw = (data[2] >> 0) & 0b111;
-    if (air_rate_raw > Configuration::AIR_RATE_19200) {
-        air_rate_raw = Configuration::AIR_RATE_19200;
-    }
-    uint8_t channel = data[3];
-    uint8_t transmission_mode_raw = (data[4] >> 7) & 0b1;
-    uint8_t io_drive_mode_raw = (data[4] >> 6) & 0b1;
-    uint8_t wireless_wakeup_time_raw = (data[4] >> 3) & 0b111;
-    uint8_t error_correction_enabled = (data[4] >> 2) & 0b1;
-    uint8_t transmission_power_raw = (data[4] >> 0) & 0b11;
-
-    conf.address = address_msb << 8 | address_lsb;
-    conf.uart_parity = static_cast<Configuration::UARTParity>(uart_parity_raw);
-    conf.uart_rate = static_cast<Configuration::UARTRate>(uart_rate_raw);
-    conf.air_rate = static_cast<Configuration::AirRate>(air_rate_raw);
-    conf.channel = channel;
-    conf.transparent_transmission = transmission_mode_raw == 0;
-    conf.io_drive_mode = io_drive_mode_raw ? Configuration::IO_PUSH_PULL :
-                                             Configuration::IO_OPEN_DRAIN;
-    conf.wireless_wake_up_time = wireless_wakeup_time_raw;
-    conf.error_correction_enabled = error_correction_enabled;
-    conf.transmission_power = static_cast<Configuration::TransmissionPower>(
-        transmission_power_raw
-    );
-
-    return conf;
-}
-
 Configuration Driver::readConfiguration() {
+    ModeController::Transaction transaction = beginConfigurationTransaction();
     uint8_t cmd[3] = { 0xc1, 0xc1, 0xc1 };
+    base::Time start = base::Time::now();
     iodrivers_base::Driver::writePacket(cmd, 3);
+    capture(CaptureLog::RECORD_COMMAND, cmd, 3);
 
-    static const int REPLY_SIZE = 6;
-    static const int EXPECTED_FIRST_BYTE = 0xc0;
-
-    uint8_t reply[REPLY_SIZE];
-    int i = iodrivers_base::Driver::readRaw(
-        reply, REPLY_SIZE,
-        base::Time::fromSeconds(1),
-        base::Time::fromSeconds(1),
-        base::Time::fromSeconds(1)
-    );
-    if (i != REPLY_SIZE) {
+    uint8_t reply[CONFIGURATION_REPLY_SIZE];
+    int i = readReply(reply, CONFIGURATION_REPLY_SIZE, m_command_timeout);
+    if (i != CONFIGURATION_REPLY_SIZE) {
+        auto type = i == 0 ? iodrivers_base::TimeoutError::FIRST_BYTE
+                           : iodrivers_base::TimeoutError::PACKET;
+        m_statistics.recordTimeout(type);
         throw iodrivers_base::TimeoutError(
-            i == 0 ? iodrivers_base::TimeoutError::FIRST_BYTE
-                   : iodrivers_base::TimeoutError::PACKET,
+            type,
             "comms_lora_ebyte_e32::Driver::readConfiguration: did not receive reply"
         );
     }
 
+    Configuration conf;
+    try {
+        conf = decodeConfigurationReply(reply);
+    }
+    catch (std::runtime_error const&) {
+        m_statistics.recordMalformedReply();
+        throw;
+    }
+    m_statistics.recordCommandLatency(base::Time::now() - start);
+    completeConfigurationRead(conf);
+    return conf;
+}
+
+void Driver::completeConfigurationRead(Configuration const& conf) {
+    setLinkConfiguration(conf);
+    m_cached_configuration = conf;
+    m_staged_configuration = conf;
+    m_has_cached_configuration = true;
+}
+
+Configuration Driver::decodeConfigurationReply(uint8_t const* reply) {
+    static const int EXPECTED_FIRST_BYTE = 0xc0;
     if (reply[0] != EXPECTED_FIRST_BYTE) {
         throw std::runtime_error(
             "unexpected first byte in data to readConfiguration, expected " +
@@ -140,23 +417,523 @@ Configuration Driver::readConfiguration() {
     return decodeConfiguration(reply + 1);
 }
 
-void Driver::encodeConfiguration(uint8_t* buffer, Configuration const& conf) {
-    buffer[0] = (conf.address >> 8) & 0xff;
-    buffer[1] = (conf.address >> 0) & 0xff;
-    buffer[2] = (conf.uart_parity << 6) |
-                (conf.uart_rate << 3) |
-                (conf.air_rate << 0);
-    buffer[3] = conf.channel;
-    buffer[4] = ((conf.transparent_transmission ? 0 : 1) << 7) |
-                ((conf.io_drive_mode == Configuration::IO_PUSH_PULL) << 6) |
-                (conf.wireless_wake_up_time << 3) |
-                ((conf.error_correction_enabled ? 1 : 0) << 2) |
-                (conf.transmission_power << 0);
+void Driver::encodeConfigurationCommand(uint8_t* buffer,
+                                        Configuration const& conf, bool save) {
+    buffer[0] = save ? 0xc0 : 0xc2;
+    encodeConfiguration(buffer + 1, conf);
 }
 
 void Driver::writeConfiguration(Configuration const& conf, bool save) {
-    uint8_t buffer[6];
-    buffer[0] = save ? 0xc0 : 0xc2;
-    encodeConfiguration(buffer + 1, conf);
-    iodrivers_base::Driver::writePacket(buffer, 6);
+    ModeController::Transaction transaction = beginConfigurationTransaction();
+    uint8_t buffer[CONFIGURATION_COMMAND_SIZE];
+    encodeConfigurationCommand(buffer, conf, save);
+    iodrivers_base::Driver::writePacket(buffer, CONFIGURATION_COMMAND_SIZE);
+    capture(CaptureLog::RECORD_COMMAND, buffer, CONFIGURATION_COMMAND_SIZE);
+    completeConfigurationWrite(conf, save);
+}
+
+void Driver::completeConfigurationWrite(Configuration const& conf, bool save) {
+    // The link configuration always holds the rate the host UART is at,
+    // while the configuration cache may be empty
+    bool rate_changed = m_link_configuration.uart_rate != conf.uart_rate;
+    int fd = getFileDescriptor();
+    if (rate_changed && fd != INVALID_FD) {
+        // The command must leave at the old rate before the switch
+        ::tcdrain(fd);
+        std::this_thread::sleep_for(std::chrono::microseconds(
+            UART_RATE_SWITCH_DELAY.toMicroseconds()
+        ));
+        setHostUARTRate(conf.uart_rate);
+        cacheUARTRate(conf.uart_rate);
+    }
+    if (m_mode_controller && fd != INVALID_FD) {
+        // The module does not accept commands while it applies the
+        // configuration
+        ::tcdrain(fd);
+        std::this_thread::sleep_for(std::chrono::microseconds(
+            getAUXReactionTime().toMicroseconds()
+        ));
+        m_mode_controller->waitReady();
+    }
+    completeConfigurationRead(conf);
+
+    m_unsaved_changes = !save;
+    // The module is configured at this point. Updating the cache is
+    // best-effort, and a file that cannot be written must not fail the call
+    if (m_saved_configuration_cache && !m_uri.empty()) {
+        std::string device = UARTRateCache::getDeviceKey(m_uri);
+        if (save) {
+            m_saved_configuration_cache->set(device, conf);
+        }
+        else {
+            m_saved_configuration_cache->remove(device);
+        }
+    }
+}
+
+bool Driver::saveConfiguration(Configuration const& conf) {
+    base::Time read_time = getUARTTransferTime(
+        m_link_configuration, 3 + CONFIGURATION_REPLY_SIZE
+    );
+    base::Time write_time = getUARTTransferTime(
+        m_link_configuration, CONFIGURATION_COMMAND_SIZE
+    );
+
+    // A configuration read since the driver was opened is more reliable than
+    // the cache
+    bool read_matches = !m_has_cached_configuration ||
+                        !m_cached_configuration.differences(conf);
+    if (m_saved_configuration_cache && !m_uri.empty() && !m_unsaved_changes &&
+        read_matches &&
+        m_saved_configuration_cache->isSaved(UARTRateCache::getDeviceKey(m_uri),
+                                             conf)) {
+        if (!m_has_cached_configuration) {
+            m_save_stats.skipped_reads++;
+            m_save_stats.avoided_time = m_save_stats.avoided_time + read_time;
+        }
+        m_save_stats.skipped_saves++;
+        m_save_stats.avoided_time = m_save_stats.avoided_time + write_time;
+
+        setLinkConfiguration(conf);
+        m_cached_configuration = conf;
+        m_staged_configuration = conf;
+        m_has_cached_configuration = true;
+        return false;
+    }
+
+    // Read and write during a single stay in sleep mode
+    ModeController::Transaction transaction = beginConfigurationTransaction();
+    if (!m_unsaved_changes && !getConfiguration().differences(conf)) {
+        m_save_stats.skipped_saves++;
+        m_save_stats.avoided_time = m_save_stats.avoided_time + write_time;
+        if (m_saved_configuration_cache && !m_uri.empty()) {
+            m_saved_configuration_cache->set(
+                UARTRateCache::getDeviceKey(m_uri), conf
+            );
+        }
+        return false;
+    }
+
+    writeConfiguration(conf, true);
+    m_save_stats.saves++;
+    return true;
+}
+
+ConfigurationSaveStatistics Driver::getConfigurationSaveStatistics() const {
+    return m_save_stats;
+}
+
+void Driver::openURI(std::string const& uri) {
+    invalidateConfigurationCache();
+    m_unsaved_changes = false;
+    iodrivers_base::Driver::openURI(uri);
+    m_uri = uri;
+}
+
+void Driver::setUARTRateCache(UARTRateCache* cache) {
+    m_uart_rate_cache = cache;
+}
+
+UARTRateCache* Driver::getUARTRateCache() const {
+    return m_uart_rate_cache;
+}
+
+void Driver::setSavedConfigurationCache(SavedConfigurationCache* cache) {
+    m_saved_configuration_cache = cache;
+}
+
+SavedConfigurationCache* Driver::getSavedConfigurationCache() const {
+    return m_saved_configuration_cache;
+}
+
+void Driver::setModeController(ModeController* controller) {
+    m_mode_controller = controller;
+}
+
+ModeController* Driver::getModeController() const {
+    return m_mode_controller;
+}
+
+ModeController::Transaction Driver::beginConfigurationTransaction() {
+    return ModeController::Transaction(m_mode_controller,
+                                       ModeController::MODE_SLEEP);
+}
+
+void Driver::setProbeTimeout(base::Time const& timeout) {
+    m_probe_timeout = timeout;
+}
+
+base::Time Driver::getProbeTimeout() const {
+    return m_probe_timeout;
+}
+
+void Driver::setHostUARTRate(Configuration::UARTRate rate) {
+    int baudrate = getUARTBaudrate(rate);
+    if (!setSerialBaudrate(baudrate)) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::Driver::setHostUARTRate: failed to set the "
+            "serial line to " + std::to_string(baudrate) + " bauds"
+        );
+    }
+}
+
+void Driver::cacheUARTRate(Configuration::UARTRate rate) {
+    // Best-effort, the rate is in use whether or not the cache file could
+    // be updated
+    if (m_uart_rate_cache && !m_uri.empty()) {
+        m_uart_rate_cache->set(UARTRateCache::getDeviceKey(m_uri), rate);
+    }
+}
+
+bool Driver::probeUARTRate(Configuration::UARTRate rate) {
+    setHostUARTRate(rate);
+    clear();
+
+    uint8_t cmd[3] = { 0xc1, 0xc1, 0xc1 };
+    iodrivers_base::Driver::writePacket(cmd, 3);
+    capture(CaptureLog::RECORD_COMMAND, cmd, 3);
+
+    Configuration probe_conf;
+    probe_conf.uart_rate = rate;
+    base::Time timeout = m_probe_timeout +
+        getUARTTransferTime(probe_conf, 3 + CONFIGURATION_REPLY_SIZE);
+    uint8_t reply[CONFIGURATION_REPLY_SIZE];
+    int size = readReply(reply, CONFIGURATION_REPLY_SIZE, timeout);
+    if (size != CONFIGURATION_REPLY_SIZE || reply[0] != 0xc0) {
+        return false;
+    }
+
+    // Garbage received at the wrong rate may start with 0xc0 by chance. The
+    // module's own rate must match the one we are probing.
+    Configuration conf = decodeConfiguration(reply + 1);
+    if (conf.uart_rate != rate) {
+        return false;
+    }
+
+    setLinkConfiguration(conf);
+    m_cached_configuration = conf;
+    m_staged_configuration = conf;
+    m_has_cached_configuration = true;
+    return true;
+}
+
+Configuration::UARTRate Driver::negotiateUARTRate() {
+    ModeController::Transaction transaction = beginConfigurationTransaction();
+    std::vector<Configuration::UARTRate> candidates;
+    Configuration::UARTRate cached;
+    if (m_uart_rate_cache && !m_uri.empty() &&
+        m_uart_rate_cache->get(UARTRateCache::getDeviceKey(m_uri), cached)) {
+        candidates.push_back(cached);
+    }
+    candidates.push_back(m_link_configuration.uart_rate);
+    candidates.push_back(Configuration::RATE_9600);
+    for (int i = Configuration::RATE_115200; i >= Configuration::RATE_1200; --i) {
+        candidates.push_back(static_cast<Configuration::UARTRate>(i));
+    }
+
+    std::vector<Configuration::UARTRate> tried;
+    for (auto rate : candidates) {
+        if (std::find(tried.begin(), tried.end(), rate) != tried.end()) {
+            continue;
+        }
+        tried.push_back(rate);
+
+        if (probeUARTRate(rate)) {
+            cacheUARTRate(rate);
+            return rate;
+        }
+    }
+
+    m_statistics.recordTimeout(iodrivers_base::TimeoutError::FIRST_BYTE);
+    throw iodrivers_base::TimeoutError(
+        iodrivers_base::TimeoutError::FIRST_BYTE,
+        "comms_lora_ebyte_e32::Driver::negotiateUARTRate: the module did not "
+        "reply at any UART rate"
+    );
+}
+
+void Driver::switchUARTRate(Configuration::UARTRate rate, bool save) {
+    ModeController::Transaction transaction = beginConfigurationTransaction();
+    Configuration conf = getConfiguration();
+    conf.uart_rate = rate;
+    writeConfiguration(conf, save);
+    readConfiguration();
+}
+
+void Driver::close() {
+    invalidateConfigurationCache();
+    iodrivers_base::Driver::close();
+}
+
+Configuration const& Driver::getConfiguration() {
+    if (!m_has_cached_configuration) {
+        readConfiguration();
+    }
+    return m_cached_configuration;
+}
+
+bool Driver::hasCachedConfiguration() const {
+    return m_has_cached_configuration;
+}
+
+void Driver::invalidateConfigurationCache() {
+    m_has_cached_configuration = false;
+}
+
+void Driver::stageConfiguration(Configuration const& conf) {
+    getConfiguration();
+    m_staged_configuration = conf;
+}
+
+Configuration const& Driver::getStagedConfiguration() {
+    getConfiguration();
+    return m_staged_configuration;
+}
+
+int Driver::getDirtyFields() {
+    return getConfiguration().differences(m_staged_configuration);
+}
+
+bool Driver::commitConfiguration(bool save) {
+    if (save) {
+        return saveConfiguration(m_staged_configuration);
+    }
+    else if (!getDirtyFields()) {
+        return false;
+    }
+
+    writeConfiguration(m_staged_configuration, false);
+    return true;
+}
+
+int Driver::writeRaw(uint16_t target, uint8_t channel,
+                     uint8_t* buffer, int bufsize) {
+    return writeRaw(target, channel, buffer, bufsize, getWriteTimeout());
+}
+
+int Driver::writeRaw(uint16_t target, uint8_t channel,
+                     uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    return writeRaw(target, channel, buffer, bufsize, timeout, timeout);
+}
+
+int Driver::writeRaw(uint16_t target, uint8_t channel, uint8_t* buffer, int bufsize,
+                     base::Time const& packet_timeout,
+                     base::Time const& first_byte_timeout,
+                     base::Time const& inter_byte_timeout) {
+    uint8_t header[FIXED_TRANSMISSION_HEADER_SIZE] = {
+        static_cast<uint8_t>((target >> 8) & 0xff),
+        static_cast<uint8_t>((target >> 0) & 0xff),
+        channel
+    };
+
+    int allowed = reserveModuleBuffer(
+        FIXED_TRANSMISSION_HEADER_SIZE + bufsize,
+        FIXED_TRANSMISSION_HEADER_SIZE + std::min(bufsize, 1), packet_timeout
+    );
+    if (allowed == 0) {
+        return 0;
+    }
+
+    iovec iov[2] = {
+        { header, FIXED_TRANSMISSION_HEADER_SIZE },
+        { buffer, static_cast<size_t>(allowed - FIXED_TRANSMISSION_HEADER_SIZE) }
+    };
+    int written = writeVector(iov, 2, packet_timeout,
+                              first_byte_timeout, inter_byte_timeout);
+    commitModuleBuffer(written);
+    commitFixedTransmission(written);
+    return std::max(0, written - FIXED_TRANSMISSION_HEADER_SIZE);
+}
+
+int Driver::writeRaw(uint8_t const* buffer, int bufsize,
+                     base::Time const& timeout) {
+    int allowed = reserveModuleBuffer(bufsize, std::min(bufsize, 1), timeout);
+    if (allowed == 0) {
+        return 0;
+    }
+
+    iovec iov = { const_cast<uint8_t*>(buffer), static_cast<size_t>(allowed) };
+    int written = writeVector(&iov, 1, timeout, timeout, base::Time());
+    commitModuleBuffer(written);
+    if (written > 0) {
+        // The bytes may continue a fixed transmission frame, the next frame
+        // must leave the UART idle after them as well
+        m_fixed_transmission_end =
+            base::Time::now() + getUARTTransferTime(m_link_configuration, written);
+    }
+    return written;
+}
+
+int Driver::writeFrame(uint8_t const* buffer, int bufsize) {
+    if (bufsize <= 0 || bufsize > MAX_FRAME_PAYLOAD_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::Driver::writeFrame: payload size must be "
+            "between 1 and " + std::to_string(MAX_FRAME_PAYLOAD_SIZE)
+        );
+    }
+
+    uint8_t header[FRAME_HEADER_SIZE] = {
+        FRAME_SYNC, static_cast<uint8_t>(bufsize)
+    };
+    base::Time timeout = getWriteTimeout();
+    int size = FRAME_HEADER_SIZE + bufsize;
+    if (reserveModuleBuffer(size, size, timeout) == 0) {
+        return 0;
+    }
+
+    iovec iov[2] = {
+        { header, FRAME_HEADER_SIZE },
+        { const_cast<uint8_t*>(buffer), static_cast<size_t>(bufsize) }
+    };
+    int written = writeVector(iov, 2, timeout, timeout, base::Time());
+    commitModuleBuffer(written);
+    return std::max(0, written - FRAME_HEADER_SIZE);
+}
+
+int Driver::writeFrame(uint16_t target, uint8_t channel,
+                       uint8_t const* buffer, int bufsize) {
+    if (bufsize <= 0 || bufsize > MAX_FRAME_PAYLOAD_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::Driver::writeFrame: payload size must be "
+            "between 1 and " + std::to_string(MAX_FRAME_PAYLOAD_SIZE)
+        );
+    }
+
+    uint8_t header[FIXED_TRANSMISSION_HEADER_SIZE + FRAME_HEADER_SIZE] = {
+        static_cast<uint8_t>((target >> 8) & 0xff),
+        static_cast<uint8_t>((target >> 0) & 0xff),
+        channel,
+        FRAME_SYNC,
+        static_cast<uint8_t>(bufsize)
+    };
+    base::Time timeout = getWriteTimeout();
+    int size = sizeof(header) + bufsize;
+    if (reserveModuleBuffer(size, size, timeout) == 0) {
+        return 0;
+    }
+
+    iovec iov[2] = {
+        { header, sizeof(header) },
+        { const_cast<uint8_t*>(buffer), static_cast<size_t>(bufsize) }
+    };
+    int written = writeVector(iov, 2, timeout, timeout, base::Time());
+    commitModuleBuffer(written);
+    commitFixedTransmission(written);
+    return std::max(0, written - static_cast<int>(sizeof(header)));
+}
+
+void Driver::setFixedTransmissionGap(base::Time const& gap) {
+    m_fixed_transmission_gap = gap;
+}
+
+base::Time Driver::getFixedTransmissionGap() const {
+    if (m_fixed_transmission_gap.isNull()) {
+        return getUARTTransferTime(m_link_configuration, PACKET_END_BYTES);
+    }
+    return m_fixed_transmission_gap;
+}
+
+base::Time Driver::getFixedTransmissionReadyTime() const {
+    base::Time gap = getFixedTransmissionGap();
+    if (m_fixed_header_interrupted) {
+        // The module must end the packet that holds the truncated header,
+        // or it would read it along with the next header as one address
+        gap = std::max(gap, getUARTTransferTime(m_link_configuration,
+                                                PACKET_END_BYTES));
+    }
+    return m_fixed_transmission_end + gap;
+}
+
+void Driver::waitFixedTransmissionGap() {
+    base::Time idle_end = getFixedTransmissionReadyTime();
+    base::Time now = base::Time::now();
+    if (idle_end > now) {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds((idle_end - now).toMicroseconds())
+        );
+    }
+}
+
+void Driver::commitFixedTransmission(int bytes) {
+    if (bytes > 0) {
+        m_fixed_transmission_end =
+            base::Time::now() + getUARTTransferTime(m_link_configuration, bytes);
+        m_fixed_header_interrupted = bytes < FIXED_TRANSMISSION_HEADER_SIZE;
+    }
+}
+
+int Driver::writeVector(iovec* iov, int iovcnt,
+                        base::Time const& packet_timeout,
+                        base::Time const& first_byte_timeout,
+                        base::Time const& inter_byte_timeout) {
+    int fd = getFileDescriptor();
+    if (fd == INVALID_FD) {
+        // Streams that are not backed by a file descriptor (e.g. test://)
+        // cannot do scatter/gather I/O. Write the parts in sequence
+        // instead, which still avoids the staging copy
+        int total = 0;
+        for (int i = 0; i < iovcnt; ++i) {
+            iodrivers_base::Driver::writePacket(
+                static_cast<uint8_t const*>(iov[i].iov_base), iov[i].iov_len
+            );
+            capture(CaptureLog::RECORD_TX,
+                    static_cast<uint8_t const*>(iov[i].iov_base), iov[i].iov_len);
+            total += iov[i].iov_len;
+        }
+        return total;
+    }
+
+    int total = 0;
+    base::Time start = base::Time::now();
+    base::Time last_progress = start;
+    while (iovcnt > 0) {
+        ssize_t ret = ::writev(fd, iov, iovcnt);
+        if (ret > 0) {
+            total += ret;
+            last_progress = base::Time::now();
+
+            // Skip what has been written, without touching the data itself
+            size_t remaining = ret;
+            while (iovcnt > 0 && remaining >= iov->iov_len) {
+                capture(CaptureLog::RECORD_TX,
+                        static_cast<uint8_t const*>(iov->iov_base), iov->iov_len);
+                remaining -= iov->iov_len;
+                ++iov;
+                --iovcnt;
+            }
+            if (iovcnt > 0) {
+                capture(CaptureLog::RECORD_TX,
+                        static_cast<uint8_t const*>(iov->iov_base), remaining);
+                iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + remaining;
+                iov->iov_len -= remaining;
+            }
+            continue;
+        }
+        else if (ret < 0 && errno != EAGAIN && errno != EINTR) {
+            throw iodrivers_base::UnixError(
+                "comms_lora_ebyte_e32::Driver::writeRaw: write failed"
+            );
+        }
+
+        base::Time now = base::Time::now();
+        base::Time deadline = start + packet_timeout;
+        if (total == 0) {
+            deadline = std::min(deadline, start + first_byte_timeout);
+        }
+        else if (!inter_byte_timeout.isNull()) {
+            deadline = std::min(deadline, last_progress + inter_byte_timeout);
+        }
+        if (now >= deadline) {
+            break;
+        }
+
+        pollfd pfd = { fd, POLLOUT, 0 };
+        int timeout_ms = (deadline - now).toMilliseconds() + 1;
+        if (::poll(&pfd, 1, timeout_ms) < 0 && errno != EINTR) {
+            throw iodrivers_base::UnixError(
+                "comms_lora_ebyte_e32::Driver::writeRaw: poll failed"
+            );
+        }
+    }
+    return total;
 }
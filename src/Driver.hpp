@@ -2,76 +2,669 @@
 #define COMMS_LORA_EBYTE_E32_DRIVER_HPP
 
 #include <iodrivers_base/Driver.hpp>
+#include <iodrivers_base/IOListener.hpp>
+#include <sys/uio.h>
+#include <comms_lora_ebyte_e32/AUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/CaptureLog.hpp>
 #include <comms_lora_ebyte_e32/Configuration.hpp>
+#include <comms_lora_ebyte_e32/ConfigurationCodec.hpp>
+#include <comms_lora_ebyte_e32/ConfigurationSaveStatistics.hpp>
+#include <comms_lora_ebyte_e32/DriverStatisticsRecorder.hpp>
+#include <comms_lora_ebyte_e32/FlowControlStatistics.hpp>
+#include <comms_lora_ebyte_e32/ModeController.hpp>
+#include <comms_lora_ebyte_e32/SavedConfigurationCache.hpp>
+#include <comms_lora_ebyte_e32/UARTRateCache.hpp>
 #include <comms_lora_ebyte_e32/Version.hpp>
+#include <vector>
 
 namespace comms_lora_ebyte_e32 {
     /**
      * Driver for the EByte E32 module
      *
-     * This driver does not deal with mode switching. Relevant methods must be
-     * called while the module is already in the right mode
+     * Without a mode controller, this driver does not deal with mode
+     * switching, and the relevant methods must be called while the module is
+     * already in the right mode. With one (see setModeController), the
+     * configuration methods switch the module to sleep mode themselves.
      *
-     * Reading should be done with readRaw() with appropriate timeouts. The driver
-     * provides \c writeRaw to send data to a particular target & channel
+     * Reading should be done with readRaw() with appropriate timeouts, or with
+     * the packet-oriented methods (see PacketMode). The driver provides \c
+     * writeRaw to send data to a particular target & channel
      */
     class Driver : public iodrivers_base::Driver {
+    public:
+        /** How received bytes are split into packets */
+        enum PacketMode {
+            /** No packet extraction, only readRaw() may be used */
+            PACKET_MODE_RAW,
+            /** Packets are delimited by the inter-byte gap between two
+             * over-the-air packets, use readFrame()
+             */
+            PACKET_MODE_GAP,
+            /** Packets are framed by the application with a sync byte and a
+             * length (see writeFrame), readPacket() may be used
+             *
+             * The frame has no checksum. The module only hands over
+             * sub-packets that passed its own CRC, but a lost sub-packet or
+             * a payload byte equal to FRAME_SYNC may still make the driver
+             * return a frame that mixes the bytes of two. Applications that
+             * need integrity must check it themselves, as FECLink does with
+             * a CRC in each frame
+             */
+            PACKET_MODE_LENGTH_PREFIXED
+        };
+
+        /** Sync byte starting each frame in PACKET_MODE_LENGTH_PREFIXED */
+        static const uint8_t FRAME_SYNC = 0xa5;
+
+        /** Size of the sync byte and length in PACKET_MODE_LENGTH_PREFIXED */
+        static const int FRAME_HEADER_SIZE = 2;
+
+        /** Maximum payload size in PACKET_MODE_LENGTH_PREFIXED */
+        static const int MAX_FRAME_PAYLOAD_SIZE = 255;
+
+        /** Size of the driver's internal buffer */
+        static const int MAX_PACKET_SIZE = 512;
+
+        /** Size of the module's reply to the version command */
+        static const int VERSION_REPLY_SIZE = 4;
+
+        /** Size of the module's reply to the configuration read command */
+        static const int CONFIGURATION_REPLY_SIZE = 6;
+
+        /** Size of the configuration write command */
+        static const int CONFIGURATION_COMMAND_SIZE =
+            comms_lora_ebyte_e32::CONFIGURATION_COMMAND_SIZE;
+
+    private:
+        base::Time m_command_timeout = base::Time::fromSeconds(1);
+
+        bool m_has_cached_configuration = false;
+        Configuration m_cached_configuration;
+        Configuration m_staged_configuration;
+        PacketMode m_packet_mode = PACKET_MODE_RAW;
+        Configuration m_link_configuration;
+
+        AUXMonitor* m_aux_monitor = nullptr;
+        /** Bytes written to the module since AUX was last seen high */
+        int m_module_buffer_usage = 0;
+        base::Time m_last_module_write;
+        FlowControlStatistics m_flow_control_stats;
+
+        /** Time at which the last fixed transmission frame is out of the UART */
+        base::Time m_fixed_transmission_end;
+        /** Null to use the transfer time of 3 bytes */
+        base::Time m_fixed_transmission_gap;
+        /** Whether the last fixed transmission frame stopped within its
+         * address/channel header
+         */
+        bool m_fixed_header_interrupted = false;
+
+        std::string m_uri;
+        UARTRateCache* m_uart_rate_cache = nullptr;
+        base::Time m_probe_timeout = base::Time::fromMilliseconds(50);
+
+        ModeController* m_mode_controller = nullptr;
+
+        SavedConfigurationCache* m_saved_configuration_cache = nullptr;
+        /** Whether a configuration was written without being saved since
+         * the driver was opened
+         */
+        bool m_unsaved_changes = false;
+        ConfigurationSaveStatistics m_save_stats;
+
+        DriverStatisticsRecorder m_statistics;
+
+        CaptureLog* m_capture_log = nullptr;
+
+        /** Passes the bytes iodrivers_base reads from the I/O to
+         * Driver::received
+         *
+         * It is the single point where all received bytes go through,
+         * whichever read method got them, including the ones the packet
+         * extraction skips while resynchronizing
+         */
+        class RXListener : public iodrivers_base::IOListener {
+            Driver& m_driver;
+
+        public:
+            explicit RXListener(Driver& driver);
+            void writeData(uint8_t const* data, size_t size);
+            void readData(uint8_t const* data, size_t size);
+        };
+        RXListener m_rx_listener;
+        /** How received bytes are recorded in the capture log */
+        CaptureLog::RecordType m_rx_record_type = CaptureLog::RECORD_RX;
+
+        /** Record traffic in the capture log, if there is one */
+        void capture(CaptureLog::RecordType type,
+                     uint8_t const* data, int size) const;
+
+        /** Record bytes read from the I/O in the capture log and the
+         * statistics
+         */
+        void received(uint8_t const* data, int size);
+
+        /** Read the reply to a command, recording it as such in the capture
+         * log
+         */
+        int readReply(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
         int extractPacket(uint8_t const* buffer, size_t buffer_size) const;
+
+        /** Wait for room in the module's buffer
+         *
+         * @arg bytes the number of bytes that will be written
+         * @arg min_bytes the minimum useful write size
+         * @return how many bytes can be written. It is either between
+         *   min_bytes and bytes, or zero if the module's buffer did not free
+         *   up before the timeout. Requests larger than the module's buffer
+         *   are reduced to MODULE_BUFFER_SIZE
+         */
+        int reserveModuleBuffer(int bytes, int min_bytes,
+                                base::Time const& timeout);
+
+        /** Account for bytes written to the module's buffer */
+        void commitModuleBuffer(int bytes);
+
+        /** Record the end of a fixed transmission frame */
+        void commitFixedTransmission(int bytes);
+
+        /** Write a set of buffers in one scatter/gather operation
+         *
+         * @return the total number of bytes written
+         * @see writeRaw for the meaning of the timeouts
+         */
+        int writeVector(iovec* iov, int iovcnt,
+                        base::Time const& packet_timeout,
+                        base::Time const& first_byte_timeout,
+                        base::Time const& inter_byte_timeout);
+
+        /** Switch the host UART and read the configuration at the given rate
+         *
+         * @return true if the module replied with a valid configuration
+         */
+        bool probeUARTRate(Configuration::UARTRate rate);
+
+        /** Update the UART rate cache entry of the current device */
+        void cacheUARTRate(Configuration::UARTRate rate);
+
     public:
         Driver();
+        ~Driver();
+
+        /** Set how long readVersion() and readConfiguration() wait for the
+         * module's reply
+         *
+         * It defaults to 1s
+         */
+        void setCommandTimeout(base::Time const& timeout);
+
+        /** How long the command methods wait for the module's reply */
+        base::Time getCommandTimeout() const;
+
+        /** Select how readPacket() splits the received bytes */
+        void setPacketMode(PacketMode mode);
+
+        /** The current packet mode */
+        PacketMode getPacketMode() const;
+
+        /** Set the configuration used to compute link timings
+         *
+         * It is updated by readConfiguration() and writeConfiguration(). Use
+         * this method to provide it when these are not called.
+         */
+        void setLinkConfiguration(Configuration const& conf);
+
+        /** The configuration used to compute link timings */
+        Configuration const& getLinkConfiguration() const;
+
+        /** Enable transmit flow control based on the module's AUX line
+         *
+         * When set, the write methods track how much data is in the module's
+         * 512-byte buffer, and block until AUX reports that the buffer
+         * drained when it would overflow. When the timeout is reached,
+         * writeRaw() writes a shorter frame and writeFrame() writes nothing.
+         *
+         * The monitor is not owned by the driver, and must remain valid until
+         * it is removed by calling this method with nullptr.
+         */
+        void setAUXMonitor(AUXMonitor* monitor);
+
+        /** The AUX monitor, or nullptr if flow control is disabled */
+        AUXMonitor* getAUXMonitor() const;
+
+        /** Set how long the UART stays idle between two frames in fixed
+         * transmission mode
+         *
+         * The module takes the first bytes after an idle UART as the target
+         * address and channel of a transmission. Frames written back-to-back
+         * would be merged, and all sent to the first target.
+         *
+         * The write methods do not wait for the gap themselves, so that they
+         * never sleep. Code that writes several fixed transmission frames in
+         * a row paces them with getFixedTransmissionReadyTime() or
+         * waitFixedTransmissionGap(), as CoalescingWriter and
+         * TransmitScheduler do.
+         *
+         * It defaults to the transfer time of 3 bytes at the UART rate of the
+         * link configuration
+         */
+        void setFixedTransmissionGap(base::Time const& gap);
+
+        /** The UART idle time between two frames in fixed transmission mode */
+        base::Time getFixedTransmissionGap() const;
+
+        /** Earliest time at which the next fixed transmission frame can be
+         * written without being merged with the previous one
+         *
+         * It is the time at which the last frame is out of the UART, plus the
+         * gap. After a frame that stopped within its header, the gap is at
+         * least long enough for the module to drop the truncated header
+         */
+        base::Time getFixedTransmissionReadyTime() const;
+
+        /** Sleep until getFixedTransmissionReadyTime() */
+        void waitFixedTransmissionGap();
+
+        /** Counters of the AUX-based flow control */
+        FlowControlStatistics getFlowControlStatistics() const;
+
+        /** Snapshot of the link statistics
+         *
+         * It is safe to call it from a different thread than the one using
+         * the driver
+         */
+        DriverStatistics getStatistics() const;
+
+        /** Reset the link statistics */
+        void resetStatistics();
+
+        /** Access to the link statistics recorder
+         *
+         * It is meant to let classes that drive the module on the driver's
+         * behalf, such as AsyncDriver, update the statistics
+         */
+        DriverStatisticsRecorder& getStatisticsRecorder();
+
+        /** @overload
+         *
+         * Reads with the driver's read timeout, and counts the received
+         * frame in the link statistics
+         */
+        int readPacket(uint8_t* buffer, int bufsize);
+
+        /** @overload
+         *
+         * Counts the received frame in the link statistics
+         */
+        int readPacket(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
+        /** Read one length-prefixed frame (see PACKET_MODE_LENGTH_PREFIXED)
+         *
+         * It behaves as iodrivers_base::Driver::readPacket, and additionally
+         * counts the received frame in the link statistics
+         *
+         * @throw iodrivers_base::TimeoutError if no whole frame was received
+         *   within the timeouts
+         */
+        int readPacket(uint8_t* buffer, int bufsize,
+                       base::Time const& packet_timeout,
+                       base::Time const& first_byte_timeout);
+
+        /** Read one length-prefixed frame if the bytes already received make
+         * one, without waiting
+         *
+         * Unlike readPacket(), it returns zero when no frame is available,
+         * which makes it suitable to drain the driver from a poll loop. When
+         * the I/O has no new bytes, it returns without going through
+         * iodrivers_base's timeout exception at all
+         *
+         * @return the frame size, or zero if there is no whole frame yet
+         */
+        int tryReadPacket(uint8_t* buffer, int bufsize);
+
+        /** Read one over-the-air packet
+         *
+         * The end of the packet is detected by waiting for the gap between
+         * two over-the-air packets, computed from the link configuration's
+         * air and UART rates (see getPacketGap)
+         *
+         * @arg first_byte_timeout how long to wait for the packet to start
+         * @return the packet size, or zero if nothing was received
+         */
+        int readFrame(uint8_t* buffer, int bufsize,
+                      base::Time const& first_byte_timeout);
 
         /** Decode the configuration raw representation
          *
          * @param buffer the configuration part of the buffer, without the first
          *    byte of the board's reply. It is expected to be 5 bytes long.
+         *
+         * @see comms_lora_ebyte_e32::decodeConfiguration
          */
-        static Configuration decodeConfiguration(uint8_t const* buffer);
+        static constexpr Configuration decodeConfiguration(
+            uint8_t const* buffer
+        ) noexcept {
+            return comms_lora_ebyte_e32::decodeConfiguration(buffer);
+        }
 
         /** Decode the configuration raw representation
          *
          * @param buffer the configuration part of the buffer, without the first
          *    byte of the board's reply. 5 bytes will be written to it.
+         *
+         * @see comms_lora_ebyte_e32::encodeConfiguration
+         */
+        static constexpr void encodeConfiguration(
+            uint8_t* buffer, Configuration const& conf
+        ) noexcept {
+            comms_lora_ebyte_e32::encodeConfiguration(buffer, conf);
+        }
+
+        /** Decode the module's reply to the version command
+         *
+         * @param buffer the reply, VERSION_REPLY_SIZE bytes long
          */
-        static void encodeConfiguration(uint8_t* buffer, Configuration const& conf);
+        static Version decodeVersionReply(uint8_t const* buffer);
 
-        /** Read the configuration from the board */
+        /** Decode the module's reply to the configuration read command
+         *
+         * @param buffer the reply, CONFIGURATION_REPLY_SIZE bytes long
+         */
+        static Configuration decodeConfigurationReply(uint8_t const* buffer);
+
+        /** Encode the configuration write command
+         *
+         * @param buffer the command buffer. CONFIGURATION_COMMAND_SIZE bytes
+         *   will be written to it
+         * @param save whether the configuration should be saved in the
+         *   module's non-volatile memory
+         */
+        static void encodeConfigurationCommand(uint8_t* buffer,
+                                               Configuration const& conf,
+                                               bool save);
+
+        /** Open the driver
+         *
+         * It invalidates the configuration cache
+         */
+        void openURI(std::string const& uri);
+
+        /** Set the cache used by negotiateUARTRate
+         *
+         * The cache is not owned by the driver, and must remain valid until
+         * it is removed by calling this method with nullptr. Entries are
+         * keyed by the URI given to openURI (see UARTRateCache::getDeviceKey)
+         */
+        void setUARTRateCache(UARTRateCache* cache);
+
+        /** The UART rate cache, or nullptr if there is none */
+        UARTRateCache* getUARTRateCache() const;
+
+        /** Set the cache used by saveConfiguration
+         *
+         * The cache is not owned by the driver, and must remain valid until
+         * it is removed by calling this method with nullptr. Entries are
+         * keyed like the ones of the UART rate cache.
+         */
+        void setSavedConfigurationCache(SavedConfigurationCache* cache);
+
+        /** The saved configuration cache, or nullptr if there is none */
+        SavedConfigurationCache* getSavedConfigurationCache() const;
+
+        /** Set the controller used to switch the module to sleep mode
+         *
+         * When set, readVersion, readConfiguration, writeConfiguration,
+         * negotiateUARTRate and the methods built on them switch the module
+         * to sleep mode and back to the previous mode around their commands.
+         * Use beginConfigurationTransaction to run several of them during a
+         * single stay in sleep mode. writeConfiguration also waits for the
+         * module to have applied the new configuration (see
+         * ModeController::waitReady).
+         *
+         * The controller is not owned by the driver, and must remain valid
+         * until it is removed by calling this method with nullptr.
+         */
+        void setModeController(ModeController* controller);
+
+        /** The mode controller, or nullptr if there is none */
+        ModeController* getModeController() const;
+
+        /** Keep the module in sleep mode until the returned transaction is
+         * destroyed
+         *
+         * It does nothing if there is no mode controller
+         *
+         * @throw iodrivers_base::TimeoutError if the mode switch failed
+         */
+        ModeController::Transaction beginConfigurationTransaction();
+
+        /** Record the traffic with the module in a capture log
+         *
+         * Each chunk of bytes written or read through the driver's own
+         * methods is recorded as it goes through the I/O, with the
+         * configuration commands and their replies told apart from data.
+         * The bytes readPacket() skips to find a frame are recorded as well,
+         * so that a replay reproduces the stream the driver actually read.
+         *
+         * The log is not owned by the driver, and must remain valid until it
+         * is removed by calling this method with nullptr.
+         */
+        void setCaptureLog(CaptureLog* log);
+
+        /** The capture log, or nullptr if traffic is not captured */
+        CaptureLog* getCaptureLog() const;
+
+        /** Set how long negotiateUARTRate waits for a reply at each rate,
+         * on top of the reply's transfer time
+         *
+         * It defaults to 50ms
+         */
+        void setProbeTimeout(base::Time const& timeout);
+
+        /** How long negotiateUARTRate waits for a reply at each rate */
+        base::Time getProbeTimeout() const;
+
+        /** Set the host side of the UART to the given rate */
+        void setHostUARTRate(Configuration::UARTRate rate);
+
+        /** Find the rate of the module's UART
+         *
+         * The host UART is switched to each rate in turn, starting with the
+         * cached rate of the device, the link configuration's rate, the
+         * factory default (9600) and then from the fastest to the slowest,
+         * until the module replies to a configuration read. The module must
+         * be in sleep mode.
+         *
+         * On success, the configuration cache, the link configuration and
+         * the UART rate cache are updated, and the host UART is left at the
+         * module's rate.
+         *
+         * @throw iodrivers_base::TimeoutError if the module replied at none
+         *   of the rates
+         */
+        Configuration::UARTRate negotiateUARTRate();
+
+        /** Change the UART rate on both the module and the host
+         *
+         * This is writeConfiguration() with only the UART rate changed,
+         * followed by a configuration read at the new rate to check that
+         * the module follows
+         */
+        void switchUARTRate(Configuration::UARTRate rate, bool save = false);
+
+        /** Close the driver
+         *
+         * It invalidates the configuration cache
+         */
+        void close();
+
+        /** Read the configuration from the board
+         *
+         * It refreshes the configuration cache, and discards staged changes
+         */
         Configuration readConfiguration();
 
-        /** Write a new configuration to the board */
+        /** Write a new configuration to the board
+         *
+         * It updates the configuration cache, and discards staged changes.
+         * If the UART rate changes and the driver is connected to a serial
+         * line, the host UART is switched to the new rate once the module had
+         * time to apply it.
+         *
+         * It also updates the saved configuration cache: a save records the
+         * configuration, and a write without save removes the device's
+         * entry, as the module's volatile configuration no longer matches
+         * the saved one.
+         */
         void writeConfiguration(Configuration const& conf, bool save = false);
 
+        /** Update the driver with the reply to a configuration read command
+         *
+         * readConfiguration() calls it. Code that sends the command itself,
+         * such as AsyncDriver, calls it with the decoded reply
+         */
+        void completeConfigurationRead(Configuration const& conf);
+
+        /** Update the driver once a configuration write command is written
+         *
+         * This is the part of writeConfiguration() that follows the command:
+         * the host UART rate switch, the wait for the module to be ready
+         * again and the cache updates. Code that sends the command itself,
+         * such as AsyncDriver, calls it once the command is written
+         */
+        void completeConfigurationWrite(Configuration const& conf, bool save);
+
+        /** Save a configuration in the module's non-volatile memory, unless
+         * it is already there
+         *
+         * The non-volatile memory wears out with writes. The save is skipped
+         * when the saved configuration cache knows that the device has this
+         * configuration saved, in which case the module is not even read, or
+         * when the module's configuration matches and this driver did not
+         * write an unsaved configuration since it was opened. Use
+         * writeConfiguration to force the save.
+         *
+         * @return true if the configuration was written, false otherwise
+         */
+        bool saveConfiguration(Configuration const& conf);
+
+        /** Counters of saveConfiguration */
+        ConfigurationSaveStatistics getConfigurationSaveStatistics() const;
+
+        /** The module's configuration
+         *
+         * It is read from the module only if the cache is empty
+         */
+        Configuration const& getConfiguration();
+
+        /** Whether the module's configuration is cached */
+        bool hasCachedConfiguration() const;
+
+        /** Empty the configuration cache, and discard staged changes */
+        void invalidateConfigurationCache();
+
+        /** Stage a configuration change, to be written by commitConfiguration
+         *
+         * The fields that differ from the module's configuration are marked
+         * dirty. Several changes can be staged before a single commit.
+         */
+        void stageConfiguration(Configuration const& conf);
+
+        /** The configuration with all staged changes applied */
+        Configuration const& getStagedConfiguration();
+
+        /** The staged fields that differ from the module's configuration, as
+         * a combination of Configuration::Field flags
+         */
+        int getDirtyFields();
+
+        /** Write the staged configuration to the module in a single command
+         *
+         * Nothing is written if no field is dirty. If save is set, this is
+         * saveConfiguration() with the staged configuration.
+         *
+         * @return true if the configuration was written, false otherwise
+         */
+        bool commitConfiguration(bool save = false);
+
+        /** Size of the address/channel header prepended to each frame in
+         * fixed transmission mode
+         */
+        static const int FIXED_TRANSMISSION_HEADER_SIZE = 3;
+
         /** @overload
-        *
-        * Calls readRaw using the default timeout as packet timeout
-        */
+         *
+         * Uses the driver's write timeout as packet timeout
+         */
         int writeRaw(uint16_t target, uint8_t channel, uint8_t* buffer, int bufsize);
 
         /** @overload
-        *
-        * Use the same timeout for first byte and packet
-        */
+         *
+         * Use the same timeout for first byte and packet
+         */
         int writeRaw(uint16_t target, uint8_t channel,
                      uint8_t* buffer, int bufsize, base::Time const& timeout);
 
-        /** Read raw bytes from the underlying I/O
-        *
-        * Reads as many bytes as possible within the time boundaries specified
-        * by its timeout parameters, not attempting to extract packets
-        *
-        * @arg packet_timeout the overall timeout. The method will return at most
-        *   after that much time has elapsed
-        * @arg first_byte_timeout return if no bytes are received within that
-        *   much time
-        * @arg inter_byte_timeout return if no new bytes have been received after
-        *   that much time has elapsed since the last received byte
-        *
-        * This never throws
-        */
+        /** Send a frame to a given target and channel in fixed transmission mode
+         *
+         * The address/channel header and the payload are handed to the
+         * kernel in a single scatter/gather write, without copying the
+         * payload into a staging buffer
+         *
+         * @arg packet_timeout the overall timeout. The method will return at most
+         *   after that much time has elapsed
+         * @arg first_byte_timeout return if no bytes could be written within
+         *   that much time
+         * @arg inter_byte_timeout return if no new bytes could be written after
+         *   that much time has elapsed since the last successful write
+         * @return the number of payload bytes written. It is lower than
+         *   bufsize if one of the timeouts was reached, or if the module's
+         *   buffer did not have enough room (see setAUXMonitor). It is zero
+         *   if the timeout was reached within the header, in which case
+         *   getFixedTransmissionReadyTime() leaves the module the time to
+         *   drop the truncated header
+         *
+         * It does not wait for the fixed transmission gap (see
+         * setFixedTransmissionGap), and never throws on timeout
+         */
         int writeRaw(uint16_t target, uint8_t channel, uint8_t* buffer, int bufsize,
                      base::Time const& packet_timeout,
                      base::Time const& first_byte_timeout,
                      base::Time const& inter_byte_timeout = base::Time());
 
+        /** Write bytes as-is, with the module flow control
+         *
+         * Written right after a short fixed transmission writeRaw(), the
+         * bytes continue the same frame, as long as the UART does not stay
+         * idle long enough for the module to end the packet
+         *
+         * @return the number of bytes written. It is lower than bufsize if
+         *   the timeout was reached, or if the module's buffer did not have
+         *   enough room (see setAUXMonitor)
+         */
+        int writeRaw(uint8_t const* buffer, int bufsize, base::Time const& timeout);
+
+        /** Send a length-prefixed frame in transparent transmission mode
+         *
+         * The frame is decoded on the receiving side by readPacket() in
+         * PACKET_MODE_LENGTH_PREFIXED. The sync byte, length and payload are
+         * written with a single scatter/gather write. It uses the driver's
+         * write timeout.
+         *
+         * @return the number of payload bytes written. It is zero if the
+         *   module's buffer did not have enough room (see setAUXMonitor)
+         */
+        int writeFrame(uint8_t const* buffer, int bufsize);
+
+        /** Send a length-prefixed frame to a given target and channel in
+         * fixed transmission mode
+         *
+         * @see writeFrame(uint8_t const*, int)
+         */
+        int writeFrame(uint16_t target, uint8_t channel,
+                       uint8_t const* buffer, int bufsize);
+
         Version readVersion();
     };
 }
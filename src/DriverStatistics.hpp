@@ -0,0 +1,58 @@
+#ifndef COMMS_LORA_EBYTE_E32_DRIVERSTATISTICS_HPP
+#define COMMS_LORA_EBYTE_E32_DRIVERSTATISTICS_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+
+namespace comms_lora_ebyte_e32 {
+    /** Snapshot of the driver's link statistics
+     *
+     * @see DriverStatisticsRecorder
+     */
+    struct DriverStatistics {
+        /** Number of buckets of the command latency histogram
+         *
+         * Bucket 0 counts latencies below 1ms, bucket i latencies between
+         * 2^(i-1) and 2^i ms. The last bucket counts everything above.
+         */
+        static const int LATENCY_BUCKETS = 13;
+
+        /** When the snapshot was taken */
+        base::Time time;
+        /** Time covered by the counters, since the last reset */
+        base::Time duration;
+
+        uint64_t tx_bytes = 0;
+        uint64_t tx_frames = 0;
+        uint64_t rx_bytes = 0;
+        uint64_t rx_frames = 0;
+
+        /** Timeouts with type iodrivers_base::TimeoutError::NONE */
+        uint64_t timeouts_none = 0;
+        /** Timeouts with type iodrivers_base::TimeoutError::FIRST_BYTE */
+        uint64_t timeouts_first_byte = 0;
+        /** Timeouts with type iodrivers_base::TimeoutError::PACKET */
+        uint64_t timeouts_packet = 0;
+        /** Replies to commands that could not be decoded */
+        uint64_t malformed_replies = 0;
+
+        /** Number of commands that got a reply */
+        uint64_t commands = 0;
+        /** Histogram of the command round-trip times */
+        uint64_t command_latency[LATENCY_BUCKETS] = { 0 };
+
+        /** Estimated airtime needed to send the transmitted frames */
+        base::Time tx_airtime;
+
+        /** Bytes sent per second, over the snapshot's duration */
+        double tx_throughput = 0;
+        /** Bytes received per second, over the snapshot's duration */
+        double rx_throughput = 0;
+        /** Configured air rate, in bytes per second */
+        double configured_air_throughput = 0;
+        /** Fraction of the time the radio was estimated to be transmitting */
+        double air_utilization = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include <comms_lora_ebyte_e32/DriverStatisticsRecorder.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+static const memory_order RELAXED = memory_order_relaxed;
+
+DriverStatisticsRecorder::DriverStatisticsRecorder() {
+    reset();
+    setLinkConfiguration(Configuration());
+}
+
+void DriverStatisticsRecorder::reset() {
+    m_start.store(base::Time::now().toMicroseconds(), RELAXED);
+    for (auto* counter : { &m_tx_bytes, &m_tx_frames, &m_rx_bytes, &m_rx_frames,
+                           &m_timeouts_none, &m_timeouts_first_byte,
+                           &m_timeouts_packet, &m_malformed_replies,
+                           &m_commands }) {
+        counter->store(0, RELAXED);
+    }
+    for (auto& bucket : m_command_latency) {
+        bucket.store(0, RELAXED);
+    }
+    m_tx_airtime.store(0, RELAXED);
+}
+
+void DriverStatisticsRecorder::setLinkConfiguration(Configuration const& conf) {
+    m_configured_air_throughput.store(getEffectiveAirBitrate(conf) / 8, RELAXED);
+}
+
+void DriverStatisticsRecorder::recordTX(int bytes, base::Time const& airtime) {
+    m_tx_bytes.fetch_add(bytes, RELAXED);
+    m_tx_frames.fetch_add(1, RELAXED);
+    m_tx_airtime.fetch_add(airtime.toMicroseconds(), RELAXED);
+}
+
+void DriverStatisticsRecorder::recordRX(int bytes, bool frame) {
+    m_rx_bytes.fetch_add(bytes, RELAXED);
+    if (frame) {
+        m_rx_frames.fetch_add(1, RELAXED);
+    }
+}
+
+void DriverStatisticsRecorder::recordTimeout(
+    iodrivers_base::TimeoutError::TIMEOUT_TYPE type
+) {
+    switch (type) {
+        case iodrivers_base::TimeoutError::FIRST_BYTE:
+            m_timeouts_first_byte.fetch_add(1, RELAXED);
+            break;
+        case iodrivers_base::TimeoutError::PACKET:
+            m_timeouts_packet.fetch_add(1, RELAXED);
+            break;
+        default:
+            m_timeouts_none.fetch_add(1, RELAXED);
+            break;
+    }
+}
+
+void DriverStatisticsRecorder::recordMalformedReply() {
+    m_malformed_replies.fetch_add(1, RELAXED);
+}
+
+void DriverStatisticsRecorder::recordCommandLatency(base::Time const& latency) {
+    int64_t ms = latency.toMilliseconds();
+    int bucket = 0;
+    while (ms > 0 && bucket < DriverStatistics::LATENCY_BUCKETS - 1) {
+        ms >>= 1;
+        ++bucket;
+    }
+    m_command_latency[bucket].fetch_add(1, RELAXED);
+    m_commands.fetch_add(1, RELAXED);
+}
+
+DriverStatistics DriverStatisticsRecorder::snapshot(base::Time const& now) const {
+    DriverStatistics stats;
+    stats.time = now;
+    stats.duration = now - base::Time::fromMicroseconds(m_start.load(RELAXED));
+    stats.tx_bytes = m_tx_bytes.load(RELAXED);
+    stats.tx_frames = m_tx_frames.load(RELAXED);
+    stats.rx_bytes = m_rx_bytes.load(RELAXED);
+    stats.rx_frames = m_rx_frames.load(RELAXED);
+    stats.timeouts_none = m_timeouts_none.load(RELAXED);
+    stats.timeouts_first_byte = m_timeouts_first_byte.load(RELAXED);
+    stats.timeouts_packet = m_timeouts_packet.load(RELAXED);
+    stats.malformed_replies = m_malformed_replies.load(RELAXED);
+    stats.commands = m_commands.load(RELAXED);
+    for (int i = 0; i < DriverStatistics::LATENCY_BUCKETS; ++i) {
+        stats.command_latency[i] = m_command_latency[i].load(RELAXED);
+    }
+    stats.tx_airtime = base::Time::fromMicroseconds(m_tx_airtime.load(RELAXED));
+
+    stats.configured_air_throughput = m_configured_air_throughput.load(RELAXED);
+    double seconds = stats.duration.toSeconds();
+    if (seconds > 0) {
+        stats.tx_throughput = stats.tx_bytes / seconds;
+        stats.rx_throughput = stats.rx_bytes / seconds;
+        stats.air_utilization = stats.tx_airtime.toSeconds() / seconds;
+    }
+    return stats;
+}
@@ -0,0 +1,69 @@
+#ifndef COMMS_LORA_EBYTE_E32_DRIVERSTATISTICSRECORDER_HPP
+#define COMMS_LORA_EBYTE_E32_DRIVERSTATISTICSRECORDER_HPP
+
+#include <atomic>
+#include <iodrivers_base/Exceptions.hpp>
+#include <comms_lora_ebyte_e32/Configuration.hpp>
+#include <comms_lora_ebyte_e32/DriverStatistics.hpp>
+
+namespace comms_lora_ebyte_e32 {
+    /** Lock-free accumulation of the driver's link statistics
+     *
+     * All counters are relaxed atomics, so that recording costs a few
+     * uncontended increments, and a snapshot can be taken from another
+     * thread than the one using the driver. The snapshot's counters are read
+     * individually, and may therefore be slightly inconsistent with each
+     * other.
+     */
+    class DriverStatisticsRecorder {
+        std::atomic<int64_t> m_start;
+        std::atomic<uint64_t> m_tx_bytes;
+        std::atomic<uint64_t> m_tx_frames;
+        std::atomic<uint64_t> m_rx_bytes;
+        std::atomic<uint64_t> m_rx_frames;
+        std::atomic<uint64_t> m_timeouts_none;
+        std::atomic<uint64_t> m_timeouts_first_byte;
+        std::atomic<uint64_t> m_timeouts_packet;
+        std::atomic<uint64_t> m_malformed_replies;
+        std::atomic<uint64_t> m_commands;
+        std::atomic<uint64_t> m_command_latency[DriverStatistics::LATENCY_BUCKETS];
+        std::atomic<int64_t> m_tx_airtime;
+        std::atomic<double> m_configured_air_throughput;
+
+    public:
+        DriverStatisticsRecorder();
+
+        /** Reset all counters */
+        void reset();
+
+        /** Set the link configuration, used to compute the configured air
+         * throughput of the snapshots
+         *
+         * It is kept across resets
+         */
+        void setLinkConfiguration(Configuration const& conf);
+
+        /** Record a transmitted frame
+         *
+         * @arg airtime the estimated airtime of the frame
+         */
+        void recordTX(int bytes, base::Time const& airtime);
+
+        /** Record received bytes
+         *
+         * @arg frame whether the bytes form a whole frame
+         */
+        void recordRX(int bytes, bool frame);
+
+        void recordTimeout(iodrivers_base::TimeoutError::TIMEOUT_TYPE type);
+
+        void recordMalformedReply();
+
+        void recordCommandLatency(base::Time const& latency);
+
+        /** Get a snapshot of the counters */
+        DriverStatistics snapshot(base::Time const& now = base::Time::now()) const;
+    };
+}
+
+#endif
@@ -0,0 +1,304 @@
+#include <comms_lora_ebyte_e32/FECLink.hpp>
+#include <comms_lora_ebyte_e32/CRC.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const int FECLink::SHARD_HEADER_SIZE;
+const int FECLink::SHARD_CRC_SIZE;
+const int FECLink::MAX_SHARD_SIZE = SUB_PACKET_SIZE - Driver::FRAME_HEADER_SIZE -
+                                    SHARD_HEADER_SIZE - SHARD_CRC_SIZE;
+const int FECLink::MAX_FIXED_SHARD_SIZE =
+    FECLink::MAX_SHARD_SIZE - Driver::FIXED_TRANSMISSION_HEADER_SIZE;
+const int FECLink::MAX_DATA_SHARDS;
+const int FECLink::MAX_PARITY_SHARDS;
+const int FECLink::RECEIVE_WINDOW;
+
+/** Size of the packet length stored at the start of the data shards */
+static const int LENGTH_SIZE = 2;
+
+static void validateShards(int data_shards, int parity_shards) {
+    if (data_shards < 1 || data_shards > FECLink::MAX_DATA_SHARDS ||
+        parity_shards < 0 || parity_shards > FECLink::MAX_PARITY_SHARDS) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::FECLink: shard counts must be between 1 and " +
+            std::to_string(FECLink::MAX_DATA_SHARDS) + " data shards, and 0 and " +
+            std::to_string(FECLink::MAX_PARITY_SHARDS) + " parity shards"
+        );
+    }
+}
+
+FECLink::FECLink(Driver& driver, int data_shards, int parity_shards)
+    : m_driver(driver) {
+    validateShards(data_shards, parity_shards);
+    m_codec.reset(new ReedSolomon(data_shards, parity_shards));
+    m_driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+}
+
+void FECLink::setParityShards(int parity_shards) {
+    validateShards(getDataShards(), parity_shards);
+    m_codec.reset(new ReedSolomon(getDataShards(), parity_shards));
+}
+
+int FECLink::getDataShards() const {
+    return m_codec->getDataShards();
+}
+
+int FECLink::getParityShards() const {
+    return m_codec->getParityShards();
+}
+
+int FECLink::getMaxPacketSize() const {
+    return getDataShards() * MAX_SHARD_SIZE - LENGTH_SIZE;
+}
+
+int FECLink::getMaxFixedPacketSize() const {
+    return getDataShards() * MAX_FIXED_SHARD_SIZE - LENGTH_SIZE;
+}
+
+int FECLink::encode(uint8_t const* packet, int size, int max_packet_size) {
+    if (size < 1 || size > max_packet_size) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::FECLink::send: packets must be between 1 "
+            "and " + std::to_string(max_packet_size) + " bytes"
+        );
+    }
+
+    int data_shards = getDataShards();
+    int parity_shards = getParityShards();
+    int shard_size = (size + LENGTH_SIZE + data_shards - 1) / data_shards;
+    int frame_size = SHARD_HEADER_SIZE + shard_size + SHARD_CRC_SIZE;
+    int total = data_shards + parity_shards;
+
+    vector<uint8_t> data(data_shards * shard_size, 0);
+    data[0] = size >> 8;
+    data[1] = size & 0xff;
+    memcpy(data.data() + LENGTH_SIZE, packet, size);
+
+    m_frames.assign(total * frame_size, 0);
+    vector<uint8_t const*> data_pointers(data_shards);
+    vector<uint8_t*> parity_pointers(parity_shards);
+    for (int i = 0; i < total; ++i) {
+        uint8_t* frame = &m_frames[i * frame_size];
+        frame[0] = m_sequence;
+        frame[1] = i;
+        frame[2] = ((data_shards - 1) << 4) | parity_shards;
+        uint8_t* shard = frame + SHARD_HEADER_SIZE;
+        if (i < data_shards) {
+            memcpy(shard, &data[i * shard_size], shard_size);
+            data_pointers[i] = shard;
+        }
+        else {
+            parity_pointers[i - data_shards] = shard;
+        }
+    }
+    m_codec->encode(data_pointers.data(), parity_pointers.data(), shard_size);
+
+    for (int i = 0; i < total; ++i) {
+        uint8_t* frame = &m_frames[i * frame_size];
+        uint16_t crc = crc16(frame, SHARD_HEADER_SIZE + shard_size);
+        frame[frame_size - 2] = crc >> 8;
+        frame[frame_size - 1] = crc & 0xff;
+    }
+    m_sequence++;
+    return frame_size;
+}
+
+static void checkWritten(int written) {
+    if (written == 0) {
+        throw iodrivers_base::TimeoutError(
+            iodrivers_base::TimeoutError::PACKET,
+            "comms_lora_ebyte_e32::FECLink::send: timed out writing a frame"
+        );
+    }
+}
+
+void FECLink::send(uint8_t const* packet, int size) {
+    int frame_size = encode(packet, size, getMaxPacketSize());
+    int count = m_frames.size() / frame_size;
+    for (int i = 0; i < count; ++i) {
+        checkWritten(m_driver.writeFrame(&m_frames[i * frame_size], frame_size));
+    }
+    m_stats.sent_packets++;
+    m_stats.sent_shards += count;
+}
+
+void FECLink::send(uint16_t target, uint8_t channel,
+                   uint8_t const* packet, int size) {
+    int frame_size = encode(packet, size, getMaxFixedPacketSize());
+    int count = m_frames.size() / frame_size;
+    for (int i = 0; i < count; ++i) {
+        // Each shard has its own header, which the module only sees as such
+        // after an idle UART
+        m_driver.waitFixedTransmissionGap();
+        checkWritten(m_driver.writeFrame(target, channel,
+                                         &m_frames[i * frame_size], frame_size));
+    }
+    m_stats.sent_packets++;
+    m_stats.sent_shards += count;
+}
+
+void FECLink::retire(Block const& block) {
+    m_stats.expected_shards += block.shards.size();
+    m_stats.window_received_shards += block.received;
+    if (!block.decoded) {
+        m_stats.lost_blocks++;
+    }
+}
+
+FECLink::Block& FECLink::findBlock(uint8_t sequence, uint8_t shape,
+                                   int shard_size) {
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+        if (it->sequence != sequence) {
+            continue;
+        }
+        else if (it->shape == shape && it->shard_size == shard_size) {
+            return *it;
+        }
+
+        // Same sequence number, but a different block. The sender probably
+        // restarted
+        retire(*it);
+        m_blocks.erase(it);
+        break;
+    }
+
+    int total = (shape >> 4) + 1 + (shape & 0xf);
+    Block block;
+    block.sequence = sequence;
+    block.shape = shape;
+    block.shard_size = shard_size;
+    block.shards.resize(total, vector<uint8_t>(shard_size));
+    block.present.resize(total, false);
+    m_blocks.push_back(std::move(block));
+    if (m_blocks.size() > RECEIVE_WINDOW) {
+        retire(m_blocks.front());
+        m_blocks.pop_front();
+    }
+    return m_blocks.back();
+}
+
+int FECLink::processFrame(uint8_t const* frame, int size,
+                          uint8_t* buffer, int bufsize) {
+    int shard_size = size - SHARD_HEADER_SIZE - SHARD_CRC_SIZE;
+    if (shard_size < 1) {
+        m_stats.invalid_frames++;
+        return -1;
+    }
+    uint16_t crc = (frame[size - 2] << 8) | frame[size - 1];
+    if (crc != crc16(frame, size - SHARD_CRC_SIZE)) {
+        m_stats.invalid_frames++;
+        return -1;
+    }
+
+    uint8_t sequence = frame[0];
+    int index = frame[1];
+    uint8_t shape = frame[2];
+    int data_shards = (shape >> 4) + 1;
+    int parity_shards = shape & 0xf;
+    if (index >= data_shards + parity_shards) {
+        m_stats.invalid_frames++;
+        return -1;
+    }
+
+    Block& block = findBlock(sequence, shape, shard_size);
+    if (block.present[index]) {
+        return -1;
+    }
+    block.present[index] = true;
+    block.received++;
+    m_stats.received_shards++;
+    memcpy(block.shards[index].data(), frame + SHARD_HEADER_SIZE, shard_size);
+    if (block.decoded || block.received < data_shards) {
+        return -1;
+    }
+
+    ReedSolomon codec(data_shards, parity_shards);
+    vector<uint8_t*> shards;
+    int missing = 0;
+    for (int i = 0; i < data_shards + parity_shards; ++i) {
+        shards.push_back(block.shards[i].data());
+        missing += (i < data_shards && !block.present[i]);
+    }
+    codec.reconstruct(shards.data(), block.present, shard_size);
+    block.decoded = true;
+    m_stats.recovered_shards += missing;
+
+    vector<uint8_t> data;
+    for (int i = 0; i < data_shards; ++i) {
+        data.insert(data.end(), block.shards[i].begin(), block.shards[i].end());
+    }
+    int packet_size = (data[0] << 8) | data[1];
+    if (packet_size > static_cast<int>(data.size()) - LENGTH_SIZE) {
+        m_stats.invalid_frames++;
+        return -1;
+    }
+
+    m_stats.received_packets++;
+    if (packet_size > bufsize) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::FECLink::receive: received a " +
+            std::to_string(packet_size) + " bytes packet in a " +
+            std::to_string(bufsize) + " bytes buffer"
+        );
+    }
+    memcpy(buffer, data.data() + LENGTH_SIZE, packet_size);
+    return packet_size;
+}
+
+int FECLink::receive(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    uint8_t packet[Driver::MAX_PACKET_SIZE];
+    while (true) {
+        base::Time now = base::Time::now();
+        base::Time remaining = deadline > now ? deadline - now : base::Time();
+        int size = m_driver.readPacket(packet, Driver::MAX_PACKET_SIZE, remaining) -
+                   Driver::FRAME_HEADER_SIZE;
+        int packet_size = processFrame(packet + Driver::FRAME_HEADER_SIZE, size,
+                                       buffer, bufsize);
+        if (packet_size >= 0) {
+            return packet_size;
+        }
+    }
+}
+
+double FECLink::getShardLossRate() const {
+    if (m_stats.expected_shards == 0) {
+        return 0;
+    }
+    return 1 - static_cast<double>(m_stats.window_received_shards) /
+               m_stats.expected_shards;
+}
+
+void FECLink::resetStatistics() {
+    m_stats = Statistics();
+}
+
+FECLink::Statistics FECLink::getStatistics() const {
+    return m_stats;
+}
+
+int FECLink::getRequiredParityShards(int data_shards, double shard_loss,
+                                     double max_block_loss) {
+    for (int parity_shards = 0; parity_shards < MAX_PARITY_SHARDS;
+         ++parity_shards) {
+        // Probability that more than parity_shards shards are lost
+        int total = data_shards + parity_shards;
+        double block_loss = 0;
+        for (int lost = parity_shards + 1; lost <= total; ++lost) {
+            double combinations = std::exp(std::lgamma(total + 1) -
+                                           std::lgamma(lost + 1) -
+                                           std::lgamma(total - lost + 1));
+            block_loss += combinations * std::pow(shard_loss, lost) *
+                          std::pow(1 - shard_loss, total - lost);
+        }
+        if (block_loss <= max_block_loss) {
+            return parity_shards;
+        }
+    }
+    return MAX_PARITY_SHARDS;
+}
@@ -0,0 +1,185 @@
+#ifndef COMMS_LORA_EBYTE_E32_FECLINK_HPP
+#define COMMS_LORA_EBYTE_E32_FECLINK_HPP
+
+#include <comms_lora_ebyte_e32/ReedSolomon.hpp>
+#include <base/Time.hpp>
+#include <deque>
+#include <memory>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Send and receive packets protected by a host-side erasure code
+     *
+     * The module drops the sub-packets that fail its CRC, so the radio link
+     * is an erasure channel, whose unit is the 58-byte sub-packet. The link
+     * splits each packet in data shards, computes parity shards with a
+     * Reed-Solomon code (see ReedSolomon), and sends each shard as its own
+     * length-prefixed frame (see Driver::writeFrame). A packet is recovered
+     * from any data_shards of its shards. When the shards are full-size,
+     * i.e. when the packet is about data_shards * MAX_SHARD_SIZE bytes,
+     * each frame fills exactly one sub-packet, and the packet survives the
+     * loss of up to parity_shards sub-packets. Smaller packets have smaller
+     * shards, which may share sub-packets. In fixed transmission mode, the
+     * module counts the address and channel header in the sub-packet, so
+     * the shards are limited to MAX_FIXED_SHARD_SIZE instead, and the
+     * shards are separated by the driver's fixed transmission gap (see
+     * Driver::setFixedTransmissionGap).
+     *
+     * This allows to disable the module's FEC, which costs throughput on
+     * good links, and to adjust the redundancy to the measured loss rate
+     * (see setParityShards and getRequiredParityShards). The shard counts
+     * are sent along with each shard, so the receiver follows the sender's
+     * changes.
+     *
+     * Each frame holds a block sequence number, the index of the shard, the
+     * shard counts, the shard and a CRC. On the receiving side, the driver
+     * is put in PACKET_MODE_LENGTH_PREFIXED.
+     */
+    class FECLink {
+    public:
+        /** Block sequence number, shard index, and shard counts */
+        static const int SHARD_HEADER_SIZE = 3;
+
+        /** Size of the CRC that ends each frame */
+        static const int SHARD_CRC_SIZE = 2;
+
+        /** Shard size at which a frame fills one sub-packet */
+        static const int MAX_SHARD_SIZE;
+
+        /** Shard size at which a frame and its fixed transmission header
+         * fill one sub-packet
+         */
+        static const int MAX_FIXED_SHARD_SIZE;
+
+        /** Maximum number of data shards */
+        static const int MAX_DATA_SHARDS = 16;
+
+        /** Maximum number of parity shards */
+        static const int MAX_PARITY_SHARDS = 15;
+
+        /** Number of partially received blocks kept by the receiver */
+        static const int RECEIVE_WINDOW = 8;
+
+        struct Statistics {
+            uint64_t sent_packets = 0;
+            uint64_t sent_shards = 0;
+            uint64_t received_packets = 0;
+            /** Valid shards received */
+            uint64_t received_shards = 0;
+            /** Data shards that were lost, and recovered from parity shards */
+            uint64_t recovered_shards = 0;
+            /** Frames that are too short or fail the CRC check */
+            uint64_t invalid_frames = 0;
+            /** Blocks that left the receive window without being decoded */
+            uint64_t lost_blocks = 0;
+            /** Shards sent in the blocks that left the receive window */
+            uint64_t expected_shards = 0;
+            /** Shards received in the blocks that left the receive window */
+            uint64_t window_received_shards = 0;
+        };
+
+    private:
+        struct Block {
+            uint8_t sequence = 0;
+            uint8_t shape = 0;
+            int shard_size = 0;
+            int received = 0;
+            bool decoded = false;
+            std::vector<std::vector<uint8_t>> shards;
+            std::vector<bool> present;
+        };
+
+        Driver& m_driver;
+        std::unique_ptr<ReedSolomon> m_codec;
+        uint8_t m_sequence = 0;
+        std::vector<uint8_t> m_frames;
+        std::deque<Block> m_blocks;
+        Statistics m_stats;
+
+        int encode(uint8_t const* packet, int size, int max_packet_size);
+        void retire(Block const& block);
+        Block& findBlock(uint8_t sequence, uint8_t shape, int shard_size);
+
+        /** Process a received frame payload
+         *
+         * @return the size of the decoded packet, or -1 if the frame did not
+         *   complete one
+         */
+        int processFrame(uint8_t const* frame, int size,
+                         uint8_t* buffer, int bufsize);
+
+    public:
+        /**
+         * @arg driver the driver. Its packet mode is changed to
+         *   PACKET_MODE_LENGTH_PREFIXED
+         * @arg data_shards the number of shards each packet is split into
+         * @arg parity_shards the number of parity shards added to them
+         * @throw std::invalid_argument if the shard counts are out of range
+         */
+        FECLink(Driver& driver, int data_shards, int parity_shards);
+
+        /** Change the number of parity shards of the next packets */
+        void setParityShards(int parity_shards);
+
+        int getDataShards() const;
+        int getParityShards() const;
+
+        /** The largest packet that can be sent in transparent transmission
+         * mode
+         */
+        int getMaxPacketSize() const;
+
+        /** The largest packet that can be sent in fixed transmission mode */
+        int getMaxFixedPacketSize() const;
+
+        /** Send a packet in transparent transmission mode
+         *
+         * @throw std::invalid_argument if the packet is larger than
+         *   getMaxPacketSize()
+         * @throw iodrivers_base::TimeoutError if a frame could not be written
+         *   within the driver's write timeout
+         */
+        void send(uint8_t const* packet, int size);
+
+        /** Send a packet in fixed transmission mode
+         *
+         * @throw std::invalid_argument if the packet is larger than
+         *   getMaxFixedPacketSize()
+         * @see send(uint8_t const*, int)
+         */
+        void send(uint16_t target, uint8_t channel, uint8_t const* packet, int size);
+
+        /** Wait for a packet
+         *
+         * @return the packet size
+         * @throw iodrivers_base::TimeoutError if no packet could be decoded
+         *   within the timeout
+         * @throw std::invalid_argument if the buffer is too small for the
+         *   packet. The packet is dropped.
+         */
+        int receive(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
+        /** Fraction of the shards lost in the blocks that left the receive
+         * window, or zero if none did
+         */
+        double getShardLossRate() const;
+
+        /** Reset the statistics */
+        void resetStatistics();
+
+        Statistics getStatistics() const;
+
+        /** The smallest number of parity shards for which the probability
+         * of losing a block is at most max_block_loss, if shards are lost
+         * independently with the given probability
+         *
+         * @return the number of parity shards, or MAX_PARITY_SHARDS if none
+         *   reaches the target
+         */
+        static int getRequiredParityShards(int data_shards, double shard_loss,
+                                           double max_block_loss);
+    };
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef COMMS_LORA_EBYTE_E32_FLOWCONTROLSTATISTICS_HPP
+#define COMMS_LORA_EBYTE_E32_FLOWCONTROLSTATISTICS_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+
+namespace comms_lora_ebyte_e32 {
+    /** Counters of the AUX-based transmit flow control */
+    struct FlowControlStatistics {
+        /** Bytes handed to the module, headers included */
+        uint64_t tx_bytes = 0;
+
+        /** Number of writes that had to wait for the module's buffer */
+        uint64_t busy_waits = 0;
+
+        /** Total time spent waiting for the module's buffer */
+        base::Time busy_time;
+
+        /** Number of writes that were truncated or refused because the
+         * module's buffer did not free up in time
+         */
+        uint64_t short_writes = 0;
+
+        /** Bytes that were not written because of short writes */
+        uint64_t refused_bytes = 0;
+    };
+}
+
+#endif
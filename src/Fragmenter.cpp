@@ -0,0 +1,89 @@
+#include <comms_lora_ebyte_e32/Fragmenter.hpp>
+#include <comms_lora_ebyte_e32/CRC.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const int Fragmenter::HEADER_SIZE;
+const int Fragmenter::TRAILER_SIZE;
+const int Fragmenter::MAX_FRAGMENTS;
+const int Fragmenter::DEFAULT_FRAGMENT_SIZE;
+
+Fragmenter::Fragmenter(int fragment_size)
+    : m_fragment_size(fragment_size) {
+    if (fragment_size <= HEADER_SIZE + TRAILER_SIZE || fragment_size > 255) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::Fragmenter: fragment size must be between " +
+            to_string(HEADER_SIZE + TRAILER_SIZE + 1) + " and 255"
+        );
+    }
+}
+
+int Fragmenter::getFragmentSize() const {
+    return m_fragment_size;
+}
+
+int Fragmenter::getFragmentDataSize() const {
+    return m_fragment_size - HEADER_SIZE - TRAILER_SIZE;
+}
+
+int Fragmenter::getMaxMessageSize() const {
+    return getFragmentDataSize() * MAX_FRAGMENTS;
+}
+
+int Fragmenter::start(uint8_t const* message, int size) {
+    if (size <= 0 || size > getMaxMessageSize()) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::Fragmenter::start: message size must be "
+            "between 1 and " + to_string(getMaxMessageSize())
+        );
+    }
+
+    if (m_message) {
+        m_message_id++;
+    }
+    m_message = message;
+    m_message_size = size;
+    m_fragment_count = (size + getFragmentDataSize() - 1) / getFragmentDataSize();
+    m_next_fragment = 0;
+    return m_fragment_count;
+}
+
+uint8_t Fragmenter::getMessageID() const {
+    return m_message_id;
+}
+
+bool Fragmenter::hasNext() const {
+    return m_next_fragment < m_fragment_count;
+}
+
+int Fragmenter::next(uint8_t* buffer) {
+    return generate(buffer, m_next_fragment++);
+}
+
+int Fragmenter::generate(uint8_t* buffer, int index) const {
+    if (index < 0 || index >= m_fragment_count) {
+        throw std::out_of_range(
+            "comms_lora_ebyte_e32::Fragmenter::generate: invalid fragment index"
+        );
+    }
+
+    int data_size = getFragmentDataSize();
+    int offset = index * data_size;
+    int size = std::min(data_size, m_message_size - offset);
+
+    buffer[0] = m_message_id;
+    buffer[1] = index;
+    buffer[2] = m_fragment_count;
+    buffer[3] = data_size;
+    memcpy(buffer + HEADER_SIZE, m_message + offset, size);
+
+    uint16_t crc = crc16(buffer, HEADER_SIZE + size);
+    buffer[HEADER_SIZE + size] = crc >> 8;
+    buffer[HEADER_SIZE + size + 1] = crc & 0xff;
+    return HEADER_SIZE + size + TRAILER_SIZE;
+}
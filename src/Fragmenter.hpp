@@ -0,0 +1,98 @@
+#ifndef COMMS_LORA_EBYTE_E32_FRAGMENTER_HPP
+#define COMMS_LORA_EBYTE_E32_FRAGMENTER_HPP
+
+#include <cstdint>
+
+namespace comms_lora_ebyte_e32 {
+    /** Split messages into fragments that fit in one frame
+     *
+     * Each fragment is laid out as
+     *
+     * - message ID (1 byte)
+     * - fragment index (1 byte)
+     * - fragment count (1 byte)
+     * - size of the data in all but the last fragment (1 byte)
+     * - data
+     * - CRC16 of all the above (2 bytes, big endian)
+     *
+     * The size field lets the receiver place fragments that arrive out of
+     * order. Message IDs are incremented for each message, and wrap.
+     *
+     * The fragmenter does not copy the message, which must remain valid until
+     * all fragments were generated
+     *
+     * @see Reassembler
+     */
+    class Fragmenter {
+    public:
+        /** Size of the fragment header */
+        static const int HEADER_SIZE = 4;
+
+        /** Size of the fragment trailer (CRC) */
+        static const int TRAILER_SIZE = 2;
+
+        /** Maximum number of fragments in a message */
+        static const int MAX_FRAGMENTS = 255;
+
+        /** Default fragment size
+         *
+         * It is the largest fragment that fits in one sub-packet when sent
+         * with Driver::writeFrame in fixed transmission mode
+         */
+        static const int DEFAULT_FRAGMENT_SIZE = 53;
+
+    private:
+        int m_fragment_size;
+        uint8_t m_message_id = 0;
+        uint8_t const* m_message = nullptr;
+        int m_message_size = 0;
+        int m_fragment_count = 0;
+        int m_next_fragment = 0;
+
+    public:
+        /** @arg fragment_size the maximum size of a fragment, including its
+         *   header and trailer. It must be between HEADER_SIZE + TRAILER_SIZE
+         *   + 1 and 255
+         */
+        explicit Fragmenter(int fragment_size = DEFAULT_FRAGMENT_SIZE);
+
+        /** The maximum fragment size */
+        int getFragmentSize() const;
+
+        /** The amount of message data per fragment */
+        int getFragmentDataSize() const;
+
+        /** The largest message that can be fragmented */
+        int getMaxMessageSize() const;
+
+        /** Start fragmenting a new message
+         *
+         * @return the number of fragments
+         * @throw std::invalid_argument if the message is empty or larger than
+         *   getMaxMessageSize()
+         */
+        int start(uint8_t const* message, int size);
+
+        /** The ID of the current message */
+        uint8_t getMessageID() const;
+
+        /** Whether some fragments of the current message remain */
+        bool hasNext() const;
+
+        /** Generate the next fragment
+         *
+         * @arg buffer the fragment buffer, at least getFragmentSize() bytes
+         * @return the fragment size
+         */
+        int next(uint8_t* buffer);
+
+        /** Generate a given fragment of the current message
+         *
+         * It does not change the fragment returned by next(). This is meant
+         * to re-send lost fragments.
+         */
+        int generate(uint8_t* buffer, int index) const;
+    };
+}
+
+#endif
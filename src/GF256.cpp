@@ -0,0 +1,72 @@
+#include <comms_lora_ebyte_e32/GF256.hpp>
+#include <stdexcept>
+
+using namespace comms_lora_ebyte_e32;
+
+namespace {
+    /** Generator polynomial, without the x^8 term */
+    const int POLYNOMIAL = 0x1d;
+
+    struct Tables {
+        uint8_t exp[512];
+        uint8_t log[256];
+        uint8_t mul[256][256];
+
+        Tables() {
+            int x = 1;
+            for (int i = 0; i < 255; ++i) {
+                exp[i] = x;
+                exp[i + 255] = x;
+                log[x] = i;
+                x <<= 1;
+                if (x & 0x100) {
+                    x = (x ^ POLYNOMIAL) & 0xff;
+                }
+            }
+            exp[510] = exp[0];
+            exp[511] = exp[1];
+            log[0] = 0;
+
+            for (int a = 0; a < 256; ++a) {
+                for (int b = 0; b < 256; ++b) {
+                    mul[a][b] = (a && b) ? exp[log[a] + log[b]] : 0;
+                }
+            }
+        }
+    };
+
+    Tables const& tables() {
+        static const Tables instance;
+        return instance;
+    }
+}
+
+uint8_t comms_lora_ebyte_e32::gf256Multiply(uint8_t a, uint8_t b) {
+    return tables().mul[a][b];
+}
+
+uint8_t comms_lora_ebyte_e32::gf256Inverse(uint8_t a) {
+    if (a == 0) {
+        throw std::invalid_argument("gf256Inverse: zero has no inverse");
+    }
+    Tables const& t = tables();
+    return t.exp[255 - t.log[a]];
+}
+
+void comms_lora_ebyte_e32::gf256MultiplyAdd(uint8_t* dst, uint8_t const* src,
+                                            uint8_t coefficient, int size) {
+    if (coefficient == 0) {
+        return;
+    }
+    else if (coefficient == 1) {
+        for (int i = 0; i < size; ++i) {
+            dst[i] ^= src[i];
+        }
+        return;
+    }
+
+    uint8_t const* row = tables().mul[coefficient];
+    for (int i = 0; i < size; ++i) {
+        dst[i] ^= row[src[i]];
+    }
+}
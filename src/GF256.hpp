@@ -0,0 +1,29 @@
+#ifndef COMMS_LORA_EBYTE_E32_GF256_HPP
+#define COMMS_LORA_EBYTE_E32_GF256_HPP
+
+#include <cstdint>
+
+namespace comms_lora_ebyte_e32 {
+    /** Multiplication in GF(2^8), with the polynomial x^8+x^4+x^3+x^2+1
+     *
+     * Addition in this field is a XOR
+     */
+    uint8_t gf256Multiply(uint8_t a, uint8_t b);
+
+    /** Multiplicative inverse in GF(2^8)
+     *
+     * @throw std::invalid_argument if a is zero
+     */
+    uint8_t gf256Inverse(uint8_t a);
+
+    /** Add coefficient * src to dst, i.e. dst[i] ^= coefficient * src[i]
+     *
+     * This is the kernel of Reed-Solomon encoding and decoding. It looks up
+     * the products in a precomputed 256-byte row of the multiplication
+     * table, one byte at a time.
+     */
+    void gf256MultiplyAdd(uint8_t* dst, uint8_t const* src,
+                          uint8_t coefficient, int size);
+}
+
+#endif
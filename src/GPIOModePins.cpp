@@ -0,0 +1,56 @@
+#include <comms_lora_ebyte_e32/GPIOModePins.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+using namespace comms_lora_ebyte_e32;
+
+/** Consumer label shown by the kernel for the requested lines */
+static const char CONSUMER_LABEL[] = "comms_lora_ebyte_e32";
+
+GPIOModePins::GPIOModePins(std::string const& chip_path, int m0, int m1) {
+    int chip = ::open(chip_path.c_str(), O_RDWR | O_CLOEXEC);
+    if (chip < 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::GPIOModePins: cannot open " + chip_path
+        );
+    }
+
+    gpiohandle_request request;
+    std::memset(&request, 0, sizeof(request));
+    request.lineoffsets[0] = m0;
+    request.lineoffsets[1] = m1;
+    request.lines = 2;
+    request.flags = GPIOHANDLE_REQUEST_OUTPUT;
+    std::strncpy(request.consumer_label, CONSUMER_LABEL,
+                 sizeof(request.consumer_label) - 1);
+    int result = ::ioctl(chip, GPIO_GET_LINEHANDLE_IOCTL, &request);
+    ::close(chip);
+    if (result < 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::GPIOModePins: cannot request lines " +
+            std::to_string(m0) + " and " + std::to_string(m1) + " of " +
+            chip_path
+        );
+    }
+    m_fd = request.fd;
+}
+
+GPIOModePins::~GPIOModePins() {
+    ::close(m_fd);
+}
+
+void GPIOModePins::set(bool m0, bool m1) {
+    gpiohandle_data data;
+    std::memset(&data, 0, sizeof(data));
+    data.values[0] = m0 ? 1 : 0;
+    data.values[1] = m1 ? 1 : 0;
+    if (::ioctl(m_fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data) < 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::GPIOModePins: failed to set M0 and M1"
+        );
+    }
+}
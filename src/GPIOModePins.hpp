@@ -0,0 +1,31 @@
+#ifndef COMMS_LORA_EBYTE_E32_GPIOMODEPINS_HPP
+#define COMMS_LORA_EBYTE_E32_GPIOMODEPINS_HPP
+
+#include <comms_lora_ebyte_e32/ModePins.hpp>
+#include <string>
+
+namespace comms_lora_ebyte_e32 {
+    /** Mode pins driven through the Linux GPIO character device
+     *
+     * This is the interface libgpiod is built on. Both lines are requested
+     * as outputs in a single handle, which sets them with a single ioctl.
+     * They are held until the object is destroyed, and start low, i.e. with
+     * the module in normal mode.
+     */
+    class GPIOModePins : public ModePins {
+        int m_fd = -1;
+
+    public:
+        /**
+         * @arg chip_path the GPIO chip device, e.g. /dev/gpiochip0
+         * @arg m0 the offset of the M0 line on the chip
+         * @arg m1 the offset of the M1 line on the chip
+         */
+        GPIOModePins(std::string const& chip_path, int m0, int m1);
+        ~GPIOModePins();
+
+        void set(bool m0, bool m1);
+    };
+}
+
+#endif
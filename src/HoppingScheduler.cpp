@@ -0,0 +1,204 @@
+#include <comms_lora_ebyte_e32/HoppingScheduler.hpp>
+#include <comms_lora_ebyte_e32/ConfigurationCodec.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const base::Time HoppingScheduler::DEFAULT_GUARD_TIME =
+    base::Time::fromMilliseconds(5);
+const int HoppingScheduler::DEFAULT_MAX_FRAME_SIZE;
+
+HoppingScheduler::HoppingScheduler(Driver& driver, ChannelPlan const& plan,
+                                   int node, int max_frame_size)
+    : m_driver(driver)
+    , m_plan(plan)
+    , m_node(node)
+    , m_max_frame_size(max_frame_size)
+    , m_queues(MAX_CHANNEL + 1) {
+    if (node < 0 || node >= plan.getNodeCount()) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::HoppingScheduler: node " +
+            std::to_string(node) + " is not part of the plan"
+        );
+    }
+    else if (max_frame_size < 1 ||
+             max_frame_size > Driver::MAX_PACKET_SIZE -
+                              Driver::FIXED_TRANSMISSION_HEADER_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::HoppingScheduler: invalid maximum frame size"
+        );
+    }
+    setGuardTime(DEFAULT_GUARD_TIME);
+}
+
+ChannelPlan const& HoppingScheduler::getPlan() const {
+    return m_plan;
+}
+
+void HoppingScheduler::setEpoch(base::Time const& time) {
+    m_epoch = time;
+    m_last_used_slot = numeric_limits<int64_t>::min();
+}
+
+void HoppingScheduler::setGuardTime(base::Time const& time) {
+    m_slot_duration = getFrameDuration(m_max_frame_size) + time;
+    m_last_used_slot = numeric_limits<int64_t>::min();
+}
+
+base::Time HoppingScheduler::getSlotDuration() const {
+    return m_slot_duration;
+}
+
+base::Time HoppingScheduler::getSuperframeDuration() const {
+    return m_slot_duration * m_plan.getSlotCount();
+}
+
+base::Time HoppingScheduler::getFrameDuration(int size) const {
+    Configuration const& conf = m_driver.getLinkConfiguration();
+    int bytes = Driver::FIXED_TRANSMISSION_HEADER_SIZE + size;
+    return getUARTTransferTime(conf, bytes + PACKET_END_BYTES) +
+           getAirtime(conf, bytes);
+}
+
+int64_t HoppingScheduler::getSlotNumber(base::Time const& time) const {
+    int64_t elapsed = (time - m_epoch).toMicroseconds();
+    int64_t duration = m_slot_duration.toMicroseconds();
+    if (elapsed >= 0) {
+        return elapsed / duration;
+    }
+    return -((-elapsed + duration - 1) / duration);
+}
+
+base::Time HoppingScheduler::getSlotStart(int64_t slot) const {
+    return m_epoch + base::Time::fromMicroseconds(
+        slot * m_slot_duration.toMicroseconds()
+    );
+}
+
+int HoppingScheduler::getSlotIndex(base::Time const& time) const {
+    int count = m_plan.getSlotCount();
+    return ((getSlotNumber(time) % count) + count) % count;
+}
+
+void HoppingScheduler::setMaxQueueSize(size_t size) {
+    m_max_queue_size = size;
+}
+
+bool HoppingScheduler::push(uint16_t target, uint8_t channel,
+                            uint8_t const* buffer, int bufsize) {
+    if (bufsize > m_max_frame_size) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::HoppingScheduler::push: frame of " +
+            std::to_string(bufsize) + " bytes is bigger than the maximum of " +
+            std::to_string(m_max_frame_size)
+        );
+    }
+    else if (!m_plan.canReach(m_node, channel)) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::HoppingScheduler::push: the plan has no "
+            "slot for channel " + std::to_string(channel)
+        );
+    }
+
+    auto& queue = m_queues[channel];
+    if (queue.size() >= m_max_queue_size) {
+        m_stats.rejected_frames++;
+        return false;
+    }
+
+    Frame frame;
+    frame.target = target;
+    frame.payload.assign(buffer, buffer + bufsize);
+    queue.push_back(std::move(frame));
+    return true;
+}
+
+int HoppingScheduler::update(base::Time const& now) {
+    int64_t slot = getSlotNumber(now);
+    if (slot == m_last_used_slot) {
+        return 0;
+    }
+    int channel = m_plan.getTransmitChannel(m_node, getSlotIndex(now));
+    if (channel < 0) {
+        return 0;
+    }
+
+    m_last_used_slot = slot;
+    auto& queue = m_queues[channel];
+    if (queue.empty()) {
+        m_stats.idle_slots++;
+        return 0;
+    }
+
+    Frame& frame = queue.front();
+    if (now + getFrameDuration(frame.payload.size()) > getSlotStart(slot + 1)) {
+        // Too late in the slot, the frame would overlap with the next one
+        m_stats.idle_slots++;
+        return 0;
+    }
+
+    int size = frame.payload.size();
+    int written = m_driver.writeRaw(
+        frame.target, channel, frame.payload.data(), size
+    );
+    // The driver's flow control may refuse part of the frame. The rest must
+    // follow in the same transmission: sent in a later slot, behind a new
+    // header, it would reach the receiver as a separate frame
+    while (written > 0 && written < size) {
+        int more = m_driver.writeRaw(frame.payload.data() + written,
+                                     size - written, m_driver.getWriteTimeout());
+        if (more == 0) {
+            break;
+        }
+        written += more;
+    }
+
+    if (written == 0) {
+        // Nothing went out, try again in the next slot
+        return 0;
+    }
+    else if (written < size) {
+        m_stats.truncated_frames++;
+        queue.pop_front();
+        return 0;
+    }
+
+    m_stats.sent_frames++;
+    queue.pop_front();
+    return 1;
+}
+
+base::Time HoppingScheduler::getNextSendTime(base::Time const& now) const {
+    if (getQueuedFrameCount() == 0) {
+        return base::Time();
+    }
+
+    int64_t current = getSlotNumber(now);
+    for (int64_t slot = current; slot <= current + m_plan.getSlotCount(); ++slot) {
+        if (slot == m_last_used_slot) {
+            continue;
+        }
+        int count = m_plan.getSlotCount();
+        int index = ((slot % count) + count) % count;
+        int channel = m_plan.getTransmitChannel(m_node, index);
+        if (channel >= 0 && !m_queues[channel].empty()) {
+            return slot == current ? now : getSlotStart(slot);
+        }
+    }
+    return base::Time();
+}
+
+size_t HoppingScheduler::getQueuedFrameCount() const {
+    size_t count = 0;
+    for (auto const& queue : m_queues) {
+        count += queue.size();
+    }
+    return count;
+}
+
+HoppingScheduler::Statistics const& HoppingScheduler::getStatistics() const {
+    return m_stats;
+}
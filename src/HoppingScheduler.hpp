@@ -0,0 +1,144 @@
+#ifndef COMMS_LORA_EBYTE_E32_HOPPINGSCHEDULER_HPP
+#define COMMS_LORA_EBYTE_E32_HOPPINGSCHEDULER_HPP
+
+#include <base/Time.hpp>
+#include <comms_lora_ebyte_e32/ChannelPlan.hpp>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Time-division, multi-channel transmission of fixed-transmission frames
+     *
+     * The scheduler runs one node of a ChannelPlan. Frames are queued per
+     * destination channel, and one frame is handed to Driver::writeRaw in
+     * each of the node's slots, on the channel that the plan gives to the
+     * slot. The channel is set by the frame header, so the module is never
+     * reconfigured.
+     *
+     * A slot lasts long enough to transfer a frame of the maximum size on
+     * the UART and send it over the air, plus a guard time that absorbs
+     * the clock offsets between the nodes. Airtimes are computed from the
+     * driver's link configuration (see Driver::getLinkConfiguration). All
+     * nodes must use the same air rate, maximum frame size and epoch, and
+     * have synchronized clocks.
+     */
+    class HoppingScheduler {
+    public:
+        struct Statistics {
+            /** Frames sent */
+            uint64_t sent_frames = 0;
+            /** Frames rejected because their queue was full */
+            uint64_t rejected_frames = 0;
+            /** Slots of the node that went unused because no frame was
+             * queued for their channel
+             */
+            uint64_t idle_slots = 0;
+            /** Frames that the driver could only write in part, and that
+             * were dropped
+             */
+            uint64_t truncated_frames = 0;
+        };
+
+        /** Default guard time, added to the slot duration */
+        static const base::Time DEFAULT_GUARD_TIME;
+
+        /** Default maximum frame payload size
+         *
+         * A frame fits in a single sub-packet along with the fixed
+         * transmission header.
+         */
+        static const int DEFAULT_MAX_FRAME_SIZE = 55;
+
+    private:
+        struct Frame {
+            uint16_t target;
+            std::vector<uint8_t> payload;
+        };
+
+        Driver& m_driver;
+        ChannelPlan m_plan;
+        int m_node;
+        int m_max_frame_size;
+        base::Time m_slot_duration;
+        base::Time m_epoch;
+        int64_t m_last_used_slot = std::numeric_limits<int64_t>::min();
+        std::vector<std::deque<Frame>> m_queues;
+        size_t m_max_queue_size = 64;
+        Statistics m_stats;
+
+        int64_t getSlotNumber(base::Time const& time) const;
+        base::Time getSlotStart(int64_t slot) const;
+        base::Time getFrameDuration(int size) const;
+
+    public:
+        /**
+         * @arg driver the driver frames are written to
+         * @arg plan the network's plan
+         * @arg node the index of this node in the plan
+         * @arg max_frame_size the biggest frame payload, which sets the slot
+         *   duration
+         */
+        HoppingScheduler(Driver& driver, ChannelPlan const& plan, int node,
+                         int max_frame_size = DEFAULT_MAX_FRAME_SIZE);
+
+        ChannelPlan const& getPlan() const;
+
+        /** Set the time at which the first superframe starts
+         *
+         * It defaults to the Unix epoch, which is enough when the nodes
+         * clocks are synchronized
+         */
+        void setEpoch(base::Time const& time);
+
+        /** Set the guard time and recompute the slot duration */
+        void setGuardTime(base::Time const& time);
+
+        base::Time getSlotDuration() const;
+
+        /** Duration of a full superframe, i.e. of a cycle over all slots */
+        base::Time getSuperframeDuration() const;
+
+        /** Index in the plan of the slot running at the given time */
+        int getSlotIndex(base::Time const& time) const;
+
+        /** Set the maximum number of frames in each channel queue */
+        void setMaxQueueSize(size_t size);
+
+        /** Queue a frame for a target on a channel
+         *
+         * @return false if the channel's queue is full
+         * @throw std::invalid_argument if the frame is bigger than the
+         *   maximum frame size, or the plan never lets this node transmit
+         *   on the channel
+         */
+        bool push(uint16_t target, uint8_t channel,
+                  uint8_t const* buffer, int bufsize);
+
+        /** Send the frame allowed by the current slot, if any
+         *
+         * The frame is only sent if it can be completed before the end of
+         * the slot, so call it often enough, e.g. at the times returned by
+         * getNextSendTime
+         *
+         * @return the number of frames sent
+         */
+        int update(base::Time const& now = base::Time::now());
+
+        /** When update() can send the next queued frame
+         *
+         * It returns a null time if nothing is queued
+         */
+        base::Time getNextSendTime(base::Time const& now = base::Time::now()) const;
+
+        /** Number of frames waiting for a slot */
+        size_t getQueuedFrameCount() const;
+
+        Statistics const& getStatistics() const;
+    };
+}
+
+#endif
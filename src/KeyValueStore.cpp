@@ -0,0 +1,85 @@
+#include <comms_lora_ebyte_e32/KeyValueStore.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+KeyValueStore::KeyValueStore() {
+}
+
+KeyValueStore::KeyValueStore(string const& path)
+    : m_path(path) {
+    ifstream file(path.c_str());
+    string key;
+    string value;
+    while (file >> key >> value) {
+        m_values[key] = value;
+    }
+}
+
+bool KeyValueStore::get(string const& key, string& value) const {
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_values.find(key);
+    if (it == m_values.end()) {
+        return false;
+    }
+    value = it->second;
+    return true;
+}
+
+bool KeyValueStore::set(string const& key, string const& value) {
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_values.find(key);
+    if (it != m_values.end() && it->second == value) {
+        return true;
+    }
+    m_values[key] = value;
+    return save();
+}
+
+bool KeyValueStore::remove(string const& key) {
+    lock_guard<mutex> lock(m_mutex);
+    if (m_values.erase(key)) {
+        return save();
+    }
+    return true;
+}
+
+bool KeyValueStore::save() const {
+    if (m_path.empty()) {
+        return true;
+    }
+
+    string tmp_template = m_path + ".XXXXXX";
+    vector<char> tmp_path(tmp_template.begin(), tmp_template.end());
+    tmp_path.push_back('\0');
+    int fd = mkstemp(tmp_path.data());
+    if (fd < 0) {
+        return false;
+    }
+    // mkstemp creates the file readable by its owner only
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    FILE* file = fdopen(fd, "w");
+    if (!file) {
+        close(fd);
+        unlink(tmp_path.data());
+        return false;
+    }
+    bool failed = false;
+    for (auto const& entry : m_values) {
+        failed |= fprintf(file, "%s %s\n",
+                          entry.first.c_str(), entry.second.c_str()) < 0;
+    }
+    failed |= fclose(file) != 0;
+    if (failed || std::rename(tmp_path.data(), m_path.c_str()) != 0) {
+        unlink(tmp_path.data());
+        return false;
+    }
+    return true;
+}
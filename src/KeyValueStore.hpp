@@ -0,0 +1,66 @@
+#ifndef COMMS_LORA_EBYTE_E32_KEYVALUESTORE_HPP
+#define COMMS_LORA_EBYTE_E32_KEYVALUESTORE_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace comms_lora_ebyte_e32 {
+    /** String values indexed by string keys, optionally persisted in a file
+     *
+     * This is the storage of the per-device caches (UARTRateCache,
+     * SavedConfigurationCache). The store is either in-memory only, or
+     * backed by a file that is read at construction and rewritten on each
+     * change. The file has one 'KEY VALUE' line per entry, so neither may
+     * contain whitespace.
+     *
+     * The file is rewritten through a uniquely named temporary file in the
+     * same directory, which is then renamed over it. Readers never see a
+     * partial file, and processes that update the same file at the same
+     * time do not write into each other's temporary file. The last rename
+     * wins.
+     *
+     * Updating the file is best-effort. The methods that change the store
+     * report a failure through their return value, and the in-memory
+     * entries are updated regardless.
+     *
+     * The store may be shared between threads
+     */
+    class KeyValueStore {
+        mutable std::mutex m_mutex;
+        std::string m_path;
+        std::map<std::string, std::string> m_values;
+
+        bool save() const;
+
+    public:
+        /** Create an in-memory store */
+        KeyValueStore();
+
+        /** Create a store backed by the given file
+         *
+         * The file does not need to exist
+         */
+        explicit KeyValueStore(std::string const& path);
+
+        /** Get the value of a key
+         *
+         * @return false if there is none
+         */
+        bool get(std::string const& key, std::string& value) const;
+
+        /** Set the value of a key
+         *
+         * @return false if the file could not be updated
+         */
+        bool set(std::string const& key, std::string const& value);
+
+        /** Remove a key
+         *
+         * @return false if the file could not be updated
+         */
+        bool remove(std::string const& key);
+    };
+}
+
+#endif
@@ -0,0 +1,382 @@
+#include <comms_lora_ebyte_e32/LinkAdapter.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const int LinkAdapter::HEADER_SIZE;
+
+static void sleepUntil(base::Time const& time) {
+    base::Time now = base::Time::now();
+    if (time > now) {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds((time - now).toMicroseconds())
+        );
+    }
+}
+
+static bool sameLinkParameters(Configuration const& a, Configuration const& b) {
+    return a.air_rate == b.air_rate &&
+           a.transmission_power == b.transmission_power;
+}
+
+LinkAdapter::LinkAdapter(Driver& driver, Role role,
+                         Configuration const& configuration,
+                         RateController const& controller)
+    : m_driver(driver)
+    , m_role(role)
+    , m_controller(controller)
+    , m_initial_configuration(configuration)
+    , m_configuration(configuration)
+    , m_previous_configuration(configuration)
+    , m_frame(Driver::MAX_FRAME_PAYLOAD_SIZE) {
+    m_driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    m_driver.setLinkConfiguration(configuration);
+    m_link_deadline = base::Time::now() + m_link_timeout;
+}
+
+void LinkAdapter::setModeSwitch(ModeSwitch mode_switch) {
+    m_mode_switch = mode_switch;
+}
+
+void LinkAdapter::setReportPeriod(base::Time const& period) {
+    m_report_period = period;
+}
+
+void LinkAdapter::setHandshakeTimeout(base::Time const& timeout) {
+    m_handshake_timeout = timeout;
+}
+
+void LinkAdapter::setLinkTimeout(base::Time const& timeout) {
+    m_link_timeout = timeout;
+    m_link_deadline = base::Time::now() + timeout;
+}
+
+void LinkAdapter::setConfigurationDelay(base::Time const& delay) {
+    m_configuration_delay = delay;
+}
+
+Configuration LinkAdapter::getConfiguration() const {
+    return m_configuration;
+}
+
+base::Time LinkAdapter::getRetryPeriod() const {
+    return m_handshake_timeout / 4;
+}
+
+void LinkAdapter::writeFrame(FrameType type, uint8_t const* payload, int size) {
+    m_frame[0] = type;
+    m_frame[1] = m_tx_seq++;
+    memcpy(m_frame.data() + HEADER_SIZE, payload, size);
+    if (m_driver.writeFrame(m_frame.data(), HEADER_SIZE + size) == 0) {
+        throw iodrivers_base::TimeoutError(
+            iodrivers_base::TimeoutError::PACKET,
+            "comms_lora_ebyte_e32::LinkAdapter: timed out writing a frame"
+        );
+    }
+    m_stats.sent_frames++;
+    m_last_sent = base::Time::now();
+
+    int bytes = Driver::FRAME_HEADER_SIZE + HEADER_SIZE + size;
+    m_transmit_end = base::Time::now() +
+                     getUARTTransferTime(m_configuration, bytes) +
+                     getAirtime(m_configuration, bytes);
+}
+
+void LinkAdapter::writeConfigurationFrame(FrameType type, Configuration const& conf) {
+    uint8_t payload[2] = {
+        static_cast<uint8_t>(conf.air_rate),
+        static_cast<uint8_t>(conf.transmission_power)
+    };
+    writeFrame(type, payload, 2);
+}
+
+void LinkAdapter::applyConfiguration(Configuration const& conf) {
+    // Let the module send what it has in its buffer first
+    sleepUntil(m_transmit_end + getPacketGap(m_configuration));
+
+    if (m_driver.getModeController()) {
+        m_driver.writeConfiguration(conf, false);
+    }
+    else {
+        if (m_mode_switch) {
+            m_mode_switch(true);
+        }
+        m_driver.writeConfiguration(conf, false);
+        sleepUntil(base::Time::now() + m_configuration_delay);
+        if (m_mode_switch) {
+            m_mode_switch(false);
+        }
+    }
+
+    m_configuration = conf;
+    m_controller.resetSamples();
+    resetCounts();
+    m_has_rx_seq = false;
+}
+
+void LinkAdapter::resetCounts() {
+    m_rx_expected = 0;
+    m_rx_received = 0;
+}
+
+void LinkAdapter::send(uint8_t const* packet, int size) {
+    if (size > Driver::MAX_FRAME_PAYLOAD_SIZE - HEADER_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::LinkAdapter::send: packets are limited to " +
+            std::to_string(Driver::MAX_FRAME_PAYLOAD_SIZE - HEADER_SIZE) +
+            " bytes"
+        );
+    }
+
+    // Keep the channel clear for the peer's replies
+    base::Time deadline = base::Time::now() + m_handshake_timeout;
+    while (m_state != STATE_IDLE && base::Time::now() < deadline) {
+        step(deadline);
+    }
+    writeFrame(FRAME_DATA, packet, size);
+}
+
+void LinkAdapter::handleFrame(uint8_t const* frame, int size, base::Time const& now) {
+    if (size < HEADER_SIZE) {
+        return;
+    }
+    m_link_deadline = now + m_link_timeout;
+    m_stats.received_frames++;
+
+    uint8_t seq = frame[1];
+    if (!m_has_rx_seq) {
+        m_has_rx_seq = true;
+        m_rx_seq = seq;
+        m_rx_expected++;
+        m_rx_received++;
+    }
+    else {
+        uint8_t gap = seq - m_rx_seq;
+        if (gap != 0 && gap < 128) {
+            m_rx_expected += gap;
+            m_rx_received++;
+            m_stats.lost_frames += gap - 1;
+            m_rx_seq = seq;
+        }
+    }
+
+    uint8_t const* payload = frame + HEADER_SIZE;
+    int payload_size = size - HEADER_SIZE;
+    switch (frame[0]) {
+        case FRAME_DATA:
+            m_received.push_back(vector<uint8_t>(payload, payload + payload_size));
+            break;
+        case FRAME_REPORT:
+            if (payload_size >= 4) {
+                handleReport((payload[0] << 8) | payload[1],
+                             (payload[2] << 8) | payload[3]);
+            }
+            break;
+        case FRAME_PROPOSE:
+        case FRAME_ACCEPT:
+        case FRAME_CONFIRM: {
+            if (payload_size < 2 || payload[0] > Configuration::AIR_RATE_19200 ||
+                payload[1] > Configuration::POWER_21dBm) {
+                return;
+            }
+            Configuration conf = m_configuration;
+            conf.air_rate = static_cast<Configuration::AirRate>(payload[0]);
+            conf.transmission_power =
+                static_cast<Configuration::TransmissionPower>(payload[1]);
+            handleConfigurationFrame(static_cast<FrameType>(frame[0]), conf);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void LinkAdapter::handleReport(int expected, int received) {
+    if (m_role != ROLE_MASTER || m_state != STATE_IDLE) {
+        return;
+    }
+
+    // Combine both directions of the link
+    Configuration next = m_controller.update(
+        m_configuration, expected + m_rx_expected, received + m_rx_received
+    );
+    resetCounts();
+    if (sameLinkParameters(next, m_configuration)) {
+        return;
+    }
+
+    base::Time now = base::Time::now();
+    m_proposed_configuration = next;
+    m_state = STATE_PROPOSED;
+    m_state_deadline = now + m_handshake_timeout;
+    m_next_retry = now + getRetryPeriod();
+    writeConfigurationFrame(FRAME_PROPOSE, next);
+}
+
+void LinkAdapter::handleConfigurationFrame(FrameType type, Configuration const& conf) {
+    if (type == FRAME_PROPOSE && m_role == ROLE_SLAVE && m_state == STATE_IDLE) {
+        writeConfigurationFrame(FRAME_ACCEPT, conf);
+        m_previous_configuration = m_configuration;
+        applyConfiguration(conf);
+        m_state = STATE_CONFIRMING;
+        m_state_deadline = base::Time::now() + m_handshake_timeout;
+    }
+    else if (type == FRAME_ACCEPT && m_role == ROLE_MASTER &&
+             m_state == STATE_PROPOSED &&
+             sameLinkParameters(conf, m_proposed_configuration)) {
+        m_previous_configuration = m_configuration;
+        applyConfiguration(conf);
+        m_state = STATE_CONFIRMING;
+        base::Time now = base::Time::now();
+        m_state_deadline = now + m_handshake_timeout;
+        m_next_retry = now + getRetryPeriod();
+        writeConfigurationFrame(FRAME_CONFIRM, conf);
+    }
+    else if (type == FRAME_CONFIRM && sameLinkParameters(conf, m_configuration)) {
+        if (m_role == ROLE_SLAVE) {
+            writeConfigurationFrame(FRAME_CONFIRM, conf);
+        }
+        if (m_state == STATE_CONFIRMING) {
+            m_state = STATE_IDLE;
+            m_stats.switches++;
+        }
+    }
+}
+
+base::Time LinkAdapter::update(base::Time const& now) {
+    if (now >= m_link_deadline) {
+        // The last switch probably broke the link. Return to the
+        // configuration before it, and then to the initial one
+        bool fallback = true;
+        if (!sameLinkParameters(m_configuration, m_previous_configuration)) {
+            applyConfiguration(m_previous_configuration);
+        }
+        else if (!sameLinkParameters(m_configuration, m_initial_configuration)) {
+            applyConfiguration(m_initial_configuration);
+        }
+        else {
+            fallback = false;
+        }
+        m_previous_configuration = m_initial_configuration;
+
+        if (fallback) {
+            m_stats.fallbacks++;
+            m_next_report = now;
+            if (m_role == ROLE_MASTER) {
+                m_controller.switchFailed();
+            }
+        }
+        m_state = STATE_IDLE;
+        m_link_deadline = base::Time::now() + m_link_timeout;
+    }
+
+    if (m_state != STATE_IDLE && now >= m_state_deadline) {
+        if (m_state == STATE_CONFIRMING) {
+            applyConfiguration(m_previous_configuration);
+            // The peer may have switched. Leave it the time to lose the link
+            // and come back
+            m_link_deadline = base::Time::now() + m_link_timeout + m_report_period;
+        }
+        m_state = STATE_IDLE;
+        m_stats.failed_switches++;
+        if (m_role == ROLE_MASTER) {
+            m_controller.switchFailed();
+        }
+    }
+    else if (m_role == ROLE_MASTER && m_state != STATE_IDLE && now >= m_next_retry) {
+        writeConfigurationFrame(
+            m_state == STATE_PROPOSED ? FRAME_PROPOSE : FRAME_CONFIRM,
+            m_state == STATE_PROPOSED ? m_proposed_configuration : m_configuration
+        );
+        m_next_retry = now + getRetryPeriod();
+    }
+
+    // The master's reports only keep the link alive, skip them if it sends
+    // other frames
+    bool report_needed =
+        m_role == ROLE_SLAVE || now - m_last_sent >= m_report_period;
+    if (m_state == STATE_IDLE && now >= m_next_report && report_needed) {
+        uint8_t payload[4] = {
+            static_cast<uint8_t>(m_rx_expected >> 8),
+            static_cast<uint8_t>(m_rx_expected & 0xff),
+            static_cast<uint8_t>(m_rx_received >> 8),
+            static_cast<uint8_t>(m_rx_received & 0xff)
+        };
+        writeFrame(FRAME_REPORT, payload, 4);
+        // The master keeps its own counts until it evaluates them
+        if (m_role == ROLE_SLAVE) {
+            resetCounts();
+        }
+        m_next_report = now + m_report_period;
+    }
+    else if (now >= m_next_report) {
+        m_next_report = now + m_report_period;
+    }
+
+    base::Time next = std::min(m_next_report, m_link_deadline);
+    if (m_state != STATE_IDLE) {
+        next = std::min(next, m_state_deadline);
+        if (m_role == ROLE_MASTER) {
+            next = std::min(next, m_next_retry);
+        }
+    }
+    return next;
+}
+
+void LinkAdapter::step(base::Time const& deadline) {
+    base::Time next = update(base::Time::now());
+
+    base::Time now = base::Time::now();
+    base::Time wait_until = std::min(next, deadline);
+    base::Time timeout = wait_until > now ? wait_until - now : base::Time();
+    uint8_t packet[Driver::MAX_PACKET_SIZE];
+    int size;
+    try {
+        size = m_driver.readPacket(packet, Driver::MAX_PACKET_SIZE, timeout);
+    }
+    catch (iodrivers_base::TimeoutError const&) {
+        return;
+    }
+    handleFrame(packet + Driver::FRAME_HEADER_SIZE,
+                size - Driver::FRAME_HEADER_SIZE, base::Time::now());
+}
+
+int LinkAdapter::receive(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    while (m_received.empty()) {
+        if (base::Time::now() >= deadline) {
+            throw iodrivers_base::TimeoutError(
+                iodrivers_base::TimeoutError::PACKET,
+                "comms_lora_ebyte_e32::LinkAdapter::receive: no packet received"
+            );
+        }
+        step(deadline);
+    }
+
+    vector<uint8_t> packet = std::move(m_received.front());
+    m_received.pop_front();
+    if (static_cast<int>(packet.size()) > bufsize) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::LinkAdapter::receive: received a " +
+            std::to_string(packet.size()) + " bytes packet in a " +
+            std::to_string(bufsize) + " bytes buffer"
+        );
+    }
+    memcpy(buffer, packet.data(), packet.size());
+    return packet.size();
+}
+
+void LinkAdapter::process(base::Time const& duration) {
+    base::Time deadline = base::Time::now() + duration;
+    while (base::Time::now() < deadline) {
+        step(deadline);
+    }
+}
+
+LinkAdapter::Statistics LinkAdapter::getStatistics() const {
+    return m_stats;
+}
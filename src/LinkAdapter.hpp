@@ -0,0 +1,213 @@
+#ifndef COMMS_LORA_EBYTE_E32_LINKADAPTER_HPP
+#define COMMS_LORA_EBYTE_E32_LINKADAPTER_HPP
+
+#include <comms_lora_ebyte_e32/Configuration.hpp>
+#include <comms_lora_ebyte_e32/RateController.hpp>
+#include <base/Time.hpp>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Adapt the air rate and transmission power of both ends of a link
+     *
+     * Both ends exchange length-prefixed frames (see Driver::writeFrame) in
+     * transparent transmission mode, laid out as
+     *
+     * - frame type (1 byte)
+     * - sequence number (1 byte), incremented for each frame
+     * - the type-specific payload
+     *
+     * Each end counts the frames missing from the peer's sequence. The slave
+     * periodically reports its counts to the master, which only sends
+     * reports to keep the link alive when it has nothing else to send. The
+     * master feeds the counts of both directions to a RateController. When
+     * it proposes a change, the switch is coordinated in-band:
+     *
+     * 1. the master sends a proposal with the new air rate and power
+     * 2. the slave accepts it, and switches once the acceptance is sent
+     * 3. the master switches when it receives the acceptance, and sends a
+     *    confirmation with the new configuration, which the slave echoes
+     *
+     * Each end returns to its previous configuration if the confirmation
+     * did not go through within the handshake timeout. When an end does not
+     * hear from its peer within the link timeout, it returns to the
+     * configuration it had before the last switch, and then to the initial
+     * configuration.
+     *
+     * The configuration is applied with Driver::writeConfiguration, without
+     * saving it. The module must be in configuration mode for that. When the
+     * driver has a mode controller (see Driver::setModeController), the
+     * switch is sequenced on AUX. Otherwise, it is the job of the mode switch
+     * callback (see setModeSwitch).
+     *
+     * The protocol only progresses while one of send(), receive() or
+     * process() is running.
+     */
+    class LinkAdapter {
+    public:
+        enum Role {
+            /** The end that decides of configuration changes */
+            ROLE_MASTER,
+            /** The end that follows the master's decisions */
+            ROLE_SLAVE
+        };
+
+        enum FrameType {
+            FRAME_DATA,
+            /** Counts of the frames received since the last report */
+            FRAME_REPORT,
+            FRAME_PROPOSE,
+            FRAME_ACCEPT,
+            FRAME_CONFIRM
+        };
+
+        /** Size of the frame type and sequence number */
+        static const int HEADER_SIZE = 2;
+
+        struct Statistics {
+            uint64_t sent_frames = 0;
+            uint64_t received_frames = 0;
+            /** Frames missing from the peer's sequence */
+            uint64_t lost_frames = 0;
+            /** Configuration switches that completed */
+            uint64_t switches = 0;
+            /** Configuration switches that were abandoned or reverted */
+            uint64_t failed_switches = 0;
+            /** Returns to the initial configuration after the peer was lost */
+            uint64_t fallbacks = 0;
+        };
+
+        /** Called with true before a configuration is written, and with false
+         * after, to switch the module to and from configuration mode
+         */
+        typedef std::function<void (bool configuration_mode)> ModeSwitch;
+
+    private:
+        enum State {
+            STATE_IDLE,
+            /** The master waits for the slave's acceptance */
+            STATE_PROPOSED,
+            /** The configuration was switched, waiting for the confirmation */
+            STATE_CONFIRMING
+        };
+
+        Driver& m_driver;
+        Role m_role;
+        RateController m_controller;
+        ModeSwitch m_mode_switch;
+        Configuration m_initial_configuration;
+        Configuration m_configuration;
+        Configuration m_previous_configuration;
+        Configuration m_proposed_configuration;
+
+        base::Time m_report_period = base::Time::fromSeconds(1);
+        base::Time m_handshake_timeout = base::Time::fromSeconds(2);
+        base::Time m_link_timeout = base::Time::fromSeconds(10);
+        base::Time m_configuration_delay = base::Time::fromMilliseconds(50);
+
+        State m_state = STATE_IDLE;
+        base::Time m_state_deadline;
+        base::Time m_next_retry;
+        base::Time m_next_report;
+        /** Time after which the peer is considered lost */
+        base::Time m_link_deadline;
+        base::Time m_last_sent;
+        /** When the last written frame is expected to be fully sent */
+        base::Time m_transmit_end;
+
+        uint8_t m_tx_seq = 0;
+        bool m_has_rx_seq = false;
+        uint8_t m_rx_seq = 0;
+        int m_rx_expected = 0;
+        int m_rx_received = 0;
+
+        std::vector<uint8_t> m_frame;
+        std::deque<std::vector<uint8_t>> m_received;
+        Statistics m_stats;
+
+        void writeFrame(FrameType type, uint8_t const* payload, int size);
+        void writeConfigurationFrame(FrameType type, Configuration const& conf);
+        void applyConfiguration(Configuration const& conf);
+        void resetCounts();
+        base::Time getRetryPeriod() const;
+
+        void handleFrame(uint8_t const* frame, int size, base::Time const& now);
+        void handleReport(int expected, int received);
+        void handleConfigurationFrame(FrameType type, Configuration const& conf);
+        base::Time update(base::Time const& now);
+        void step(base::Time const& deadline);
+
+    public:
+        /**
+         * @arg driver the driver. Its packet mode is changed to
+         *   PACKET_MODE_LENGTH_PREFIXED
+         * @arg role whether this end decides of the changes
+         * @arg configuration the current module configuration. Both ends
+         *   eventually return to it when they lose each other.
+         * @arg controller the policy, only used by the master
+         */
+        LinkAdapter(Driver& driver, Role role, Configuration const& configuration,
+                    RateController const& controller = RateController());
+
+        /** Set the callback that switches the module to configuration mode
+         *
+         * It is not used when the driver has a mode controller
+         */
+        void setModeSwitch(ModeSwitch mode_switch);
+
+        /** Set how often each end reports its frame counts. Defaults to 1s */
+        void setReportPeriod(base::Time const& period);
+
+        /** Set how long a switch may take before being reverted. Defaults to
+         * 2s
+         */
+        void setHandshakeTimeout(base::Time const& timeout);
+
+        /** Set how long without hearing from the peer before returning to the
+         * initial configuration. Defaults to 10s
+         */
+        void setLinkTimeout(base::Time const& timeout);
+
+        /** Set how long the module takes to apply a configuration before it
+         * leaves configuration mode. Defaults to 50ms
+         *
+         * It is not used when the driver has a mode controller, which waits
+         * for AUX instead
+         */
+        void setConfigurationDelay(base::Time const& delay);
+
+        /** The configuration currently in use */
+        Configuration getConfiguration() const;
+
+        /** Send an application packet
+         *
+         * If a configuration switch is in progress, it first waits for it to
+         * complete, at most for the handshake timeout
+         *
+         * @throw std::invalid_argument if the packet does not fit in a frame
+         * @throw iodrivers_base::TimeoutError if the frame could not be
+         *   written within the driver's write timeout
+         */
+        void send(uint8_t const* packet, int size);
+
+        /** Wait for an application packet
+         *
+         * @return the packet size
+         * @throw iodrivers_base::TimeoutError if no packet was received
+         *   within the timeout
+         * @throw std::invalid_argument if the buffer is too small for the
+         *   packet. The packet is dropped.
+         */
+        int receive(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
+        /** Run the protocol for the given duration */
+        void process(base::Time const& duration);
+
+        Statistics getStatistics() const;
+    };
+}
+
+#endif
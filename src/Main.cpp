@@ -1,15 +1,58 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <comms_lora_ebyte_e32/CaptureReader.hpp>
 #include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <comms_lora_ebyte_e32/WakeUpTradeoff.hpp>
 
 using namespace std;
 using namespace comms_lora_ebyte_e32;
 
 void usage(std::ostream& os) {
     os << "comms_lora_ebyte_e32_ctl URI CMD ARGS\n"
+       << "comms_lora_ebyte_e32_ctl batch FILE [URI...]\n"
+       << "comms_lora_ebyte_e32_ctl dump-capture FILE\n"
        << "  version: displays the version info\n"
        << "  show: display current configuration\n"
-       << "  set VAR VALUE: set a configuration variable (non permanent)\n"
+       << "  set VAR VALUE [VAR VALUE...]: set configuration variables (non permanent)\n"
+       << "    all variables are written at once, and only if one changed\n"
        << "  save: save the current configuration\n"
+       << "  wake-up-tradeoff BYTES PERIOD: latency and energy cost of each\n"
+       << "    wireless-wake-up-time at the module's air rate, for batches of\n"
+       << "    BYTES bytes sent every PERIOD seconds to a power-saving receiver\n"
+       << "\n"
+       << "The UART rate of serial:// devices is detected automatically, and\n"
+       << "cached in ~/.comms_lora_ebyte_e32_uart_rates to speed up the next\n"
+       << "connection. Changing uart-rate switches the host side as well.\n"
+       << "\n"
+       << "Saves are skipped when the module already has the configuration.\n"
+       << "The last configuration saved on each device is cached in\n"
+       << "~/.comms_lora_ebyte_e32_saved_configurations, so that the device is\n"
+       << "not even opened when it is known to be up to date.\n"
+       << "\n"
+       << "dump-capture displays the records of a traffic capture (see\n"
+       << "Driver::setCaptureLog), one per line: time in ms since the first\n"
+       << "record, type, size and bytes in hexadecimal.\n"
+       << "\n"
+       << "Batch mode:\n"
+       << "  applies a configuration file to several devices in parallel (at most\n"
+       << "  8 at a time). Each device may appear only once. FILE\n"
+       << "  may be '-' to read from standard input. It contains one statement\n"
+       << "  per line, '#' starting a comment:\n"
+       << "    device URI: start the statements for the given device\n"
+       << "    set VAR VALUE: set a configuration variable\n"
+       << "    save: save the configuration once set\n"
+       << "  Statements before the first 'device' apply to all devices, including\n"
+       << "  the URIs given on the command line.\n"
        << "\n"
        << "Configuration parameters:\n"
        << "  uart-parity: 8N1, 8E1 or 8O1\n"
@@ -188,7 +231,7 @@ void conf_set(Configuration& conf, string var, string value) {
         conf.air_rate = from_string<Configuration::AirRate>(value);
     }
     else if (var == "channel") {
-        conf.channel = std::stoi(value);
+        conf = ConfigurationBuilder(conf).channel(std::stoi(value)).build();
     }
     else if (var == "transmission-mode") {
         conf.transparent_transmission = (value == "transparent");
@@ -197,7 +240,9 @@ void conf_set(Configuration& conf, string var, string value) {
         conf.io_drive_mode = from_string<Configuration::IODriveMode>(value);
     }
     else if (var == "wireless-wake-up-time") {
-        conf.wireless_wake_up_time = std::stoi(value);
+        conf = ConfigurationBuilder(conf)
+            .wirelessWakeUpTime(std::stoi(value))
+            .build();
     }
     else if (var == "error-correction") {
         conf.error_correction_enabled = (value == "enabled");
@@ -211,6 +256,317 @@ void conf_set(Configuration& conf, string var, string value) {
     }
 }
 
+void save_stats_show(ConfigurationSaveStatistics const& stats) {
+    cout << "saves: " << stats.saves << " written, "
+         << stats.skipped_saves << " avoided, "
+         << stats.skipped_reads << " configuration reads avoided, at least "
+         << stats.avoided_time.toMilliseconds() << "ms of UART time saved\n";
+}
+
+void wake_up_tradeoff_show(vector<WakeUpTradeoff> const& tradeoffs) {
+    cout << "wake-up-time latency(ms) tx-charge(mAs) "
+         << "rx-idle-current(mA) rx-average-current(mA)\n";
+    for (auto const& tradeoff : tradeoffs) {
+        cout << static_cast<int>(tradeoff.wireless_wake_up_time) << " ("
+             << tradeoff.wake_up_time.toMilliseconds() << "ms) "
+             << tradeoff.latency.toMilliseconds() << " "
+             << tradeoff.transmit_charge << " "
+             << tradeoff.idle_current << " "
+             << tradeoff.average_current << "\n";
+    }
+}
+
+string to_string(CaptureLog::RecordType type) {
+    switch (type) {
+        case CaptureLog::RECORD_TX:
+            return "TX";
+        case CaptureLog::RECORD_RX:
+            return "RX";
+        case CaptureLog::RECORD_COMMAND:
+            return "COMMAND";
+        case CaptureLog::RECORD_REPLY:
+            return "REPLY";
+    }
+    return "UNKNOWN";
+}
+
+int dump_capture(string const& path) {
+    CaptureReader reader(path);
+    CaptureReader::Record record;
+    base::Time start;
+    while (reader.next(record)) {
+        if (start.isNull()) {
+            start = record.time;
+        }
+        cout << std::dec << std::fixed << std::setprecision(3)
+             << (record.time - start).toSeconds() * 1e3 << " "
+             << to_string(record.type) << " " << record.size << " "
+             << std::hex << std::setfill('0');
+        for (int i = 0; i < record.size; ++i) {
+            cout << std::setw(2) << static_cast<int>(record.data[i]);
+        }
+        cout << std::setfill(' ') << "\n";
+    }
+    cout << std::dec << flush;
+    return 0;
+}
+
+struct BatchJob {
+    string uri;
+    vector<pair<string, string>> settings;
+    bool save = false;
+};
+
+struct BatchResult {
+    bool success = false;
+    bool written = false;
+    /** Whether the saved configuration cache made opening the device
+     * unnecessary
+     */
+    bool cached = false;
+    ConfigurationSaveStatistics save_stats;
+    string error;
+    chrono::steady_clock::duration duration;
+};
+
+/** Maximum number of devices configured at the same time in batch mode */
+static const size_t MAX_BATCH_THREADS = 8;
+
+/** Register the device of a batch job, throwing if it is already part of
+ * the batch
+ *
+ * URIs are compared by device (see UARTRateCache::getDeviceKey), as two jobs
+ * on the same serial port would open and configure it concurrently
+ */
+void batch_add_device(set<string>& devices, string const& uri) {
+    if (!devices.insert(UARTRateCache::getDeviceKey(uri)).second) {
+        throw std::invalid_argument("device '" + uri + "' given more than once");
+    }
+}
+
+vector<BatchJob> batch_parse(istream& input, vector<string> const& uris) {
+    BatchJob common;
+    vector<BatchJob> jobs;
+    BatchJob* current = &common;
+    set<string> devices;
+
+    string line;
+    int line_number = 0;
+    while (getline(input, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        istringstream tokens(line);
+        vector<string> words;
+        string word;
+        while (tokens >> word) {
+            words.push_back(word);
+        }
+
+        if (words.empty()) {
+            continue;
+        }
+        else if (words[0] == "device" && words.size() == 2) {
+            try {
+                batch_add_device(devices, words[1]);
+            }
+            catch (std::exception const& e) {
+                throw std::invalid_argument(
+                    "line " + std::to_string(line_number) + ": " + e.what()
+                );
+            }
+            jobs.push_back(common);
+            jobs.back().uri = words[1];
+            current = &jobs.back();
+        }
+        else if (words[0] == "set" && words.size() == 3) {
+            // Validate the setting now, before any device is touched
+            Configuration conf;
+            try {
+                conf_set(conf, words[1], words[2]);
+            }
+            catch (std::exception const& e) {
+                throw std::invalid_argument(
+                    "line " + std::to_string(line_number) + ": " + e.what()
+                );
+            }
+            current->settings.push_back(make_pair(words[1], words[2]));
+        }
+        else if (words[0] == "save" && words.size() == 1) {
+            current->save = true;
+        }
+        else {
+            throw std::invalid_argument(
+                "line " + std::to_string(line_number) +
+                ": invalid statement '" + line + "'"
+            );
+        }
+    }
+
+    for (auto const& uri : uris) {
+        batch_add_device(devices, uri);
+        jobs.push_back(common);
+        jobs.back().uri = uri;
+    }
+    return jobs;
+}
+
+/** Path of the file caching the UART rate of each device */
+string uart_rate_cache_path() {
+    char const* home = getenv("HOME");
+    if (!home) {
+        return string();
+    }
+    return string(home) + "/.comms_lora_ebyte_e32_uart_rates";
+}
+
+/** Path of the file caching the configuration saved on each device */
+string saved_configuration_cache_path() {
+    char const* home = getenv("HOME");
+    if (!home) {
+        return string();
+    }
+    return string(home) + "/.comms_lora_ebyte_e32_saved_configurations";
+}
+
+/** Open a device, detecting the UART rate of serial devices */
+void open(Driver& driver, string const& uri, UARTRateCache& cache,
+          SavedConfigurationCache& saved_cache) {
+    driver.openURI(uri);
+    driver.setSavedConfigurationCache(&saved_cache);
+    if (uri.compare(0, 9, "serial://") == 0) {
+        driver.setUARTRateCache(&cache);
+        driver.negotiateUARTRate();
+    }
+}
+
+/** Whether the saved configuration cache tells that saving the settings
+ * would not change the device
+ *
+ * On success, stats is updated with the read and save that are avoided
+ */
+bool is_saved(string const& uri, vector<pair<string, string>> const& settings,
+              SavedConfigurationCache const& saved_cache,
+              ConfigurationSaveStatistics& stats) {
+    Configuration saved;
+    if (!saved_cache.get(UARTRateCache::getDeviceKey(uri), saved)) {
+        return false;
+    }
+
+    Configuration conf = saved;
+    for (auto const& setting : settings) {
+        conf_set(conf, setting.first, setting.second);
+    }
+    if (conf.differences(saved)) {
+        return false;
+    }
+
+    stats.skipped_reads++;
+    stats.skipped_saves++;
+    stats.avoided_time = stats.avoided_time + getUARTTransferTime(
+        saved, 3 + Driver::CONFIGURATION_REPLY_SIZE +
+               Driver::CONFIGURATION_COMMAND_SIZE
+    );
+    return true;
+}
+
+BatchResult batch_apply(BatchJob const& job, UARTRateCache& cache,
+                        SavedConfigurationCache& saved_cache) {
+    BatchResult result;
+    auto start = chrono::steady_clock::now();
+    try {
+        if (job.save &&
+            is_saved(job.uri, job.settings, saved_cache, result.save_stats)) {
+            result.cached = true;
+            result.success = true;
+            result.duration = chrono::steady_clock::now() - start;
+            return result;
+        }
+
+        Driver driver;
+        open(driver, job.uri, cache, saved_cache);
+        Configuration conf = driver.getConfiguration();
+        for (auto const& setting : job.settings) {
+            conf_set(conf, setting.first, setting.second);
+        }
+        driver.stageConfiguration(conf);
+        result.written = driver.commitConfiguration(job.save);
+        result.save_stats = driver.getConfigurationSaveStatistics();
+        result.success = true;
+    }
+    catch (std::exception const& e) {
+        result.error = e.what();
+    }
+    result.duration = chrono::steady_clock::now() - start;
+    return result;
+}
+
+int batch(string const& path, vector<string> const& uris) {
+    vector<BatchJob> jobs;
+    try {
+        if (path == "-") {
+            jobs = batch_parse(cin, uris);
+        }
+        else {
+            ifstream file(path.c_str());
+            if (!file) {
+                cerr << "cannot open " << path << endl;
+                return 1;
+            }
+            jobs = batch_parse(file, uris);
+        }
+    }
+    catch (std::invalid_argument const& e) {
+        cerr << path << ": " << e.what() << endl;
+        return 1;
+    }
+
+    UARTRateCache cache(uart_rate_cache_path());
+    SavedConfigurationCache saved_cache(saved_configuration_cache_path());
+    vector<BatchResult> results(jobs.size());
+    atomic<size_t> next_job(0);
+    vector<thread> threads;
+    size_t thread_count = min(jobs.size(), MAX_BATCH_THREADS);
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&jobs, &results, &cache, &saved_cache, &next_job] {
+            for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+                results[i] = batch_apply(jobs[i], cache, saved_cache);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    int failures = 0;
+    ConfigurationSaveStatistics save_stats;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        auto ms = chrono::duration_cast<chrono::milliseconds>(results[i].duration);
+        cout << jobs[i].uri << ": ";
+        if (results[i].success) {
+            cout << (results[i].written ? "written" : "unchanged");
+            if (results[i].cached) {
+                cout << " (cached)";
+            }
+        }
+        else {
+            cout << "FAILED (" << results[i].error << ")";
+            ++failures;
+        }
+        cout << " in " << ms.count() << "ms\n";
+
+        auto const& stats = results[i].save_stats;
+        save_stats.saves += stats.saves;
+        save_stats.skipped_saves += stats.skipped_saves;
+        save_stats.skipped_reads += stats.skipped_reads;
+        save_stats.avoided_time = save_stats.avoided_time + stats.avoided_time;
+    }
+    if (save_stats.saves || save_stats.skipped_saves) {
+        save_stats_show(save_stats);
+    }
+    cout << flush;
+    return failures ? 1 : 0;
+}
+
 int main(int argc, char** argv)
 {
     if (argc < 3) {
@@ -218,11 +574,28 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (string(argv[1]) == "batch") {
+        return batch(argv[2], vector<string>(argv + 3, argv + argc));
+    }
+    else if (string(argv[1]) == "dump-capture") {
+        return dump_capture(argv[2]);
+    }
+
     string uri = argv[1];
     string cmd = argv[2];
 
+    UARTRateCache cache(uart_rate_cache_path());
+    SavedConfigurationCache saved_cache(saved_configuration_cache_path());
+    if (cmd == "save") {
+        ConfigurationSaveStatistics stats;
+        if (is_saved(uri, {}, saved_cache, stats)) {
+            save_stats_show(stats);
+            return 0;
+        }
+    }
+
     Driver driver;
-    driver.openURI(uri);
+    open(driver, uri, cache, saved_cache);
 
     if (cmd == "version") {
         auto version = driver.readVersion();
@@ -236,21 +609,35 @@ int main(int argc, char** argv)
         conf_show(conf);
     }
     else if (cmd == "set") {
-        if (argc < 5) {
-            cerr << "'set' expects two arguments";
+        if (argc < 5 || (argc - 3) % 2 != 0) {
+            cerr << "'set' expects pairs of arguments";
             usage(cerr);
             return 1;
         }
 
-        string var = argv[3];
-        string value = argv[4];
-        Configuration conf = driver.readConfiguration();
-        conf_set(conf, var, value);
-        driver.writeConfiguration(conf);
+        Configuration conf = driver.getConfiguration();
+        for (int i = 3; i < argc; i += 2) {
+            conf_set(conf, argv[i], argv[i + 1]);
+        }
+        driver.stageConfiguration(conf);
+        driver.commitConfiguration();
     }
     else if (cmd == "save") {
-        Configuration conf = driver.readConfiguration();
-        driver.writeConfiguration(conf, true);
+        driver.commitConfiguration(true);
+        save_stats_show(driver.getConfigurationSaveStatistics());
+    }
+    else if (cmd == "wake-up-tradeoff") {
+        if (argc != 5) {
+            cerr << "'wake-up-tradeoff' expects a batch size and a period\n";
+            usage(cerr);
+            return 1;
+        }
+
+        auto tradeoffs = computeWakeUpTradeoffs(
+            driver.getConfiguration(), std::stoi(argv[3]),
+            base::Time::fromSeconds(std::stod(argv[4]))
+        );
+        wake_up_tradeoff_show(tradeoffs);
     }
 
     return 0;
@@ -0,0 +1,117 @@
+#include <comms_lora_ebyte_e32/MessageLink.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <cstring>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+MessageLink::MessageLink(Driver& driver, int reassembly_slots,
+                         int max_message_size, int fragment_size)
+    : m_driver(driver)
+    , m_fragmenter(fragment_size)
+    , m_reassembler(reassembly_slots, max_message_size)
+    , m_fragment(fragment_size)
+    , m_stats_start(base::Time::now()) {
+    if (fragment_size > Driver::MAX_FRAME_PAYLOAD_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::MessageLink: fragments must fit in a frame"
+        );
+    }
+    m_driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+}
+
+Reassembler& MessageLink::getReassembler() {
+    return m_reassembler;
+}
+
+int MessageLink::getMaxMessageSize() const {
+    return m_fragmenter.getMaxMessageSize();
+}
+
+template<typename Write>
+void MessageLink::sendFragments(uint8_t const* message, int size, Write write) {
+    m_fragmenter.start(message, size);
+    while (m_fragmenter.hasNext()) {
+        int fragment_size = m_fragmenter.next(m_fragment.data());
+        if (write(m_fragment.data(), fragment_size) == 0) {
+            throw iodrivers_base::TimeoutError(
+                iodrivers_base::TimeoutError::PACKET,
+                "comms_lora_ebyte_e32::MessageLink::send: "
+                "timed out writing a fragment"
+            );
+        }
+        m_sent_fragments++;
+    }
+    m_sent_messages++;
+    m_sent_bytes += size;
+}
+
+void MessageLink::send(uint8_t const* message, int size) {
+    sendFragments(message, size, [this](uint8_t const* buffer, int size) {
+        return m_driver.writeFrame(buffer, size);
+    });
+}
+
+void MessageLink::send(uint16_t target, uint8_t channel,
+                       uint8_t const* message, int size) {
+    sendFragments(message, size,
+                  [this, target, channel](uint8_t const* buffer, int size) {
+        return m_driver.writeFrame(target, channel, buffer, size);
+    });
+}
+
+int MessageLink::receive(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    uint8_t packet[Driver::MAX_PACKET_SIZE];
+    while (true) {
+        base::Time now = base::Time::now();
+        base::Time remaining = deadline > now ? deadline - now : base::Time();
+        int size = m_driver.readPacket(packet, Driver::MAX_PACKET_SIZE, remaining);
+
+        auto result = m_reassembler.push(packet + Driver::FRAME_HEADER_SIZE,
+                                         size - Driver::FRAME_HEADER_SIZE,
+                                         base::Time::now());
+        if (result != Reassembler::MESSAGE_COMPLETE) {
+            continue;
+        }
+
+        int message_size = m_reassembler.getMessageSize();
+        if (message_size > bufsize) {
+            throw std::invalid_argument(
+                "comms_lora_ebyte_e32::MessageLink::receive: received a " +
+                std::to_string(message_size) + " bytes message in a " +
+                std::to_string(bufsize) + " bytes buffer"
+            );
+        }
+        memcpy(buffer, m_reassembler.getMessage(), message_size);
+        return message_size;
+    }
+}
+
+void MessageLink::resetStatistics() {
+    m_stats_start = base::Time::now();
+    m_sent_messages = 0;
+    m_sent_bytes = 0;
+    m_sent_fragments = 0;
+    m_reassembler.resetStatistics();
+}
+
+MessageLink::Statistics MessageLink::getStatistics(base::Time const& now) const {
+    Statistics stats;
+    stats.sent_messages = m_sent_messages;
+    stats.sent_bytes = m_sent_bytes;
+    stats.sent_fragments = m_sent_fragments;
+
+    stats.reassembly = m_reassembler.getStatistics();
+
+    stats.duration = now - m_stats_start;
+    double seconds = stats.duration.toSeconds();
+    if (seconds > 0) {
+        stats.tx_goodput = stats.sent_bytes / seconds;
+        stats.rx_goodput = stats.reassembly.message_bytes / seconds;
+    }
+    stats.configured_air_throughput =
+        getEffectiveAirBitrate(m_driver.getLinkConfiguration()) / 8;
+    return stats;
+}
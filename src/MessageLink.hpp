@@ -0,0 +1,108 @@
+#ifndef COMMS_LORA_EBYTE_E32_MESSAGELINK_HPP
+#define COMMS_LORA_EBYTE_E32_MESSAGELINK_HPP
+
+#include <comms_lora_ebyte_e32/Fragmenter.hpp>
+#include <comms_lora_ebyte_e32/Reassembler.hpp>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Send and receive messages larger than a frame
+     *
+     * Messages are split by a Fragmenter, and each fragment is sent as a
+     * length-prefixed frame (see Driver::writeFrame). On the receiving side,
+     * the driver is put in PACKET_MODE_LENGTH_PREFIXED and the frames are fed
+     * to a Reassembler.
+     *
+     * There is no retransmission: a message is lost if one of its fragments
+     * is lost.
+     */
+    class MessageLink {
+    public:
+        struct Statistics {
+            uint64_t sent_messages = 0;
+            /** Total size of the sent messages */
+            uint64_t sent_bytes = 0;
+            uint64_t sent_fragments = 0;
+            /** Reception counters */
+            Reassembler::Statistics reassembly;
+            /** Time since the statistics were reset */
+            base::Time duration;
+            /** Message bytes sent per second */
+            double tx_goodput = 0;
+            /** Message bytes received per second */
+            double rx_goodput = 0;
+            /** Configured air rate, in bytes per second */
+            double configured_air_throughput = 0;
+        };
+
+    private:
+        Driver& m_driver;
+        Fragmenter m_fragmenter;
+        Reassembler m_reassembler;
+        std::vector<uint8_t> m_fragment;
+        base::Time m_stats_start;
+        uint64_t m_sent_messages = 0;
+        uint64_t m_sent_bytes = 0;
+        uint64_t m_sent_fragments = 0;
+
+        template<typename Write>
+        void sendFragments(uint8_t const* message, int size, Write write);
+
+    public:
+        /**
+         * @arg driver the driver. Its packet mode is changed to
+         *   PACKET_MODE_LENGTH_PREFIXED
+         * @arg reassembly_slots the number of messages that can be reassembled
+         *   in parallel
+         * @arg max_message_size the largest message that can be received
+         * @arg fragment_size the size of the fragments, see Fragmenter
+         */
+        MessageLink(Driver& driver, int reassembly_slots = 4,
+                    int max_message_size = 4096,
+                    int fragment_size = Fragmenter::DEFAULT_FRAGMENT_SIZE);
+
+        /** The fragment reassembler, e.g. to change its timeout */
+        Reassembler& getReassembler();
+
+        /** The largest message that can be sent */
+        int getMaxMessageSize() const;
+
+        /** Send a message in transparent transmission mode
+         *
+         * @throw iodrivers_base::TimeoutError if a fragment could not be
+         *   written within the driver's write timeout
+         */
+        void send(uint8_t const* message, int size);
+
+        /** Send a message in fixed transmission mode
+         *
+         * @throw iodrivers_base::TimeoutError if a fragment could not be
+         *   written within the driver's write timeout
+         */
+        void send(uint16_t target, uint8_t channel,
+                  uint8_t const* message, int size);
+
+        /** Wait for a complete message
+         *
+         * @return the message size
+         * @throw iodrivers_base::TimeoutError if no message was completed
+         *   within the timeout
+         * @throw std::invalid_argument if the buffer is too small for the
+         *   message. The message is dropped.
+         */
+        int receive(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
+        /** Reset the statistics */
+        void resetStatistics();
+
+        /** Statistics since the last reset
+         *
+         * @arg now the time at which the goodput is computed
+         */
+        Statistics getStatistics(base::Time const& now = base::Time::now()) const;
+    };
+}
+
+#endif
@@ -0,0 +1,25 @@
+#include <comms_lora_ebyte_e32/MockAUXMonitor.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+void MockAUXMonitor::setReady(bool ready) {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_ready = ready;
+    }
+    m_ready_signal.notify_all();
+}
+
+bool MockAUXMonitor::isReady() {
+    lock_guard<mutex> lock(m_mutex);
+    return m_ready;
+}
+
+bool MockAUXMonitor::waitReady(base::Time const& timeout) {
+    unique_lock<mutex> lock(m_mutex);
+    return m_ready_signal.wait_for(
+        lock, chrono::microseconds(timeout.toMicroseconds()),
+        [this] { return m_ready; }
+    );
+}
@@ -0,0 +1,28 @@
+#ifndef COMMS_LORA_EBYTE_E32_MOCKAUXMONITOR_HPP
+#define COMMS_LORA_EBYTE_E32_MOCKAUXMONITOR_HPP
+
+#include <comms_lora_ebyte_e32/AUXMonitor.hpp>
+#include <condition_variable>
+#include <mutex>
+
+namespace comms_lora_ebyte_e32 {
+    /** AUX monitor whose state is controlled programmatically
+     *
+     * It is meant to be used in tests and simulations. setReady() may be
+     * called from a different thread than the one using the driver.
+     */
+    class MockAUXMonitor : public AUXMonitor {
+        std::mutex m_mutex;
+        std::condition_variable m_ready_signal;
+        bool m_ready = true;
+
+    public:
+        /** Change the AUX state */
+        void setReady(bool ready);
+
+        bool isReady();
+        bool waitReady(base::Time const& timeout);
+    };
+}
+
+#endif
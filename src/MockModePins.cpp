@@ -0,0 +1,41 @@
+#include <comms_lora_ebyte_e32/MockModePins.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+void MockModePins::setCallback(Callback callback) {
+    lock_guard<mutex> lock(m_mutex);
+    m_callback = callback;
+}
+
+void MockModePins::set(bool m0, bool m1) {
+    Callback callback;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (m_m0 == m0 && m_m1 == m1) {
+            return;
+        }
+        m_m0 = m0;
+        m_m1 = m1;
+        m_changes++;
+        callback = m_callback;
+    }
+    if (callback) {
+        callback(m0, m1);
+    }
+}
+
+bool MockModePins::getM0() const {
+    lock_guard<mutex> lock(m_mutex);
+    return m_m0;
+}
+
+bool MockModePins::getM1() const {
+    lock_guard<mutex> lock(m_mutex);
+    return m_m1;
+}
+
+int MockModePins::getChangeCount() const {
+    lock_guard<mutex> lock(m_mutex);
+    return m_changes;
+}
@@ -0,0 +1,39 @@
+#ifndef COMMS_LORA_EBYTE_E32_MOCKMODEPINS_HPP
+#define COMMS_LORA_EBYTE_E32_MOCKMODEPINS_HPP
+
+#include <comms_lora_ebyte_e32/ModePins.hpp>
+#include <functional>
+#include <mutex>
+
+namespace comms_lora_ebyte_e32 {
+    /** Mode pins that record their state
+     *
+     * It is meant to be used in tests and simulations. A callback can be
+     * registered to follow the changes, e.g. to call Simulator::setMode.
+     */
+    class MockModePins : public ModePins {
+    public:
+        typedef std::function<void (bool m0, bool m1)> Callback;
+
+    private:
+        mutable std::mutex m_mutex;
+        bool m_m0 = false;
+        bool m_m1 = false;
+        int m_changes = 0;
+        Callback m_callback;
+
+    public:
+        /** Set a callback called on each change, after the state is updated */
+        void setCallback(Callback callback);
+
+        void set(bool m0, bool m1);
+
+        bool getM0() const;
+        bool getM1() const;
+
+        /** Number of calls to set() that changed the state */
+        int getChangeCount() const;
+    };
+}
+
+#endif
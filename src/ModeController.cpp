@@ -0,0 +1,124 @@
+#include <comms_lora_ebyte_e32/ModeController.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <base-logging/Logging.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Time between AUX going high and the end of a mode switch */
+static const base::Time MODE_SWITCH_SETTLE_TIME = base::Time::fromMilliseconds(2);
+
+static void sleepFor(base::Time const& duration) {
+    this_thread::sleep_for(chrono::microseconds(duration.toMicroseconds()));
+}
+
+ModeController::Transaction::Transaction(ModeController* controller, Mode mode)
+    : m_controller(controller) {
+    if (!controller) {
+        return;
+    }
+
+    m_lock = unique_lock<recursive_mutex>(controller->m_mutex);
+    m_previous_mode = controller->getMode();
+    controller->setMode(mode);
+}
+
+ModeController::Transaction::Transaction(Transaction&& other)
+    : m_controller(other.m_controller)
+    , m_previous_mode(other.m_previous_mode)
+    , m_lock(std::move(other.m_lock)) {
+    other.m_controller = nullptr;
+}
+
+ModeController::Transaction::~Transaction() {
+    if (!m_controller) {
+        return;
+    }
+
+    // Destructors must not throw. The next switch will fail the same way,
+    // report it there
+    try {
+        m_controller->setMode(m_previous_mode);
+    }
+    catch (std::exception const& e) {
+        LOG_ERROR_S << "comms_lora_ebyte_e32::ModeController: failed to "
+                    << "restore mode " << m_previous_mode << " at the end of "
+                    << "a transaction: " << e.what() << std::endl;
+    }
+}
+
+ModeController::ModeController(ModePins& pins, AUXMonitor* aux_monitor,
+                               Mode initial_mode)
+    : m_pins(pins)
+    , m_aux_monitor(aux_monitor)
+    , m_mode(initial_mode) {
+    m_pins.set(initial_mode & 1, initial_mode & 2);
+}
+
+void ModeController::setAUXTimeout(base::Time const& timeout) {
+    m_aux_timeout = timeout;
+}
+
+void ModeController::setFallbackDelay(base::Time const& delay) {
+    m_fallback_delay = delay;
+}
+
+ModeController::Mode ModeController::getMode() const {
+    lock_guard<recursive_mutex> lock(m_mutex);
+    return m_mode;
+}
+
+void ModeController::waitIdle(base::Time const& deadline) {
+    base::Time now = base::Time::now();
+    if (!m_aux_monitor->waitReady(deadline > now ? deadline - now : base::Time())) {
+        throw iodrivers_base::TimeoutError(
+            iodrivers_base::TimeoutError::NONE,
+            "comms_lora_ebyte_e32::ModeController::setMode: AUX did not go "
+            "high in time"
+        );
+    }
+}
+
+void ModeController::setMode(Mode mode) {
+    lock_guard<recursive_mutex> lock(m_mutex);
+    if (mode == m_mode) {
+        return;
+    }
+
+    base::Time start = base::Time::now();
+    if (m_aux_monitor) {
+        // The module finishes what it is doing before switching, let it be
+        // done so that the duration measures the switch only
+        waitIdle(start + m_aux_timeout);
+    }
+
+    m_pins.set(mode & 1, mode & 2);
+    m_mode = mode;
+    if (m_aux_monitor) {
+        sleepFor(getAUXReactionTime());
+    }
+    waitReady();
+
+    base::Time duration = base::Time::now() - start;
+    m_stats.switches++;
+    m_stats.last_switch_duration = duration;
+    m_stats.max_switch_duration = std::max(m_stats.max_switch_duration, duration);
+    m_stats.total_switch_duration = m_stats.total_switch_duration + duration;
+}
+
+void ModeController::waitReady() {
+    if (m_aux_monitor) {
+        waitIdle(base::Time::now() + m_aux_timeout);
+        sleepFor(MODE_SWITCH_SETTLE_TIME);
+    }
+    else {
+        sleepFor(m_fallback_delay);
+    }
+}
+
+ModeController::Statistics ModeController::getStatistics() const {
+    lock_guard<recursive_mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,139 @@
+#ifndef COMMS_LORA_EBYTE_E32_MODECONTROLLER_HPP
+#define COMMS_LORA_EBYTE_E32_MODECONTROLLER_HPP
+
+#include <base/Time.hpp>
+#include <comms_lora_ebyte_e32/AUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/ModePins.hpp>
+#include <cstdint>
+#include <mutex>
+
+namespace comms_lora_ebyte_e32 {
+    /** Switch the module's operating mode through its M0 and M1 lines
+     *
+     * A switch waits for AUX to be high, i.e. for the module to be idle,
+     * changes the pins, and waits for AUX to be high again, which signals
+     * that the module is in the new mode. The module's documentation asks
+     * for 2ms between AUX going high and the next command, which is the
+     * only fixed delay involved. Without an AUX monitor, the switch falls
+     * back to waiting for a fixed delay (see setFallbackDelay).
+     *
+     * Transactions group the commands that need a given mode, and restore
+     * the previous mode at their end. Nested transactions for the same mode
+     * do not switch modes, which lets a read and a write of the configuration
+     * share a single stay in sleep mode. A transaction also keeps other
+     * threads from switching modes until it ends.
+     */
+    class ModeController {
+    public:
+        enum Mode {
+            /** Transmission mode (M0 = 0, M1 = 0) */
+            MODE_NORMAL,
+            /** Wake-up mode (M0 = 1, M1 = 0). Transmissions are preceded by
+             * a preamble long enough to wake up modules in power-saving mode
+             */
+            MODE_WAKE_UP,
+            /** Power-saving mode (M0 = 0, M1 = 1). The receiver only wakes
+             * up periodically, and the module does not transmit
+             */
+            MODE_POWER_SAVING,
+            /** Sleep mode (M0 = 1, M1 = 1), in which the module accepts
+             * configuration commands
+             */
+            MODE_SLEEP
+        };
+
+        struct Statistics {
+            /** Number of mode switches */
+            uint64_t switches = 0;
+            /** Duration of the last switch, from the call to its end */
+            base::Time last_switch_duration;
+            /** Longest switch */
+            base::Time max_switch_duration;
+            /** Time spent switching modes */
+            base::Time total_switch_duration;
+        };
+
+        /** Stay in a mode for the lifetime of the object
+         *
+         * The previous mode is restored on destruction. Errors while doing
+         * so are ignored, as the module will stay in the transaction's mode
+         * anyway. Call ModeController::setMode explicitly to handle them.
+         */
+        class Transaction {
+            ModeController* m_controller;
+            Mode m_previous_mode;
+            std::unique_lock<std::recursive_mutex> m_lock;
+
+        public:
+            /**
+             * @arg controller the controller, or nullptr for a transaction
+             *   that does nothing
+             * @arg mode the mode the transaction needs
+             */
+            Transaction(ModeController* controller, Mode mode);
+            Transaction(Transaction&& other);
+            ~Transaction();
+        };
+
+    private:
+        mutable std::recursive_mutex m_mutex;
+        ModePins& m_pins;
+        AUXMonitor* m_aux_monitor;
+        Mode m_mode;
+        base::Time m_aux_timeout = base::Time::fromSeconds(1);
+        base::Time m_fallback_delay = base::Time::fromMilliseconds(50);
+        Statistics m_stats;
+
+        void waitIdle(base::Time const& deadline);
+
+    public:
+        /**
+         * The pins are set to the initial mode right away, without waiting
+         *
+         * @arg pins the M0 and M1 lines
+         * @arg aux_monitor the module's AUX line, or nullptr if it is not
+         *   available. It is not owned by the controller, and must remain
+         *   valid for its lifetime.
+         * @arg initial_mode the mode the module should be in
+         */
+        ModeController(ModePins& pins, AUXMonitor* aux_monitor,
+                       Mode initial_mode = MODE_NORMAL);
+
+        /** How long a switch may wait for AUX, before and after changing
+         * the pins. It defaults to 1s
+         */
+        void setAUXTimeout(base::Time const& timeout);
+
+        /** The delay used to let the module switch modes when there is no
+         * AUX monitor. It defaults to 50ms
+         */
+        void setFallbackDelay(base::Time const& delay);
+
+        /** The current mode */
+        Mode getMode() const;
+
+        /** Switch to a mode
+         *
+         * It does nothing if the module is already in this mode
+         *
+         * @throw iodrivers_base::TimeoutError if AUX did not go high in time,
+         *   before or after the switch
+         */
+        void setMode(Mode mode);
+
+        /** Wait for the module to be ready for the next command
+         *
+         * It waits for AUX to be high, plus the settling time required by
+         * the module, or for the fallback delay if there is no AUX monitor.
+         * It is used after commands that keep the module busy, such as a
+         * configuration write.
+         *
+         * @throw iodrivers_base::TimeoutError if AUX did not go high in time
+         */
+        void waitReady();
+
+        Statistics getStatistics() const;
+    };
+}
+
+#endif
@@ -0,0 +1,6 @@
+#include <comms_lora_ebyte_e32/ModePins.hpp>
+
+using namespace comms_lora_ebyte_e32;
+
+ModePins::~ModePins() {
+}
@@ -0,0 +1,19 @@
+#ifndef COMMS_LORA_EBYTE_E32_MODEPINS_HPP
+#define COMMS_LORA_EBYTE_E32_MODEPINS_HPP
+
+namespace comms_lora_ebyte_e32 {
+    /** Interface to the module's M0 and M1 lines
+     *
+     * The two lines select the module's operating mode. Use ModeController
+     * to switch modes, as it sequences the changes with the AUX line.
+     */
+    class ModePins {
+    public:
+        virtual ~ModePins();
+
+        /** Set both lines at once */
+        virtual void set(bool m0, bool m1) = 0;
+    };
+}
+
+#endif
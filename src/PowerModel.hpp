@@ -0,0 +1,31 @@
+#ifndef COMMS_LORA_EBYTE_E32_POWERMODEL_HPP
+#define COMMS_LORA_EBYTE_E32_POWERMODEL_HPP
+
+#include <base/Time.hpp>
+
+namespace comms_lora_ebyte_e32 {
+    /** Current drawn by the module in each of its states
+     *
+     * The defaults are typical values for the 1W (30dBm) modules at full
+     * power. Check the datasheet of the actual module and power setting.
+     */
+    struct PowerModel {
+        /** Current while transmitting, in mA */
+        double transmit_current = 610;
+
+        /** Current while receiving or listening, in mA */
+        double receive_current = 15;
+
+        /** Current while sleeping between two wake-ups in power-saving
+         * mode, in mA
+         */
+        double sleep_current = 0.005;
+
+        /** Time a module in power-saving mode listens for a preamble at
+         * each wake-up
+         */
+        base::Time listen_time = base::Time::fromMilliseconds(5);
+    };
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include <comms_lora_ebyte_e32/RadioPool.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <poll.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const base::Time RadioPool::MAX_WRITE_TIME_PER_PASS =
+    base::Time::fromMilliseconds(5);
+
+RadioPool::RadioPool() {
+}
+
+RadioPool::~RadioPool() {
+}
+
+int RadioPool::add(unique_ptr<Driver> driver) {
+    int index = m_radios.size();
+
+    Radio radio;
+    radio.async.reset(new AsyncDriver(*driver));
+    radio.scheduler.reset(new TransmitScheduler(*driver));
+    radio.scheduler->setMaxWriteTime(MAX_WRITE_TIME_PER_PASS);
+    radio.driver = std::move(driver);
+    radio.start_time = base::Time::now();
+    radio.async->setReceiveCallback([this, index](uint8_t const* data, int size) {
+        m_radios[index].rx_bytes += size;
+        if (m_receive_callback) {
+            m_receive_callback(index, data, size);
+        }
+    });
+    m_radios.push_back(std::move(radio));
+    return index;
+}
+
+size_t RadioPool::size() const {
+    return m_radios.size();
+}
+
+Driver& RadioPool::getDriver(int radio) {
+    return *m_radios.at(radio).driver;
+}
+
+AsyncDriver& RadioPool::getAsyncDriver(int radio) {
+    return *m_radios.at(radio).async;
+}
+
+TransmitScheduler& RadioPool::getScheduler(int radio) {
+    return *m_radios.at(radio).scheduler;
+}
+
+void RadioPool::setReceiveCallback(ReceiveCallback callback) {
+    m_receive_callback = callback;
+}
+
+int RadioPool::route(uint8_t channel) const {
+    if (m_radios.empty()) {
+        throw std::logic_error("RadioPool: no radios");
+    }
+
+    int best = -1;
+    size_t best_depth = 0;
+    for (size_t i = 0; i < m_radios.size(); ++i) {
+        auto const& radio = m_radios[i];
+        size_t depth = radio.scheduler->getQueuedFrameCount();
+        bool on_channel = radio.driver->getLinkConfiguration().channel == channel;
+        if (on_channel) {
+            return i;
+        }
+        else if (best == -1 || depth < best_depth) {
+            best = i;
+            best_depth = depth;
+        }
+    }
+    return best;
+}
+
+int RadioPool::send(uint16_t target, uint8_t channel,
+                    uint8_t const* buffer, int bufsize, int priority) {
+    int index = route(channel);
+    if (!m_radios[index].scheduler->push(priority, target, channel, buffer, bufsize)) {
+        return -1;
+    }
+    return index;
+}
+
+base::Time RadioPool::getNextEventTime() const {
+    base::Time next;
+    for (auto const& radio : m_radios) {
+        for (base::Time t : { radio.async->getDeadline(),
+                              radio.scheduler->getNextSendTime() }) {
+            if (!t.isNull() && (next.isNull() || t < next)) {
+                next = t;
+            }
+        }
+    }
+    return next;
+}
+
+void RadioPool::poll(base::Time const& timeout) {
+    vector<pollfd> fds;
+    fds.reserve(m_radios.size());
+    for (auto const& radio : m_radios) {
+        pollfd pfd = { radio.driver->getFileDescriptor(), POLLIN, 0 };
+        fds.push_back(pfd);
+    }
+
+    base::Time now = base::Time::now();
+    base::Time wait = timeout;
+    base::Time next = getNextEventTime();
+    if (!next.isNull()) {
+        wait = std::max(base::Time(), std::min(wait, next - now));
+    }
+
+    // Round up, truncating would busy-loop on waits shorter than 1ms
+    int wait_ms = (wait.toMicroseconds() + 999) / 1000;
+    int ret = ::poll(fds.data(), fds.size(), wait_ms);
+    if (ret < 0 && errno != EINTR) {
+        throw iodrivers_base::UnixError("RadioPool::poll: poll failed");
+    }
+    process();
+}
+
+void RadioPool::process(base::Time const& now) {
+    for (auto& radio : m_radios) {
+        radio.async->process(now);
+        radio.tx_frames += radio.scheduler->update(now);
+    }
+}
+
+RadioPool::RadioStatus RadioPool::getStatus(int index, base::Time const& now) const {
+    auto const& radio = m_radios.at(index);
+    RadioStatus status;
+    status.channel = radio.driver->getLinkConfiguration().channel;
+    status.queue_depth = radio.scheduler->getQueuedFrameCount();
+    status.tx_frames = radio.tx_frames;
+    status.tx_bytes = radio.driver->getFlowControlStatistics().tx_bytes;
+    status.rx_bytes = radio.rx_bytes;
+
+    double elapsed = (now - radio.start_time).toSeconds();
+    if (elapsed > 0) {
+        status.tx_throughput = status.tx_bytes / elapsed;
+        status.rx_throughput = status.rx_bytes / elapsed;
+    }
+    return status;
+}
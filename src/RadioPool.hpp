@@ -0,0 +1,132 @@
+#ifndef COMMS_LORA_EBYTE_E32_RADIOPOOL_HPP
+#define COMMS_LORA_EBYTE_E32_RADIOPOOL_HPP
+
+#include <comms_lora_ebyte_e32/AsyncDriver.hpp>
+#include <comms_lora_ebyte_e32/TransmitScheduler.hpp>
+#include <memory>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** Drives several E32 modules from a single thread
+     *
+     * The pool owns one Driver per module, and multiplexes all of them in a
+     * single poll()-based reactor (see poll()). Each radio has its own
+     * AsyncDriver, to run commands, and its own TransmitScheduler, to pace
+     * outgoing frames.
+     *
+     * Outgoing frames are routed to the radio whose configured channel is the
+     * frame's channel, or to the least loaded radio if none is. All radios are
+     * expected to be in fixed transmission mode, which lets any of them send
+     * on any channel.
+     *
+     * Writes wait for each module's flow control (see Driver::setAUXMonitor),
+     * which would stall the other radios. The time each radio's scheduler
+     * spends writing in a single pass is therefore bounded to
+     * MAX_WRITE_TIME_PER_PASS (see TransmitScheduler::setMaxWriteTime).
+     */
+    class RadioPool {
+    public:
+        /** Default bound on the time spent writing to a single radio in each
+         * pass of the reactor
+         */
+        static const base::Time MAX_WRITE_TIME_PER_PASS;
+
+        /** Receive callback, called with the index of the radio the data
+         * comes from
+         */
+        typedef std::function<void (int, uint8_t const*, int)> ReceiveCallback;
+
+        struct RadioStatus {
+            /** The radio's channel, from its link configuration */
+            uint8_t channel = 0;
+            /** Number of frames waiting in the radio's scheduler */
+            size_t queue_depth = 0;
+            uint64_t tx_frames = 0;
+            uint64_t tx_bytes = 0;
+            uint64_t rx_bytes = 0;
+            /** Average transmitted bytes per second since the radio was added */
+            double tx_throughput = 0;
+            /** Average received bytes per second since the radio was added */
+            double rx_throughput = 0;
+        };
+
+    private:
+        struct Radio {
+            std::unique_ptr<Driver> driver;
+            std::unique_ptr<AsyncDriver> async;
+            std::unique_ptr<TransmitScheduler> scheduler;
+            base::Time start_time;
+            uint64_t tx_frames = 0;
+            uint64_t rx_bytes = 0;
+        };
+
+        std::vector<Radio> m_radios;
+        ReceiveCallback m_receive_callback;
+
+        base::Time getNextEventTime() const;
+
+    public:
+        RadioPool();
+        ~RadioPool();
+
+        /** The radios' callbacks refer to the pool, which therefore cannot
+         * be copied nor moved
+         */
+        RadioPool(RadioPool const&) = delete;
+        RadioPool(RadioPool&&) = delete;
+        RadioPool& operator=(RadioPool const&) = delete;
+        RadioPool& operator=(RadioPool&&) = delete;
+
+        /** Add a radio to the pool
+         *
+         * The driver must be open, and its link configuration set (see
+         * Driver::setLinkConfiguration or Driver::readConfiguration)
+         *
+         * @return the radio index
+         */
+        int add(std::unique_ptr<Driver> driver);
+
+        /** Number of radios in the pool */
+        size_t size() const;
+
+        /** Access the radio's driver */
+        Driver& getDriver(int radio);
+
+        /** Access the radio's asynchronous driver, to queue commands */
+        AsyncDriver& getAsyncDriver(int radio);
+
+        /** Access the radio's transmit scheduler, to tune its pacing */
+        TransmitScheduler& getScheduler(int radio);
+
+        /** Set the callback called with the data received by all radios */
+        void setReceiveCallback(ReceiveCallback callback);
+
+        /** Pick the radio a frame for the given channel should be sent from
+         *
+         * @return the radio index
+         */
+        int route(uint8_t channel) const;
+
+        /** Queue a frame on the radio selected by route()
+         *
+         * @return the index of the radio, or -1 if its queue is full
+         */
+        int send(uint16_t target, uint8_t channel,
+                 uint8_t const* buffer, int bufsize, int priority = 1);
+
+        /** Wait for events on the radios and process them
+         *
+         * It waits at most for the given timeout, less if a command times out
+         * or if a scheduler can send a frame earlier.
+         */
+        void poll(base::Time const& timeout);
+
+        /** Run the radios' state machines and schedulers without waiting */
+        void process(base::Time const& now = base::Time::now());
+
+        /** Status of a single radio */
+        RadioStatus getStatus(int radio, base::Time const& now = base::Time::now()) const;
+    };
+}
+
+#endif
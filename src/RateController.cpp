@@ -0,0 +1,101 @@
+#include <comms_lora_ebyte_e32/RateController.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Upper bound of the number of good evaluations between probes */
+static const int MAX_PROBE_INTERVAL = 64;
+
+RateController::RateController(double target_loss, int min_samples,
+                               int probe_interval)
+    : m_target_loss(target_loss)
+    , m_min_samples(min_samples)
+    , m_min_probe_interval(probe_interval)
+    , m_probe_interval(probe_interval) {
+    if (target_loss <= 0 || target_loss >= 1) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::RateController: the target loss must be "
+            "between 0 and 1"
+        );
+    }
+}
+
+double RateController::getTargetLoss() const {
+    return m_target_loss;
+}
+
+void RateController::resetSamples() {
+    m_expected = 0;
+    m_received = 0;
+}
+
+void RateController::switchFailed() {
+    if (m_probing) {
+        m_probe_interval = std::min(MAX_PROBE_INTERVAL, m_probe_interval * 2);
+        m_probing = false;
+    }
+    m_good_evaluations = 0;
+    resetSamples();
+}
+
+Configuration RateController::update(Configuration const& current,
+                                     int expected, int received) {
+    m_expected += expected;
+    m_received += received;
+    if (m_expected < m_min_samples) {
+        return current;
+    }
+
+    double loss = 1 - static_cast<double>(m_received) / m_expected;
+    resetSamples();
+
+    Configuration next = current;
+    if (loss > m_target_loss) {
+        m_good_evaluations = 0;
+        if (m_probing) {
+            m_probe_interval = std::min(MAX_PROBE_INTERVAL, m_probe_interval * 2);
+            m_probing = false;
+            next.air_rate = m_before_probe.air_rate;
+            next.transmission_power = m_before_probe.transmission_power;
+        }
+        else if (current.transmission_power != Configuration::POWER_30dBm) {
+            next.transmission_power = static_cast<Configuration::TransmissionPower>(
+                current.transmission_power - 1
+            );
+        }
+        else if (current.air_rate != Configuration::AIR_RATE_300) {
+            next.air_rate = static_cast<Configuration::AirRate>(current.air_rate - 1);
+        }
+        return next;
+    }
+
+    if (m_probing) {
+        m_probing = false;
+        m_probe_interval = std::max(m_min_probe_interval, m_probe_interval / 2);
+    }
+    if (loss > m_target_loss / 2) {
+        m_good_evaluations = 0;
+        return next;
+    }
+    if (++m_good_evaluations < m_probe_interval) {
+        return next;
+    }
+
+    m_good_evaluations = 0;
+    if (current.air_rate != Configuration::AIR_RATE_19200) {
+        next.air_rate = static_cast<Configuration::AirRate>(current.air_rate + 1);
+    }
+    else if (current.transmission_power != Configuration::POWER_21dBm) {
+        next.transmission_power = static_cast<Configuration::TransmissionPower>(
+            current.transmission_power + 1
+        );
+    }
+    else {
+        return next;
+    }
+    m_probing = true;
+    m_before_probe = current;
+    return next;
+}
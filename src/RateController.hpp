@@ -0,0 +1,69 @@
+#ifndef COMMS_LORA_EBYTE_E32_RATECONTROLLER_HPP
+#define COMMS_LORA_EBYTE_E32_RATECONTROLLER_HPP
+
+#include <comms_lora_ebyte_e32/Configuration.hpp>
+
+namespace comms_lora_ebyte_e32 {
+    /** Choose the air rate and transmission power from the observed loss
+     *
+     * The controller accumulates frame counts until it has enough samples
+     * to estimate the loss ratio, and then
+     *
+     * - when the loss is above the target, raises the transmission power,
+     *   or lowers the air rate if the power is already at its maximum. If
+     *   the previous change was a probe, it is reverted instead.
+     * - when the loss stayed below half of the target for a number of
+     *   evaluations, probes the next air rate, or the next lower power once
+     *   the air rate is at its maximum. The number of evaluations doubles
+     *   each time a probe fails, and halves back each time one succeeds.
+     *
+     * It only computes configurations. Applying them to both ends of the
+     * link is the job of LinkAdapter.
+     */
+    class RateController {
+        double m_target_loss;
+        int m_min_samples;
+        int m_min_probe_interval;
+        int m_probe_interval;
+
+        int m_expected = 0;
+        int m_received = 0;
+        int m_good_evaluations = 0;
+        bool m_probing = false;
+        Configuration m_before_probe;
+
+    public:
+        /**
+         * @arg target_loss the highest acceptable ratio of lost frames
+         * @arg min_samples the number of frames needed for an evaluation
+         * @arg probe_interval the number of good evaluations before trying a
+         *   faster or lower power configuration
+         */
+        explicit RateController(double target_loss = 0.1, int min_samples = 20,
+                                int probe_interval = 3);
+
+        double getTargetLoss() const;
+
+        /** Account for frames and propose a new configuration
+         *
+         * @arg current the configuration in use
+         * @arg expected the number of frames the peer sent
+         * @arg received the number of frames that were received
+         * @return the configuration to switch to. It is equal to current if
+         *   no change is needed.
+         */
+        Configuration update(Configuration const& current,
+                             int expected, int received);
+
+        /** Forget the accumulated samples, e.g. after a switch */
+        void resetSamples();
+
+        /** Notify that the proposed configuration could not be applied
+         *
+         * If it was a probe, it counts as a failed one
+         */
+        void switchFailed();
+    };
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include <comms_lora_ebyte_e32/Reassembler.hpp>
+#include <comms_lora_ebyte_e32/CRC.hpp>
+#include <comms_lora_ebyte_e32/Fragmenter.hpp>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+Reassembler::Reassembler(int slots, int max_message_size, base::Time const& timeout)
+    : m_slots(slots)
+    , m_max_message_size(max_message_size)
+    , m_timeout(timeout) {
+    if (slots <= 0) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::Reassembler: needs at least one slot"
+        );
+    }
+    for (auto& slot : m_slots) {
+        slot.buffer.resize(max_message_size);
+    }
+}
+
+void Reassembler::setTimeout(base::Time const& timeout) {
+    m_timeout = timeout;
+}
+
+base::Time Reassembler::getTimeout() const {
+    return m_timeout;
+}
+
+Reassembler::Result Reassembler::push(uint8_t const* fragment, int size,
+                                      base::Time const& now) {
+    m_complete_slot = -1;
+    expire(now);
+    m_stats.received_fragments++;
+
+    static const int OVERHEAD = Fragmenter::HEADER_SIZE + Fragmenter::TRAILER_SIZE;
+    int length = size - OVERHEAD;
+    if (length <= 0) {
+        m_stats.invalid_fragments++;
+        return FRAGMENT_INVALID;
+    }
+
+    uint16_t crc = (fragment[size - 2] << 8) | fragment[size - 1];
+    if (crc16(fragment, size - Fragmenter::TRAILER_SIZE) != crc) {
+        m_stats.invalid_fragments++;
+        return FRAGMENT_INVALID;
+    }
+
+    uint8_t message_id = fragment[0];
+    int index = fragment[1];
+    int count = fragment[2];
+    int data_size = fragment[3];
+    bool last = (index == count - 1);
+    if (index >= count || data_size == 0 ||
+        (last ? length > data_size : length != data_size) ||
+        (count - 1) * data_size + (last ? length : 1) > m_max_message_size) {
+        m_stats.invalid_fragments++;
+        return FRAGMENT_INVALID;
+    }
+
+    Slot& slot = findSlot(message_id, count, data_size);
+    if (slot.fragments[index]) {
+        m_stats.duplicate_fragments++;
+        return FRAGMENT_DUPLICATE;
+    }
+
+    memcpy(slot.buffer.data() + index * data_size,
+           fragment + Fragmenter::HEADER_SIZE, length);
+    slot.fragments[index] = true;
+    slot.received++;
+    slot.last_update = now;
+    if (last) {
+        slot.size = index * data_size + length;
+    }
+    if (slot.received < count) {
+        return FRAGMENT_ACCEPTED;
+    }
+
+    slot.used = false;
+    m_complete_slot = &slot - m_slots.data();
+    m_stats.completed_messages++;
+    m_stats.message_bytes += slot.size;
+    return MESSAGE_COMPLETE;
+}
+
+Reassembler::Slot& Reassembler::findSlot(uint8_t message_id,
+                                         int fragment_count, int data_size) {
+    Slot* free_slot = nullptr;
+    Slot* oldest = nullptr;
+    for (auto& slot : m_slots) {
+        if (!slot.used) {
+            free_slot = free_slot ? free_slot : &slot;
+            continue;
+        }
+        else if (slot.message_id == message_id) {
+            if (slot.fragment_count == fragment_count &&
+                slot.data_size == data_size) {
+                return slot;
+            }
+            // Same ID but different layout, this is a new message after the
+            // IDs wrapped around
+            slot.used = false;
+            free_slot = &slot;
+            m_stats.evicted_messages++;
+            break;
+        }
+
+        if (!oldest || slot.last_update < oldest->last_update) {
+            oldest = &slot;
+        }
+    }
+
+    Slot* slot = free_slot;
+    if (!slot) {
+        slot = oldest;
+        m_stats.evicted_messages++;
+    }
+    slot->used = true;
+    slot->message_id = message_id;
+    slot->fragment_count = fragment_count;
+    slot->data_size = data_size;
+    slot->received = 0;
+    slot->size = 0;
+    slot->fragments.reset();
+    return *slot;
+}
+
+uint8_t const* Reassembler::getMessage() const {
+    if (m_complete_slot < 0) {
+        throw std::logic_error(
+            "comms_lora_ebyte_e32::Reassembler::getMessage: "
+            "the last fragment did not complete a message"
+        );
+    }
+    return m_slots[m_complete_slot].buffer.data();
+}
+
+int Reassembler::getMessageSize() const {
+    if (m_complete_slot < 0) {
+        return 0;
+    }
+    return m_slots[m_complete_slot].size;
+}
+
+void Reassembler::expire(base::Time const& now) {
+    for (auto& slot : m_slots) {
+        if (slot.used && now - slot.last_update > m_timeout) {
+            slot.used = false;
+            m_stats.expired_messages++;
+        }
+    }
+}
+
+int Reassembler::getPendingMessageCount() const {
+    int count = 0;
+    for (auto const& slot : m_slots) {
+        count += slot.used ? 1 : 0;
+    }
+    return count;
+}
+
+Reassembler::Statistics Reassembler::getStatistics() const {
+    return m_stats;
+}
+
+void Reassembler::resetStatistics() {
+    m_stats = Statistics();
+}
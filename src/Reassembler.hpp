@@ -0,0 +1,112 @@
+#ifndef COMMS_LORA_EBYTE_E32_REASSEMBLER_HPP
+#define COMMS_LORA_EBYTE_E32_REASSEMBLER_HPP
+
+#include <base/Time.hpp>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** Rebuild messages from the fragments generated by Fragmenter
+     *
+     * Fragments are checked against their CRC, and may arrive in any order.
+     * Several messages can be reassembled in parallel, each in one of a fixed
+     * number of slots allocated at construction. When all slots are in use,
+     * a fragment of a new message evicts the message that made no progress
+     * for the longest time. A message that received no fragment for longer
+     * than the timeout is dropped.
+     */
+    class Reassembler {
+    public:
+        enum Result {
+            /** The fragment was malformed, or failed its CRC check */
+            FRAGMENT_INVALID,
+            /** The fragment was already received */
+            FRAGMENT_DUPLICATE,
+            /** The fragment was stored, the message is not complete yet */
+            FRAGMENT_ACCEPTED,
+            /** The fragment completed a message, see getMessage() */
+            MESSAGE_COMPLETE
+        };
+
+        struct Statistics {
+            uint64_t received_fragments = 0;
+            uint64_t invalid_fragments = 0;
+            uint64_t duplicate_fragments = 0;
+            uint64_t completed_messages = 0;
+            /** Total size of the completed messages */
+            uint64_t message_bytes = 0;
+            /** Messages dropped because they timed out */
+            uint64_t expired_messages = 0;
+            /** Messages dropped to make room for a new one */
+            uint64_t evicted_messages = 0;
+        };
+
+    private:
+        struct Slot {
+            bool used = false;
+            uint8_t message_id = 0;
+            int fragment_count = 0;
+            int data_size = 0;
+            int received = 0;
+            int size = 0;
+            base::Time last_update;
+            std::bitset<256> fragments;
+            std::vector<uint8_t> buffer;
+        };
+
+        std::vector<Slot> m_slots;
+        int m_max_message_size;
+        base::Time m_timeout;
+        int m_complete_slot = -1;
+        Statistics m_stats;
+
+        Slot& findSlot(uint8_t message_id, int fragment_count, int data_size);
+
+    public:
+        /**
+         * @arg slots how many messages can be reassembled in parallel
+         * @arg max_message_size the maximum size of a message. Fragments of
+         *   larger messages are rejected as invalid
+         * @arg timeout how long a message may wait for its next fragment
+         */
+        Reassembler(int slots = 4, int max_message_size = 4096,
+                    base::Time const& timeout = base::Time::fromSeconds(10));
+
+        /** Set how long a message may wait for its next fragment */
+        void setTimeout(base::Time const& timeout);
+
+        /** How long a message may wait for its next fragment */
+        base::Time getTimeout() const;
+
+        /** Process a received fragment
+         *
+         * It first drops the messages that timed out
+         */
+        Result push(uint8_t const* fragment, int size, base::Time const& now);
+
+        /** The message completed by the last call to push
+         *
+         * It remains valid until the next call to push
+         */
+        uint8_t const* getMessage() const;
+
+        /** Size of the message completed by the last call to push */
+        int getMessageSize() const;
+
+        /** Drop the messages that received no fragment for longer than the
+         * timeout
+         */
+        void expire(base::Time const& now);
+
+        /** Number of messages being reassembled */
+        int getPendingMessageCount() const;
+
+        Statistics getStatistics() const;
+
+        /** Reset the statistics */
+        void resetStatistics();
+    };
+}
+
+#endif
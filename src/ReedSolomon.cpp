@@ -0,0 +1,156 @@
+#include <comms_lora_ebyte_e32/ReedSolomon.hpp>
+#include <comms_lora_ebyte_e32/GF256.hpp>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const int ReedSolomon::MAX_SHARDS;
+
+/** Invert a size x size matrix by Gauss-Jordan elimination
+ *
+ * @return false if the matrix is singular
+ */
+static bool invert(vector<uint8_t> matrix, vector<uint8_t>& inverse, int size) {
+    inverse.assign(size * size, 0);
+    for (int i = 0; i < size; ++i) {
+        inverse[i * size + i] = 1;
+    }
+
+    for (int col = 0; col < size; ++col) {
+        int pivot = col;
+        while (pivot < size && matrix[pivot * size + col] == 0) {
+            ++pivot;
+        }
+        if (pivot == size) {
+            return false;
+        }
+        if (pivot != col) {
+            for (int i = 0; i < size; ++i) {
+                swap(matrix[pivot * size + i], matrix[col * size + i]);
+                swap(inverse[pivot * size + i], inverse[col * size + i]);
+            }
+        }
+
+        uint8_t scale = gf256Inverse(matrix[col * size + col]);
+        for (int i = 0; i < size; ++i) {
+            matrix[col * size + i] = gf256Multiply(matrix[col * size + i], scale);
+            inverse[col * size + i] = gf256Multiply(inverse[col * size + i], scale);
+        }
+        for (int row = 0; row < size; ++row) {
+            uint8_t factor = matrix[row * size + col];
+            if (row == col || factor == 0) {
+                continue;
+            }
+            gf256MultiplyAdd(&matrix[row * size], &matrix[col * size], factor, size);
+            gf256MultiplyAdd(&inverse[row * size], &inverse[col * size], factor, size);
+        }
+    }
+    return true;
+}
+
+ReedSolomon::ReedSolomon(int data_shards, int parity_shards)
+    : m_data_shards(data_shards)
+    , m_parity_shards(parity_shards) {
+    if (data_shards < 1 || parity_shards < 0 ||
+        data_shards + parity_shards > MAX_SHARDS) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::ReedSolomon: invalid shard counts " +
+            std::to_string(data_shards) + "+" + std::to_string(parity_shards)
+        );
+    }
+
+    // Vandermonde matrix, whose row r is (r^0, r^1, ...). Any data_shards of
+    // its rows are linearly independent
+    int total = data_shards + parity_shards;
+    vector<uint8_t> vandermonde(total * data_shards);
+    for (int r = 0; r < total; ++r) {
+        uint8_t value = 1;
+        for (int c = 0; c < data_shards; ++c) {
+            vandermonde[r * data_shards + c] = value;
+            value = gf256Multiply(value, r);
+        }
+    }
+
+    // Multiply by the inverse of the top square so that the code is
+    // systematic. This preserves the independence of the rows.
+    vector<uint8_t> top(vandermonde.begin(),
+                        vandermonde.begin() + data_shards * data_shards);
+    vector<uint8_t> top_inverse;
+    invert(top, top_inverse, data_shards);
+
+    m_matrix.assign(total * data_shards, 0);
+    for (int r = 0; r < total; ++r) {
+        for (int k = 0; k < data_shards; ++k) {
+            gf256MultiplyAdd(&m_matrix[r * data_shards],
+                             &top_inverse[k * data_shards],
+                             vandermonde[r * data_shards + k], data_shards);
+        }
+    }
+}
+
+int ReedSolomon::getDataShards() const {
+    return m_data_shards;
+}
+
+int ReedSolomon::getParityShards() const {
+    return m_parity_shards;
+}
+
+void ReedSolomon::encode(uint8_t const* const* data, uint8_t* const* parity,
+                         int shard_size) const {
+    for (int p = 0; p < m_parity_shards; ++p) {
+        uint8_t const* row = &m_matrix[(m_data_shards + p) * m_data_shards];
+        memset(parity[p], 0, shard_size);
+        for (int d = 0; d < m_data_shards; ++d) {
+            gf256MultiplyAdd(parity[p], data[d], row[d], shard_size);
+        }
+    }
+}
+
+bool ReedSolomon::reconstruct(uint8_t* const* shards,
+                              vector<bool> const& present,
+                              int shard_size) const {
+    bool complete = true;
+    for (int i = 0; i < m_data_shards; ++i) {
+        complete = complete && present[i];
+    }
+    if (complete) {
+        return true;
+    }
+
+    // Use the first data_shards shards that are present
+    vector<int> used;
+    for (int i = 0; i < m_data_shards + m_parity_shards &&
+                    static_cast<int>(used.size()) < m_data_shards; ++i) {
+        if (present[i]) {
+            used.push_back(i);
+        }
+    }
+    if (static_cast<int>(used.size()) < m_data_shards) {
+        return false;
+    }
+
+    vector<uint8_t> submatrix(m_data_shards * m_data_shards);
+    for (int r = 0; r < m_data_shards; ++r) {
+        memcpy(&submatrix[r * m_data_shards], &m_matrix[used[r] * m_data_shards],
+               m_data_shards);
+    }
+    vector<uint8_t> decoding;
+    invert(submatrix, decoding, m_data_shards);
+
+    // The used shards include the data shards that are present, so the
+    // missing ones can be overwritten as they are computed
+    for (int d = 0; d < m_data_shards; ++d) {
+        if (present[d]) {
+            continue;
+        }
+        memset(shards[d], 0, shard_size);
+        for (int k = 0; k < m_data_shards; ++k) {
+            gf256MultiplyAdd(shards[d], shards[used[k]],
+                             decoding[d * m_data_shards + k], shard_size);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef COMMS_LORA_EBYTE_E32_REEDSOLOMON_HPP
+#define COMMS_LORA_EBYTE_E32_REEDSOLOMON_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** Systematic Reed-Solomon erasure code over GF(2^8)
+     *
+     * The code works on shards, i.e. equal-size byte buffers. From
+     * data_shards data shards, it computes parity_shards parity shards, such
+     * that any data_shards shards out of the total are enough to recover the
+     * data. The i-th bytes of all the shards form a codeword, so the shards
+     * are a byte interleaving of shard-size codewords, and losing a shard
+     * is a single erasure in each of them.
+     *
+     * The encoding matrix is derived from a Vandermonde matrix, normalized
+     * so that its first rows are the identity.
+     */
+    class ReedSolomon {
+        int m_data_shards;
+        int m_parity_shards;
+        /** Encoding matrix, row-major, one row per shard */
+        std::vector<uint8_t> m_matrix;
+
+    public:
+        /** Maximum total number of shards */
+        static const int MAX_SHARDS = 255;
+
+        /**
+         * @throw std::invalid_argument if there is no data shard, or more
+         *   than MAX_SHARDS shards in total
+         */
+        ReedSolomon(int data_shards, int parity_shards);
+
+        int getDataShards() const;
+        int getParityShards() const;
+
+        /** Compute the parity shards
+         *
+         * @arg data the data_shards data shards
+         * @arg parity the parity_shards parity shards, overwritten
+         */
+        void encode(uint8_t const* const* data, uint8_t* const* parity,
+                    int shard_size) const;
+
+        /** Recover the missing data shards
+         *
+         * Missing parity shards are not recomputed
+         *
+         * @arg shards all the shards, data shards first. The missing data
+         *   shards are written
+         * @arg present whether each shard was received
+         * @return false if fewer than data_shards shards are present
+         */
+        bool reconstruct(uint8_t* const* shards,
+                         std::vector<bool> const& present,
+                         int shard_size) const;
+    };
+}
+
+#endif
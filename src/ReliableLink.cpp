@@ -0,0 +1,404 @@
+#include <comms_lora_ebyte_e32/ReliableLink.hpp>
+#include <comms_lora_ebyte_e32/CRC.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const uint8_t ReliableLink::FLAG_DATA;
+const uint8_t ReliableLink::FLAG_ACK;
+const int ReliableLink::HEADER_SIZE;
+const int ReliableLink::TRAILER_SIZE;
+const int ReliableLink::MAX_WINDOW;
+const int ReliableLink::DEFAULT_MAX_PACKET_SIZE;
+
+/** Upper bound of the retransmission timeout when backing off */
+static const base::Time MAX_RTO = base::Time::fromSeconds(60);
+
+/** Size of the driver's framing in fixed transmission mode */
+static const int FRAMING_SIZE =
+    Driver::FIXED_TRANSMISSION_HEADER_SIZE + Driver::FRAME_HEADER_SIZE;
+
+ReliableLink::ReliableLink(Driver& driver, uint16_t peer_address,
+                           uint8_t peer_channel, int window, int max_packet_size)
+    : m_driver(driver)
+    , m_peer_address(peer_address)
+    , m_peer_channel(peer_channel)
+    , m_window(window)
+    , m_max_packet_size(max_packet_size)
+    , m_frame(HEADER_SIZE + max_packet_size + TRAILER_SIZE) {
+    if (window < 1 || window > MAX_WINDOW) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::ReliableLink: window must be between 1 and " +
+            std::to_string(MAX_WINDOW)
+        );
+    }
+    if (max_packet_size < 1 ||
+        static_cast<int>(m_frame.size()) > Driver::MAX_FRAME_PAYLOAD_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::ReliableLink: packets must fit in a frame"
+        );
+    }
+
+    for (auto& slot : m_tx) {
+        slot.data.resize(max_packet_size);
+    }
+    for (auto& slot : m_rx) {
+        slot.data.resize(max_packet_size);
+    }
+    m_driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+
+    // Before the first sample, assume that the last frame of a full window
+    // waits for all the others in the module's buffer
+    Configuration const& conf = m_driver.getLinkConfiguration();
+    int frame_size = FRAMING_SIZE + m_frame.size();
+    m_rto = (getAirtime(conf, frame_size * window) + getMinRTO()) * 2.0;
+}
+
+int ReliableLink::getWindow() const {
+    return m_window;
+}
+
+int ReliableLink::getMaxPacketSize() const {
+    return m_max_packet_size;
+}
+
+void ReliableLink::setMaxQueueSize(size_t size) {
+    m_max_queue_size = size;
+}
+
+base::Time ReliableLink::getAckDelay() const {
+    // Leave room for the next frame of a burst, so that the acknowledgment
+    // does not collide with it
+    return getPacketGap(m_driver.getLinkConfiguration()) * 2.0;
+}
+
+base::Time ReliableLink::getMinRTO() const {
+    Configuration const& conf = m_driver.getLinkConfiguration();
+    int frame_size = FRAMING_SIZE + m_frame.size();
+    int ack_size = FRAMING_SIZE + HEADER_SIZE + TRAILER_SIZE;
+    return getUARTTransferTime(conf, frame_size) + getAirtime(conf, frame_size) +
+           getAckDelay() +
+           getAirtime(conf, ack_size) + getUARTTransferTime(conf, ack_size);
+}
+
+void ReliableLink::updateRTO(base::Time const& sample) {
+    if (!m_has_rtt) {
+        m_srtt = sample;
+        m_rttvar = sample / 2;
+        m_has_rtt = true;
+    }
+    else {
+        base::Time error = m_srtt > sample ? m_srtt - sample : sample - m_srtt;
+        m_rttvar = m_rttvar * 0.75 + error * 0.25;
+        m_srtt = m_srtt * 0.875 + sample * 0.125;
+    }
+    m_rto = std::max(getMinRTO(), m_srtt + m_rttvar * 4.0);
+}
+
+bool ReliableLink::send(uint8_t const* data, int size) {
+    if (size <= 0 || size > m_max_packet_size) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::ReliableLink::send: packet size must be "
+            "between 1 and " + std::to_string(m_max_packet_size)
+        );
+    }
+    if (m_send_queue.size() >= m_max_queue_size) {
+        return false;
+    }
+    m_send_queue.push_back(vector<uint8_t>(data, data + size));
+    return true;
+}
+
+int ReliableLink::encodeFrame(uint8_t flags, uint8_t seq,
+                              uint8_t const* data, int size) {
+    uint16_t sack = 0;
+    for (int i = 0; i < 16; ++i) {
+        uint8_t sacked = m_rx_base + 1 + i;
+        if (static_cast<uint8_t>(sacked - m_rx_base) < MAX_WINDOW &&
+            m_rx[sacked % MAX_WINDOW].used) {
+            sack |= 1 << i;
+        }
+    }
+
+    m_frame[0] = flags | FLAG_ACK;
+    m_frame[1] = seq;
+    m_frame[2] = m_rx_base;
+    m_frame[3] = sack >> 8;
+    m_frame[4] = sack & 0xff;
+    if (size > 0) {
+        memcpy(m_frame.data() + HEADER_SIZE, data, size);
+    }
+    uint16_t crc = crc16(m_frame.data(), HEADER_SIZE + size);
+    m_frame[HEADER_SIZE + size] = crc >> 8;
+    m_frame[HEADER_SIZE + size + 1] = crc & 0xff;
+    m_ack_pending = false;
+    return HEADER_SIZE + size + TRAILER_SIZE;
+}
+
+void ReliableLink::writeFrame(int size) {
+    if (m_driver.writeFrame(m_peer_address, m_peer_channel,
+                            m_frame.data(), size) == 0) {
+        throw iodrivers_base::TimeoutError(
+            iodrivers_base::TimeoutError::PACKET,
+            "comms_lora_ebyte_e32::ReliableLink: timed out writing a frame"
+        );
+    }
+}
+
+void ReliableLink::transmit(uint8_t seq, base::Time const& now) {
+    TxSlot& slot = m_tx[seq % MAX_WINDOW];
+    if (slot.transmissions > 0) {
+        m_stats.retransmissions++;
+    }
+    slot.fast_retransmit = false;
+
+    writeFrame(encodeFrame(FLAG_DATA, seq, slot.data.data(), slot.size));
+    slot.transmissions++;
+    slot.sent_time = now;
+    slot.deadline = slot.sent_time + m_rto;
+    m_stats.sent_frames++;
+}
+
+base::Time ReliableLink::update(base::Time const& now) {
+    while (!m_send_queue.empty() &&
+           static_cast<uint8_t>(m_tx_next - m_tx_base) < m_window) {
+        TxSlot& slot = m_tx[m_tx_next % MAX_WINDOW];
+        auto const& packet = m_send_queue.front();
+        memcpy(slot.data.data(), packet.data(), packet.size());
+        slot.size = packet.size();
+        slot.used = true;
+        slot.acked = false;
+        slot.fast_retransmit = false;
+        slot.transmissions = 0;
+        m_send_queue.pop_front();
+        m_tx_next++;
+    }
+
+    // Back off once per timeout, however many frames of the window it
+    // affects
+    for (uint8_t seq = m_tx_base; seq != m_tx_next; ++seq) {
+        TxSlot const& slot = m_tx[seq % MAX_WINDOW];
+        if (!slot.acked && slot.transmissions > 0 && !slot.fast_retransmit &&
+            slot.deadline <= now) {
+            m_rto = std::min(MAX_RTO, m_rto * 2.0);
+            break;
+        }
+    }
+
+    base::Time next = base::Time::max();
+    for (uint8_t seq = m_tx_base; seq != m_tx_next; ++seq) {
+        TxSlot& slot = m_tx[seq % MAX_WINDOW];
+        if (slot.acked) {
+            continue;
+        }
+        if (slot.transmissions == 0 || slot.fast_retransmit ||
+            slot.deadline <= now) {
+            transmit(seq, now);
+        }
+        next = std::min(next, slot.deadline);
+    }
+
+    if (m_ack_pending) {
+        if (now >= m_ack_deadline) {
+            writeFrame(encodeFrame(0, 0, nullptr, 0));
+            m_stats.sent_acks++;
+        }
+        else {
+            next = std::min(next, m_ack_deadline);
+        }
+    }
+    return next;
+}
+
+void ReliableLink::handleFrame(uint8_t const* frame, int size,
+                               base::Time const& now) {
+    m_stats.received_frames++;
+    int data_size = size - HEADER_SIZE - TRAILER_SIZE;
+    if (data_size < 0 || data_size > m_max_packet_size) {
+        m_stats.invalid_frames++;
+        return;
+    }
+    uint16_t crc = (frame[size - 2] << 8) | frame[size - 1];
+    if (crc16(frame, size - TRAILER_SIZE) != crc) {
+        m_stats.invalid_frames++;
+        return;
+    }
+
+    uint8_t flags = frame[0];
+    if (flags & FLAG_ACK) {
+        handleAck(frame[2], (frame[3] << 8) | frame[4], now);
+    }
+    if (flags & FLAG_DATA) {
+        handleData(frame[1], frame + HEADER_SIZE, data_size, now);
+    }
+}
+
+void ReliableLink::handleAck(uint8_t ack, uint16_t sack, base::Time const& now) {
+    uint8_t in_flight = m_tx_next - m_tx_base;
+    if (static_cast<uint8_t>(ack - m_tx_base) > in_flight) {
+        // Stale acknowledgment
+        return;
+    }
+
+    auto acknowledge = [this, &now](uint8_t seq) {
+        TxSlot& slot = m_tx[seq % MAX_WINDOW];
+        if (slot.acked) {
+            return;
+        }
+        slot.acked = true;
+        m_stats.acknowledged_packets++;
+        // Karn's algorithm: the RTT of retransmitted frames is ambiguous
+        if (slot.transmissions == 1) {
+            updateRTO(now - slot.sent_time);
+        }
+    };
+
+    for (uint8_t seq = m_tx_base; seq != ack; ++seq) {
+        acknowledge(seq);
+    }
+    for (int i = 0; i < 16; ++i) {
+        uint8_t seq = ack + 1 + i;
+        if ((sack & (1 << i)) &&
+            static_cast<uint8_t>(seq - m_tx_base) < in_flight) {
+            acknowledge(seq);
+        }
+    }
+
+    while (m_tx_base != m_tx_next && m_tx[m_tx_base % MAX_WINDOW].acked) {
+        m_tx[m_tx_base % MAX_WINDOW].used = false;
+        m_tx_base++;
+    }
+
+    // The link does not reorder frames. An unacknowledged frame sent before
+    // an acknowledged one is lost.
+    base::Time last_acked;
+    for (uint8_t seq = m_tx_base; seq != m_tx_next; ++seq) {
+        TxSlot const& slot = m_tx[seq % MAX_WINDOW];
+        if (slot.acked) {
+            last_acked = std::max(last_acked, slot.sent_time);
+        }
+    }
+    for (uint8_t seq = m_tx_base; seq != m_tx_next; ++seq) {
+        TxSlot& slot = m_tx[seq % MAX_WINDOW];
+        if (!slot.acked && slot.transmissions > 0 &&
+            slot.sent_time < last_acked) {
+            slot.fast_retransmit = true;
+        }
+    }
+}
+
+void ReliableLink::handleData(uint8_t seq, uint8_t const* data, int size,
+                              base::Time const& now) {
+    m_ack_pending = true;
+    m_ack_deadline = now + getAckDelay();
+
+    uint8_t offset = seq - m_rx_base;
+    if (offset >= 128) {
+        // Already delivered, our acknowledgment was lost
+        m_stats.duplicate_frames++;
+        return;
+    }
+    else if (offset >= MAX_WINDOW) {
+        m_stats.invalid_frames++;
+        return;
+    }
+
+    RxSlot& slot = m_rx[seq % MAX_WINDOW];
+    if (slot.used) {
+        m_stats.duplicate_frames++;
+        return;
+    }
+    memcpy(slot.data.data(), data, size);
+    slot.size = size;
+    slot.used = true;
+
+    while (m_rx[m_rx_base % MAX_WINDOW].used) {
+        RxSlot& next = m_rx[m_rx_base % MAX_WINDOW];
+        m_delivered.push_back(
+            vector<uint8_t>(next.data.begin(), next.data.begin() + next.size)
+        );
+        m_stats.delivered_packets++;
+        m_stats.delivered_bytes += next.size;
+        next.used = false;
+        m_rx_base++;
+    }
+}
+
+void ReliableLink::step(base::Time const& deadline) {
+    base::Time next = update(base::Time::now());
+
+    base::Time now = base::Time::now();
+    base::Time wait_until = std::min(next, deadline);
+    base::Time timeout = wait_until > now ? wait_until - now : base::Time();
+    uint8_t packet[Driver::MAX_PACKET_SIZE];
+    int size;
+    try {
+        size = m_driver.readPacket(packet, Driver::MAX_PACKET_SIZE, timeout);
+    }
+    catch (iodrivers_base::TimeoutError const&) {
+        return;
+    }
+    handleFrame(packet + Driver::FRAME_HEADER_SIZE,
+                size - Driver::FRAME_HEADER_SIZE, base::Time::now());
+}
+
+int ReliableLink::receive(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    while (m_delivered.empty()) {
+        if (base::Time::now() >= deadline) {
+            throw iodrivers_base::TimeoutError(
+                iodrivers_base::TimeoutError::PACKET,
+                "comms_lora_ebyte_e32::ReliableLink::receive: "
+                "no packet received"
+            );
+        }
+        step(deadline);
+    }
+
+    vector<uint8_t> packet = std::move(m_delivered.front());
+    m_delivered.pop_front();
+    if (static_cast<int>(packet.size()) > bufsize) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::ReliableLink::receive: received a " +
+            std::to_string(packet.size()) + " bytes packet in a " +
+            std::to_string(bufsize) + " bytes buffer"
+        );
+    }
+    memcpy(buffer, packet.data(), packet.size());
+    return packet.size();
+}
+
+void ReliableLink::process(base::Time const& duration) {
+    base::Time deadline = base::Time::now() + duration;
+    while (base::Time::now() < deadline) {
+        step(deadline);
+    }
+}
+
+bool ReliableLink::flush(base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    while (hasPendingPackets() && base::Time::now() < deadline) {
+        step(deadline);
+    }
+    return !hasPendingPackets();
+}
+
+bool ReliableLink::hasPendingPackets() const {
+    return !m_send_queue.empty() || m_tx_base != m_tx_next;
+}
+
+base::Time ReliableLink::getRTO() const {
+    return m_rto;
+}
+
+base::Time ReliableLink::getSRTT() const {
+    return m_has_rtt ? m_srtt : base::Time();
+}
+
+ReliableLink::Statistics ReliableLink::getStatistics() const {
+    return m_stats;
+}
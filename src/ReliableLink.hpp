@@ -0,0 +1,206 @@
+#ifndef COMMS_LORA_EBYTE_E32_RELIABLELINK_HPP
+#define COMMS_LORA_EBYTE_E32_RELIABLELINK_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Reliable, in-order delivery of packets to a single peer
+     *
+     * This implements selective-repeat ARQ on top of fixed transmission
+     * mode. Packets are sent as length-prefixed frames (Driver::writeFrame)
+     * to the peer's address and channel, and are laid out as
+     *
+     * - flags (1 byte, FLAG_DATA and/or FLAG_ACK)
+     * - sequence number of the data (1 byte)
+     * - cumulative acknowledgment, i.e. the next expected sequence number
+     *   (1 byte)
+     * - selective acknowledgment of the 16 sequence numbers that follow the
+     *   cumulative acknowledgment (2 bytes, big endian, bit 0 is ack + 1)
+     * - data
+     * - CRC16 of all the above (2 bytes, big endian)
+     *
+     * Acknowledgments are piggybacked on data frames. When there is no data
+     * to send, a pure acknowledgment is sent once the peer's transmission is
+     * over, i.e. after twice the packet gap (see getPacketGap). Frames are
+     * retransmitted when their retransmission timeout expires, or as soon as
+     * a selective acknowledgment shows that a later frame went through.
+     *
+     * The retransmission timeout starts from an estimate of the round trip
+     * based on the link configuration (see Driver::getLinkConfiguration),
+     * and is then refined from the measured round-trip times. It is
+     * never lower than the airtime of a frame and its acknowledgment.
+     *
+     * The protocol only progresses while one of receive(), process() or
+     * flush() is running. A window of 1 is stop-and-wait.
+     */
+    class ReliableLink {
+    public:
+        static const uint8_t FLAG_DATA = 1;
+        static const uint8_t FLAG_ACK = 2;
+
+        /** Size of the frame header */
+        static const int HEADER_SIZE = 5;
+
+        /** Size of the frame trailer (CRC) */
+        static const int TRAILER_SIZE = 2;
+
+        /** Largest window, bound by the selective acknowledgment field */
+        static const int MAX_WINDOW = 16;
+
+        /** Default maximum packet size
+         *
+         * It is the largest packet whose frame fits in one sub-packet
+         */
+        static const int DEFAULT_MAX_PACKET_SIZE = 46;
+
+        struct Statistics {
+            /** Data frames sent, including retransmissions */
+            uint64_t sent_frames = 0;
+            uint64_t retransmissions = 0;
+            /** Acknowledgments sent without data */
+            uint64_t sent_acks = 0;
+            uint64_t received_frames = 0;
+            /** Frames that failed the CRC check or were out of the window */
+            uint64_t invalid_frames = 0;
+            uint64_t duplicate_frames = 0;
+            /** Packets acknowledged by the peer */
+            uint64_t acknowledged_packets = 0;
+            /** Packets delivered in order */
+            uint64_t delivered_packets = 0;
+            uint64_t delivered_bytes = 0;
+        };
+
+    private:
+        struct TxSlot {
+            bool used = false;
+            bool acked = false;
+            /** Set when a selective acknowledgment showed that the frame was
+             * lost, to retransmit it without waiting for its timeout
+             */
+            bool fast_retransmit = false;
+            int size = 0;
+            int transmissions = 0;
+            base::Time sent_time;
+            base::Time deadline;
+            std::vector<uint8_t> data;
+        };
+
+        struct RxSlot {
+            bool used = false;
+            int size = 0;
+            std::vector<uint8_t> data;
+        };
+
+        Driver& m_driver;
+        uint16_t m_peer_address;
+        uint8_t m_peer_channel;
+        int m_window;
+        int m_max_packet_size;
+        size_t m_max_queue_size = 64;
+
+        std::deque<std::vector<uint8_t>> m_send_queue;
+        TxSlot m_tx[MAX_WINDOW];
+        uint8_t m_tx_base = 0;
+        uint8_t m_tx_next = 0;
+
+        RxSlot m_rx[MAX_WINDOW];
+        uint8_t m_rx_base = 0;
+        std::deque<std::vector<uint8_t>> m_delivered;
+        bool m_ack_pending = false;
+        base::Time m_ack_deadline;
+
+        bool m_has_rtt = false;
+        base::Time m_srtt;
+        base::Time m_rttvar;
+        base::Time m_rto;
+
+        std::vector<uint8_t> m_frame;
+        Statistics m_stats;
+
+        base::Time getMinRTO() const;
+        base::Time getAckDelay() const;
+        void updateRTO(base::Time const& sample);
+        int encodeFrame(uint8_t flags, uint8_t seq,
+                        uint8_t const* data, int size);
+        void writeFrame(int size);
+        void transmit(uint8_t seq, base::Time const& now);
+        void handleFrame(uint8_t const* frame, int size, base::Time const& now);
+        void handleAck(uint8_t ack, uint16_t sack, base::Time const& now);
+        void handleData(uint8_t seq, uint8_t const* data, int size,
+                        base::Time const& now);
+        base::Time update(base::Time const& now);
+        void step(base::Time const& deadline);
+
+    public:
+        /**
+         * @arg driver the driver, whose module must be in fixed transmission
+         *   mode. Its packet mode is changed to PACKET_MODE_LENGTH_PREFIXED
+         * @arg peer_address the address of the peer's module
+         * @arg peer_channel the channel of the peer's module
+         * @arg window how many packets may be in flight, at most MAX_WINDOW
+         * @arg max_packet_size the largest packet that can be sent
+         */
+        ReliableLink(Driver& driver, uint16_t peer_address, uint8_t peer_channel,
+                     int window = 8, int max_packet_size = DEFAULT_MAX_PACKET_SIZE);
+
+        /** The window size */
+        int getWindow() const;
+
+        /** The largest packet that can be sent */
+        int getMaxPacketSize() const;
+
+        /** Set the maximum number of packets waiting to enter the window */
+        void setMaxQueueSize(size_t size);
+
+        /** Queue a packet
+         *
+         * It is sent by the next call to receive(), process() or flush()
+         *
+         * @return false if the queue is full
+         * @throw std::invalid_argument if the packet is larger than
+         *   getMaxPacketSize()
+         */
+        bool send(uint8_t const* data, int size);
+
+        /** Wait for the next in-order packet
+         *
+         * @return the packet size
+         * @throw iodrivers_base::TimeoutError if no packet was delivered within
+         *   the timeout
+         * @throw std::invalid_argument if the buffer is too small for the
+         *   packet. The packet is dropped.
+         */
+        int receive(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
+        /** Run the protocol for the given amount of time
+         *
+         * Packets received in the meantime are kept for receive()
+         */
+        void process(base::Time const& duration);
+
+        /** Run the protocol until all queued packets are acknowledged
+         *
+         * @return false if some packets were still not acknowledged at the
+         *   timeout
+         */
+        bool flush(base::Time const& timeout);
+
+        /** Whether some packets are queued or not yet acknowledged */
+        bool hasPendingPackets() const;
+
+        /** The current retransmission timeout */
+        base::Time getRTO() const;
+
+        /** The smoothed round-trip time, or zero if there was no sample yet */
+        base::Time getSRTT() const;
+
+        Statistics getStatistics() const;
+    };
+}
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef COMMS_LORA_EBYTE_E32_SPSCRING_HPP
+#define COMMS_LORA_EBYTE_E32_SPSCRING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** Lock-free single-producer/single-consumer ring of preallocated slots
+     *
+     * The slots are allocated at construction. The producer fills the slot
+     * returned by beginPush() in place and publishes it with commitPush(), and
+     * the consumer reads the slot returned by front() in place and releases
+     * it with pop(). Neither side allocates, locks or copies the elements.
+     *
+     * Exactly one thread may push and one thread may pop at any given time.
+     * The size and high-water mark may be read from any thread.
+     */
+    template<typename T>
+    class SPSCRing {
+        /** Assumed size of a cache line, used to keep the producer and
+         * consumer indexes from sharing one
+         */
+        static const size_t CACHE_LINE_SIZE = 64;
+
+        std::vector<T> m_slots;
+
+        /** Number of pushed elements, written by the producer */
+        std::atomic<size_t> m_head;
+        /** Producer's last read of m_tail */
+        size_t m_cached_tail = 0;
+        /** Largest size seen by the producer after a push */
+        std::atomic<size_t> m_high_water_mark;
+        char m_padding[CACHE_LINE_SIZE];
+
+        /** Number of popped elements, written by the consumer */
+        std::atomic<size_t> m_tail;
+        /** Consumer's last read of m_head */
+        size_t m_cached_head = 0;
+
+    public:
+        explicit SPSCRing(size_t capacity)
+            : m_slots(capacity)
+            , m_head(0)
+            , m_high_water_mark(0)
+            , m_tail(0) {
+            if (capacity == 0) {
+                throw std::invalid_argument(
+                    "comms_lora_ebyte_e32::SPSCRing: capacity must be positive"
+                );
+            }
+        }
+
+        SPSCRing(SPSCRing const&) = delete;
+        SPSCRing& operator=(SPSCRing const&) = delete;
+
+        /** Number of slots */
+        size_t capacity() const {
+            return m_slots.size();
+        }
+
+        /** Number of published elements not yet popped
+         *
+         * When called from another thread than the producer and consumer, it
+         * is only a snapshot
+         */
+        size_t size() const {
+            size_t tail = m_tail.load(std::memory_order_acquire);
+            return m_head.load(std::memory_order_acquire) - tail;
+        }
+
+        /** Whether no published element is waiting */
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /** Largest number of elements that have been in the ring at once */
+        size_t getHighWaterMark() const {
+            return m_high_water_mark.load(std::memory_order_relaxed);
+        }
+
+        /** Reset the high-water mark
+         *
+         * Producer side only
+         */
+        void resetHighWaterMark() {
+            m_high_water_mark.store(0, std::memory_order_relaxed);
+        }
+
+        /** The slot to fill for the next push, or nullptr if the ring is full
+         *
+         * Producer side only. The slot holds whatever it held the last time
+         * it was used.
+         */
+        T* beginPush() {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (head - m_cached_tail == m_slots.size()) {
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+                if (head - m_cached_tail == m_slots.size()) {
+                    return nullptr;
+                }
+            }
+            return &m_slots[head % m_slots.size()];
+        }
+
+        /** Publish the slot returned by the last beginPush()
+         *
+         * Producer side only
+         */
+        void commitPush() {
+            size_t head = m_head.load(std::memory_order_relaxed) + 1;
+            m_head.store(head, std::memory_order_release);
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            size_t size = head - m_cached_tail;
+            if (size > m_high_water_mark.load(std::memory_order_relaxed)) {
+                m_high_water_mark.store(size, std::memory_order_relaxed);
+            }
+        }
+
+        /** Copy an element into the ring
+         *
+         * Producer side only
+         *
+         * @return false if the ring is full
+         */
+        bool push(T const& value) {
+            T* slot = beginPush();
+            if (!slot) {
+                return false;
+            }
+            *slot = value;
+            commitPush();
+            return true;
+        }
+
+        /** The oldest published element, or nullptr if the ring is empty
+         *
+         * Consumer side only. The element stays valid until pop() is called.
+         */
+        T* front() {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_cached_head) {
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                if (tail == m_cached_head) {
+                    return nullptr;
+                }
+            }
+            return &m_slots[tail % m_slots.size()];
+        }
+
+        /** Release the element returned by front()
+         *
+         * Consumer side only
+         */
+        void pop() {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            m_tail.store(tail + 1, std::memory_order_release);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include <comms_lora_ebyte_e32/SavedConfigurationCache.hpp>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+static bool fromHex(string const& hex, Configuration& conf) {
+    if (hex.size() != CONFIGURATION_SIZE * 2 ||
+        hex.find_first_not_of("0123456789abcdefABCDEF") != string::npos) {
+        return false;
+    }
+
+    uint8_t raw[CONFIGURATION_SIZE];
+    for (int i = 0; i < CONFIGURATION_SIZE; ++i) {
+        raw[i] = std::stoi(hex.substr(i * 2, 2), nullptr, 16);
+    }
+    conf = decodeConfiguration(raw);
+    return true;
+}
+
+static string toHex(Configuration const& conf) {
+    uint8_t raw[CONFIGURATION_SIZE];
+    encodeConfiguration(raw, conf);
+    ostringstream hex;
+    hex << std::hex << setfill('0');
+    for (int i = 0; i < CONFIGURATION_SIZE; ++i) {
+        hex << setw(2) << static_cast<int>(raw[i]);
+    }
+    return hex.str();
+}
+
+SavedConfigurationCache::SavedConfigurationCache() {
+}
+
+SavedConfigurationCache::SavedConfigurationCache(string const& path)
+    : m_store(path) {
+}
+
+bool SavedConfigurationCache::get(string const& device, Configuration& conf) const {
+    string hex;
+    return m_store.get(device, hex) && fromHex(hex, conf);
+}
+
+bool SavedConfigurationCache::isSaved(string const& device,
+                                      Configuration const& conf) const {
+    Configuration saved;
+    return get(device, saved) && !saved.differences(conf);
+}
+
+bool SavedConfigurationCache::set(string const& device, Configuration const& conf) {
+    return m_store.set(device, toHex(conf));
+}
+
+bool SavedConfigurationCache::remove(string const& device) {
+    return m_store.remove(device);
+}
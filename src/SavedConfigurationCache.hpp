@@ -0,0 +1,62 @@
+#ifndef COMMS_LORA_EBYTE_E32_SAVEDCONFIGURATIONCACHE_HPP
+#define COMMS_LORA_EBYTE_E32_SAVEDCONFIGURATIONCACHE_HPP
+
+#include <comms_lora_ebyte_e32/ConfigurationCodec.hpp>
+#include <comms_lora_ebyte_e32/KeyValueStore.hpp>
+#include <string>
+
+namespace comms_lora_ebyte_e32 {
+    /** Last configuration saved in the non-volatile memory of each device
+     *
+     * It is used by Driver::saveConfiguration to skip both the save and the
+     * configuration read when a device already has the requested
+     * configuration. The entries are stored in a KeyValueStore, as one
+     * 'DEVICE CONFIGURATION' line per device, the configuration being its
+     * raw 5-byte encoding in hexadecimal. It is as short as a hash, and lets
+     * the configuration be recovered without reading the module.
+     *
+     * An entry means that the last configuration write done through a driver
+     * using the cache was a save of that configuration, i.e. that the
+     * module's volatile and saved configurations are both equal to it.
+     * Changes done by other means, or replacing the module behind a device,
+     * go unnoticed. The module has already been configured when the cache
+     * is updated, which is why failing to write the file does not fail the
+     * configuration.
+     */
+    class SavedConfigurationCache {
+        KeyValueStore m_store;
+
+    public:
+        /** Create an in-memory cache */
+        SavedConfigurationCache();
+
+        /** Create a cache backed by the given file
+         *
+         * The file does not need to exist
+         */
+        explicit SavedConfigurationCache(std::string const& path);
+
+        /** Get the configuration saved on a device
+         *
+         * @return false if there is none
+         */
+        bool get(std::string const& device, Configuration& conf) const;
+
+        /** Whether the device is known to have this configuration saved */
+        bool isSaved(std::string const& device, Configuration const& conf) const;
+
+        /** Record that the configuration has been saved on the device
+         *
+         * @return false if the cache file could not be updated
+         */
+        bool set(std::string const& device, Configuration const& conf);
+
+        /** Remove a device from the cache
+         *
+         * @return false if the cache file could not be updated
+         */
+        bool remove(std::string const& device);
+    };
+}
+
+#endif
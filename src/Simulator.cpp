@@ -0,0 +1,541 @@
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/ConfigurationCodec.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Maximum real time the simulation thread sleeps between two steps
+ *
+ * It is also the simulation's time resolution
+ */
+static const base::Time STEP_PERIOD = base::Time::fromMicroseconds(500);
+
+static speed_t getSpeed(Configuration::UARTRate rate) {
+    switch (rate) {
+        case Configuration::RATE_1200:
+            return B1200;
+        case Configuration::RATE_2400:
+            return B2400;
+        case Configuration::RATE_4800:
+            return B4800;
+        case Configuration::RATE_9600:
+            return B9600;
+        case Configuration::RATE_19200:
+            return B19200;
+        case Configuration::RATE_38400:
+            return B38400;
+        case Configuration::RATE_57600:
+            return B57600;
+        case Configuration::RATE_115200:
+            return B115200;
+        default:
+            return B0;
+    }
+}
+
+static uint8_t encodeFrequency(Frequency frequency) {
+    switch (frequency) {
+        case FREQ_433MHZ:
+            return 32;
+        case FREQ_470MHZ:
+            return 38;
+        case FREQ_868MHZ:
+            return 45;
+        case FREQ_915MHZ:
+            return 44;
+        case FREQ_170MHZ:
+            return 46;
+        default:
+            return 0;
+    }
+}
+
+Simulator::Simulator(unsigned int seed)
+    : m_random(seed) {
+    setPacketLoss(0);
+}
+
+Simulator::~Simulator() {
+    stop();
+    for (auto& module : m_modules) {
+        ::close(module->master);
+        ::close(module->slave);
+    }
+}
+
+int Simulator::addModule(Configuration const& conf, Version const& version) {
+    if (m_thread.joinable()) {
+        throw std::logic_error(
+            "comms_lora_ebyte_e32::Simulator::addModule: "
+            "cannot add modules while the simulation is running"
+        );
+    }
+
+    unique_ptr<Module> module(new Module());
+    module->version = version;
+    module->status.configuration = conf;
+    module->status.saved_configuration = conf;
+
+    module->master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (module->master < 0 || grantpt(module->master) != 0 ||
+        unlockpt(module->master) != 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::Simulator::addModule: failed to create pty"
+        );
+    }
+    module->device_path = ptsname(module->master);
+
+    // Keep the slave open so that the master does not hang up when the
+    // driver closes its side
+    module->slave = ::open(module->device_path.c_str(), O_RDWR | O_NOCTTY);
+    if (module->slave < 0) {
+        ::close(module->master);
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::Simulator::addModule: failed to open " +
+            module->device_path
+        );
+    }
+    termios tio;
+    tcgetattr(module->slave, &tio);
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, getSpeed(conf.uart_rate));
+    cfsetospeed(&tio, getSpeed(conf.uart_rate));
+    tcsetattr(module->slave, TCSANOW, &tio);
+
+    m_modules.push_back(std::move(module));
+    return m_modules.size() - 1;
+}
+
+string Simulator::getDevicePath(int module) const {
+    return m_modules.at(module)->device_path;
+}
+
+int Simulator::openDevice(int module) const {
+    string path = getDevicePath(module);
+    int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::Simulator::openDevice: failed to open " + path
+        );
+    }
+    return fd;
+}
+
+AUXMonitor& Simulator::getAUX(int module) {
+    return m_modules.at(module)->aux;
+}
+
+void Simulator::setMode(int module, Mode mode) {
+    lock_guard<mutex> lock(m_mutex);
+    Module& m = *m_modules.at(module);
+    if (m.mode != mode && !m_mode_switch_time.isNull()) {
+        m.busy_until = getSimulatedTime(base::Time::now()) + m_mode_switch_time;
+        m.aux.setReady(false);
+    }
+    m.mode = mode;
+    m.command.clear();
+    m.header.clear();
+    m.current = Packet();
+}
+
+void Simulator::setModeSwitchTime(base::Time const& duration) {
+    lock_guard<mutex> lock(m_mutex);
+    m_mode_switch_time = duration;
+}
+
+void Simulator::setTimeScale(double scale) {
+    if (scale <= 0) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::Simulator::setTimeScale: "
+            "scale must be strictly positive"
+        );
+    }
+
+    lock_guard<mutex> lock(m_mutex);
+    base::Time real_now = base::Time::now();
+    m_simulated_start = getSimulatedTime(real_now);
+    m_real_start = real_now;
+    m_time_scale = scale;
+}
+
+void Simulator::setPacketLoss(double probability) {
+    setLossModel([probability](Configuration const&, Configuration const&) {
+        return probability;
+    });
+}
+
+void Simulator::setLossModel(LossModel model) {
+    lock_guard<mutex> lock(m_mutex);
+    m_loss_model = model;
+}
+
+base::Time Simulator::getSimulatedTime(base::Time const& real_now) const {
+    if (m_real_start.isNull()) {
+        return m_simulated_start;
+    }
+    return m_simulated_start + (real_now - m_real_start) * m_time_scale;
+}
+
+base::Time Simulator::now() const {
+    lock_guard<mutex> lock(m_mutex);
+    return getSimulatedTime(base::Time::now());
+}
+
+Simulator::ModuleStatus Simulator::getStatus(int module) const {
+    lock_guard<mutex> lock(m_mutex);
+    return m_modules.at(module)->status;
+}
+
+void Simulator::start() {
+    if (m_thread.joinable()) {
+        return;
+    }
+
+    m_quit = false;
+    m_real_start = base::Time::now();
+    m_thread = thread([this]() { run(); });
+}
+
+void Simulator::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_thread.join();
+}
+
+void Simulator::run() {
+    vector<pollfd> fds;
+    for (auto& module : m_modules) {
+        fds.push_back(pollfd { module->master, POLLIN, 0 });
+    }
+
+    base::Time wait = STEP_PERIOD;
+    while (true) {
+        timespec ts = { static_cast<time_t>(wait.toMicroseconds() / 1000000),
+                        static_cast<long>(wait.toMicroseconds() % 1000000) * 1000 };
+        ::ppoll(fds.data(), fds.size(), &ts, nullptr);
+
+        lock_guard<mutex> lock(m_mutex);
+        if (m_quit) {
+            return;
+        }
+
+        base::Time now = getSimulatedTime(base::Time::now());
+        for (size_t i = 0; i < m_modules.size(); ++i) {
+            if (!(fds[i].revents & POLLIN)) {
+                continue;
+            }
+
+            uint8_t buffer[MODULE_BUFFER_SIZE];
+            int size = ::read(m_modules[i]->master, buffer, MODULE_BUFFER_SIZE);
+            if (size > 0) {
+                processUART(*m_modules[i], buffer, size, now);
+            }
+        }
+
+        base::Time next = step(now);
+        wait = std::min(STEP_PERIOD, (next - now) / m_time_scale);
+        if (wait < base::Time()) {
+            wait = base::Time();
+        }
+    }
+}
+
+base::Time Simulator::step(base::Time const& now) {
+    // Resolve all transmissions that ended first, so that the modules that
+    // start one in this step do not see them
+    for (auto& module : m_modules) {
+        if (module->transmitting && module->transmit_end <= now) {
+            module->transmitting = false;
+            module->last_transmit_start = module->transmit_start;
+            module->last_transmit_end = module->transmit_end;
+            module->last_transmit_channel = module->in_flight.channel;
+            module->status.buffer_usage -= module->in_flight.data.size();
+            deliver(*module, module->in_flight, module->transmit_end);
+        }
+    }
+
+    base::Time next = base::Time::max();
+    for (auto& module : m_modules) {
+        Configuration const& conf = module->status.configuration;
+        base::Time packet_end = std::max(
+            getUARTTransferTime(conf, PACKET_END_BYTES),
+            STEP_PERIOD * m_time_scale
+        );
+        bool idle = module->last_uart_byte + packet_end <= now;
+        if (idle) {
+            // End of packet. In fixed mode, the next bytes start with a new
+            // header
+            if (!module->current.data.empty()) {
+                module->buffer.push_back(module->current);
+                module->current.data.clear();
+            }
+            module->header.clear();
+        }
+        else if (!module->current.data.empty() || !module->header.empty()) {
+            next = std::min(next, module->last_uart_byte + packet_end);
+        }
+
+        if (!module->transmitting && !module->buffer.empty()) {
+            module->in_flight = module->buffer.front();
+            module->buffer.pop_front();
+            // In wake-up mode, only the start of a transmission carries a
+            // preamble, not the sub-packets that follow it
+            bool continued = !module->last_transmit_end.isNull() &&
+                             now - module->last_transmit_end <= getPacketGap(conf);
+            if (module->mode == MODE_WAKE_UP && !continued) {
+                module->in_flight.preamble = getWakeUpTime(conf);
+            }
+            module->transmitting = true;
+            module->transmit_start = now;
+            module->transmit_end = now + module->in_flight.preamble +
+                                   getAirtime(conf, module->in_flight.data.size());
+            module->status.sent_sub_packets++;
+        }
+        if (module->transmitting) {
+            next = std::min(next, module->transmit_end);
+        }
+
+        flushOutput(*module, now);
+        if (!module->output.empty()) {
+            next = std::min(next, module->output.front().time);
+        }
+        if (module->busy_until > now) {
+            next = std::min(next, module->busy_until);
+        }
+        updateAUX(*module, now);
+    }
+    return next;
+}
+
+bool Simulator::isHostRateMatching(Module const& module) const {
+    termios tio;
+    if (tcgetattr(module.master, &tio) != 0) {
+        return true;
+    }
+    return cfgetospeed(&tio) == getSpeed(module.status.configuration.uart_rate);
+}
+
+void Simulator::processUART(Module& module, uint8_t const* data, int size,
+                            base::Time const& now) {
+    if (!isHostRateMatching(module)) {
+        module.status.uart_errors += size;
+        return;
+    }
+    else if (now < module.busy_until || module.mode == MODE_POWER_SAVING) {
+        module.status.ignored_bytes += size;
+        return;
+    }
+
+    module.status.uart_rx_bytes += size;
+    if (module.mode == MODE_SLEEP) {
+        module.command.insert(module.command.end(), data, data + size);
+        processCommand(module, now);
+        return;
+    }
+
+    Configuration const& conf = module.status.configuration;
+    module.last_uart_byte = now;
+    for (int i = 0; i < size; ++i) {
+        if (!conf.transparent_transmission && module.header.size() < 3) {
+            module.header.push_back(data[i]);
+            if (module.header.size() == 3) {
+                module.current.target = (module.header[0] << 8) | module.header[1];
+                module.current.channel = module.header[2];
+            }
+            continue;
+        }
+        else if (conf.transparent_transmission && module.current.data.empty()) {
+            module.current.target = conf.address;
+            module.current.channel = conf.channel;
+        }
+
+        if (module.status.buffer_usage >= MODULE_BUFFER_SIZE) {
+            module.status.dropped_bytes++;
+            continue;
+        }
+
+        module.current.data.push_back(data[i]);
+        module.status.buffer_usage++;
+        if (static_cast<int>(module.current.data.size()) == SUB_PACKET_SIZE) {
+            module.buffer.push_back(module.current);
+            module.current.data.clear();
+        }
+    }
+}
+
+void Simulator::processCommand(Module& module, base::Time const& now) {
+    auto& command = module.command;
+    while (!command.empty()) {
+        uint8_t head = command[0];
+        if (head == 0xc1 || head == 0xc3) {
+            if (command.size() < 3) {
+                return;
+            }
+            if (command[1] != head || command[2] != head) {
+                command.erase(command.begin());
+                continue;
+            }
+
+            command.erase(command.begin(), command.begin() + 3);
+            base::Time received =
+                now + getUARTTransferTime(module.status.configuration, 3);
+            if (head == 0xc1) {
+                uint8_t reply[CONFIGURATION_COMMAND_SIZE];
+                reply[0] = 0xc0;
+                encodeConfiguration(reply + 1, module.status.configuration);
+                writeToHost(module, reply, CONFIGURATION_COMMAND_SIZE, received);
+            }
+            else {
+                uint8_t reply[4] = {
+                    0xc3, encodeFrequency(module.version.frequency),
+                    module.version.version, module.version.features
+                };
+                writeToHost(module, reply, 4, received);
+            }
+        }
+        else if (head == 0xc0 || head == 0xc2) {
+            if (static_cast<int>(command.size()) < CONFIGURATION_COMMAND_SIZE) {
+                return;
+            }
+
+            Configuration conf = decodeConfiguration(command.data() + 1);
+            command.erase(command.begin(),
+                          command.begin() + CONFIGURATION_COMMAND_SIZE);
+            module.status.configuration = conf;
+            if (!m_mode_switch_time.isNull()) {
+                module.busy_until = now + m_mode_switch_time;
+                module.aux.setReady(false);
+            }
+            if (head == 0xc0) {
+                module.status.saved_configuration = conf;
+                module.status.saves++;
+            }
+        }
+        else {
+            command.erase(command.begin());
+        }
+    }
+}
+
+void Simulator::deliver(Module& from, Packet const& packet,
+                        base::Time const& now) {
+    Configuration const& from_conf = from.status.configuration;
+    bool colliding = isColliding(from, packet);
+    bool lost = false;
+    for (auto& to : m_modules) {
+        Configuration const& to_conf = to->status.configuration;
+        if (to.get() == &from || to->mode == MODE_SLEEP ||
+            to_conf.channel != packet.channel ||
+            to_conf.air_rate != from_conf.air_rate ||
+            to_conf.error_correction_enabled != from_conf.error_correction_enabled) {
+            continue;
+        }
+        else if (packet.target != 0xffff && to_conf.address != 0xffff &&
+                 packet.target != to_conf.address) {
+            continue;
+        }
+        else if ((to->transmitting && to->transmit_start < from.transmit_end) ||
+                 to->last_transmit_end > from.transmit_start) {
+            // The radio is half-duplex
+            to->status.missed_sub_packets++;
+            continue;
+        }
+        else if (colliding) {
+            to->status.collided_sub_packets++;
+            continue;
+        }
+        else if (to->mode == MODE_POWER_SAVING) {
+            if (packet.preamble >= getWakeUpTime(to_conf)) {
+                to->status.wake_ups++;
+            }
+            else if (from.transmit_start > to->awake_until) {
+                to->status.asleep_sub_packets++;
+                continue;
+            }
+            to->awake_until = from.transmit_end + getPacketGap(to_conf);
+        }
+
+        std::uniform_real_distribution<double> draw(0, 1);
+        if (draw(m_random) < m_loss_model(from_conf, to_conf)) {
+            lost = true;
+            continue;
+        }
+
+        to->status.received_sub_packets++;
+        writeToHost(*to, packet.data.data(), packet.data.size(), now);
+    }
+
+    if (lost) {
+        from.status.lost_sub_packets++;
+    }
+}
+
+bool Simulator::isColliding(Module const& from, Packet const& packet) const {
+    Configuration const& from_conf = from.status.configuration;
+    for (auto const& other : m_modules) {
+        if (other.get() == &from ||
+            other->status.configuration.air_rate != from_conf.air_rate) {
+            continue;
+        }
+
+        // Transmissions that ended in this step were already moved to the
+        // last_transmit_ fields
+        if (other->transmitting && other->in_flight.channel == packet.channel &&
+            other->transmit_start < from.transmit_end) {
+            return true;
+        }
+        else if (other->last_transmit_channel == packet.channel &&
+                 other->last_transmit_end > from.transmit_start &&
+                 other->last_transmit_start < from.transmit_end) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Simulator::writeToHost(Module& module, uint8_t const* data, int size,
+                            base::Time const& now) {
+    Output output;
+    base::Time start = std::max(now, module.output_end);
+    module.output_end =
+        start + getUARTTransferTime(module.status.configuration, size);
+    output.time = module.output_end;
+    output.data.assign(data, data + size);
+    module.output.push_back(output);
+}
+
+void Simulator::flushOutput(Module& module, base::Time const& now) {
+    bool matching = isHostRateMatching(module);
+    while (!module.output.empty() && module.output.front().time <= now) {
+        auto const& data = module.output.front().data;
+        if (matching) {
+            int written = ::write(module.master, data.data(), data.size());
+            if (written > 0) {
+                module.status.uart_tx_bytes += written;
+            }
+        }
+        else {
+            module.status.uart_errors += data.size();
+        }
+        module.output.pop_front();
+    }
+}
+
+void Simulator::updateAUX(Module& module, base::Time const& now) {
+    module.aux.setReady(
+        !module.transmitting && module.buffer.empty() &&
+        module.current.data.empty() && module.busy_until <= now
+    );
+}
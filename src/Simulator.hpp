@@ -0,0 +1,250 @@
+#ifndef COMMS_LORA_EBYTE_E32_SIMULATOR_HPP
+#define COMMS_LORA_EBYTE_E32_SIMULATOR_HPP
+
+#include <base/Time.hpp>
+#include <comms_lora_ebyte_e32/Configuration.hpp>
+#include <comms_lora_ebyte_e32/MockAUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/Version.hpp>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** Software model of a set of E32 modules sharing the air
+     *
+     * Each simulated module is reachable through a pty. In MODE_SLEEP, it
+     * answers the C0/C1/C2/C3 commands. In MODE_NORMAL, it buffers the bytes
+     * received on its UART in a 512-byte buffer (dropping what does not fit),
+     * splits them in packets at UART idle gaps, and sends them as 58-byte
+     * sub-packets. Each sub-packet occupies the module for its airtime, and
+     * is delivered to the modules on the same channel and air rate whose
+     * address matches, unless the loss model drops it. As on the real
+     * hardware, a module does not receive while it transmits, and two
+     * sub-packets that overlap in time on the same channel and air rate
+     * are lost for all the receivers.
+     *
+     * In MODE_WAKE_UP, a module transmits as in MODE_NORMAL, but the first
+     * sub-packet of each transmission is preceded by a preamble lasting the
+     * wake-up time (see getWakeUpTime). A module in MODE_POWER_SAVING
+     * ignores its UART input, and only receives transmissions whose
+     * preamble is at least as long as its own wake-up time, along with the
+     * sub-packets that follow them without interruption.
+     *
+     * The bytes the module sends to the host are delayed by their transfer
+     * time at the configured UART rate. The pty starts at that rate. If the
+     * host switches it to a different one, the bytes exchanged with the
+     * module are lost in both directions, as the framing errors of a
+     * real UART would do.
+     *
+     * Time can be accelerated with setTimeScale. All delays are computed in
+     * simulated time, which runs that many times faster than real time.
+     *
+     * Packet losses are drawn from a random generator seeded at
+     * construction, so that a given seed and sequence of transmissions
+     * always produces the same losses.
+     */
+    class Simulator {
+    public:
+        enum Mode {
+            /** Transmission mode (M0 = M1 = 0) */
+            MODE_NORMAL,
+            /** Configuration mode (M0 = M1 = 1) */
+            MODE_SLEEP,
+            /** Wake-up mode (M0 = 1, M1 = 0) */
+            MODE_WAKE_UP,
+            /** Power-saving mode (M0 = 0, M1 = 1) */
+            MODE_POWER_SAVING
+        };
+
+        /** Probability that a sub-packet sent by a module with the first
+         * configuration is lost for a module with the second configuration
+         */
+        typedef std::function<double (Configuration const&, Configuration const&)>
+            LossModel;
+
+        struct ModuleStatus {
+            /** Bytes received from the host on the UART */
+            uint64_t uart_rx_bytes = 0;
+            /** Bytes sent to the host on the UART */
+            uint64_t uart_tx_bytes = 0;
+            /** Bytes dropped because the buffer was full */
+            uint64_t dropped_bytes = 0;
+            /** Bytes lost in either direction because the host UART rate
+             * did not match the module's
+             */
+            uint64_t uart_errors = 0;
+            /** Bytes currently in the transmit buffer */
+            int buffer_usage = 0;
+            uint64_t sent_sub_packets = 0;
+            /** Sub-packets that did not reach one of their recipients */
+            uint64_t lost_sub_packets = 0;
+            uint64_t received_sub_packets = 0;
+            /** Sub-packets that could not be received because the module was
+             * transmitting at the time
+             */
+            uint64_t missed_sub_packets = 0;
+            /** Sub-packets that could not be received because another module
+             * was transmitting on the same channel at the same time
+             */
+            uint64_t collided_sub_packets = 0;
+            /** Sub-packets that could not be received because the module was
+             * in power-saving mode, and no preamble woke it up
+             */
+            uint64_t asleep_sub_packets = 0;
+            /** Number of times a preamble woke the module up in power-saving
+             * mode
+             */
+            uint64_t wake_ups = 0;
+            /** Bytes received from the host while the module was switching
+             * modes (see setModeSwitchTime)
+             */
+            uint64_t ignored_bytes = 0;
+            /** Number of C0 (save) commands received */
+            uint64_t saves = 0;
+            /** The configuration currently in use */
+            Configuration configuration;
+            /** The configuration saved in non-volatile memory */
+            Configuration saved_configuration;
+        };
+
+    private:
+        struct Packet {
+            uint16_t target = 0xffff;
+            uint8_t channel = 0;
+            std::vector<uint8_t> data;
+            /** Duration of the wake-up preamble sent before the data */
+            base::Time preamble;
+        };
+
+        /** Bytes that the module sends to the host once they have been
+         * transferred on the UART
+         */
+        struct Output {
+            base::Time time;
+            std::vector<uint8_t> data;
+        };
+
+        struct Module {
+            int master = -1;
+            int slave = -1;
+            std::string device_path;
+            Mode mode = MODE_NORMAL;
+            /** End of the current mode switch */
+            base::Time busy_until;
+            /** Time until which a module in power-saving mode, woken up by
+             * a preamble, keeps receiving
+             */
+            base::Time awake_until;
+            Version version;
+            MockAUXMonitor aux;
+            std::vector<uint8_t> command;
+            std::vector<uint8_t> header;
+            Packet current;
+            base::Time last_uart_byte;
+            std::deque<Packet> buffer;
+            bool transmitting = false;
+            base::Time transmit_start;
+            base::Time transmit_end;
+            base::Time last_transmit_start;
+            base::Time last_transmit_end;
+            uint8_t last_transmit_channel = 0;
+            Packet in_flight;
+            std::deque<Output> output;
+            base::Time output_end;
+            ModuleStatus status;
+        };
+
+        std::vector<std::unique_ptr<Module>> m_modules;
+        mutable std::mutex m_mutex;
+        std::thread m_thread;
+        bool m_quit = false;
+        double m_time_scale = 1;
+        base::Time m_real_start;
+        base::Time m_simulated_start;
+        std::mt19937 m_random;
+        LossModel m_loss_model;
+        base::Time m_mode_switch_time;
+
+        void run();
+        base::Time step(base::Time const& now);
+        void processUART(Module& module, uint8_t const* data, int size,
+                         base::Time const& now);
+        void processCommand(Module& module, base::Time const& now);
+        bool isHostRateMatching(Module const& module) const;
+        void deliver(Module& from, Packet const& packet, base::Time const& now);
+        bool isColliding(Module const& from, Packet const& packet) const;
+        void writeToHost(Module& module, uint8_t const* data, int size,
+                         base::Time const& now);
+        void flushOutput(Module& module, base::Time const& now);
+        void updateAUX(Module& module, base::Time const& now);
+        base::Time getSimulatedTime(base::Time const& real_now) const;
+
+    public:
+        /** @arg seed the seed of the packet loss generator */
+        explicit Simulator(unsigned int seed = 0);
+        ~Simulator();
+
+        /** Add a module
+         *
+         * Modules must be added before the simulation is started
+         *
+         * @return the module index
+         */
+        int addModule(Configuration const& conf = Configuration(),
+                      Version const& version = Version());
+
+        /** Path to the module's pty slave, e.g. to build a serial:// URI */
+        std::string getDevicePath(int module) const;
+
+        /** Open a new file descriptor on the module's pty, for
+         * Driver::setFileDescriptor
+         */
+        int openDevice(int module) const;
+
+        /** The AUX line of the module */
+        AUXMonitor& getAUX(int module);
+
+        /** Set the module's mode */
+        void setMode(int module, Mode mode);
+
+        /** Set how long modules take to switch modes
+         *
+         * During a switch, AUX is low and the bytes received from the host
+         * are ignored. Modules take the same time to apply a new
+         * configuration. It defaults to zero, i.e. mode switches and
+         * configuration changes are instantaneous.
+         */
+        void setModeSwitchTime(base::Time const& duration);
+
+        /** Make simulated time run this many times faster than real time */
+        void setTimeScale(double scale);
+
+        /** Use a constant loss probability for all sub-packets */
+        void setPacketLoss(double probability);
+
+        /** Use a custom loss model */
+        void setLossModel(LossModel model);
+
+        /** Current simulated time
+         *
+         * It starts at zero when start() is called
+         */
+        base::Time now() const;
+
+        /** Snapshot of the module's status */
+        ModuleStatus getStatus(int module) const;
+
+        /** Start the simulation thread */
+        void start();
+
+        /** Stop the simulation thread */
+        void stop();
+    };
+}
+
+#endif
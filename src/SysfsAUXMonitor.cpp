@@ -0,0 +1,67 @@
+#include <comms_lora_ebyte_e32/SysfsAUXMonitor.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <fcntl.h>
+#include <fstream>
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace comms_lora_ebyte_e32;
+
+/** Polling period when the GPIO does not support edge interrupts */
+static const base::Time POLL_PERIOD = base::Time::fromMilliseconds(1);
+
+SysfsAUXMonitor::SysfsAUXMonitor(std::string const& gpio_path) {
+    std::ofstream edge((gpio_path + "/edge").c_str());
+    if (edge) {
+        edge << "both" << std::flush;
+        m_has_edge = edge.good();
+    }
+
+    std::string value_path = gpio_path + "/value";
+    m_fd = ::open(value_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::SysfsAUXMonitor: cannot open " + value_path
+        );
+    }
+}
+
+SysfsAUXMonitor::~SysfsAUXMonitor() {
+    ::close(m_fd);
+}
+
+bool SysfsAUXMonitor::readValue() {
+    char value;
+    if (::pread(m_fd, &value, 1, 0) != 1) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::SysfsAUXMonitor: failed to read AUX value"
+        );
+    }
+    return value == '1';
+}
+
+bool SysfsAUXMonitor::isReady() {
+    return readValue();
+}
+
+bool SysfsAUXMonitor::waitReady(base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    while (!readValue()) {
+        base::Time now = base::Time::now();
+        if (now >= deadline) {
+            return false;
+        }
+
+        if (m_has_edge) {
+            pollfd pfd = { m_fd, POLLPRI | POLLERR, 0 };
+            ::poll(&pfd, 1, (deadline - now).toMilliseconds() + 1);
+        }
+        else {
+            std::this_thread::sleep_for(
+                std::chrono::microseconds(POLL_PERIOD.toMicroseconds())
+            );
+        }
+    }
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef COMMS_LORA_EBYTE_E32_SYSFSAUXMONITOR_HPP
+#define COMMS_LORA_EBYTE_E32_SYSFSAUXMONITOR_HPP
+
+#include <comms_lora_ebyte_e32/AUXMonitor.hpp>
+#include <string>
+
+namespace comms_lora_ebyte_e32 {
+    /** AUX monitor reading a GPIO exported through sysfs
+     *
+     * The GPIO must already be exported and configured as an input. If its
+     * 'edge' attribute can be set to 'both', waitReady() waits for the edge
+     * interrupt. Otherwise, it polls the value.
+     */
+    class SysfsAUXMonitor : public AUXMonitor {
+        int m_fd = -1;
+        bool m_has_edge = false;
+
+        bool readValue();
+
+    public:
+        /** @arg gpio_path the GPIO directory, e.g. /sys/class/gpio/gpio17 */
+        explicit SysfsAUXMonitor(std::string const& gpio_path);
+        ~SysfsAUXMonitor();
+
+        bool isReady();
+        bool waitReady(base::Time const& timeout);
+    };
+}
+
+#endif
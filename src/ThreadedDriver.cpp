@@ -0,0 +1,294 @@
+#include <comms_lora_ebyte_e32/ThreadedDriver.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+const int ThreadedDriver::DEFAULT_RING_SIZE;
+
+static const memory_order RELAXED = memory_order_relaxed;
+
+/** How long the I/O thread waits before retrying a write refused by the
+ * flow control
+ */
+static const int WRITE_RETRY_PERIOD_MS = 5;
+
+/** Signal an eventfd
+ *
+ * @return false on error. EAGAIN is not one, as it means that the event is
+ *   already signalled
+ */
+static bool writeEvent(int fd) {
+    uint64_t value = 1;
+    return ::write(fd, &value, sizeof(value)) >= 0 || errno == EAGAIN;
+}
+
+static void signalEvent(int fd) {
+    if (!writeEvent(fd)) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::ThreadedDriver: failed to signal event"
+        );
+    }
+}
+
+static void clearEvent(int fd) {
+    uint64_t value;
+    if (::read(fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::ThreadedDriver: failed to clear event"
+        );
+    }
+}
+
+ThreadedDriver::ThreadedDriver(Driver& driver, int rx_ring_size, int tx_ring_size)
+    : m_driver(driver)
+    , m_rx_ring(std::max(rx_ring_size, 0))
+    , m_tx_ring(std::max(tx_ring_size, 0))
+    , m_quit(false)
+    , m_failed(false)
+    , m_received_frames(0)
+    , m_dropped_frames(0)
+    , m_sent_frames(0)
+    , m_rejected_frames(0)
+    , m_write_retries(0) {
+    m_tx_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_rx_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_tx_event < 0 || m_rx_event < 0) {
+        ::close(m_tx_event);
+        ::close(m_rx_event);
+        throw iodrivers_base::UnixError(
+            "comms_lora_ebyte_e32::ThreadedDriver: failed to create eventfd"
+        );
+    }
+    m_driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+}
+
+ThreadedDriver::~ThreadedDriver() {
+    stop();
+    ::close(m_tx_event);
+    ::close(m_rx_event);
+}
+
+Driver& ThreadedDriver::getDriver() {
+    return m_driver;
+}
+
+void ThreadedDriver::start() {
+    if (m_thread.joinable()) {
+        return;
+    }
+
+    m_quit.store(false);
+    m_failed.store(false);
+    m_error = exception_ptr();
+    m_thread = thread([this]() { run(); });
+}
+
+void ThreadedDriver::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    m_quit.store(true);
+    signalEvent(m_tx_event);
+    m_thread.join();
+}
+
+bool ThreadedDriver::isRunning() const {
+    return m_thread.joinable() && !m_failed.load(memory_order_acquire);
+}
+
+int ThreadedDriver::getReceiveFileDescriptor() const {
+    return m_rx_event;
+}
+
+void ThreadedDriver::run() {
+    pollfd fds[2] = {
+        { m_driver.getFileDescriptor(), POLLIN, 0 },
+        { m_tx_event, POLLIN, 0 }
+    };
+
+    try {
+        while (true) {
+            // Bytes may already be in the driver's internal buffer, so read
+            // before waiting
+            receiveFrames();
+            bool retry = sendFrames();
+
+            ::poll(fds, 2, retry ? WRITE_RETRY_PERIOD_MS : -1);
+            if (m_quit.load(memory_order_acquire)) {
+                return;
+            }
+            if (fds[1].revents & POLLIN) {
+                clearEvent(m_tx_event);
+            }
+        }
+    }
+    catch (...) {
+        m_error = current_exception();
+        m_failed.store(true, memory_order_release);
+        // Must not throw from here. If the event cannot be signalled,
+        // receive() still reports the error once its timeout expires
+        writeEvent(m_rx_event);
+    }
+}
+
+void ThreadedDriver::receiveFrames() {
+    bool received = false;
+    while (true) {
+        int size = m_driver.tryReadPacket(m_read_buffer, Driver::MAX_PACKET_SIZE);
+        if (size == 0) {
+            break;
+        }
+        size -= Driver::FRAME_HEADER_SIZE;
+
+        Frame* frame = m_rx_ring.beginPush();
+        if (!frame) {
+            m_dropped_frames.fetch_add(1, RELAXED);
+            continue;
+        }
+        frame->size = size;
+        frame->time = base::Time::now();
+        memcpy(frame->data, m_read_buffer + Driver::FRAME_HEADER_SIZE, size);
+        m_rx_ring.commitPush();
+        m_received_frames.fetch_add(1, RELAXED);
+        received = true;
+    }
+
+    if (received) {
+        signalEvent(m_rx_event);
+    }
+}
+
+bool ThreadedDriver::sendFrames() {
+    while (Frame* frame = m_tx_ring.front()) {
+        int written;
+        if (frame->fixed) {
+            m_driver.waitFixedTransmissionGap();
+            written = m_driver.writeFrame(frame->target, frame->channel,
+                                          frame->data, frame->size);
+        }
+        else {
+            written = m_driver.writeFrame(frame->data, frame->size);
+        }
+
+        if (written == 0) {
+            m_write_retries.fetch_add(1, RELAXED);
+            return true;
+        }
+        else if (written < frame->size) {
+            throw iodrivers_base::TimeoutError(
+                iodrivers_base::TimeoutError::PACKET,
+                "comms_lora_ebyte_e32::ThreadedDriver: timed out while "
+                "writing a frame"
+            );
+        }
+        m_tx_ring.pop();
+        m_sent_frames.fetch_add(1, RELAXED);
+    }
+    return false;
+}
+
+void ThreadedDriver::checkError() const {
+    if (m_failed.load(memory_order_acquire)) {
+        rethrow_exception(m_error);
+    }
+}
+
+bool ThreadedDriver::queue(bool fixed, uint16_t target, uint8_t channel,
+                           uint8_t const* buffer, int size) {
+    checkError();
+    if (size <= 0 || size > Driver::MAX_FRAME_PAYLOAD_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::ThreadedDriver::send: frame size must be "
+            "between 1 and " + std::to_string(Driver::MAX_FRAME_PAYLOAD_SIZE)
+        );
+    }
+
+    Frame* frame = m_tx_ring.beginPush();
+    if (!frame) {
+        m_rejected_frames.fetch_add(1, RELAXED);
+        return false;
+    }
+    frame->fixed = fixed;
+    frame->target = target;
+    frame->channel = channel;
+    frame->size = size;
+    memcpy(frame->data, buffer, size);
+    m_tx_ring.commitPush();
+    signalEvent(m_tx_event);
+    return true;
+}
+
+bool ThreadedDriver::send(uint8_t const* buffer, int size) {
+    return queue(false, 0, 0, buffer, size);
+}
+
+bool ThreadedDriver::send(uint16_t target, uint8_t channel,
+                          uint8_t const* buffer, int size) {
+    return queue(true, target, channel, buffer, size);
+}
+
+int ThreadedDriver::receive(uint8_t* buffer, int bufsize, base::Time const& timeout) {
+    base::Time deadline = base::Time::now() + timeout;
+    while (true) {
+        Frame* frame = m_rx_ring.front();
+        if (!frame) {
+            // Clear the event before checking the ring again, so that a frame
+            // queued in-between signals it anew
+            clearEvent(m_rx_event);
+            frame = m_rx_ring.front();
+        }
+
+        if (frame) {
+            int size = frame->size;
+            if (size > bufsize) {
+                m_rx_ring.pop();
+                throw std::invalid_argument(
+                    "comms_lora_ebyte_e32::ThreadedDriver::receive: frame of " +
+                    std::to_string(size) + " bytes does not fit in a buffer of " +
+                    std::to_string(bufsize)
+                );
+            }
+            memcpy(buffer, frame->data, size);
+            m_rx_ring.pop();
+            return size;
+        }
+
+        checkError();
+        base::Time now = base::Time::now();
+        if (now >= deadline) {
+            throw iodrivers_base::TimeoutError(
+                iodrivers_base::TimeoutError::FIRST_BYTE,
+                "comms_lora_ebyte_e32::ThreadedDriver::receive: no frame received"
+            );
+        }
+        pollfd pfd = { m_rx_event, POLLIN, 0 };
+        ::poll(&pfd, 1, (deadline - now).toMilliseconds() + 1);
+    }
+}
+
+size_t ThreadedDriver::getReceiveQueueSize() const {
+    return m_rx_ring.size();
+}
+
+size_t ThreadedDriver::getTransmitQueueSize() const {
+    return m_tx_ring.size();
+}
+
+ThreadedDriver::Statistics ThreadedDriver::getStatistics() const {
+    Statistics stats;
+    stats.received_frames = m_received_frames.load(RELAXED);
+    stats.dropped_frames = m_dropped_frames.load(RELAXED);
+    stats.sent_frames = m_sent_frames.load(RELAXED);
+    stats.rejected_frames = m_rejected_frames.load(RELAXED);
+    stats.write_retries = m_write_retries.load(RELAXED);
+    stats.rx_high_water_mark = m_rx_ring.getHighWaterMark();
+    stats.tx_high_water_mark = m_tx_ring.getHighWaterMark();
+    return stats;
+}
@@ -0,0 +1,178 @@
+#ifndef COMMS_LORA_EBYTE_E32_THREADEDDRIVER_HPP
+#define COMMS_LORA_EBYTE_E32_THREADEDDRIVER_HPP
+
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/SPSCRing.hpp>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace comms_lora_ebyte_e32 {
+    /** Service a driver from a dedicated I/O thread
+     *
+     * The I/O thread waits on the driver's file descriptor, reads the
+     * received length-prefixed frames (see Driver::writeFrame) and writes
+     * the outgoing ones. Frames are exchanged with the application through
+     * two single-producer/single-consumer rings of preallocated slots
+     * (SPSCRing), so that neither send() nor receive() allocates or locks.
+     * One application thread may send while another one receives.
+     *
+     * The driver is switched to Driver::PACKET_MODE_LENGTH_PREFIXED. It must
+     * not be used directly between start() and stop(), except for the
+     * methods that are documented as thread-safe (e.g.
+     * Driver::getStatistics).
+     *
+     * Received frames are dropped when the receive ring is full, and send()
+     * refuses frames when the transmit ring is full. When a frame cannot be
+     * written because of AUX-based flow control (see Driver::setAUXMonitor),
+     * it stays in the ring and is retried. Fixed transmission frames are
+     * separated by the driver's fixed transmission gap (see
+     * Driver::setFixedTransmissionGap). Any other error stops the I/O
+     * thread, and is rethrown by the next call to send() or receive().
+     */
+    class ThreadedDriver {
+    public:
+        /** Default number of slots in each ring */
+        static const int DEFAULT_RING_SIZE = 16;
+
+        struct Frame {
+            /** Whether the frame is sent in fixed transmission mode */
+            bool fixed = false;
+            uint16_t target = 0;
+            uint8_t channel = 0;
+            int size = 0;
+            /** For received frames, the time at which the I/O thread read
+             * it
+             */
+            base::Time time;
+            uint8_t data[Driver::MAX_FRAME_PAYLOAD_SIZE];
+        };
+
+        struct Statistics {
+            /** Frames read by the I/O thread and queued for the application */
+            uint64_t received_frames = 0;
+            /** Received frames dropped because the receive ring was full */
+            uint64_t dropped_frames = 0;
+            /** Frames written by the I/O thread */
+            uint64_t sent_frames = 0;
+            /** Frames refused by send() because the transmit ring was full */
+            uint64_t rejected_frames = 0;
+            /** Writes that did not go through because of flow control, and
+             * were retried
+             */
+            uint64_t write_retries = 0;
+            /** Largest number of frames that waited in the receive ring */
+            size_t rx_high_water_mark = 0;
+            /** Largest number of frames that waited in the transmit ring */
+            size_t tx_high_water_mark = 0;
+        };
+
+    private:
+        Driver& m_driver;
+        SPSCRing<Frame> m_rx_ring;
+        SPSCRing<Frame> m_tx_ring;
+        /** Signalled by the application when it queues a frame to send, and
+         * by stop()
+         */
+        int m_tx_event = -1;
+        /** Signalled by the I/O thread when it queues received frames */
+        int m_rx_event = -1;
+
+        std::thread m_thread;
+        std::atomic<bool> m_quit;
+        std::atomic<bool> m_failed;
+        /** Error that stopped the I/O thread, valid once m_failed is set */
+        std::exception_ptr m_error;
+        /** Where the I/O thread reads frames, header included */
+        uint8_t m_read_buffer[Driver::MAX_PACKET_SIZE];
+
+        std::atomic<uint64_t> m_received_frames;
+        std::atomic<uint64_t> m_dropped_frames;
+        std::atomic<uint64_t> m_sent_frames;
+        std::atomic<uint64_t> m_rejected_frames;
+        std::atomic<uint64_t> m_write_retries;
+
+        void run();
+        void receiveFrames();
+        bool sendFrames();
+        bool queue(bool fixed, uint16_t target, uint8_t channel,
+                   uint8_t const* buffer, int size);
+        void checkError() const;
+
+    public:
+        /**
+         * @arg rx_ring_size the number of received frames that may wait for
+         *   the application
+         * @arg tx_ring_size the number of frames that may wait for the I/O
+         *   thread
+         */
+        explicit ThreadedDriver(Driver& driver,
+                                int rx_ring_size = DEFAULT_RING_SIZE,
+                                int tx_ring_size = DEFAULT_RING_SIZE);
+        ~ThreadedDriver();
+
+        ThreadedDriver(ThreadedDriver const&) = delete;
+        ThreadedDriver& operator=(ThreadedDriver const&) = delete;
+
+        /** The underlying driver */
+        Driver& getDriver();
+
+        /** Start the I/O thread */
+        void start();
+
+        /** Stop the I/O thread
+         *
+         * Frames still in the transmit ring are not sent
+         */
+        void stop();
+
+        /** Whether the I/O thread is running */
+        bool isRunning() const;
+
+        /** A file descriptor that is readable when received frames may be
+         * waiting, to integrate the driver in an event loop
+         *
+         * It is also readable once the I/O thread stopped on an error
+         */
+        int getReceiveFileDescriptor() const;
+
+        /** Queue a frame in transparent transmission mode
+         *
+         * @return false if the transmit ring is full
+         */
+        bool send(uint8_t const* buffer, int size);
+
+        /** Queue a frame to a given target and channel in fixed transmission
+         * mode
+         *
+         * @return false if the transmit ring is full
+         */
+        bool send(uint16_t target, uint8_t channel, uint8_t const* buffer, int size);
+
+        /** Get the next received frame
+         *
+         * @arg timeout how long to wait for a frame. A null timeout does not
+         *   wait
+         * @return the frame size
+         * @throw iodrivers_base::TimeoutError if no frame was received within
+         *   the timeout
+         * @throw std::invalid_argument if the frame does not fit in the
+         *   buffer. The frame is dropped
+         */
+        int receive(uint8_t* buffer, int bufsize, base::Time const& timeout);
+
+        /** Number of frames waiting in the receive ring */
+        size_t getReceiveQueueSize() const;
+
+        /** Number of frames waiting in the transmit ring */
+        size_t getTransmitQueueSize() const;
+
+        /** Snapshot of the counters and ring high-water marks
+         *
+         * It may be called from any thread
+         */
+        Statistics getStatistics() const;
+    };
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <stdexcept>
+
+using namespace comms_lora_ebyte_e32;
+
+int comms_lora_ebyte_e32::getUARTBaudrate(Configuration::UARTRate rate) {
+    switch (rate) {
+        case Configuration::RATE_1200: return 1200;
+        case Configuration::RATE_2400: return 2400;
+        case Configuration::RATE_4800: return 4800;
+        case Configuration::RATE_9600: return 9600;
+        case Configuration::RATE_19200: return 19200;
+        case Configuration::RATE_38400: return 38400;
+        case Configuration::RATE_57600: return 57600;
+        case Configuration::RATE_115200: return 115200;
+    }
+    throw std::invalid_argument("getUARTBaudrate: unexpected UART rate");
+}
+
+int comms_lora_ebyte_e32::getAirBitrate(Configuration::AirRate rate) {
+    switch (rate) {
+        case Configuration::AIR_RATE_300: return 300;
+        case Configuration::AIR_RATE_1200: return 1200;
+        case Configuration::AIR_RATE_2400: return 2400;
+        case Configuration::AIR_RATE_4800: return 4800;
+        case Configuration::AIR_RATE_9600: return 9600;
+        case Configuration::AIR_RATE_19200: return 19200;
+    }
+    throw std::invalid_argument("getAirBitrate: unexpected air rate");
+}
+
+double comms_lora_ebyte_e32::getEffectiveAirBitrate(Configuration const& conf) {
+    double bitrate = getAirBitrate(conf.air_rate);
+    // The module's FEC uses a 4/5 coding rate
+    return conf.error_correction_enabled ? bitrate : bitrate * 5 / 4;
+}
+
+base::Time comms_lora_ebyte_e32::getUARTTransferTime(
+    Configuration const& conf, int bytes
+) {
+    int bits_per_byte = conf.uart_parity == Configuration::PARITY_8N1 ? 10 : 11;
+    double seconds = static_cast<double>(bytes) * bits_per_byte /
+                     getUARTBaudrate(conf.uart_rate);
+    return base::Time::fromMicroseconds(seconds * 1e6);
+}
+
+base::Time comms_lora_ebyte_e32::getAirtime(Configuration const& conf, int bytes) {
+    int sub_packets = (bytes + SUB_PACKET_SIZE - 1) / SUB_PACKET_SIZE;
+    double air_bytes = bytes + sub_packets * SUB_PACKET_OVERHEAD;
+    double seconds = air_bytes * 8 / getEffectiveAirBitrate(conf);
+    return base::Time::fromMicroseconds(seconds * 1e6);
+}
+
+base::Time comms_lora_ebyte_e32::getPacketGap(Configuration const& conf) {
+    return getAirtime(conf, SUB_PACKET_SIZE) + getUARTTransferTime(conf, PACKET_END_BYTES);
+}
+
+base::Time comms_lora_ebyte_e32::getWakeUpTime(Configuration const& conf) {
+    return base::Time::fromMilliseconds(250 * (1 + conf.wireless_wake_up_time));
+}
+
+base::Time comms_lora_ebyte_e32::getAUXReactionTime() {
+    return base::Time::fromMilliseconds(2);
+}
@@ -0,0 +1,67 @@
+#ifndef COMMS_LORA_EBYTE_E32_TIMING_HPP
+#define COMMS_LORA_EBYTE_E32_TIMING_HPP
+
+#include <base/Time.hpp>
+#include <comms_lora_ebyte_e32/Configuration.hpp>
+
+namespace comms_lora_ebyte_e32 {
+    /** Size of the sub-packets the module splits transmissions into */
+    static const int SUB_PACKET_SIZE = 58;
+
+    /** Size of the module's internal transmit buffer */
+    static const int MODULE_BUFFER_SIZE = 512;
+
+    /** Estimated per-sub-packet over-the-air overhead (preamble, LoRa
+     * header and CRC), expressed in bytes at the configured air rate
+     */
+    static const int SUB_PACKET_OVERHEAD = 8;
+
+    /** Number of byte times of UART silence after which the module starts
+     * transmitting what it received
+     */
+    static const int PACKET_END_BYTES = 3;
+
+    /** UART baud rate in bits per second */
+    int getUARTBaudrate(Configuration::UARTRate rate);
+
+    /** Nominal over-the-air data rate in bits per second */
+    int getAirBitrate(Configuration::AirRate rate);
+
+    /** Effective over-the-air data rate in bits per second
+     *
+     * This is the nominal air rate, augmented when the module's error
+     * correction is disabled
+     */
+    double getEffectiveAirBitrate(Configuration const& conf);
+
+    /** Time needed to transfer bytes between the host and the module */
+    base::Time getUARTTransferTime(Configuration const& conf, int bytes);
+
+    /** Estimated time the module needs to send bytes over the air
+     *
+     * It accounts for the split in sub-packets and their overhead
+     */
+    base::Time getAirtime(Configuration const& conf, int bytes);
+
+    /** Inter-byte gap that marks the end of an over-the-air packet on the
+     * receiver's UART
+     *
+     * The receiving module outputs each sub-packet in a burst, with a pause of
+     * about one sub-packet airtime between the bursts of a same packet. A
+     * silence longer than this means that the transmitter had nothing more
+     * to send.
+     */
+    base::Time getPacketGap(Configuration const& conf);
+
+    /** Period at which a module in power-saving mode wakes up to listen,
+     * which is also the length of the preamble sent in wake-up mode
+     */
+    base::Time getWakeUpTime(Configuration const& conf);
+
+    /** Time the module needs to reflect on AUX what it was just given,
+     * either bytes on the UART or a change of M0 and M1
+     */
+    base::Time getAUXReactionTime();
+}
+
+#endif
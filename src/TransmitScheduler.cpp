@@ -0,0 +1,188 @@
+#include <comms_lora_ebyte_e32/TransmitScheduler.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Check the number of priority levels before it is used to size the queues
+ *
+ * A negative count would otherwise turn into a huge vector size
+ */
+static int validatePriorityLevels(int priority_levels) {
+    if (priority_levels < 1) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::TransmitScheduler: needs at least one "
+            "priority level"
+        );
+    }
+    return priority_levels;
+}
+
+TransmitScheduler::TransmitScheduler(Driver& driver, int priority_levels)
+    : m_driver(driver)
+    , m_queues(validatePriorityLevels(priority_levels)) {
+    m_stats.sent_frames.resize(priority_levels, 0);
+    m_stats.rejected_frames.resize(priority_levels, 0);
+    m_stats.truncated_frames.resize(priority_levels, 0);
+    m_stats.max_queue_latency.resize(priority_levels);
+    setBurstTime(getAirtime(driver.getLinkConfiguration(), MODULE_BUFFER_SIZE));
+}
+
+void TransmitScheduler::setBurstTime(base::Time const& time) {
+    m_burst_time = time;
+    m_tokens = time;
+}
+
+base::Time TransmitScheduler::getBurstTime() const {
+    return m_burst_time;
+}
+
+void TransmitScheduler::setMaxWriteTime(base::Time const& time) {
+    m_max_write_time = time;
+}
+
+base::Time TransmitScheduler::getMaxWriteTime() const {
+    return m_max_write_time;
+}
+
+void TransmitScheduler::setMaxQueueSize(size_t size) {
+    m_max_queue_size = size;
+}
+
+bool TransmitScheduler::push(int priority, uint16_t target, uint8_t channel,
+                             uint8_t const* buffer, int bufsize,
+                             base::Time const& now) {
+    auto& queue = m_queues.at(priority);
+    if (queue.size() >= m_max_queue_size) {
+        m_stats.rejected_frames[priority]++;
+        return false;
+    }
+
+    Frame frame;
+    frame.target = target;
+    frame.channel = channel;
+    frame.payload.assign(buffer, buffer + bufsize);
+    frame.queued_time = now;
+    queue.push_back(std::move(frame));
+    return true;
+}
+
+void TransmitScheduler::refill(base::Time const& now) {
+    if (!m_last_update.isNull() && now > m_last_update) {
+        m_tokens = std::min(m_burst_time, m_tokens + (now - m_last_update));
+    }
+    m_last_update = now;
+}
+
+base::Time TransmitScheduler::getFrameAirtime(Frame const& frame) const {
+    return getAirtime(m_driver.getLinkConfiguration(),
+                      Driver::FIXED_TRANSMISSION_HEADER_SIZE + frame.payload.size());
+}
+
+base::Time TransmitScheduler::getWriteTimeout(base::Time const& deadline) const {
+    base::Time timeout = m_driver.getWriteTimeout();
+    if (deadline.isNull()) {
+        return timeout;
+    }
+    return std::max(base::Time(), std::min(timeout, deadline - base::Time::now()));
+}
+
+int TransmitScheduler::update(base::Time const& now) {
+    refill(now);
+
+    base::Time deadline;
+    if (!m_max_write_time.isNull()) {
+        deadline = base::Time::now() + m_max_write_time;
+    }
+
+    int sent = 0;
+    for (size_t priority = 0; priority < m_queues.size(); ++priority) {
+        auto& queue = m_queues[priority];
+        while (!queue.empty()) {
+            Frame& frame = queue.front();
+            base::Time airtime = getFrameAirtime(frame);
+            // A frame bigger than the bucket is sent when the bucket is full
+            if (m_tokens < std::min(airtime, m_burst_time) || now < m_uart_ready) {
+                return sent;
+            }
+            else if (!deadline.isNull() && base::Time::now() >= deadline) {
+                return sent;
+            }
+
+            int size = frame.payload.size();
+            int written = m_driver.writeRaw(
+                frame.target, frame.channel, frame.payload.data(), size,
+                getWriteTimeout(deadline)
+            );
+            // The driver's flow control may refuse part of the frame. The
+            // rest must follow in the same transmission: sent later, behind
+            // a new header, it would reach the receiver as a separate frame
+            while (written > 0 && written < size) {
+                int more = m_driver.writeRaw(frame.payload.data() + written,
+                                             size - written,
+                                             getWriteTimeout(deadline));
+                if (more == 0) {
+                    break;
+                }
+                written += more;
+            }
+
+            Configuration const& conf = m_driver.getLinkConfiguration();
+            int bytes = Driver::FIXED_TRANSMISSION_HEADER_SIZE + written;
+            m_tokens = m_tokens - getAirtime(conf, bytes);
+            m_uart_ready = now + getUARTTransferTime(conf, bytes) +
+                           m_driver.getFixedTransmissionGap();
+            if (written == 0) {
+                // Nothing went out, try again on the next update
+                return sent;
+            }
+            else if (written < size) {
+                m_stats.truncated_frames[priority]++;
+                queue.pop_front();
+                continue;
+            }
+
+            m_stats.sent_frames[priority]++;
+            m_stats.max_queue_latency[priority] = std::max(
+                m_stats.max_queue_latency[priority], now - frame.queued_time
+            );
+            queue.pop_front();
+            ++sent;
+        }
+    }
+    return sent;
+}
+
+base::Time TransmitScheduler::getNextSendTime() const {
+    for (auto const& queue : m_queues) {
+        if (queue.empty()) {
+            continue;
+        }
+
+        base::Time needed = std::min(getFrameAirtime(queue.front()), m_burst_time);
+        base::Time refilled = m_last_update;
+        if (m_tokens < needed) {
+            refilled = m_last_update + (needed - m_tokens);
+        }
+        return std::max(refilled, m_uart_ready);
+    }
+    return base::Time();
+}
+
+size_t TransmitScheduler::getQueueSize(int priority) const {
+    return m_queues.at(priority).size();
+}
+
+size_t TransmitScheduler::getQueuedFrameCount() const {
+    size_t count = 0;
+    for (auto const& queue : m_queues) {
+        count += queue.size();
+    }
+    return count;
+}
+
+TransmitScheduler::Statistics const& TransmitScheduler::getStatistics() const {
+    return m_stats;
+}
@@ -0,0 +1,140 @@
+#ifndef COMMS_LORA_EBYTE_E32_TRANSMITSCHEDULER_HPP
+#define COMMS_LORA_EBYTE_E32_TRANSMITSCHEDULER_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+
+    /** Airtime-aware pacing of fixed-transmission frames
+     *
+     * Frames are queued by priority and handed to Driver::writeRaw only when
+     * a token bucket, filled at the rate of one second of airtime per second,
+     * has enough airtime for them. The bucket depth bounds how much data can
+     * wait in the module's buffer, which in turn bounds the latency of a
+     * high-priority frame to the bucket depth plus its own airtime.
+     *
+     * Airtimes are computed from the driver's link configuration (see
+     * Driver::getLinkConfiguration). Consecutive frames are also separated
+     * by the driver's fixed transmission gap (see
+     * Driver::setFixedTransmissionGap), so that the module does not merge
+     * them.
+     *
+     * Priority 0 is the highest. Queues are served in strict priority order,
+     * and in FIFO order within a queue.
+     *
+     * When the driver's flow control refuses part of a frame, the rest is
+     * written right away in the same transmission. A frame that still cannot
+     * be completed within the write timeout is dropped, and counted in
+     * Statistics::truncated_frames.
+     */
+    class TransmitScheduler {
+    public:
+        struct Statistics {
+            /** Frames sent, per priority */
+            std::vector<uint64_t> sent_frames;
+            /** Frames rejected because their queue was full, per priority */
+            std::vector<uint64_t> rejected_frames;
+            /** Frames of which the driver only accepted a part, per priority */
+            std::vector<uint64_t> truncated_frames;
+            /** Worst time spent in the queue, per priority */
+            std::vector<base::Time> max_queue_latency;
+        };
+
+    private:
+        struct Frame {
+            uint16_t target;
+            uint8_t channel;
+            std::vector<uint8_t> payload;
+            base::Time queued_time;
+        };
+
+        Driver& m_driver;
+        std::vector<std::deque<Frame>> m_queues;
+        size_t m_max_queue_size = 64;
+        base::Time m_burst_time;
+        base::Time m_tokens;
+        base::Time m_last_update;
+        /** Time at which the UART has been idle long enough after the last
+         * frame to start the next one
+         */
+        base::Time m_uart_ready;
+        base::Time m_max_write_time;
+        Statistics m_stats;
+
+        void refill(base::Time const& now);
+        base::Time getFrameAirtime(Frame const& frame) const;
+        base::Time getWriteTimeout(base::Time const& deadline) const;
+
+    public:
+        /**
+         * @arg driver the driver frames are written to
+         * @arg priority_levels the number of priority queues
+         */
+        TransmitScheduler(Driver& driver, int priority_levels = 2);
+
+        /** Set the bucket depth, as an amount of airtime
+         *
+         * It defaults to the airtime of a full module buffer, computed from
+         * the link configuration at construction time
+         */
+        void setBurstTime(base::Time const& time);
+
+        /** The bucket depth */
+        base::Time getBurstTime() const;
+
+        /** Bound the time a single update() spends in the driver's writes
+         *
+         * Writes wait for the module's flow control (see
+         * Driver::setAUXMonitor), by default up to the driver's write timeout
+         * each. With a bound, update() stops once it is spent, and leaves
+         * the remaining frames for the next call. A frame that was only
+         * partially written by then is dropped.
+         *
+         * It is measured on the system clock. A null time, the default,
+         * disables the bound
+         */
+        void setMaxWriteTime(base::Time const& time);
+
+        /** The bound on the time spent writing in a single update() */
+        base::Time getMaxWriteTime() const;
+
+        /** Set the maximum number of frames in each priority queue */
+        void setMaxQueueSize(size_t size);
+
+        /** Queue a frame
+         *
+         * @return false if the priority's queue is full
+         */
+        bool push(int priority, uint16_t target, uint8_t channel,
+                  uint8_t const* buffer, int bufsize,
+                  base::Time const& now = base::Time::now());
+
+        /** Send the queued frames allowed by the token bucket
+         *
+         * @return the number of frames sent
+         */
+        int update(base::Time const& now = base::Time::now());
+
+        /** When update() can send the next queued frame
+         *
+         * Use it to compute how long to sleep or poll. It returns a null time
+         * if nothing is queued
+         */
+        base::Time getNextSendTime() const;
+
+        /** Number of frames waiting in a priority queue */
+        size_t getQueueSize(int priority) const;
+
+        /** Number of frames waiting in all queues */
+        size_t getQueuedFrameCount() const;
+
+        /** Scheduling statistics */
+        Statistics const& getStatistics() const;
+    };
+}
+
+#endif
@@ -0,0 +1,55 @@
+#include <comms_lora_ebyte_e32/UARTRateCache.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <cstdlib>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+static bool fromBaudrate(int baudrate, Configuration::UARTRate& rate) {
+    for (int i = Configuration::RATE_1200; i <= Configuration::RATE_115200; ++i) {
+        auto candidate = static_cast<Configuration::UARTRate>(i);
+        if (getUARTBaudrate(candidate) == baudrate) {
+            rate = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+UARTRateCache::UARTRateCache() {
+}
+
+UARTRateCache::UARTRateCache(string const& path)
+    : m_store(path) {
+}
+
+string UARTRateCache::getDeviceKey(string const& uri) {
+    if (uri.compare(0, 9, "serial://") != 0) {
+        return uri;
+    }
+
+    size_t colon = uri.rfind(':');
+    if (colon < 9 || colon == uri.size() - 1 ||
+        uri.find_first_not_of("0123456789", colon + 1) != string::npos) {
+        return uri;
+    }
+    return uri.substr(0, colon);
+}
+
+bool UARTRateCache::get(string const& device, Configuration::UARTRate& rate) const {
+    string baudrate;
+    if (!m_store.get(device, baudrate) ||
+        baudrate.empty() ||
+        baudrate.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    return fromBaudrate(atoi(baudrate.c_str()), rate);
+}
+
+bool UARTRateCache::set(string const& device, Configuration::UARTRate rate) {
+    return m_store.set(device, to_string(getUARTBaudrate(rate)));
+}
+
+bool UARTRateCache::remove(string const& device) {
+    return m_store.remove(device);
+}
@@ -0,0 +1,57 @@
+#ifndef COMMS_LORA_EBYTE_E32_UARTRATECACHE_HPP
+#define COMMS_LORA_EBYTE_E32_UARTRATECACHE_HPP
+
+#include <comms_lora_ebyte_e32/Configuration.hpp>
+#include <comms_lora_ebyte_e32/KeyValueStore.hpp>
+#include <string>
+
+namespace comms_lora_ebyte_e32 {
+    /** Last known UART rate of each device
+     *
+     * It is used by Driver::negotiateUARTRate to try the rate that worked last
+     * first. The entries are stored in a KeyValueStore, as one
+     * 'DEVICE BAUDRATE' line per device, so that an unwritable cache does
+     * not fail a rate that was successfully negotiated.
+     */
+    class UARTRateCache {
+        KeyValueStore m_store;
+
+    public:
+        /** Create an in-memory cache */
+        UARTRateCache();
+
+        /** Create a cache backed by the given file
+         *
+         * The file does not need to exist
+         */
+        explicit UARTRateCache(std::string const& path);
+
+        /** The device part of an iodrivers_base URI
+         *
+         * This removes the baud rate of serial:// URIs, so that the same
+         * device maps to the same cache entry regardless of the rate it was
+         * opened with
+         */
+        static std::string getDeviceKey(std::string const& uri);
+
+        /** Get the rate cached for a device
+         *
+         * @return false if there is none
+         */
+        bool get(std::string const& device, Configuration::UARTRate& rate) const;
+
+        /** Set the rate of a device
+         *
+         * @return false if the cache file could not be updated
+         */
+        bool set(std::string const& device, Configuration::UARTRate rate);
+
+        /** Remove a device from the cache
+         *
+         * @return false if the cache file could not be updated
+         */
+        bool remove(std::string const& device);
+    };
+}
+
+#endif
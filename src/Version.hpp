@@ -1,6 +1,10 @@
 #ifndef COMMS_LORA_EBYTE_E32_VERSION_HPP
 #define COMMS_LORA_EBYTE_E32_VERSION_HPP
 
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
 namespace comms_lora_ebyte_e32 {
     enum Frequency {
         FREQ_INVALID,
@@ -17,7 +21,7 @@ namespace comms_lora_ebyte_e32 {
         uint8_t features = 0;
     };
 
-    std::string to_string(Frequency f) {
+    inline std::string to_string(Frequency f) {
         switch (f) {
             case FREQ_INVALID:
                 return "invalid";
@@ -0,0 +1,191 @@
+#include <comms_lora_ebyte_e32/WakeUpScheduler.hpp>
+#include <comms_lora_ebyte_e32/ConfigurationCodec.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/ModeController.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+WakeUpScheduler::WakeUpScheduler(Driver& driver, ModeController& mode_controller)
+    : m_driver(driver)
+    , m_mode_controller(mode_controller)
+    , m_max_latency(getWakeUpTime(driver.getLinkConfiguration()))
+    , m_max_batch_size(MODULE_BUFFER_SIZE - Driver::FIXED_TRANSMISSION_HEADER_SIZE) {
+}
+
+void WakeUpScheduler::setMaxLatency(base::Time const& latency) {
+    m_max_latency = latency;
+}
+
+base::Time WakeUpScheduler::getMaxLatency() const {
+    return m_max_latency;
+}
+
+void WakeUpScheduler::setMaxBatchSize(int size) {
+    if (size <= Driver::FRAME_HEADER_SIZE ||
+        size > MODULE_BUFFER_SIZE - Driver::FIXED_TRANSMISSION_HEADER_SIZE) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::WakeUpScheduler::setMaxBatchSize: "
+            "invalid batch size " + std::to_string(size)
+        );
+    }
+    m_max_batch_size = size;
+}
+
+void WakeUpScheduler::setMaxQueueSize(size_t size) {
+    m_max_queue_size = size;
+}
+
+base::Time WakeUpScheduler::getBatchDuration(int bytes) const {
+    Configuration const& conf = m_driver.getLinkConfiguration();
+    int uart_bytes = Driver::FIXED_TRANSMISSION_HEADER_SIZE + bytes;
+    return getUARTTransferTime(conf, uart_bytes + PACKET_END_BYTES) +
+           getWakeUpTime(conf) + getAirtime(conf, bytes) + getPacketGap(conf);
+}
+
+bool WakeUpScheduler::push(uint16_t target, uint8_t channel,
+                           uint8_t const* buffer, int bufsize,
+                           base::Time const& now) {
+    int max_size = std::min(Driver::MAX_FRAME_PAYLOAD_SIZE,
+                            m_max_batch_size - Driver::FRAME_HEADER_SIZE);
+    if (bufsize < 1 || bufsize > max_size) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::WakeUpScheduler::push: messages must be "
+            "between 1 and " + std::to_string(max_size) + " bytes"
+        );
+    }
+    else if (channel > MAX_CHANNEL) {
+        throw std::invalid_argument(
+            "comms_lora_ebyte_e32::WakeUpScheduler::push: channel " +
+            std::to_string(channel) + " is out of range"
+        );
+    }
+
+    if (m_queue.size() >= m_max_queue_size) {
+        m_stats.rejected_messages++;
+        return false;
+    }
+
+    Message message;
+    message.target = target;
+    message.channel = channel;
+    message.queued = now;
+    message.payload.assign(buffer, buffer + bufsize);
+    m_queue.push_back(std::move(message));
+    return true;
+}
+
+int WakeUpScheduler::findNextBatch(base::Time& due) const {
+    int next = -1;
+    for (size_t first = 0; first < m_queue.size(); ++first) {
+        Message const& head = m_queue[first];
+        bool seen = false;
+        for (size_t i = 0; i < first && !seen; ++i) {
+            seen = m_queue[i].target == head.target &&
+                   m_queue[i].channel == head.channel;
+        }
+        if (seen) {
+            continue;
+        }
+
+        int bytes = 0;
+        for (size_t i = first; i < m_queue.size(); ++i) {
+            if (m_queue[i].target == head.target &&
+                m_queue[i].channel == head.channel) {
+                bytes += Driver::FRAME_HEADER_SIZE + m_queue[i].payload.size();
+            }
+        }
+        // A full batch does not have to wait for more messages
+        base::Time batch_due = bytes >= m_max_batch_size
+                               ? head.queued
+                               : head.queued + m_max_latency;
+        if (next < 0 || batch_due < due) {
+            next = first;
+            due = batch_due;
+        }
+    }
+    return next;
+}
+
+int WakeUpScheduler::update(base::Time const& now) {
+    if (now < m_busy_until) {
+        return 0;
+    }
+    base::Time due;
+    int first = findNextBatch(due);
+    if (first < 0 || due > now) {
+        return 0;
+    }
+
+    uint16_t target = m_queue[first].target;
+    uint8_t channel = m_queue[first].channel;
+    base::Time oldest = m_queue[first].queued;
+    vector<uint8_t> batch;
+    vector<size_t> messages;
+    for (size_t i = first; i < m_queue.size(); ++i) {
+        Message const& message = m_queue[i];
+        if (message.target != target || message.channel != channel) {
+            continue;
+        }
+        // A message queued before setMaxBatchSize shrank the limit may not
+        // fit in any batch. It is sent alone rather than blocking the queue
+        else if (!batch.empty() &&
+                 static_cast<int>(batch.size() + Driver::FRAME_HEADER_SIZE +
+                                  message.payload.size()) > m_max_batch_size) {
+            break;
+        }
+        batch.push_back(Driver::FRAME_SYNC);
+        batch.push_back(message.payload.size());
+        batch.insert(batch.end(), message.payload.begin(), message.payload.end());
+        messages.push_back(i);
+    }
+
+    m_mode_controller.setMode(ModeController::MODE_WAKE_UP);
+    int written = m_driver.writeRaw(target, channel, batch.data(), batch.size());
+
+    // Only the messages that were completely written are done, the
+    // receiver drops a truncated frame
+    size_t done = 0;
+    int end = 0;
+    for (size_t index : messages) {
+        end += Driver::FRAME_HEADER_SIZE + m_queue[index].payload.size();
+        if (end > written) {
+            break;
+        }
+        done++;
+    }
+
+    base::Time duration = getBatchDuration(written);
+    m_busy_until = now + duration;
+    m_stats.sent_messages += done;
+    m_stats.sent_batches++;
+    m_stats.preamble_time = m_stats.preamble_time +
+                            getWakeUpTime(m_driver.getLinkConfiguration());
+    if (done) {
+        m_stats.max_latency = std::max(m_stats.max_latency,
+                                       now + duration - oldest);
+    }
+
+    for (size_t i = done; i > 0; --i) {
+        m_queue.erase(m_queue.begin() + messages[i - 1]);
+    }
+    return done;
+}
+
+base::Time WakeUpScheduler::getNextSendTime(base::Time const& now) const {
+    base::Time due;
+    if (findNextBatch(due) < 0) {
+        return base::Time();
+    }
+    return std::max(std::max(due, m_busy_until), now);
+}
+
+size_t WakeUpScheduler::getQueuedMessageCount() const {
+    return m_queue.size();
+}
+
+WakeUpScheduler::Statistics const& WakeUpScheduler::getStatistics() const {
+    return m_stats;
+}
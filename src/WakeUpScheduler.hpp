@@ -0,0 +1,152 @@
+#ifndef COMMS_LORA_EBYTE_E32_WAKEUPSCHEDULER_HPP
+#define COMMS_LORA_EBYTE_E32_WAKEUPSCHEDULER_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    class Driver;
+    class ModeController;
+
+    /** Batched transmission of messages to receivers in power-saving mode
+     *
+     * A module in power-saving mode wakes up once per wake-up time to listen
+     * for a preamble. To reach it, the sender must be in wake-up mode, in
+     * which each transmission is preceded by a preamble as long as the
+     * wake-up time, i.e. between 250ms and 2s. That preamble dominates the
+     * cost of short messages, for both ends.
+     *
+     * The scheduler queues messages per target and channel, and sends all
+     * the messages of a target in a single transmission, so that they share
+     * a preamble. A target's messages are sent when the oldest one has waited
+     * for the maximum latency, or when they fill a batch. A new batch is
+     * only started once the previous one is over the air, as a transmission
+     * that follows another without a pause does not get its own preamble.
+     *
+     * Messages are framed as by Driver::writeFrame, and are split on the
+     * receiving side by Driver::readPacket in PACKET_MODE_LENGTH_PREFIXED.
+     * The module must be in fixed transmission mode. The scheduler switches
+     * it to wake-up mode before sending, and leaves it there. Airtimes are
+     * computed from the driver's link configuration, whose wake-up time must
+     * be the one of the receivers.
+     */
+    class WakeUpScheduler {
+    public:
+        struct Statistics {
+            /** Messages sent */
+            uint64_t sent_messages = 0;
+            /** Transmissions, i.e. preambles, used to send them */
+            uint64_t sent_batches = 0;
+            /** Messages rejected because the queue was full */
+            uint64_t rejected_messages = 0;
+            /** Time spent sending preambles */
+            base::Time preamble_time;
+            /** Longest estimated time between the queueing of a message and
+             * its reception
+             */
+            base::Time max_latency;
+        };
+
+    private:
+        struct Message {
+            uint16_t target;
+            uint8_t channel;
+            base::Time queued;
+            std::vector<uint8_t> payload;
+        };
+
+        Driver& m_driver;
+        ModeController& m_mode_controller;
+        base::Time m_max_latency;
+        int m_max_batch_size;
+        size_t m_max_queue_size = 64;
+        std::deque<Message> m_queue;
+        base::Time m_busy_until;
+        Statistics m_stats;
+
+        /** Find the batch that becomes due first
+         *
+         * @arg due set to the time at which the batch is due, regardless of
+         *   the transmission in progress
+         * @return the index in the queue of the batch's first message, or -1
+         *   if the queue is empty
+         */
+        int findNextBatch(base::Time& due) const;
+
+    public:
+        /**
+         * @arg driver the driver batches are written to
+         * @arg mode_controller the controller used to switch the module to
+         *   wake-up mode
+         */
+        WakeUpScheduler(Driver& driver, ModeController& mode_controller);
+
+        /** Set how long a message may wait for others to share its preamble
+         *
+         * It defaults to the wake-up time of the driver's link configuration
+         * at construction. The latency of a message is at most this, plus
+         * the duration of the batch that is on the air when it becomes due,
+         * plus the duration of its own batch (see getBatchDuration).
+         */
+        void setMaxLatency(base::Time const& latency);
+
+        base::Time getMaxLatency() const;
+
+        /** Set the maximum size of a batch, including the framing of each
+         * message
+         *
+         * It defaults to the size of the module's buffer, minus the fixed
+         * transmission header. Queued messages that are larger than the new
+         * size are sent in a batch of their own
+         */
+        void setMaxBatchSize(int size);
+
+        /** Set the maximum number of queued messages */
+        void setMaxQueueSize(size_t size);
+
+        /** Estimated time from the start of the batch's transfer on the UART
+         * to the end of its reception
+         *
+         * @arg bytes the size of the batch, including the framing of each
+         *   message
+         */
+        base::Time getBatchDuration(int bytes) const;
+
+        /** Queue a message
+         *
+         * @arg now the time the message is queued at, from which its latency
+         *   is counted
+         * @return false if the queue is full
+         * @throw std::invalid_argument if the message does not fit in a batch
+         */
+        bool push(uint16_t target, uint8_t channel,
+                  uint8_t const* buffer, int bufsize,
+                  base::Time const& now = base::Time::now());
+
+        /** Send the batch that is due, if any
+         *
+         * Call it often enough, e.g. at the times returned by
+         * getNextSendTime
+         *
+         * @return the number of messages sent
+         * @throw iodrivers_base::TimeoutError if switching to wake-up mode
+         *   failed
+         */
+        int update(base::Time const& now = base::Time::now());
+
+        /** When update() will send the next batch
+         *
+         * It returns a null time if nothing is queued
+         */
+        base::Time getNextSendTime(base::Time const& now = base::Time::now()) const;
+
+        /** Number of messages waiting to be sent */
+        size_t getQueuedMessageCount() const;
+
+        Statistics const& getStatistics() const;
+    };
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include <comms_lora_ebyte_e32/WakeUpTradeoff.hpp>
+#include <comms_lora_ebyte_e32/ConfigurationCodec.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <algorithm>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+WakeUpTradeoff comms_lora_ebyte_e32::computeWakeUpTradeoff(
+    Configuration const& conf, int batch_size, base::Time const& batch_period,
+    PowerModel const& model
+) {
+    WakeUpTradeoff result;
+    result.wireless_wake_up_time = conf.wireless_wake_up_time;
+    result.wake_up_time = getWakeUpTime(conf);
+
+    double wake_up_time = result.wake_up_time.toSeconds();
+    double airtime = getAirtime(conf, batch_size).toSeconds();
+    int uart_bytes =
+        Driver::FIXED_TRANSMISSION_HEADER_SIZE + batch_size + PACKET_END_BYTES;
+    result.latency = getUARTTransferTime(conf, uart_bytes) +
+                     result.wake_up_time + getAirtime(conf, batch_size);
+    result.transmit_charge = model.transmit_current * (wake_up_time + airtime);
+
+    double listening = std::min(1.0, model.listen_time.toSeconds() / wake_up_time);
+    result.idle_current = listening * model.receive_current +
+                          (1 - listening) * model.sleep_current;
+
+    double receiving = 1;
+    if (!batch_period.isNull()) {
+        receiving = std::min(
+            1.0, (wake_up_time / 2 + airtime) / batch_period.toSeconds()
+        );
+    }
+    result.average_current = std::min(
+        model.receive_current,
+        result.idle_current +
+            receiving * (model.receive_current - model.sleep_current)
+    );
+    return result;
+}
+
+vector<WakeUpTradeoff> comms_lora_ebyte_e32::computeWakeUpTradeoffs(
+    Configuration const& conf, int batch_size, base::Time const& batch_period,
+    PowerModel const& model
+) {
+    vector<WakeUpTradeoff> result;
+    Configuration setting = conf;
+    for (int i = 0; i <= MAX_WIRELESS_WAKE_UP_TIME; ++i) {
+        setting.wireless_wake_up_time = i;
+        result.push_back(
+            computeWakeUpTradeoff(setting, batch_size, batch_period, model)
+        );
+    }
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef COMMS_LORA_EBYTE_E32_WAKEUPTRADEOFF_HPP
+#define COMMS_LORA_EBYTE_E32_WAKEUPTRADEOFF_HPP
+
+#include <base/Time.hpp>
+#include <comms_lora_ebyte_e32/Configuration.hpp>
+#include <comms_lora_ebyte_e32/PowerModel.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace comms_lora_ebyte_e32 {
+    /** Latency and energy cost of a wireless wake-up time setting
+     *
+     * A longer wake-up time lets the receiver sleep longer between two
+     * wake-ups, but makes each transmission longer, as it starts with a
+     * preamble of that length. The receiver wakes up at a random point of the
+     * preamble, and listens to the rest of it, i.e. half of it on average.
+     */
+    struct WakeUpTradeoff {
+        /** The setting, see Configuration::wireless_wake_up_time */
+        uint8_t wireless_wake_up_time = 0;
+
+        /** The corresponding wake-up time, i.e. preamble length */
+        base::Time wake_up_time;
+
+        /** Time from the start of a batch's transfer on the transmitter's
+         * UART to its reception, queueing excluded
+         */
+        base::Time latency;
+
+        /** Charge drawn by the transmitter to send a batch, in mA.s */
+        double transmit_charge = 0;
+
+        /** Average current of the receiver without traffic, in mA */
+        double idle_current = 0;
+
+        /** Average current of the receiver with the given traffic, in mA */
+        double average_current = 0;
+    };
+
+    /** Compute the tradeoff of the configuration's wake-up time
+     *
+     * @arg batch_size the size of each transmission
+     * @arg batch_period the average time between two transmissions to the
+     *   receiver
+     */
+    WakeUpTradeoff computeWakeUpTradeoff(Configuration const& conf,
+                                         int batch_size,
+                                         base::Time const& batch_period,
+                                         PowerModel const& model = PowerModel());
+
+    /** Compute the tradeoff of each wake-up time, from the shortest to the
+     * longest
+     *
+     * The other parameters of the configuration are used as-is
+     */
+    std::vector<WakeUpTradeoff> computeWakeUpTradeoffs(
+        Configuration const& conf, int batch_size,
+        base::Time const& batch_period, PowerModel const& model = PowerModel()
+    );
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef COMMS_LORA_EBYTE_E32_TEST_BENCHMARK_HPP
+#define COMMS_LORA_EBYTE_E32_TEST_BENCHMARK_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace comms_lora_ebyte_e32 {
+    /** Helpers shared by the benchmark executables */
+    namespace benchmark {
+        /** CPU time used by the calling thread, in seconds */
+        inline double threadCPUTime() {
+            timespec ts;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            return ts.tv_sec + ts.tv_nsec * 1e-9;
+        }
+
+        /** Open a pty with both sides in raw mode
+         *
+         * @arg master set to the file descriptor of the master side
+         * @return the file descriptor of the slave side
+         */
+        inline int openPTY(int& master) {
+            master = posix_openpt(O_RDWR | O_NOCTTY);
+            if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+                throw std::runtime_error("failed to create pty");
+            }
+            int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+            if (slave < 0) {
+                throw std::runtime_error("failed to open pty slave");
+            }
+            termios tio;
+            tcgetattr(slave, &tio);
+            cfmakeraw(&tio);
+            tcsetattr(slave, TCSANOW, &tio);
+            tcgetattr(master, &tio);
+            cfmakeraw(&tio);
+            tcsetattr(master, TCSANOW, &tio);
+            return slave;
+        }
+
+        /** Read and discard everything received on fd until quit is set */
+        inline void drain(int fd, std::atomic<bool>& quit) {
+            uint8_t buffer[4096];
+            while (!quit) {
+                pollfd pfd = { fd, POLLIN, 0 };
+                if (poll(&pfd, 1, 10) > 0) {
+                    if (read(fd, buffer, sizeof(buffer)) < 0) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/ReliableLink.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Goodput of ReliableLink through a lossy simulated link
+ *
+ * Compares stop-and-wait (a window of one) with selective repeat at
+ * various loss rates. The loss applies to the sub-packets in both
+ * directions, i.e. to data frames and acknowledgments alike.
+ *
+ * The output format is the one of benchmark_driver. The optional argument
+ * scales the number of packets.
+ */
+
+static const double LOSS_RATES[] = { 0, 0.05, 0.1, 0.2, 0.3 };
+static const int WINDOWS[] = { 1, 8 };
+
+static void report(string const& benchmark, string const& parameter,
+                   string const& metric, double value, string const& unit) {
+    cout << benchmark << " " << parameter << " " << metric << " "
+         << value << " " << unit << endl;
+}
+
+static void benchmarkARQ(int packets) {
+    for (double loss : LOSS_RATES) {
+        for (int window : WINDOWS) {
+            Simulator simulator;
+            Driver drivers[2];
+            Configuration conf;
+            for (int i = 0; i < 2; ++i) {
+                conf.uart_rate = Configuration::RATE_115200;
+                conf.air_rate = Configuration::AIR_RATE_19200;
+                conf.transparent_transmission = false;
+                conf.address = i + 1;
+                simulator.addModule(conf);
+                drivers[i].setFileDescriptor(simulator.openDevice(i));
+                drivers[i].setLinkConfiguration(conf);
+                drivers[i].setAUXMonitor(&simulator.getAUX(i));
+            }
+            simulator.setPacketLoss(loss);
+            simulator.start();
+
+            ReliableLink tx(drivers[0], 2, conf.channel, window);
+            ReliableLink rx(drivers[1], 1, conf.channel, window);
+
+            atomic<bool> done(false);
+            int received = 0;
+            base::Time start = simulator.now();
+            base::Time end;
+            thread receiver([&]() {
+                uint8_t buffer[ReliableLink::DEFAULT_MAX_PACKET_SIZE];
+                while (!done) {
+                    try {
+                        received += rx.receive(buffer, sizeof(buffer),
+                                               base::Time::fromMilliseconds(50));
+                        end = simulator.now();
+                    }
+                    catch (iodrivers_base::TimeoutError const&) {
+                    }
+                }
+            });
+
+            vector<uint8_t> packet(ReliableLink::DEFAULT_MAX_PACKET_SIZE, 0x42);
+            for (int i = 0; i < packets; ++i) {
+                tx.send(packet.data(), packet.size());
+            }
+            tx.flush(base::Time::fromSeconds(120));
+            done = true;
+            receiver.join();
+            for (int i = 0; i < 2; ++i) {
+                drivers[i].setAUXMonitor(nullptr);
+            }
+
+            double goodput = received * 8 / (end - start).toSeconds();
+            auto stats = tx.getStatistics();
+            string parameter = "loss=" + to_string(loss) +
+                               ",window=" + to_string(window);
+            report("arq", parameter, "goodput", goodput, "bit/s");
+            report("arq", parameter, "efficiency",
+                   goodput / getAirBitrate(conf.air_rate), "-");
+            report("arq", parameter, "retransmissions",
+                   stats.retransmissions, "frames");
+            // Sub-packets that arrived while the receiver was transmitting
+            report("arq", parameter, "collisions",
+                   simulator.getStatus(0).missed_sub_packets +
+                   simulator.getStatus(1).missed_sub_packets, "sub-packets");
+            report("arq", parameter, "srtt",
+                   tx.getSRTT().toSeconds() * 1e3, "ms");
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    cout << "benchmark parameter metric value unit\n";
+    benchmarkARQ(std::max<int>(10, 100 * scale));
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <comms_lora_ebyte_e32/CompressedLink.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Effective goodput of CompressedLink at low air rates
+ *
+ * Sends telemetry-like JSON samples through simulated modules, once as
+ * plain frames and once through a CompressedLink whose dictionary was
+ * trained on other samples, and compares the goodput of both against the
+ * configured air rate.
+ *
+ * The output format is the one of benchmark_driver. The optional argument
+ * scales the number of samples.
+ */
+
+static const Configuration::AirRate AIR_RATES[] = {
+    Configuration::AIR_RATE_300, Configuration::AIR_RATE_1200,
+    Configuration::AIR_RATE_2400
+};
+
+static vector<uint8_t> telemetry(int i) {
+    char buffer[256];
+    int size = snprintf(
+        buffer, sizeof(buffer),
+        "{\"time\":%d,\"latitude\":48.%06d,\"longitude\":-4.%06d,"
+        "\"heading\":%d,\"speed\":%d.%d,\"battery_voltage\":12.%d}",
+        100000 + i, 123456 + i * 3, 654321 - i * 2, (i * 7) % 360,
+        i % 5, i % 10, 90 - i % 10
+    );
+    return vector<uint8_t>(buffer, buffer + size);
+}
+
+static void report(string const& benchmark, string const& parameter,
+                   string const& metric, double value, string const& unit) {
+    cout << benchmark << " " << parameter << " " << metric << " "
+         << value << " " << unit << endl;
+}
+
+/** Send the samples and return the goodput in bit/s of simulated time */
+static double measureGoodput(Configuration::AirRate rate,
+                             vector<vector<uint8_t>> const& samples,
+                             vector<uint8_t> const* dictionary) {
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    conf.air_rate = rate;
+
+    int bytes = 0;
+    for (auto const& sample : samples) {
+        bytes += sample.size();
+    }
+    // Run for about one second of real time
+    double scale = std::max(1.0, getAirtime(conf, bytes).toSeconds());
+
+    Simulator simulator;
+    simulator.addModule(conf);
+    simulator.addModule(conf);
+    simulator.setTimeScale(scale);
+    Driver drivers[2];
+    for (int i = 0; i < 2; ++i) {
+        drivers[i].setFileDescriptor(simulator.openDevice(i));
+        drivers[i].setLinkConfiguration(conf);
+    }
+    drivers[0].setAUXMonitor(&simulator.getAUX(0));
+    drivers[1].setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    simulator.start();
+
+    unique_ptr<CompressedLink> tx;
+    unique_ptr<CompressedLink> rx;
+    if (dictionary) {
+        tx.reset(new CompressedLink(drivers[0], *dictionary));
+        rx.reset(new CompressedLink(drivers[1], *dictionary));
+    }
+
+    base::Time start = simulator.now();
+    thread writer([&]() {
+        for (auto const& sample : samples) {
+            if (tx) {
+                tx->send(sample.data(), sample.size());
+            }
+            else {
+                drivers[0].writeFrame(sample.data(), sample.size());
+            }
+        }
+    });
+
+    int received = 0;
+    uint8_t buffer[Driver::MAX_PACKET_SIZE];
+    for (size_t i = 0; i < samples.size(); ++i) {
+        try {
+            if (rx) {
+                received += rx->receive(buffer, Driver::MAX_PACKET_SIZE,
+                                        base::Time::fromSeconds(2));
+            }
+            else {
+                received += drivers[1].readPacket(buffer, Driver::MAX_PACKET_SIZE,
+                                                  base::Time::fromSeconds(2)) -
+                            Driver::FRAME_HEADER_SIZE;
+            }
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+            break;
+        }
+    }
+    double elapsed = (simulator.now() - start).toSeconds();
+    writer.join();
+    drivers[0].setAUXMonitor(nullptr);
+    return received * 8 / elapsed;
+}
+
+static void benchmarkCompression(int count) {
+    vector<vector<uint8_t>> training;
+    for (int i = 0; i < 100; ++i) {
+        training.push_back(telemetry(i));
+    }
+    auto dictionary = Compressor::train(training, 1024);
+
+    vector<vector<uint8_t>> samples;
+    int bytes = 0;
+    for (int i = 0; i < count; ++i) {
+        samples.push_back(telemetry(1000 + i * 13));
+        bytes += samples.back().size();
+    }
+
+    Compressor compressor(dictionary);
+    int compressed = 0;
+    for (auto const& sample : samples) {
+        uint8_t out[Driver::MAX_FRAME_PAYLOAD_SIZE];
+        compressed += compressor.compress(sample.data(), sample.size(),
+                                          out, sizeof(out));
+    }
+    report("compression", "dictionary=" + to_string(dictionary.size()),
+           "ratio", static_cast<double>(bytes) / compressed, "-");
+
+    for (auto rate : AIR_RATES) {
+        double plain = measureGoodput(rate, samples, nullptr);
+        double compressed = measureGoodput(rate, samples, &dictionary);
+
+        string parameter = "air_rate=" + to_string(getAirBitrate(rate));
+        report("compression", parameter, "plain_goodput", plain, "bit/s");
+        report("compression", parameter, "compressed_goodput",
+               compressed, "bit/s");
+        report("compression", parameter, "plain_efficiency",
+               plain / getAirBitrate(rate), "-");
+        report("compression", parameter, "compressed_efficiency",
+               compressed / getAirBitrate(rate), "-");
+        report("compression", parameter, "speedup", compressed / plain, "-");
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    cout << "benchmark parameter metric value unit\n";
+    benchmarkCompression(std::max<int>(10, 50 * scale));
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+using namespace comms_lora_ebyte_e32::benchmark;
+
+/** Benchmarks of the driver's data and command paths
+ *
+ * The write and read paths run on a loopback pty, the command round-trips
+ * and the end-to-end goodput on simulated modules (see Simulator).
+ *
+ * Each result is written on its own line as
+ *
+ *   benchmark parameter metric value unit
+ *
+ * so that results of different releases can be compared with standard text
+ * tools. The optional argument scales the number of iterations.
+ */
+
+static const Configuration::UARTRate UART_RATES[] = {
+    Configuration::RATE_1200, Configuration::RATE_2400,
+    Configuration::RATE_4800, Configuration::RATE_9600,
+    Configuration::RATE_19200, Configuration::RATE_38400,
+    Configuration::RATE_57600, Configuration::RATE_115200
+};
+
+static const Configuration::AirRate AIR_RATES[] = {
+    Configuration::AIR_RATE_300, Configuration::AIR_RATE_1200,
+    Configuration::AIR_RATE_2400, Configuration::AIR_RATE_4800,
+    Configuration::AIR_RATE_9600, Configuration::AIR_RATE_19200
+};
+
+static double median(vector<double> values) {
+    sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static double percentile99(vector<double> values) {
+    sort(values.begin(), values.end());
+    return values[values.size() * 99 / 100];
+}
+
+static void report(string const& benchmark, string const& parameter,
+                   string const& metric, double value, string const& unit) {
+    cout << benchmark << " " << parameter << " " << metric << " "
+         << value << " " << unit << endl;
+}
+
+/** Cost of fixed transmission writes on a pty
+ *
+ * Driver::writeRaw does not wait for the fixed transmission gap, which is
+ * left to the callers (see Driver::setFixedTransmissionGap). The numbers are
+ * therefore the driver and kernel cost of the writes, not the UART pacing
+ */
+static void benchmarkWriteRaw(int frames) {
+    int master;
+    int slave = openPTY(master);
+    atomic<bool> quit(false);
+    thread drainer(drain, master, std::ref(quit));
+
+    Driver driver;
+    driver.setFileDescriptor(slave);
+
+    for (int size : { 16, 55, 256, 509 }) {
+        vector<uint8_t> payload(size, 0x42);
+
+        base::Time start = base::Time::now();
+        double cpu_start = threadCPUTime();
+        for (int i = 0; i < frames; ++i) {
+            driver.writeRaw(0x1234, 0x12, payload.data(), size);
+        }
+        double cpu = threadCPUTime() - cpu_start;
+        double elapsed = (base::Time::now() - start).toSeconds();
+
+        string parameter = "payload=" + to_string(size);
+        report("write_raw", parameter, "frames_per_s", frames / elapsed, "1/s");
+        report("write_raw", parameter, "cpu_per_byte",
+               cpu / (static_cast<double>(frames) * size) * 1e9, "ns");
+    }
+
+    quit = true;
+    drainer.join();
+    driver.close();
+    close(master);
+}
+
+static void benchmarkReadRaw(int samples) {
+    int master;
+    int slave = openPTY(master);
+
+    Driver driver;
+    driver.setFileDescriptor(slave);
+
+    vector<double> latencies;
+    atomic<int64_t> sent_at(0);
+    for (int i = 0; i < samples; ++i) {
+        // An exception escaping the thread would terminate the process, pass
+        // it back instead
+        exception_ptr error;
+        thread writer([master, &sent_at, &error]() {
+            try {
+                this_thread::sleep_for(chrono::microseconds(200));
+                uint8_t byte = 0x42;
+                sent_at = base::Time::now().toMicroseconds();
+                if (write(master, &byte, 1) != 1) {
+                    throw std::runtime_error("failed to write on pty");
+                }
+            }
+            catch (...) {
+                error = current_exception();
+            }
+        });
+
+        uint8_t byte;
+        driver.readRaw(&byte, 1, base::Time::fromSeconds(1));
+        base::Time received = base::Time::now();
+        writer.join();
+        if (error) {
+            rethrow_exception(error);
+        }
+        latencies.push_back(received.toMicroseconds() - sent_at);
+    }
+
+    report("read_raw", "-", "first_byte_latency_median", median(latencies), "us");
+    report("read_raw", "-", "first_byte_latency_p99",
+           percentile99(latencies), "us");
+
+    driver.close();
+    close(master);
+}
+
+static void benchmarkCommands(int samples) {
+    for (auto rate : UART_RATES) {
+        Configuration conf;
+        conf.uart_rate = rate;
+
+        Version version;
+        version.frequency = FREQ_868MHZ;
+        Simulator simulator;
+        simulator.addModule(conf, version);
+        simulator.setMode(0, Simulator::MODE_SLEEP);
+        Driver driver;
+        driver.setFileDescriptor(simulator.openDevice(0));
+        simulator.start();
+
+        vector<double> version_rtt;
+        vector<double> configuration_rtt;
+        for (int i = 0; i < samples; ++i) {
+            base::Time start = base::Time::now();
+            driver.readVersion();
+            version_rtt.push_back((base::Time::now() - start).toSeconds() * 1e3);
+
+            start = base::Time::now();
+            driver.readConfiguration();
+            configuration_rtt.push_back(
+                (base::Time::now() - start).toSeconds() * 1e3
+            );
+        }
+
+        string parameter = "uart_rate=" + to_string(getUARTBaudrate(rate));
+        report("commands", parameter, "read_version_rtt_median",
+               median(version_rtt), "ms");
+        report("commands", parameter, "read_configuration_rtt_median",
+               median(configuration_rtt), "ms");
+    }
+}
+
+static void benchmarkGoodput(int bytes) {
+    for (auto rate : AIR_RATES) {
+        Configuration conf;
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = rate;
+
+        // Run each air rate for about one second of real time
+        double scale = std::max(1.0, getAirtime(conf, bytes).toSeconds());
+
+        Simulator simulator;
+        simulator.addModule(conf);
+        simulator.addModule(conf);
+        simulator.setTimeScale(scale);
+        Driver tx;
+        tx.setFileDescriptor(simulator.openDevice(0));
+        tx.setLinkConfiguration(conf);
+        tx.setAUXMonitor(&simulator.getAUX(0));
+        Driver rx;
+        rx.setFileDescriptor(simulator.openDevice(1));
+        rx.setLinkConfiguration(conf);
+        rx.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+        simulator.start();
+
+        base::Time start = simulator.now();
+        thread writer([&tx, bytes]() {
+            // One sub-packet per frame
+            static const int FRAME_SIZE =
+                SUB_PACKET_SIZE - Driver::FRAME_HEADER_SIZE;
+            vector<uint8_t> payload(bytes, 0x42);
+            int written = 0;
+            while (written < bytes) {
+                written += tx.writeFrame(payload.data() + written,
+                                         std::min(FRAME_SIZE, bytes - written));
+            }
+        });
+
+        int received = 0;
+        uint8_t buffer[Driver::MAX_PACKET_SIZE];
+        while (received < bytes) {
+            try {
+                received += rx.readPacket(buffer, Driver::MAX_PACKET_SIZE,
+                                          base::Time::fromSeconds(1)) -
+                            Driver::FRAME_HEADER_SIZE;
+            }
+            catch (iodrivers_base::TimeoutError const&) {
+                break;
+            }
+        }
+        double elapsed = (simulator.now() - start).toSeconds();
+        writer.join();
+        tx.setAUXMonitor(nullptr);
+
+        double goodput = received * 8 / elapsed;
+        string parameter = "air_rate=" + to_string(getAirBitrate(rate));
+        report("goodput", parameter, "goodput", goodput, "bit/s");
+        report("goodput", parameter, "efficiency",
+               goodput / getAirBitrate(rate), "-");
+        report("goodput", parameter, "lost_bytes", bytes - received, "B");
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    cout << "benchmark parameter metric value unit\n";
+    benchmarkWriteRaw(20000 * scale);
+    benchmarkReadRaw(1000 * scale);
+    benchmarkCommands(std::max<int>(1, 10 * scale));
+    benchmarkGoodput(std::max<int>(MODULE_BUFFER_SIZE, 4096 * scale));
+    return 0;
+}
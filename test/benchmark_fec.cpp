@@ -0,0 +1,130 @@
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/FECLink.hpp>
+#include <comms_lora_ebyte_e32/ReedSolomon.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Host-side erasure coding against the module's own FEC
+ *
+ * The first benchmark measures the encoding throughput of ReedSolomon. The
+ * second sends packets over a simulated channel that loses sub-packets with
+ * a fixed probability, reduced four times when the module's FEC is enabled
+ * (which also lowers its effective air rate), and reports the goodput and
+ * fraction of delivered packets of FECLink with an increasing number of
+ * parity shards.
+ *
+ * The output format is the one of benchmark_driver. The optional argument
+ * scales the duration of each run.
+ */
+
+static const double SUB_PACKET_LOSS = 0.1;
+static const int DATA_SHARDS = 4;
+
+static void report(string const& benchmark, string const& parameter,
+                   string const& metric, double value, string const& unit) {
+    cout << benchmark << " " << parameter << " " << metric << " "
+         << value << " " << unit << endl;
+}
+
+static void benchmarkEncoding(double scale) {
+    int const shard_size = FECLink::MAX_SHARD_SIZE;
+    int const codes[][2] = { { 4, 2 }, { 8, 4 }, { 16, 15 } };
+    for (auto const& code : codes) {
+        ReedSolomon codec(code[0], code[1]);
+        vector<vector<uint8_t>> shards(
+            code[0] + code[1], vector<uint8_t>(shard_size, 0x42)
+        );
+        vector<uint8_t*> pointers;
+        for (auto& shard : shards) {
+            pointers.push_back(shard.data());
+        }
+
+        int iterations = std::max(1000.0, 100000 * scale);
+        base::Time start = base::Time::now();
+        for (int i = 0; i < iterations; ++i) {
+            codec.encode(pointers.data(), pointers.data() + code[0], shard_size);
+        }
+        base::Time elapsed = base::Time::now() - start;
+
+        string parameter = "k=" + to_string(code[0]) + ",m=" + to_string(code[1]);
+        double bytes = static_cast<double>(iterations) * code[0] * shard_size;
+        report("fec_encode", parameter, "throughput",
+               bytes / elapsed.toSeconds() / 1e6, "MB/s");
+    }
+}
+
+static void benchmarkLink(base::Time const& duration, bool module_fec, int parity) {
+    Simulator simulator;
+    Driver drivers[2];
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    conf.error_correction_enabled = module_fec;
+    for (int i = 0; i < 2; ++i) {
+        simulator.addModule(conf);
+        drivers[i].setFileDescriptor(simulator.openDevice(i));
+        drivers[i].setLinkConfiguration(conf);
+    }
+    drivers[0].setAUXMonitor(&simulator.getAUX(0));
+    simulator.setLossModel([](Configuration const& from, Configuration const&) {
+        return from.error_correction_enabled ? SUB_PACKET_LOSS / 4 : SUB_PACKET_LOSS;
+    });
+    simulator.start();
+
+    FECLink tx(drivers[0], DATA_SHARDS, parity);
+    FECLink rx(drivers[1], DATA_SHARDS, parity);
+    vector<uint8_t> packet(tx.getMaxPacketSize(), 0x42);
+    uint8_t buffer[1024];
+
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    base::Time start = base::Time::now();
+    while (base::Time::now() - start < duration) {
+        tx.send(packet.data(), packet.size());
+        ++sent;
+        simulator.getAUX(0).waitReady(base::Time::fromSeconds(1));
+        try {
+            rx.receive(buffer, sizeof(buffer), base::Time::fromMilliseconds(50));
+            ++received;
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+        }
+    }
+    base::Time elapsed = base::Time::now() - start;
+    // Collect the packets whose last shards are still on their way
+    try {
+        while (true) {
+            rx.receive(buffer, sizeof(buffer), base::Time::fromMilliseconds(100));
+            ++received;
+        }
+    }
+    catch (iodrivers_base::TimeoutError const&) {
+    }
+
+    string parameter = string("module_fec=") + (module_fec ? "on" : "off") +
+                       ",k=" + to_string(DATA_SHARDS) + ",m=" + to_string(parity);
+    report("fec_link", parameter, "delivered",
+           static_cast<double>(received) / sent, "-");
+    report("fec_link", parameter, "goodput",
+           received * packet.size() * 8 / elapsed.toSeconds(), "bit/s");
+    report("fec_link", parameter, "recovered",
+           rx.getStatistics().recovered_shards, "shards");
+}
+
+int main(int argc, char** argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    cout << "benchmark parameter metric value unit\n";
+    benchmarkEncoding(scale);
+
+    base::Time duration = base::Time::fromSeconds(std::max(0.5, 3 * scale));
+    benchmarkLink(duration, true, 0);
+    for (int parity : { 0, 1, 2, 4 }) {
+        benchmarkLink(duration, false, parity);
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/MockAUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include "Benchmark.hpp"
+#include <atomic>
+#include <iostream>
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+using namespace comms_lora_ebyte_e32::benchmark;
+
+/** Shows the effect of AUX-based flow control on a simulated link
+ *
+ * A thread plays the role of the module: it reads the master side of a pty
+ * into a 512-byte buffer, drains that buffer at the configured air rate,
+ * drops whatever does not fit and drives a MockAUXMonitor. The driver writes
+ * 58-byte frames as fast as it can, with and without flow control.
+ */
+
+struct SimulatedModule {
+    int fd;
+    Configuration conf;
+    MockAUXMonitor& aux;
+    atomic<bool> quit;
+    atomic<uint64_t> sent;
+    atomic<uint64_t> dropped;
+
+    SimulatedModule(int fd, Configuration const& conf, MockAUXMonitor& aux)
+        : fd(fd), conf(conf), aux(aux), quit(false), sent(0), dropped(0) {}
+
+    void run() {
+        double bytes_per_second = getEffectiveAirBitrate(conf) / 8;
+        int buffer_usage = 0;
+        base::Time last = base::Time::now();
+        uint8_t buffer[1024];
+        while (!quit) {
+            pollfd pfd = { fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 1) > 0) {
+                int n = read(fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    int accepted = min(n, MODULE_BUFFER_SIZE - buffer_usage);
+                    buffer_usage += accepted;
+                    dropped += n - accepted;
+                }
+            }
+
+            base::Time now = base::Time::now();
+            int drained = min<int>(buffer_usage,
+                                   (now - last).toSeconds() * bytes_per_second);
+            if (drained > 0) {
+                buffer_usage -= drained;
+                sent += drained;
+                last = now;
+            }
+            else if (buffer_usage == 0) {
+                last = now;
+            }
+            aux.setReady(buffer_usage == 0);
+        }
+    }
+};
+
+static void run(bool flow_control, base::Time const& duration) {
+    int master;
+    int slave = openPTY(master);
+
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    conf.air_rate = Configuration::AIR_RATE_19200;
+
+    MockAUXMonitor aux;
+    SimulatedModule module(master, conf, aux);
+    thread module_thread(&SimulatedModule::run, &module);
+
+    Driver driver;
+    driver.setFileDescriptor(slave);
+    driver.setLinkConfiguration(conf);
+    if (flow_control) {
+        driver.setAUXMonitor(&aux);
+    }
+
+    // Pace the writes at the UART rate, as the real UART would
+    vector<uint8_t> payload(SUB_PACKET_SIZE - Driver::FIXED_TRANSMISSION_HEADER_SIZE);
+    base::Time start = base::Time::now();
+    while (base::Time::now() - start < duration) {
+        driver.writeRaw(0x1234, 0x12, payload.data(), payload.size(),
+                        base::Time::fromMilliseconds(100));
+        this_thread::sleep_for(chrono::microseconds(
+            getUARTTransferTime(conf, SUB_PACKET_SIZE).toMicroseconds()
+        ));
+    }
+    double elapsed = (base::Time::now() - start).toSeconds();
+    driver.setAUXMonitor(nullptr);
+
+    module.quit = true;
+    module_thread.join();
+    close(master);
+
+    auto stats = driver.getFlowControlStatistics();
+    cout << (flow_control ? "aux" : "none") << " "
+         << stats.tx_bytes / elapsed << " "
+         << module.sent / elapsed << " "
+         << module.dropped << " "
+         << stats.busy_waits << " "
+         << stats.short_writes << endl;
+}
+
+int main(int argc, char** argv) {
+    base::Time duration = base::Time::fromSeconds(argc > 1 ? atof(argv[1]) : 5);
+
+    cout << "flow_control written_bytes_per_s sent_bytes_per_s module_drops "
+            "busy_waits short_writes\n";
+    run(false, duration);
+    run(true, duration);
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/HoppingScheduler.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <iostream>
+#include <memory>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Aggregate throughput of a saturated multi-node network
+ *
+ * Each node of the network constantly has a frame queued for every other
+ * node, and HoppingScheduler sends them according to a ChannelPlan over
+ * an increasing number of channels.
+ *
+ * The output format is the one of benchmark_driver. The optional argument
+ * scales the duration of each run.
+ */
+
+static const int NODES = 8;
+static const int CHANNEL_COUNTS[] = { 1, 2, 4, 8 };
+
+static void report(string const& benchmark, string const& parameter,
+                   string const& metric, double value, string const& unit) {
+    cout << benchmark << " " << parameter << " " << metric << " "
+         << value << " " << unit << endl;
+}
+
+static void benchmarkHopping(base::Time const& duration) {
+    for (int channel_count : CHANNEL_COUNTS) {
+        vector<uint8_t> channels;
+        for (int i = 0; i < channel_count; ++i) {
+            channels.push_back(i);
+        }
+        ChannelPlan plan(NODES, channels);
+
+        Simulator simulator;
+        Driver drivers[NODES];
+        Configuration conf;
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = Configuration::AIR_RATE_19200;
+        conf.transparent_transmission = false;
+        for (int i = 0; i < NODES; ++i) {
+            conf.address = i + 1;
+            conf.channel = plan.getNodeChannel(i);
+            simulator.addModule(conf);
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(conf);
+        }
+        simulator.start();
+
+        vector<unique_ptr<HoppingScheduler>> schedulers;
+        base::Time start = base::Time::now();
+        for (int i = 0; i < NODES; ++i) {
+            schedulers.emplace_back(new HoppingScheduler(drivers[i], plan, i));
+            schedulers[i]->setEpoch(start);
+        }
+
+        vector<uint8_t> payload(HoppingScheduler::DEFAULT_MAX_FRAME_SIZE, 0x42);
+        size_t received = 0;
+        uint64_t sent = 0;
+        while (base::Time::now() - start < duration) {
+            for (int i = 0; i < NODES; ++i) {
+                auto& scheduler = *schedulers[i];
+                // Keep one frame queued for each peer
+                if (scheduler.getQueuedFrameCount() < NODES - 1) {
+                    for (int target = 0; target < NODES; ++target) {
+                        if (target != i) {
+                            scheduler.push(target + 1,
+                                           plan.getNodeChannel(target),
+                                           payload.data(), payload.size());
+                        }
+                    }
+                }
+                sent += scheduler.update();
+
+                uint8_t buffer[512];
+                try {
+                    received += drivers[i].readRaw(
+                        buffer, sizeof(buffer), base::Time(), base::Time()
+                    );
+                }
+                catch (iodrivers_base::TimeoutError const&) {
+                }
+            }
+            usleep(200);
+        }
+        base::Time elapsed = base::Time::now() - start;
+
+        uint64_t collisions = 0;
+        uint64_t missed = 0;
+        for (int i = 0; i < NODES; ++i) {
+            auto status = simulator.getStatus(i);
+            collisions += status.collided_sub_packets;
+            missed += status.missed_sub_packets;
+        }
+
+        string parameter = "nodes=" + to_string(NODES) +
+                           ",channels=" + to_string(channel_count);
+        double goodput = received * 8 / elapsed.toSeconds();
+        report("hopping", parameter, "slots", plan.getSlotCount(), "-");
+        report("hopping", parameter, "superframe",
+               schedulers[0]->getSuperframeDuration().toSeconds() * 1e3, "ms");
+        report("hopping", parameter, "frames", sent, "frames");
+        report("hopping", parameter, "goodput", goodput, "bit/s");
+        report("hopping", parameter, "efficiency",
+               goodput / getAirBitrate(conf.air_rate), "-");
+        report("hopping", parameter, "collisions", collisions, "sub-packets");
+        report("hopping", parameter, "missed", missed, "sub-packets");
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    cout << "benchmark parameter metric value unit\n";
+    benchmarkHopping(base::Time::fromSeconds(std::max(0.5, 3 * scale)));
+    return 0;
+}
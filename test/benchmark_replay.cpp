@@ -0,0 +1,163 @@
+#include <comms_lora_ebyte_e32/CaptureLog.hpp>
+#include <comms_lora_ebyte_e32/CaptureReplay.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Cost of capturing the driver traffic, and replay of a captured session
+ *
+ * The capture benchmark measures the time spent in CaptureLog::record, i.e.
+ * the overhead added to the driver's I/O path. The replay benchmark captures
+ * a simulated session on the receiving side, and feeds it back to a new
+ * driver at several speeds, reporting how long the replay took and how late
+ * the records were written.
+ *
+ * The output format is the one of benchmark_driver. The optional argument
+ * scales the number of records and frames.
+ */
+
+static const int FRAME_SIZE = 50;
+static const base::Time FRAME_PERIOD = base::Time::fromMilliseconds(50);
+
+static void report(string const& benchmark, string const& parameter,
+                   string const& metric, double value, string const& unit) {
+    cout << benchmark << " " << parameter << " " << metric << " "
+         << value << " " << unit << endl;
+}
+
+static string temporaryPath() {
+    char tmp[] = "/tmp/benchmark_replay_XXXXXX";
+    int fd = mkstemp(tmp);
+    close(fd);
+    return tmp;
+}
+
+static void benchmarkCapture(int records) {
+    string path = temporaryPath();
+    vector<uint8_t> chunk(FRAME_SIZE, 0x42);
+    base::Time total;
+    CaptureLog::Statistics stats;
+    {
+        CaptureLog log(path);
+        for (int i = 0; i < records; ++i) {
+            base::Time start = base::Time::now();
+            log.record(CaptureLog::RECORD_RX, chunk.data(), chunk.size());
+            total = total + (base::Time::now() - start);
+            // Leave the background thread time to keep up, as a driver would
+            if (i % CaptureLog::DEFAULT_RING_SIZE == 0) {
+                log.flush();
+            }
+        }
+        log.flush();
+        stats = log.getStatistics();
+    }
+    unlink(path.c_str());
+
+    string parameter = "chunk=" + to_string(FRAME_SIZE);
+    report("capture", parameter, "mean",
+           total.toSeconds() / records * 1e9, "ns");
+    report("capture", parameter, "dropped", stats.dropped_records, "records");
+    report("capture", parameter, "ring_high_water_mark",
+           stats.ring_high_water_mark, "records");
+}
+
+/** Capture the receiving side of a simulated session
+ *
+ * @return the number of frames received
+ */
+static int captureSession(string const& path, int frames) {
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    Simulator simulator;
+    simulator.addModule(conf);
+    simulator.addModule(conf);
+    Driver drivers[2];
+    for (int i = 0; i < 2; ++i) {
+        drivers[i].setFileDescriptor(simulator.openDevice(i));
+        drivers[i].setLinkConfiguration(conf);
+    }
+    drivers[1].setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    CaptureLog log(path);
+    drivers[1].setCaptureLog(&log);
+    simulator.start();
+
+    thread writer([&]() {
+        vector<uint8_t> frame(FRAME_SIZE, 0x42);
+        for (int i = 0; i < frames; ++i) {
+            drivers[0].writeFrame(frame.data(), frame.size());
+            usleep(FRAME_PERIOD.toMicroseconds());
+        }
+    });
+
+    int received = 0;
+    uint8_t buffer[Driver::MAX_PACKET_SIZE];
+    for (int i = 0; i < frames; ++i) {
+        try {
+            drivers[1].readPacket(buffer, Driver::MAX_PACKET_SIZE,
+                                  base::Time::fromSeconds(1));
+            ++received;
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+            break;
+        }
+    }
+    writer.join();
+    drivers[1].setCaptureLog(nullptr);
+    return received;
+}
+
+static void benchmarkReplay(string const& path, int frames, double speed) {
+    CaptureReplay replay(path);
+    replay.setSpeed(speed);
+    Driver driver;
+    driver.setFileDescriptor(replay.openDevice());
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+
+    base::Time start = base::Time::now();
+    replay.start();
+    int received = 0;
+    uint8_t buffer[Driver::MAX_PACKET_SIZE];
+    for (int i = 0; i < frames; ++i) {
+        try {
+            driver.readPacket(buffer, Driver::MAX_PACKET_SIZE,
+                              base::Time::fromSeconds(1));
+            ++received;
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+            break;
+        }
+    }
+    base::Time duration = base::Time::now() - start;
+    replay.waitFinished(base::Time::fromSeconds(1));
+    auto stats = replay.getStatistics();
+
+    string parameter = "speed=" + to_string(static_cast<int>(speed)) +
+                       ",frames=" + to_string(frames);
+    report("replay", parameter, "duration", duration.toSeconds() * 1e3, "ms");
+    report("replay", parameter, "received", received, "frames");
+    report("replay", parameter, "max_lag", stats.max_lag.toSeconds() * 1e3, "ms");
+    report("replay", parameter, "tx_mismatches", stats.tx_mismatches, "bytes");
+}
+
+int main(int argc, char** argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    cout << "benchmark parameter metric value unit\n";
+    benchmarkCapture(std::max(1000.0, 100000 * scale));
+
+    int frames = std::max(5.0, 50 * scale);
+    string path = temporaryPath();
+    frames = captureSession(path, frames);
+    for (double speed : { 1, 10, 0 }) {
+        benchmarkReplay(path, frames, speed);
+    }
+    unlink(path.c_str());
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/ThreadedDriver.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Cost of sending a frame from the application thread
+ *
+ * Bursts of frames are sent to a simulated module, either directly with
+ * Driver::writeFrame, or by queueing them to a ThreadedDriver. The time
+ * spent in each call is measured, and the rings' high-water marks are
+ * reported for the threaded case.
+ *
+ * The output format is the one of benchmark_driver. The optional argument
+ * scales the number of bursts.
+ */
+
+static const int FRAME_SIZE = 50;
+static const int BURST_SIZE = ThreadedDriver::DEFAULT_RING_SIZE;
+
+static void report(string const& benchmark, string const& parameter,
+                   string const& metric, double value, string const& unit) {
+    cout << benchmark << " " << parameter << " " << metric << " "
+         << value << " " << unit << endl;
+}
+
+static void benchmarkSend(bool threaded, int bursts) {
+    Simulator simulator;
+    Driver driver;
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    simulator.addModule(conf);
+    driver.setFileDescriptor(simulator.openDevice(0));
+    driver.setLinkConfiguration(conf);
+    simulator.start();
+
+    ThreadedDriver io(driver);
+    if (threaded) {
+        io.start();
+    }
+
+    vector<uint8_t> frame(FRAME_SIZE, 0x42);
+    base::Time total;
+    base::Time max;
+    int calls = 0;
+    for (int burst = 0; burst < bursts; ++burst) {
+        for (int i = 0; i < BURST_SIZE; ++i) {
+            base::Time start = base::Time::now();
+            if (threaded) {
+                io.send(frame.data(), frame.size());
+            }
+            else {
+                driver.writeFrame(frame.data(), frame.size());
+            }
+            base::Time duration = base::Time::now() - start;
+            total = total + duration;
+            max = std::max(max, duration);
+            ++calls;
+        }
+        // Let the UART drain before the next burst
+        while (io.getTransmitQueueSize() != 0) {
+            usleep(1000);
+        }
+        usleep(getUARTTransferTime(conf, (FRAME_SIZE + 2) * BURST_SIZE)
+                   .toMicroseconds());
+    }
+
+    string parameter = string(threaded ? "threaded" : "direct") +
+                       ",frame=" + to_string(FRAME_SIZE) +
+                       ",burst=" + to_string(BURST_SIZE);
+    report("send", parameter, "mean",
+           total.toSeconds() / calls * 1e6, "us");
+    report("send", parameter, "max", max.toSeconds() * 1e6, "us");
+    if (threaded) {
+        auto stats = io.getStatistics();
+        report("send", parameter, "tx_high_water_mark",
+               stats.tx_high_water_mark, "frames");
+        report("send", parameter, "rejected", stats.rejected_frames, "frames");
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    cout << "benchmark parameter metric value unit\n";
+    int bursts = std::max(2.0, 20 * scale);
+    benchmarkSend(false, bursts);
+    benchmarkSend(true, bursts);
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/MockModePins.hpp>
+#include <comms_lora_ebyte_e32/ModeController.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/WakeUpScheduler.hpp>
+#include <comms_lora_ebyte_e32/WakeUpTradeoff.hpp>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Cost of reaching a receiver in power-saving mode
+ *
+ * A sender queues a short message every MESSAGE_PERIOD for a receiver in
+ * power-saving mode, and WakeUpScheduler sends them with an increasing
+ * maximum latency, i.e. with more messages sharing each preamble. The
+ * receiver's average current is then estimated from the measured batches
+ * with computeWakeUpTradeoff.
+ *
+ * The output format is the one of benchmark_driver. The optional argument
+ * scales the duration of each run.
+ */
+
+static const base::Time MESSAGE_PERIOD = base::Time::fromMilliseconds(100);
+static const int MESSAGE_SIZE = 16;
+static const int MAX_LATENCIES_MS[] = { 0, 250, 1000, 2000 };
+
+static void report(string const& benchmark, string const& parameter,
+                   string const& metric, double value, string const& unit) {
+    cout << benchmark << " " << parameter << " " << metric << " "
+         << value << " " << unit << endl;
+}
+
+static void benchmarkWakeUp(base::Time const& duration) {
+    for (int max_latency : MAX_LATENCIES_MS) {
+        Simulator simulator;
+        Driver drivers[2];
+        Configuration conf;
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = Configuration::AIR_RATE_19200;
+        conf.transparent_transmission = false;
+        for (int i = 0; i < 2; ++i) {
+            conf.address = i + 1;
+            simulator.addModule(conf);
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(conf);
+        }
+        drivers[1].setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+        simulator.setMode(1, Simulator::MODE_POWER_SAVING);
+        simulator.start();
+
+        MockModePins pins;
+        pins.setCallback([&simulator](bool m0, bool) {
+            simulator.setMode(0, m0 ? Simulator::MODE_WAKE_UP
+                                    : Simulator::MODE_NORMAL);
+        });
+        ModeController controller(pins, &simulator.getAUX(0));
+        WakeUpScheduler scheduler(drivers[0], controller);
+        scheduler.setMaxLatency(base::Time::fromMilliseconds(max_latency));
+        scheduler.setMaxQueueSize(1000);
+
+        uint8_t payload[MESSAGE_SIZE] = { 0 };
+        uint64_t pushed = 0;
+        uint64_t received = 0;
+        base::Time start = base::Time::now();
+        base::Time next_message = start;
+        // Let the last batches arrive once the messages stop
+        base::Time deadline = start + duration + base::Time::fromSeconds(5);
+        while (received < pushed || base::Time::now() - start < duration) {
+            base::Time now = base::Time::now();
+            if (now > deadline) {
+                break;
+            }
+            else if (now - start < duration && now >= next_message) {
+                scheduler.push(2, conf.channel, payload, MESSAGE_SIZE, now);
+                next_message = next_message + MESSAGE_PERIOD;
+                pushed++;
+            }
+            scheduler.update(now);
+
+            uint8_t buffer[Driver::MAX_PACKET_SIZE];
+            try {
+                drivers[1].readPacket(buffer, Driver::MAX_PACKET_SIZE,
+                                      base::Time::fromMilliseconds(1));
+                received++;
+            }
+            catch (iodrivers_base::TimeoutError const&) {
+            }
+        }
+
+        auto const& stats = scheduler.getStatistics();
+        string parameter = "max_latency=" + std::to_string(max_latency) + "ms";
+        double batch_size = stats.sent_batches
+            ? static_cast<double>(stats.sent_messages) / stats.sent_batches : 0;
+        base::Time batch_period = stats.sent_batches
+            ? base::Time::fromSeconds(duration.toSeconds() / stats.sent_batches)
+            : base::Time();
+        auto tradeoff = computeWakeUpTradeoff(
+            conf, batch_size * (MESSAGE_SIZE + Driver::FRAME_HEADER_SIZE),
+            batch_period
+        );
+
+        report("wake_up", parameter, "sent", pushed, "messages");
+        report("wake_up", parameter, "received", received, "messages");
+        report("wake_up", parameter, "preambles", stats.sent_batches, "-");
+        report("wake_up", parameter, "messages_per_preamble", batch_size, "-");
+        report("wake_up", parameter, "max_latency",
+               stats.max_latency.toSeconds() * 1e3, "ms");
+        report("wake_up", parameter, "receiver_wake_ups",
+               simulator.getStatus(1).wake_ups, "-");
+        report("wake_up", parameter, "receiver_current",
+               tradeoff.average_current, "mA");
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    cout << "benchmark parameter metric value unit\n";
+    benchmarkWakeUp(base::Time::fromSeconds(std::max(2.0, 10 * scale)));
+    return 0;
+}
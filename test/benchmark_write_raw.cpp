@@ -0,0 +1,74 @@
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include "Benchmark.hpp"
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+using namespace comms_lora_ebyte_e32::benchmark;
+
+/** Micro-benchmark of the fixed-transmission write path
+ *
+ * Compares Driver::writeRaw, which hands the header and payload to the kernel
+ * with a single writev, against building the whole frame in a heap-allocated
+ * buffer and calling writePacket. The driver writes on the slave side of a
+ * pty while a thread drains the master side.
+ *
+ * Neither path waits for the fixed transmission gap (see
+ * Driver::setFixedTransmissionGap), which is left to the callers, so the
+ * results are the CPU cost of the writes and not the UART pacing
+ */
+
+struct BaselineDriver : public Driver {
+    void writeCopied(uint16_t target, uint8_t channel,
+                     uint8_t const* buffer, int bufsize) {
+        vector<uint8_t> frame(FIXED_TRANSMISSION_HEADER_SIZE + bufsize);
+        frame[0] = (target >> 8) & 0xff;
+        frame[1] = (target >> 0) & 0xff;
+        frame[2] = channel;
+        memcpy(frame.data() + FIXED_TRANSMISSION_HEADER_SIZE, buffer, bufsize);
+        writePacket(frame.data(), frame.size());
+    }
+};
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 100000;
+    int master;
+    int slave = openPTY(master);
+
+    atomic<bool> quit(false);
+    thread drainer(drain, master, std::ref(quit));
+
+    BaselineDriver driver;
+    driver.setFileDescriptor(slave);
+
+    cout << "payload_size writev_ns_per_frame copy_ns_per_frame\n";
+    for (int size : { 16, 58, 256, 509 }) {
+        vector<uint8_t> payload(size, 0x42);
+
+        double start = threadCPUTime();
+        for (int i = 0; i < frames; ++i) {
+            driver.writeRaw(0x1234, 0x12, payload.data(), size);
+        }
+        double writev_time = threadCPUTime() - start;
+
+        start = threadCPUTime();
+        for (int i = 0; i < frames; ++i) {
+            driver.writeCopied(0x1234, 0x12, payload.data(), size);
+        }
+        double copy_time = threadCPUTime() - start;
+
+        cout << size << " "
+             << writev_time / frames * 1e9 << " "
+             << copy_time / frames * 1e9 << endl;
+    }
+
+    quit = true;
+    drainer.join();
+    close(master);
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <comms_lora_ebyte_e32/AsyncDriver.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct AsyncDriverTest : public ::testing::Test,
+                         public iodrivers_base::Fixture<Driver> {
+    AsyncDriver async;
+
+    AsyncDriverTest()
+        : async(driver) {
+        driver.openURI("test://");
+    }
+};
+
+TEST_F(AsyncDriverTest, it_reports_the_version_once_the_reply_is_complete) {
+    Version version;
+    bool called = false;
+    async.readVersion([&](Version const& v) { version = v; called = true; });
+    ASSERT_EQ(vector<uint8_t>({ 0xc3, 0xc3, 0xc3 }), readDataFromDriver());
+
+    pushDataToDriver({ 0xc3, 32 });
+    async.process();
+    ASSERT_FALSE(called);
+
+    pushDataToDriver({ 1, 2 });
+    async.process();
+    ASSERT_TRUE(called);
+    ASSERT_EQ(FREQ_433MHZ, version.frequency);
+    ASSERT_EQ(1, version.version);
+    ASSERT_EQ(2, version.features);
+    ASSERT_FALSE(async.hasPendingCommands());
+}
+
+TEST_F(AsyncDriverTest, it_sends_queued_commands_one_at_a_time) {
+    Configuration conf;
+    async.readVersion([](Version const&) {});
+    async.readConfiguration([&](Configuration const& c) { conf = c; });
+    ASSERT_EQ(vector<uint8_t>({ 0xc3, 0xc3, 0xc3 }), readDataFromDriver());
+
+    pushDataToDriver({ 0xc3, 32, 1, 2 });
+    async.process();
+    ASSERT_EQ(vector<uint8_t>({ 0xc1, 0xc1, 0xc1 }), readDataFromDriver());
+
+    pushDataToDriver({ 0xc0, 0x1, 0x2, 0b01100011, 0b00010100, 0b11100110 });
+    async.process();
+    ASSERT_EQ(0x0102, conf.address);
+    ASSERT_EQ(20, driver.getLinkConfiguration().channel);
+}
+
+TEST_F(AsyncDriverTest, it_reports_a_timeout_when_the_deadline_is_reached) {
+    exception_ptr error;
+    async.readVersion([](Version const&) {},
+                      [&](exception_ptr e) { error = e; });
+    base::Time deadline = async.getDeadline();
+    async.process(deadline - base::Time::fromMilliseconds(1));
+    ASSERT_FALSE(error);
+
+    async.process(deadline);
+    ASSERT_THROW(rethrow_exception(error), iodrivers_base::TimeoutError);
+    ASSERT_FALSE(async.hasPendingCommands());
+}
+
+TEST_F(AsyncDriverTest, it_throws_from_process_if_there_is_no_error_callback) {
+    async.readVersion([](Version const&) {});
+    pushDataToDriver({ 0, 32, 1, 2 });
+    ASSERT_THROW(async.process(), std::runtime_error);
+    ASSERT_FALSE(async.hasPendingCommands());
+}
+
+TEST_F(AsyncDriverTest, it_completes_configuration_writes_once_written) {
+    Configuration conf;
+    conf.channel = 10;
+    bool done = false;
+    async.writeConfiguration(conf, false, [&] { done = true; });
+    async.process();
+    ASSERT_TRUE(done);
+    ASSERT_EQ(6u, readDataFromDriver().size());
+    ASSERT_EQ(10, driver.getLinkConfiguration().channel);
+}
+
+TEST_F(AsyncDriverTest, it_updates_the_configuration_cache_on_writes) {
+    Configuration conf;
+    conf.channel = 10;
+    async.writeConfiguration(conf, false);
+    async.process();
+    readDataFromDriver();
+    ASSERT_TRUE(driver.hasCachedConfiguration());
+    ASSERT_EQ(10, driver.getConfiguration().channel);
+}
+
+TEST(AsyncDriverUARTRateTest, the_host_follows_UART_rate_changes) {
+    Simulator simulator;
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_9600;
+    simulator.addModule(conf);
+    simulator.setMode(0, Simulator::MODE_SLEEP);
+    simulator.start();
+    Driver driver;
+    driver.openURI("serial://" + simulator.getDevicePath(0) + ":9600");
+    driver.readConfiguration();
+
+    AsyncDriver async(driver);
+    conf = driver.getConfiguration();
+    conf.uart_rate = Configuration::RATE_115200;
+    bool done = false;
+    async.writeConfiguration(conf, false, [&] { done = true; });
+    async.process();
+    ASSERT_TRUE(done);
+    ASSERT_EQ(Configuration::RATE_115200,
+              simulator.getStatus(0).configuration.uart_rate);
+    ASSERT_EQ(Configuration::RATE_115200, driver.readConfiguration().uart_rate);
+}
+
+TEST_F(AsyncDriverTest, it_passes_frames_to_the_receive_callback) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    vector<vector<uint8_t>> frames;
+    async.setReceiveCallback([&](uint8_t const* data, int size) {
+        frames.push_back(vector<uint8_t>(data, data + size));
+    });
+
+    pushDataToDriver({ Driver::FRAME_SYNC, 1, 1, Driver::FRAME_SYNC, 1 });
+    async.process();
+    ASSERT_EQ(1u, frames.size());
+    pushDataToDriver({ 2 });
+    async.process();
+    ASSERT_EQ(2u, frames.size());
+    ASSERT_EQ(vector<uint8_t>({ Driver::FRAME_SYNC, 1, 2 }), frames[1]);
+}
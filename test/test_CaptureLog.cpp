@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <comms_lora_ebyte_e32/CaptureLog.hpp>
+#include <comms_lora_ebyte_e32/CaptureReader.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <fstream>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct CaptureLogTest : public ::testing::Test {
+    string path;
+
+    CaptureLogTest() {
+        char tmp[] = "/tmp/capture_log_XXXXXX";
+        int fd = mkstemp(tmp);
+        close(fd);
+        path = tmp;
+    }
+
+    ~CaptureLogTest() {
+        unlink(path.c_str());
+    }
+
+    struct Record {
+        CaptureLog::RecordType type;
+        base::Time time;
+        vector<uint8_t> data;
+    };
+
+    /** Copy the records, as the reader's are only valid as long as it is */
+    vector<Record> readAll() {
+        CaptureReader reader(path);
+        vector<Record> records;
+        CaptureReader::Record record;
+        while (reader.next(record)) {
+            records.push_back(Record{
+                record.type, record.time,
+                vector<uint8_t>(record.data, record.data + record.size)
+            });
+        }
+        return records;
+    }
+
+    static vector<uint8_t> data(CaptureReader::Record const& record) {
+        return vector<uint8_t>(record.data, record.data + record.size);
+    }
+};
+
+TEST_F(CaptureLogTest, it_writes_the_records_in_order) {
+    {
+        CaptureLog log(path);
+        uint8_t tx[] = { 1, 2, 3 };
+        uint8_t rx[] = { 4, 5 };
+        log.record(CaptureLog::RECORD_TX, tx, 3, base::Time::fromMicroseconds(10));
+        log.record(CaptureLog::RECORD_RX, rx, 2, base::Time::fromMicroseconds(20));
+    }
+
+    CaptureReader reader(path);
+    CaptureReader::Record record;
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(CaptureLog::RECORD_TX, record.type);
+    ASSERT_EQ(base::Time::fromMicroseconds(10), record.time);
+    ASSERT_EQ(vector<uint8_t>({ 1, 2, 3 }), data(record));
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(CaptureLog::RECORD_RX, record.type);
+    ASSERT_EQ(vector<uint8_t>({ 4, 5 }), data(record));
+    ASSERT_FALSE(reader.next(record));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(CaptureLog::RECORD_TX, record.type);
+}
+
+TEST_F(CaptureLogTest, it_splits_long_chunks) {
+    vector<uint8_t> chunk(CaptureLog::MAX_RECORD_SIZE + 10);
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        chunk[i] = i;
+    }
+    {
+        CaptureLog log(path);
+        log.record(CaptureLog::RECORD_RX, chunk.data(), chunk.size());
+    }
+
+    auto records = readAll();
+    ASSERT_EQ(2u, records.size());
+    ASSERT_EQ(static_cast<size_t>(CaptureLog::MAX_RECORD_SIZE),
+              records[0].data.size());
+    ASSERT_EQ(records[0].time, records[1].time);
+    vector<uint8_t> joined = records[0].data;
+    joined.insert(joined.end(), records[1].data.begin(), records[1].data.end());
+    ASSERT_EQ(chunk, joined);
+}
+
+TEST_F(CaptureLogTest, the_committed_records_can_be_read_while_the_log_is_open) {
+    CaptureLog log(path);
+    uint8_t tx[] = { 1, 2, 3 };
+    log.record(CaptureLog::RECORD_TX, tx, 3);
+    log.flush();
+
+    // The file is preallocated beyond the end of the records
+    ASSERT_EQ(1u, readAll().size());
+    auto stats = log.getStatistics();
+    ASSERT_EQ(1u, stats.records);
+    ASSERT_EQ(3u, stats.bytes);
+    ASSERT_EQ(static_cast<uint64_t>(CaptureLog::FILE_HEADER_SIZE +
+                                    CaptureLog::RECORD_HEADER_SIZE + 3),
+              stats.file_size);
+}
+
+TEST_F(CaptureLogTest, it_drops_records_rather_than_block) {
+    uint8_t chunk[100] = { 0 };
+    {
+        CaptureLog log(path, 1);
+        for (int i = 0; i < 1000; ++i) {
+            log.record(CaptureLog::RECORD_TX, chunk, 100);
+        }
+        log.flush();
+        auto stats = log.getStatistics();
+        ASSERT_EQ(1000u, stats.records + stats.dropped_records);
+        ASSERT_EQ(100 * stats.dropped_records, stats.dropped_bytes);
+        ASSERT_EQ(1u, stats.ring_high_water_mark);
+    }
+}
+
+TEST_F(CaptureLogTest, the_reader_rejects_other_files) {
+    ofstream(path) << "not a capture log, but long enough to have a header";
+    ASSERT_THROW(CaptureReader reader(path), std::runtime_error);
+}
+
+struct DriverCaptureTest : public CaptureLogTest,
+                           public iodrivers_base::Fixture<Driver> {
+    DriverCaptureTest() {
+        driver.openURI("test://");
+    }
+};
+
+TEST_F(DriverCaptureTest, it_records_the_driver_traffic) {
+    {
+        CaptureLog log(path);
+        driver.setCaptureLog(&log);
+        uint8_t payload[] = { 1, 2 };
+        driver.writeFrame(payload, 2);
+        pushDataToDriver({ 4, 5, 6 });
+        uint8_t buffer[10];
+        driver.readRaw(buffer, 10, base::Time::fromMilliseconds(10));
+        driver.setCaptureLog(nullptr);
+    }
+
+    auto records = readAll();
+    ASSERT_EQ(3u, records.size());
+    ASSERT_EQ(CaptureLog::RECORD_TX, records[0].type);
+    ASSERT_EQ(vector<uint8_t>({ Driver::FRAME_SYNC, 2 }), records[0].data);
+    ASSERT_EQ(vector<uint8_t>({ 1, 2 }), records[1].data);
+    ASSERT_EQ(CaptureLog::RECORD_RX, records[2].type);
+    ASSERT_EQ(vector<uint8_t>({ 4, 5, 6 }), records[2].data);
+}
+
+TEST_F(DriverCaptureTest, it_records_the_bytes_skipped_to_find_a_frame) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    {
+        CaptureLog log(path);
+        driver.setCaptureLog(&log);
+        pushDataToDriver({ 0x42, 0x43, Driver::FRAME_SYNC, 1, 7 });
+        uint8_t buffer[Driver::MAX_PACKET_SIZE];
+        ASSERT_EQ(3, driver.readPacket(buffer, Driver::MAX_PACKET_SIZE,
+                                       base::Time::fromMilliseconds(10)));
+        ASSERT_FALSE(driver.hasPacket());
+        driver.setCaptureLog(nullptr);
+    }
+
+    auto records = readAll();
+    ASSERT_EQ(1u, records.size());
+    ASSERT_EQ(CaptureLog::RECORD_RX, records[0].type);
+    ASSERT_EQ(vector<uint8_t>({ 0x42, 0x43, Driver::FRAME_SYNC, 1, 7 }),
+              records[0].data);
+    ASSERT_EQ(5u, driver.getStatistics().rx_bytes);
+    ASSERT_EQ(1u, driver.getStatistics().rx_frames);
+}
+
+TEST_F(DriverCaptureTest, it_records_commands_and_their_replies) {
+    vector<uint8_t> reply = { 0xc0, 0x1, 0x2, 0b01100011, 0b00010100, 0b11100110 };
+    {
+        CaptureLog log(path);
+        driver.setCaptureLog(&log);
+        IODRIVERS_BASE_MOCK();
+        EXPECT_REPLY({ 0xc1, 0xc1, 0xc1 }, reply);
+        driver.readConfiguration();
+        driver.setCaptureLog(nullptr);
+    }
+
+    auto records = readAll();
+    ASSERT_EQ(2u, records.size());
+    ASSERT_EQ(CaptureLog::RECORD_COMMAND, records[0].type);
+    ASSERT_EQ(vector<uint8_t>({ 0xc1, 0xc1, 0xc1 }), records[0].data);
+    ASSERT_EQ(CaptureLog::RECORD_REPLY, records[1].type);
+    ASSERT_EQ(reply, records[1].data);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/CaptureReplay.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+static const vector<uint8_t> CONFIGURATION_REPLY = {
+    0xc0, 0x1, 0x2, 0b01100011, 0b00010100, 0b11100110
+};
+
+struct CaptureReplayTest : public ::testing::Test {
+    string path;
+    base::Time start = base::Time::fromSeconds(1000);
+
+    CaptureReplayTest() {
+        char tmp[] = "/tmp/capture_replay_XXXXXX";
+        int fd = mkstemp(tmp);
+        close(fd);
+        path = tmp;
+
+        // A configuration read, followed by two data chunks 200ms apart
+        CaptureLog log(path);
+        uint8_t command[] = { 0xc1, 0xc1, 0xc1 };
+        uint8_t data[] = { 1, 2, 3 };
+        log.record(CaptureLog::RECORD_COMMAND, command, 3, start);
+        log.record(CaptureLog::RECORD_REPLY, CONFIGURATION_REPLY.data(), 6,
+                   start + base::Time::fromMilliseconds(10));
+        log.record(CaptureLog::RECORD_RX, data, 3,
+                   start + base::Time::fromMilliseconds(100));
+        log.record(CaptureLog::RECORD_RX, data, 3,
+                   start + base::Time::fromMilliseconds(300));
+    }
+
+    ~CaptureReplayTest() {
+        unlink(path.c_str());
+    }
+};
+
+TEST_F(CaptureReplayTest, it_reproduces_the_captured_session) {
+    CaptureReplay replay(path);
+    replay.setSpeed(0);
+    Driver driver;
+    driver.setFileDescriptor(replay.openDevice());
+    replay.start();
+
+    ASSERT_EQ(0x0102, driver.readConfiguration().address);
+    uint8_t buffer[6];
+    ASSERT_EQ(6, driver.readRaw(buffer, 6, base::Time::fromSeconds(1),
+                                base::Time::fromSeconds(1)));
+    ASSERT_TRUE(replay.waitFinished(base::Time::fromSeconds(1)));
+
+    auto stats = replay.getStatistics();
+    ASSERT_EQ(3u, stats.replayed_records);
+    ASSERT_EQ(12u, stats.rx_bytes);
+    ASSERT_EQ(3u, stats.tx_bytes);
+    ASSERT_EQ(3u, stats.expected_tx_bytes);
+    ASSERT_EQ(0u, stats.tx_mismatches);
+}
+
+TEST_F(CaptureReplayTest, it_replays_at_the_captured_pace_scaled_by_the_speed) {
+    CaptureReplay replay(path);
+    replay.setSpeed(2);
+    Driver driver;
+    driver.setFileDescriptor(replay.openDevice());
+    base::Time real_start = base::Time::now();
+    replay.start();
+
+    driver.readConfiguration();
+    uint8_t buffer[3];
+    driver.readRaw(buffer, 3, base::Time::fromSeconds(1), base::Time::fromSeconds(1));
+    ASSERT_GE(base::Time::now() - real_start, base::Time::fromMilliseconds(50));
+    driver.readRaw(buffer, 3, base::Time::fromSeconds(1), base::Time::fromSeconds(1));
+    base::Time elapsed = base::Time::now() - real_start;
+    ASSERT_GE(elapsed, base::Time::fromMilliseconds(150));
+    ASSERT_LT(elapsed, base::Time::fromMilliseconds(250));
+}
+
+TEST_F(CaptureReplayTest, it_counts_the_bytes_that_differ_from_the_capture) {
+    CaptureReplay replay(path);
+    replay.setSpeed(0);
+    replay.setReplyTimeout(base::Time::fromMilliseconds(10));
+    Driver driver;
+    driver.setFileDescriptor(replay.openDevice());
+    replay.start();
+
+    ASSERT_THROW(driver.readVersion(), std::runtime_error);
+    ASSERT_TRUE(replay.waitFinished(base::Time::fromSeconds(1)));
+    ASSERT_EQ(3u, replay.getStatistics().tx_mismatches);
+}
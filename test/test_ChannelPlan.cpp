@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/ChannelPlan.hpp>
+#include <set>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+static void assertValid(ChannelPlan const& plan) {
+    for (int i = 0; i < plan.getSlotCount(); ++i) {
+        set<int> senders;
+        set<uint8_t> channels;
+        for (auto const& transmission : plan.getSlot(i)) {
+            ASSERT_TRUE(senders.insert(transmission.node).second);
+            ASSERT_TRUE(channels.insert(transmission.channel).second);
+        }
+        for (auto const& transmission : plan.getSlot(i)) {
+            uint8_t home = plan.getNodeChannel(transmission.node);
+            if (home != transmission.channel) {
+                ASSERT_EQ(0u, channels.count(home));
+            }
+        }
+    }
+}
+
+TEST(ChannelPlan, it_spreads_the_nodes_over_the_channels) {
+    ChannelPlan plan(5, { 3, 7 });
+    ASSERT_EQ(3, plan.getNodeChannel(0));
+    ASSERT_EQ(7, plan.getNodeChannel(1));
+    ASSERT_EQ(3, plan.getNodeChannel(2));
+    ASSERT_EQ(7, plan.getNodeChannel(3));
+    ASSERT_EQ(3, plan.getNodeChannel(4));
+}
+
+TEST(ChannelPlan, it_degenerates_to_round_robin_on_a_single_channel) {
+    ChannelPlan plan(4, { 5 });
+    ASSERT_EQ(4, plan.getSlotCount());
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(1u, plan.getSlot(i).size());
+        ASSERT_EQ(i, plan.getSlot(i)[0].node);
+        ASSERT_EQ(5, plan.getTransmitChannel(i, i));
+    }
+}
+
+TEST(ChannelPlan, it_lets_each_node_reach_every_other_node_once) {
+    for (int nodes = 1; nodes < 12; ++nodes) {
+        for (int channel_count = 1; channel_count < 6; ++channel_count) {
+            vector<uint8_t> channels;
+            for (int i = 0; i < channel_count; ++i) {
+                channels.push_back(i * 2);
+            }
+            ChannelPlan plan(nodes, channels);
+            assertValid(plan);
+            if (nodes == 1) {
+                continue;
+            }
+
+            for (int node = 0; node < nodes; ++node) {
+                for (int other = 0; other < nodes; ++other) {
+                    if (other == node) {
+                        continue;
+                    }
+                    uint8_t channel = plan.getNodeChannel(other);
+                    int count = 0;
+                    for (int slot = 0; slot < plan.getSlotCount(); ++slot) {
+                        count += plan.getTransmitChannel(node, slot) == channel;
+                    }
+                    ASSERT_EQ(1, count);
+                }
+            }
+        }
+    }
+}
+
+TEST(ChannelPlan, it_runs_transmissions_in_parallel_on_several_channels) {
+    ChannelPlan single(8, { 0 });
+    ChannelPlan multiple(8, { 0, 1, 2, 3 });
+    ASSERT_EQ(8, single.getSlotCount());
+
+    size_t transmissions = 0;
+    for (int i = 0; i < multiple.getSlotCount(); ++i) {
+        transmissions += multiple.getSlot(i).size();
+    }
+    // Each node has a slot on each of the 4 channels
+    ASSERT_EQ(32u, transmissions);
+    ASSERT_LT(multiple.getSlotCount(), 16);
+}
+
+TEST(ChannelPlan, it_rejects_invalid_channels) {
+    ASSERT_THROW(ChannelPlan(2, {}), std::invalid_argument);
+    ASSERT_THROW(ChannelPlan(2, { 0x20 }), std::invalid_argument);
+    ASSERT_THROW(ChannelPlan(2, { 1, 1 }), std::invalid_argument);
+    ASSERT_THROW(ChannelPlan(0, { 1 }), std::invalid_argument);
+}
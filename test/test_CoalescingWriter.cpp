@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/CoalescingReader.hpp>
+#include <comms_lora_ebyte_e32/CoalescingWriter.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct CoalescingWriterTest : public ::testing::Test {
+    Simulator simulator;
+    Driver drivers[3];
+
+    CoalescingWriterTest() {
+        for (int i = 0; i < 3; ++i) {
+            Configuration conf;
+            conf.uart_rate = Configuration::RATE_115200;
+            conf.air_rate = Configuration::AIR_RATE_19200;
+            conf.transparent_transmission = false;
+            conf.address = i + 1;
+            simulator.addModule(conf);
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(conf);
+            // The simulator detects the end of UART packets at the
+            // resolution of its time step
+            drivers[i].setFixedTransmissionGap(base::Time::fromMilliseconds(10));
+        }
+        simulator.setTimeScale(10);
+        simulator.start();
+    }
+
+    vector<uint8_t> receive(CoalescingReader& reader) {
+        uint8_t buffer[256];
+        int size = reader.receive(buffer, 256, base::Time::fromSeconds(1));
+        return vector<uint8_t>(buffer, buffer + size);
+    }
+};
+
+TEST_F(CoalescingWriterTest, it_sends_messages_to_the_same_target_in_one_frame) {
+    CoalescingWriter writer(drivers[0]);
+    CoalescingReader reader(drivers[1]);
+
+    for (uint8_t i = 0; i < 5; ++i) {
+        vector<uint8_t> message(5, i);
+        writer.write(2, 0, message.data(), message.size());
+    }
+    ASSERT_EQ(5, writer.getPendingMessages());
+    writer.flush();
+
+    for (uint8_t i = 0; i < 5; ++i) {
+        ASSERT_EQ(vector<uint8_t>(5, i), receive(reader));
+    }
+    auto stats = writer.getStatistics();
+    ASSERT_EQ(1u, stats.frames);
+    ASSERT_EQ(30u, stats.frame_bytes);
+    ASSERT_EQ(5.0, stats.getBatchingRatio());
+    ASSERT_EQ(1u, reader.getStatistics().frames);
+}
+
+TEST_F(CoalescingWriterTest, it_keeps_one_batch_per_target) {
+    CoalescingWriter writer(drivers[0]);
+    CoalescingReader reader1(drivers[1]);
+    CoalescingReader reader2(drivers[2]);
+
+    uint8_t message[2] = { 1, 2 };
+    writer.write(2, 0, message, 2);
+    writer.write(3, 0, message, 2);
+    writer.write(2, 0, message, 2);
+    writer.flush();
+
+    receive(reader1);
+    receive(reader1);
+    receive(reader2);
+    ASSERT_EQ(2u, writer.getStatistics().frames);
+}
+
+TEST_F(CoalescingWriterTest, it_sends_the_batch_when_the_next_message_does_not_fit) {
+    CoalescingWriter writer(drivers[0], 20, base::Time::fromSeconds(10));
+    CoalescingReader reader(drivers[1]);
+
+    vector<uint8_t> message(8, 0x42);
+    writer.write(2, 0, message.data(), message.size());
+    writer.write(2, 0, message.data(), message.size());
+    ASSERT_EQ(0u, writer.getStatistics().frames);
+    writer.write(2, 0, message.data(), message.size());
+    ASSERT_EQ(1u, writer.getStatistics().frames);
+    ASSERT_EQ(1u, writer.getStatistics().size_flushes);
+    ASSERT_EQ(1, writer.getPendingMessages());
+
+    receive(reader);
+    receive(reader);
+}
+
+TEST_F(CoalescingWriterTest, it_sends_the_batch_when_its_deadline_is_reached) {
+    CoalescingWriter writer(drivers[0], 53, base::Time::fromMilliseconds(10));
+    CoalescingReader reader(drivers[1]);
+
+    uint8_t message[2] = { 1, 2 };
+    writer.write(2, 0, message, 2);
+    ASSERT_LE(writer.getNextDeadline(),
+              base::Time::now() + base::Time::fromMilliseconds(10));
+    writer.process();
+    ASSERT_EQ(0u, writer.getStatistics().frames);
+    usleep(20000);
+    writer.process();
+    ASSERT_EQ(1u, writer.getStatistics().deadline_flushes);
+    ASSERT_EQ(base::Time::max(), writer.getNextDeadline());
+    ASSERT_EQ(vector<uint8_t>({ 1, 2 }), receive(reader));
+}
+
+TEST_F(CoalescingWriterTest, it_rejects_messages_larger_than_a_batch) {
+    CoalescingWriter writer(drivers[0], 20);
+    vector<uint8_t> message(20);
+    ASSERT_THROW(writer.write(2, 0, message.data(), 20), std::invalid_argument);
+}
+
+TEST(CoalescingReaderTest, it_rejects_a_batch_whose_sizes_do_not_add_up) {
+    uint8_t batch[] = { 2, 1, 2, 3, 1 };
+    vector<vector<uint8_t>> messages;
+    ASSERT_FALSE(CoalescingReader::split(batch, 5, messages));
+    ASSERT_TRUE(messages.empty());
+}
+
+TEST(CoalescingReaderTest, it_splits_a_batch) {
+    uint8_t batch[] = { 2, 1, 2, 0, 1, 3 };
+    vector<vector<uint8_t>> messages;
+    ASSERT_TRUE(CoalescingReader::split(batch, 6, messages));
+    ASSERT_EQ(3u, messages.size());
+    ASSERT_EQ(vector<uint8_t>({ 1, 2 }), messages[0]);
+    ASSERT_EQ(vector<uint8_t>(), messages[1]);
+    ASSERT_EQ(vector<uint8_t>({ 3 }), messages[2]);
+}
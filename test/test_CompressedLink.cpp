@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/CompressedLink.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <random>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct CompressedLinkTest : public ::testing::Test {
+    Simulator simulator;
+    Driver drivers[2];
+    vector<uint8_t> dictionary;
+
+    CompressedLinkTest() {
+        Configuration conf;
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = Configuration::AIR_RATE_19200;
+        simulator.addModule(conf);
+        simulator.addModule(conf);
+        simulator.setTimeScale(10);
+        for (int i = 0; i < 2; ++i) {
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(conf);
+        }
+        simulator.start();
+
+        string common = "\"latitude\":,\"longitude\":";
+        dictionary = vector<uint8_t>(common.begin(), common.end());
+    }
+};
+
+TEST_F(CompressedLinkTest, it_sends_compressible_packets_compressed) {
+    CompressedLink tx(drivers[0], dictionary);
+    CompressedLink rx(drivers[1], dictionary);
+
+    string text = "{\"latitude\":48.1234,\"longitude\":-4.5678}";
+    vector<uint8_t> packet(text.begin(), text.end());
+    tx.send(packet.data(), packet.size());
+
+    uint8_t buffer[256];
+    int size = rx.receive(buffer, 256, base::Time::fromSeconds(1));
+    ASSERT_EQ(packet, vector<uint8_t>(buffer, buffer + size));
+
+    auto stats = tx.getStatistics();
+    ASSERT_EQ(1u, stats.compressed_packets);
+    ASSERT_LT(stats.sent_frame_bytes, stats.sent_bytes);
+    ASSERT_EQ(stats.sent_frame_bytes, rx.getStatistics().received_frame_bytes);
+}
+
+TEST_F(CompressedLinkTest, it_sends_incompressible_packets_as_is) {
+    CompressedLink tx(drivers[0], dictionary);
+    CompressedLink rx(drivers[1], dictionary);
+
+    std::mt19937 rng(42);
+    vector<uint8_t> packet(40);
+    for (auto& byte : packet) {
+        byte = rng();
+    }
+    tx.send(packet.data(), packet.size());
+
+    uint8_t buffer[256];
+    int size = rx.receive(buffer, 256, base::Time::fromSeconds(1));
+    ASSERT_EQ(packet, vector<uint8_t>(buffer, buffer + size));
+    ASSERT_EQ(0u, tx.getStatistics().compressed_packets);
+    ASSERT_EQ(41u, tx.getStatistics().sent_frame_bytes);
+}
+
+TEST_F(CompressedLinkTest, it_skips_frames_that_fail_to_decompress) {
+    CompressedLink tx(drivers[0], dictionary);
+    CompressedLink rx(drivers[1]);
+
+    string text = "{\"latitude\":48.1234,\"longitude\":-4.5678}";
+    vector<uint8_t> packet(text.begin(), text.end());
+    tx.send(packet.data(), packet.size());
+
+    uint8_t buffer[256];
+    ASSERT_THROW(rx.receive(buffer, 256, base::Time::fromMilliseconds(200)),
+                 iodrivers_base::TimeoutError);
+    ASSERT_EQ(1u, rx.getStatistics().invalid_frames);
+}
+
+TEST_F(CompressedLinkTest, it_rejects_packets_larger_than_the_maximum) {
+    CompressedLink tx(drivers[0], dictionary, 100);
+    vector<uint8_t> packet(101);
+    ASSERT_THROW(tx.send(packet.data(), packet.size()), std::invalid_argument);
+}
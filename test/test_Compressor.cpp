@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Compressor.hpp>
+#include <cstdio>
+#include <random>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+static vector<uint8_t> telemetry(int i) {
+    char buffer[256];
+    int size = snprintf(
+        buffer, sizeof(buffer),
+        "{\"time\":%d,\"latitude\":48.%06d,\"longitude\":-4.%06d,"
+        "\"heading\":%d,\"battery_voltage\":12.%d}",
+        1000 + i, 123456 + i * 3, 654321 - i * 2, (i * 7) % 360, 90 - i % 10
+    );
+    return vector<uint8_t>(buffer, buffer + size);
+}
+
+static vector<uint8_t> roundTrip(Compressor& compressor, vector<uint8_t> const& data,
+                                 int& compressed_size) {
+    vector<uint8_t> compressed(Compressor::getMaxCompressedSize(data.size()));
+    compressed_size = compressor.compress(data.data(), data.size(),
+                                          compressed.data(), compressed.size());
+    EXPECT_GE(compressed_size, 0);
+    vector<uint8_t> result(data.size());
+    int size = compressor.decompress(compressed.data(), compressed_size,
+                                     result.data(), result.size());
+    result.resize(size);
+    return result;
+}
+
+TEST(CompressorTest, it_round_trips_without_a_dictionary) {
+    Compressor compressor;
+    vector<uint8_t> data(200);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = "abcabcabd"[i % 9];
+    }
+
+    int compressed_size;
+    ASSERT_EQ(data, roundTrip(compressor, data, compressed_size));
+    ASSERT_LT(compressed_size, 30);
+}
+
+TEST(CompressorTest, it_round_trips_incompressible_data) {
+    Compressor compressor;
+    std::mt19937 rng(42);
+    vector<uint8_t> data(1000);
+    for (auto& byte : data) {
+        byte = rng();
+    }
+
+    int compressed_size;
+    ASSERT_EQ(data, roundTrip(compressor, data, compressed_size));
+    ASSERT_LE(compressed_size, Compressor::getMaxCompressedSize(1000));
+}
+
+TEST(CompressorTest, it_round_trips_an_empty_payload) {
+    Compressor compressor;
+    int compressed_size;
+    ASSERT_EQ(vector<uint8_t>(), roundTrip(compressor, vector<uint8_t>(), compressed_size));
+    ASSERT_EQ(0, compressed_size);
+}
+
+TEST(CompressorTest, it_refers_to_the_dictionary) {
+    vector<vector<uint8_t>> samples;
+    for (int i = 0; i < 50; ++i) {
+        samples.push_back(telemetry(i));
+    }
+    auto dictionary = Compressor::train(samples, 512);
+    ASSERT_FALSE(dictionary.empty());
+    ASSERT_LE(dictionary.size(), 512u);
+
+    Compressor with_dictionary(dictionary);
+    Compressor without_dictionary;
+    auto data = telemetry(100);
+    int with_size, without_size;
+    ASSERT_EQ(data, roundTrip(with_dictionary, data, with_size));
+    ASSERT_EQ(data, roundTrip(without_dictionary, data, without_size));
+    ASSERT_LT(with_size, static_cast<int>(data.size()) / 2);
+    ASSERT_LT(with_size, without_size);
+}
+
+TEST(CompressorTest, it_returns_minus_one_if_the_output_is_too_small) {
+    Compressor compressor;
+    vector<uint8_t> data(100, 0x42);
+    data[50] = 0;
+    uint8_t out[4];
+    ASSERT_EQ(-1, compressor.compress(data.data(), data.size(), out, 4));
+}
+
+TEST(CompressorTest, it_throws_on_a_match_before_the_start_of_the_data) {
+    Compressor compressor;
+    uint8_t data[] = { 0x10, 'a', 2, 0 };
+    uint8_t out[64];
+    ASSERT_THROW(compressor.decompress(data, 4, out, 64), std::invalid_argument);
+}
+
+TEST(CompressorTest, it_throws_if_the_output_is_too_small) {
+    Compressor compressor;
+    vector<uint8_t> data(100, 0x42);
+    vector<uint8_t> compressed(200);
+    int size = compressor.compress(data.data(), data.size(),
+                                   compressed.data(), compressed.size());
+    uint8_t out[50];
+    ASSERT_THROW(compressor.decompress(compressed.data(), size, out, 50),
+                 std::invalid_argument);
+}
+
+TEST(CompressorTest, it_throws_on_truncated_data) {
+    Compressor compressor;
+    uint8_t data[] = { 0x20, 'a' };
+    uint8_t out[64];
+    ASSERT_THROW(compressor.decompress(data, 2, out, 64), std::invalid_argument);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/ConfigurationCodec.hpp>
+
+using namespace comms_lora_ebyte_e32;
+
+static constexpr Configuration KNOWN_GOOD = ConfigurationBuilder()
+    .address(0x0102)
+    .uartParity(Configuration::PARITY_8O1)
+    .uartRate(Configuration::RATE_19200)
+    .airRate(Configuration::AIR_RATE_4800)
+    .channel(20)
+    .transparentTransmission(false)
+    .wirelessWakeUpTime(4)
+    .transmissionPower(Configuration::POWER_24dBm)
+    .build();
+
+static constexpr ConfigurationCommand KNOWN_GOOD_COMMAND =
+    makeConfigurationCommand(KNOWN_GOOD, false);
+
+static_assert(isValid(KNOWN_GOOD), "known-good configuration is invalid");
+static_assert(KNOWN_GOOD_COMMAND[0] == 0xc2, "unexpected command byte");
+static_assert(KNOWN_GOOD_COMMAND[1] == 0x01, "unexpected address MSB");
+static_assert(KNOWN_GOOD_COMMAND[2] == 0x02, "unexpected address LSB");
+static_assert(KNOWN_GOOD_COMMAND[3] == 0b01100011, "unexpected SPED byte");
+static_assert(KNOWN_GOOD_COMMAND[4] == 20, "unexpected channel");
+static_assert(KNOWN_GOOD_COMMAND[5] == 0b11100110, "unexpected OPTION byte");
+static_assert(std::get<0>(makeConfigurationCommand(KNOWN_GOOD, true)) == 0xc0,
+              "unexpected save command byte");
+static_assert(decodeConfiguration(&KNOWN_GOOD_COMMAND[1]).channel == 20,
+              "compile-time round-trip failed");
+
+TEST(ConfigurationCodecTest, the_builder_rejects_out_of_range_channels) {
+    ASSERT_THROW(ConfigurationBuilder().channel(0x20), std::out_of_range);
+    ASSERT_NO_THROW(ConfigurationBuilder().channel(0x1f));
+}
+
+TEST(ConfigurationCodecTest, the_builder_rejects_out_of_range_wake_up_times) {
+    ASSERT_THROW(ConfigurationBuilder().wirelessWakeUpTime(8), std::out_of_range);
+    ASSERT_NO_THROW(ConfigurationBuilder().wirelessWakeUpTime(7));
+}
+
+TEST(ConfigurationCodecTest, it_detects_invalid_configurations) {
+    Configuration conf;
+    conf.channel = 0x20;
+    ASSERT_FALSE(isValid(conf));
+}
+
+TEST(ConfigurationCodecTest, the_address_round_trips) {
+    for (int address = 0; address < 0x10000; ++address) {
+        uint8_t raw[CONFIGURATION_SIZE] = {
+            static_cast<uint8_t>(address >> 8), static_cast<uint8_t>(address),
+            0, 0, 0
+        };
+        uint8_t encoded[CONFIGURATION_SIZE];
+        encodeConfiguration(encoded, decodeConfiguration(raw));
+        ASSERT_EQ(address, encoded[0] << 8 | encoded[1]);
+    }
+}
+
+TEST(ConfigurationCodecTest, all_parameter_bytes_round_trip) {
+    // Exhaustive over bytes 2 to 4. The address bytes are independent from
+    // them, and covered by the_address_round_trips
+    for (uint32_t value = 0; value < (1 << 24); ++value) {
+        uint8_t raw[CONFIGURATION_SIZE] = {
+            0, 0,
+            static_cast<uint8_t>(value >> 16),
+            static_cast<uint8_t>(value >> 8),
+            static_cast<uint8_t>(value)
+        };
+
+        // The module treats parity 0b11 as 8N1, and air rates above 0b101
+        // as 19200
+        uint8_t expected_sped = raw[2];
+        if ((expected_sped >> 6) == 0b11) {
+            expected_sped &= 0b00111111;
+        }
+        if ((expected_sped & 0b111) > 0b101) {
+            expected_sped = (expected_sped & 0b11111000) | 0b101;
+        }
+
+        uint8_t encoded[CONFIGURATION_SIZE];
+        encodeConfiguration(encoded, decodeConfiguration(raw));
+        if (encoded[2] != expected_sped || encoded[3] != raw[3] ||
+            encoded[4] != raw[4]) {
+            FAIL() << "round-trip failed for " << std::hex << value;
+        }
+    }
+}
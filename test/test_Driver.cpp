@@ -1,10 +1,22 @@
 #include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
 #include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/MockAUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
 
+using namespace std;
 using namespace comms_lora_ebyte_e32;
 
-struct DriverTest : public ::testing::Test {
-    Driver driver;
+struct DriverTest : public ::testing::Test, public iodrivers_base::Fixture<Driver> {
+    DriverTest() {
+        driver.openURI("test://");
+    }
 };
 
 TEST_F(DriverTest, it_encodes_a_configuration_structure) {
@@ -61,4 +73,527 @@ TEST_F(DriverTest, decoding_handles_special_air_rate_values) {
     buffer[2] = 0b00000111;
     ASSERT_EQ(Configuration::AIR_RATE_19200,
               driver.decodeConfiguration(buffer).air_rate);
-}
\ No newline at end of file
+}
+
+TEST_F(DriverTest, writeRaw_prepends_the_fixed_transmission_header) {
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    ASSERT_EQ(4, driver.writeRaw(0x1234, 0x12, payload, 4));
+
+    vector<uint8_t> expected = { 0x12, 0x34, 0x12, 1, 2, 3, 4 };
+    ASSERT_EQ(expected, readDataFromDriver());
+}
+
+TEST_F(DriverTest, writeFrame_prepends_the_fixed_transmission_header_and_the_length) {
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    ASSERT_EQ(4, driver.writeFrame(0x1234, 0x12, payload, 4));
+
+    vector<uint8_t> expected = { 0x12, 0x34, 0x12, Driver::FRAME_SYNC, 4, 1, 2, 3, 4 };
+    ASSERT_EQ(expected, readDataFromDriver());
+}
+
+TEST_F(DriverTest, it_leaves_the_UART_idle_between_fixed_transmission_frames) {
+    driver.setFixedTransmissionGap(base::Time::fromMilliseconds(50));
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    base::Time start = base::Time::now();
+    driver.writeFrame(0x1234, 0x12, payload, 4);
+    ASSERT_GE(driver.getFixedTransmissionReadyTime() - start,
+              base::Time::fromMilliseconds(50));
+    driver.waitFixedTransmissionGap();
+    ASSERT_GE(base::Time::now() - start, base::Time::fromMilliseconds(45));
+}
+
+TEST_F(DriverTest, it_does_not_wait_for_the_fixed_transmission_gap_on_write) {
+    driver.setFixedTransmissionGap(base::Time::fromMilliseconds(50));
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    driver.writeFrame(0x1234, 0x12, payload, 4);
+    base::Time start = base::Time::now();
+    driver.writeFrame(0x1234, 0x12, payload, 4);
+    ASSERT_LT(base::Time::now() - start, base::Time::fromMilliseconds(45));
+}
+
+TEST_F(DriverTest, it_extracts_length_prefixed_frames) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    pushDataToDriver({ 0, 1, Driver::FRAME_SYNC, 2, 1, 2, Driver::FRAME_SYNC, 1, 3 });
+
+    vector<uint8_t> first = { Driver::FRAME_SYNC, 2, 1, 2 };
+    ASSERT_EQ(first, readPacket());
+    vector<uint8_t> second = { Driver::FRAME_SYNC, 1, 3 };
+    ASSERT_EQ(second, readPacket());
+}
+
+TEST_F(DriverTest, it_waits_for_the_whole_length_prefixed_frame) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    pushDataToDriver({ Driver::FRAME_SYNC, 3, 1, 2 });
+    ASSERT_THROW(readPacket(), iodrivers_base::TimeoutError);
+    pushDataToDriver({ 3 });
+
+    vector<uint8_t> expected = { Driver::FRAME_SYNC, 3, 1, 2, 3 };
+    ASSERT_EQ(expected, readPacket());
+}
+
+TEST_F(DriverTest, it_waits_for_the_rest_of_a_frame_until_the_read_timeout) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    driver.setReadTimeout(base::Time::fromMilliseconds(10));
+    pushDataToDriver({ Driver::FRAME_SYNC, 3, 1, 2 });
+    base::Time start = base::Time::now();
+    ASSERT_THROW(readPacket(), iodrivers_base::TimeoutError);
+    ASSERT_GE(base::Time::now() - start, base::Time::fromMilliseconds(10));
+}
+
+TEST_F(DriverTest, readFrame_returns_the_bytes_of_an_over_the_air_packet) {
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    driver.setLinkConfiguration(conf);
+    driver.setPacketMode(Driver::PACKET_MODE_GAP);
+    pushDataToDriver({ 1, 2, 3 });
+
+    uint8_t buffer[10];
+    ASSERT_EQ(3, driver.readFrame(buffer, 10, base::Time::fromMilliseconds(10)));
+    ASSERT_EQ(0, driver.readFrame(buffer, 10, base::Time::fromMilliseconds(10)));
+}
+
+struct DriverFlowControlTest : public DriverTest {
+    MockAUXMonitor aux;
+    vector<uint8_t> payload = vector<uint8_t>(500, 0);
+
+    DriverFlowControlTest() {
+        Configuration conf;
+        conf.uart_rate = Configuration::RATE_115200;
+        driver.setLinkConfiguration(conf);
+        driver.setAUXMonitor(&aux);
+    }
+};
+
+TEST_F(DriverFlowControlTest, writeRaw_writes_what_fits_in_the_module_buffer) {
+    ASSERT_EQ(500, driver.writeRaw(1, 2, payload.data(), 500));
+    aux.setReady(false);
+    ASSERT_EQ(6, driver.writeRaw(1, 2, payload.data(), 20,
+                                 base::Time::fromMilliseconds(10)));
+
+    auto stats = driver.getFlowControlStatistics();
+    ASSERT_EQ(512, stats.tx_bytes);
+    ASSERT_EQ(1, stats.busy_waits);
+    ASSERT_EQ(1, stats.short_writes);
+    ASSERT_EQ(14, stats.refused_bytes);
+}
+
+TEST_F(DriverFlowControlTest, it_does_not_wait_for_more_than_the_module_buffer) {
+    vector<uint8_t> large(600, 0);
+    base::Time start = base::Time::now();
+    ASSERT_EQ(509, driver.writeRaw(1, 2, large.data(), 600,
+                                   base::Time::fromSeconds(1)));
+    ASSERT_LT(base::Time::now() - start, base::Time::fromMilliseconds(500));
+
+    auto stats = driver.getFlowControlStatistics();
+    ASSERT_EQ(0, stats.busy_waits);
+    ASSERT_EQ(1, stats.short_writes);
+    ASSERT_EQ(91, stats.refused_bytes);
+}
+
+TEST_F(DriverFlowControlTest, writeFrame_does_not_write_a_partial_frame) {
+    ASSERT_EQ(500, driver.writeRaw(1, 2, payload.data(), 500));
+    aux.setReady(false);
+    driver.setWriteTimeout(base::Time::fromMilliseconds(10));
+    ASSERT_EQ(0, driver.writeFrame(payload.data(), 20));
+    ASSERT_EQ(22, driver.getFlowControlStatistics().refused_bytes);
+}
+
+TEST_F(DriverFlowControlTest, it_waits_for_AUX_to_free_the_module_buffer) {
+    ASSERT_EQ(500, driver.writeRaw(1, 2, payload.data(), 500));
+    ASSERT_EQ(20, driver.writeRaw(1, 2, payload.data(), 20,
+                                  base::Time::fromSeconds(1)));
+    ASSERT_EQ(1, driver.getFlowControlStatistics().busy_waits);
+    ASSERT_EQ(0, driver.getFlowControlStatistics().short_writes);
+}
+
+/** Driver writing on the slave side of a pty, to exercise writev */
+struct DriverPTYTest : public ::testing::Test {
+    int master = -1;
+    Driver driver;
+    vector<uint8_t> payload;
+
+    DriverPTYTest() {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        grantpt(master);
+        unlockpt(master);
+        int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+        termios tio;
+        tcgetattr(slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(slave, TCSANOW, &tio);
+        driver.setFileDescriptor(slave);
+
+        // More than the pty buffers, so that writev cannot take it at once
+        for (int i = 0; i < 32768; ++i) {
+            payload.push_back(i * 7);
+        }
+    }
+
+    ~DriverPTYTest() {
+        driver.close();
+        close(master);
+    }
+
+    vector<uint8_t> readAll(base::Time const& timeout) {
+        vector<uint8_t> result;
+        uint8_t buffer[4096];
+        while (true) {
+            pollfd pfd = { master, POLLIN, 0 };
+            if (::poll(&pfd, 1, timeout.toMilliseconds()) <= 0) {
+                return result;
+            }
+            int n = ::read(master, buffer, sizeof(buffer));
+            if (n <= 0) {
+                return result;
+            }
+            result.insert(result.end(), buffer, buffer + n);
+        }
+    }
+
+    vector<uint8_t> expectedFrame(int payload_size) {
+        vector<uint8_t> expected = { 0x12, 0x34, 0x12 };
+        expected.insert(expected.end(), payload.begin(),
+                        payload.begin() + payload_size);
+        return expected;
+    }
+};
+
+TEST_F(DriverPTYTest, writeRaw_writes_the_header_and_the_payload) {
+    ASSERT_EQ(100, driver.writeRaw(0x1234, 0x12, payload.data(), 100));
+    ASSERT_EQ(expectedFrame(100), readAll(base::Time::fromMilliseconds(100)));
+}
+
+TEST_F(DriverPTYTest, writeRaw_reports_a_partial_write) {
+    int written = driver.writeRaw(0x1234, 0x12, payload.data(), payload.size(),
+                                  base::Time::fromMilliseconds(50));
+    ASSERT_GT(written, 0);
+    ASSERT_LT(written, static_cast<int>(payload.size()));
+    ASSERT_EQ(expectedFrame(written), readAll(base::Time::fromMilliseconds(100)));
+}
+
+TEST_F(DriverPTYTest, writeRaw_resumes_a_partial_write_once_there_is_room) {
+    vector<uint8_t> received;
+    thread reader([this, &received]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        received = readAll(base::Time::fromMilliseconds(200));
+    });
+    int written = driver.writeRaw(0x1234, 0x12, payload.data(), payload.size(),
+                                  base::Time::fromSeconds(2));
+    reader.join();
+    ASSERT_EQ(static_cast<int>(payload.size()), written);
+    ASSERT_EQ(expectedFrame(payload.size()), received);
+}
+
+static const vector<uint8_t> CONFIGURATION_REPLY = {
+    0xc0, 0x1, 0x2, 0b01100011, 0b00010100, 0b11100110
+};
+
+TEST_F(DriverTest, it_reads_the_configuration_only_once) {
+    IODRIVERS_BASE_MOCK();
+    EXPECT_REPLY({ 0xc1, 0xc1, 0xc1 }, CONFIGURATION_REPLY);
+    ASSERT_EQ(0x0102, driver.getConfiguration().address);
+    ASSERT_EQ(0x0102, driver.getConfiguration().address);
+}
+
+TEST_F(DriverTest, it_does_not_write_an_unchanged_configuration) {
+    IODRIVERS_BASE_MOCK();
+    EXPECT_REPLY({ 0xc1, 0xc1, 0xc1 }, CONFIGURATION_REPLY);
+    Configuration conf = driver.getConfiguration();
+    conf.channel = 20;
+    driver.stageConfiguration(conf);
+    ASSERT_EQ(0, driver.getDirtyFields());
+    ASSERT_FALSE(driver.commitConfiguration());
+}
+
+TEST_F(DriverTest, it_writes_several_staged_changes_at_once) {
+    IODRIVERS_BASE_MOCK();
+    EXPECT_REPLY({ 0xc1, 0xc1, 0xc1 }, CONFIGURATION_REPLY);
+    Configuration conf = driver.getConfiguration();
+    conf.channel = 21;
+    driver.stageConfiguration(conf);
+    conf.address = 0x0304;
+    driver.stageConfiguration(conf);
+    ASSERT_EQ(Configuration::FIELD_CHANNEL | Configuration::FIELD_ADDRESS,
+              driver.getDirtyFields());
+
+    EXPECT_REPLY({ 0xc2, 0x3, 0x4, 0b01100011, 21, 0b11100110 }, {});
+    ASSERT_TRUE(driver.commitConfiguration());
+    ASSERT_EQ(0, driver.getDirtyFields());
+    ASSERT_EQ(21, driver.getConfiguration().channel);
+}
+
+TEST_F(DriverTest, it_does_not_save_a_configuration_the_module_already_has) {
+    IODRIVERS_BASE_MOCK();
+    EXPECT_REPLY({ 0xc1, 0xc1, 0xc1 }, CONFIGURATION_REPLY);
+    Configuration conf = Driver::decodeConfigurationReply(
+        CONFIGURATION_REPLY.data()
+    );
+    ASSERT_FALSE(driver.saveConfiguration(conf));
+
+    auto stats = driver.getConfigurationSaveStatistics();
+    ASSERT_EQ(0u, stats.saves);
+    ASSERT_EQ(1u, stats.skipped_saves);
+    ASSERT_EQ(0u, stats.skipped_reads);
+}
+
+TEST_F(DriverTest, it_saves_a_configuration_that_differs_from_the_module) {
+    IODRIVERS_BASE_MOCK();
+    EXPECT_REPLY({ 0xc1, 0xc1, 0xc1 }, CONFIGURATION_REPLY);
+    Configuration conf = driver.getConfiguration();
+    conf.channel = 21;
+
+    EXPECT_REPLY({ 0xc0, 0x1, 0x2, 0b01100011, 21, 0b11100110 }, {});
+    ASSERT_TRUE(driver.saveConfiguration(conf));
+    ASSERT_EQ(1u, driver.getConfigurationSaveStatistics().saves);
+}
+
+TEST_F(DriverTest, it_saves_a_configuration_that_was_written_without_save) {
+    IODRIVERS_BASE_MOCK();
+    EXPECT_REPLY({ 0xc1, 0xc1, 0xc1 }, CONFIGURATION_REPLY);
+    Configuration conf = driver.getConfiguration();
+    conf.channel = 21;
+    EXPECT_REPLY({ 0xc2, 0x1, 0x2, 0b01100011, 21, 0b11100110 }, {});
+    driver.writeConfiguration(conf);
+
+    EXPECT_REPLY({ 0xc0, 0x1, 0x2, 0b01100011, 21, 0b11100110 }, {});
+    ASSERT_TRUE(driver.saveConfiguration(conf));
+}
+
+TEST_F(DriverTest, it_skips_the_read_and_save_if_the_cache_has_the_configuration) {
+    IODRIVERS_BASE_MOCK();
+    SavedConfigurationCache cache;
+    Configuration conf;
+    conf.channel = 21;
+    cache.set("test://", conf);
+    driver.setSavedConfigurationCache(&cache);
+
+    ASSERT_FALSE(driver.saveConfiguration(conf));
+    ASSERT_EQ(21, driver.getConfiguration().channel);
+    auto stats = driver.getConfigurationSaveStatistics();
+    ASSERT_EQ(1u, stats.skipped_saves);
+    ASSERT_EQ(1u, stats.skipped_reads);
+    ASSERT_LT(base::Time(), stats.avoided_time);
+    driver.setSavedConfigurationCache(nullptr);
+}
+
+TEST_F(DriverTest, it_records_saves_in_the_cache_and_forgets_unsaved_writes) {
+    SavedConfigurationCache cache;
+    driver.setSavedConfigurationCache(&cache);
+    Configuration conf;
+    conf.channel = 21;
+
+    driver.writeConfiguration(conf, true);
+    ASSERT_TRUE(cache.isSaved("test://", conf));
+    driver.writeConfiguration(conf, false);
+    ASSERT_FALSE(cache.isSaved("test://", conf));
+    driver.setSavedConfigurationCache(nullptr);
+}
+
+TEST_F(DriverTest, a_cache_that_cannot_be_written_does_not_fail_the_configuration) {
+    SavedConfigurationCache cache("/nonexistent/saved_configuration_cache");
+    driver.setSavedConfigurationCache(&cache);
+    Configuration conf;
+    conf.channel = 21;
+
+    ASSERT_NO_THROW(driver.writeConfiguration(conf, true));
+    ASSERT_TRUE(cache.isSaved("test://", conf));
+    driver.setSavedConfigurationCache(nullptr);
+}
+
+TEST_F(DriverTest, reopening_invalidates_the_configuration_cache) {
+    Configuration conf;
+    driver.writeConfiguration(conf);
+    ASSERT_TRUE(driver.hasCachedConfiguration());
+    driver.close();
+    driver.openURI("test://");
+    ASSERT_FALSE(driver.hasCachedConfiguration());
+}
+
+TEST_F(DriverTest, it_counts_transmitted_frames) {
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    driver.writeRaw(0x1234, 0x12, payload, 4);
+    driver.writeRaw(0x1234, 0x12, payload, 4);
+
+    auto stats = driver.getStatistics();
+    ASSERT_EQ(2u, stats.tx_frames);
+    ASSERT_EQ(14u, stats.tx_bytes);
+    ASSERT_EQ(getAirtime(driver.getLinkConfiguration(), 7) * 2, stats.tx_airtime);
+}
+
+TEST_F(DriverTest, it_counts_received_bytes_and_frames) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    pushDataToDriver({ Driver::FRAME_SYNC, 2, 1, 2 });
+    readPacket();
+    pushDataToDriver({ 1, 2, 3 });
+    uint8_t buffer[10];
+    driver.readRaw(buffer, 10, base::Time::fromMilliseconds(10));
+
+    auto stats = driver.getStatistics();
+    ASSERT_EQ(1u, stats.rx_frames);
+    ASSERT_EQ(7u, stats.rx_bytes);
+}
+
+TEST_F(DriverTest, readRaw_returns_the_bytes_left_over_by_readPacket) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    pushDataToDriver({ Driver::FRAME_SYNC, 1, 1, Driver::FRAME_SYNC, 3, 2 });
+    readPacket();
+    uint8_t buffer[10];
+    ASSERT_EQ(3, driver.readRaw(buffer, 10, base::Time::fromMilliseconds(10)));
+    ASSERT_EQ(Driver::FRAME_SYNC, buffer[0]);
+    ASSERT_EQ(2, buffer[2]);
+}
+
+TEST_F(DriverTest, readFrame_returns_the_bytes_left_over_by_readPacket) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    pushDataToDriver({ Driver::FRAME_SYNC, 1, 1, 4, 5, 6 });
+    readPacket();
+    uint8_t buffer[10];
+    ASSERT_EQ(3, driver.readFrame(buffer, 10, base::Time::fromMilliseconds(10)));
+    ASSERT_EQ(4, buffer[0]);
+    ASSERT_EQ(6u, driver.getStatistics().rx_bytes);
+    ASSERT_EQ(2u, driver.getStatistics().rx_frames);
+}
+
+TEST_F(DriverTest, it_counts_a_frame_once_even_if_hasPacket_saw_it) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    pushDataToDriver({ Driver::FRAME_SYNC, 1, 1, Driver::FRAME_SYNC, 1, 2 });
+    readPacket();
+    ASSERT_TRUE(driver.hasPacket());
+    readPacket();
+    ASSERT_EQ(2u, driver.getStatistics().rx_frames);
+}
+
+TEST_F(DriverTest, tryReadPacket_returns_zero_until_a_whole_frame_is_received) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    uint8_t buffer[10];
+    ASSERT_EQ(0, driver.tryReadPacket(buffer, 10));
+    pushDataToDriver({ 0, Driver::FRAME_SYNC, 2, 1 });
+    ASSERT_EQ(0, driver.tryReadPacket(buffer, 10));
+    pushDataToDriver({ 2 });
+    ASSERT_EQ(4, driver.tryReadPacket(buffer, 10));
+    ASSERT_EQ(2, buffer[3]);
+    ASSERT_EQ(0, driver.tryReadPacket(buffer, 10));
+}
+
+TEST_F(DriverTest, the_statistics_follow_the_link_configuration) {
+    Configuration conf;
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    driver.setLinkConfiguration(conf);
+    ASSERT_EQ(getEffectiveAirBitrate(conf) / 8,
+              driver.getStatistics().configured_air_throughput);
+}
+
+TEST_F(DriverTest, it_records_the_command_latency) {
+    IODRIVERS_BASE_MOCK();
+    EXPECT_REPLY({ 0xc3, 0xc3, 0xc3 }, { 0xc3, 32, 1, 2 });
+    driver.readVersion();
+
+    auto stats = driver.getStatistics();
+    ASSERT_EQ(1u, stats.commands);
+    ASSERT_EQ(1u, stats.command_latency[0]);
+}
+
+TEST_F(DriverTest, it_counts_timeouts_by_type) {
+    driver.setCommandTimeout(base::Time::fromMilliseconds(10));
+    ASSERT_THROW(driver.readVersion(), iodrivers_base::TimeoutError);
+    pushDataToDriver({ 0xc3 });
+    ASSERT_THROW(driver.readVersion(), iodrivers_base::TimeoutError);
+
+    auto stats = driver.getStatistics();
+    ASSERT_EQ(1u, stats.timeouts_first_byte);
+    ASSERT_EQ(1u, stats.timeouts_packet);
+}
+
+TEST_F(DriverTest, it_counts_the_timeouts_of_readPacket) {
+    driver.setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    uint8_t buffer[10];
+    base::Time timeout = base::Time::fromMilliseconds(10);
+    ASSERT_THROW(driver.readPacket(buffer, 10, timeout), iodrivers_base::TimeoutError);
+    pushDataToDriver({ Driver::FRAME_SYNC, 2, 1 });
+    ASSERT_THROW(driver.readPacket(buffer, 10, timeout), iodrivers_base::TimeoutError);
+
+    auto stats = driver.getStatistics();
+    ASSERT_EQ(1u, stats.timeouts_first_byte);
+    ASSERT_EQ(1u, stats.timeouts_packet);
+}
+
+TEST_F(DriverTest, it_counts_malformed_replies) {
+    pushDataToDriver({ 0, 32, 1, 2 });
+    ASSERT_THROW(driver.readVersion(), std::runtime_error);
+    ASSERT_EQ(1u, driver.getStatistics().malformed_replies);
+}
+
+struct DriverUARTRateTest : public ::testing::Test {
+    Simulator simulator;
+    UARTRateCache cache;
+    Driver driver;
+
+    void open(Configuration::UARTRate rate) {
+        Configuration conf;
+        conf.uart_rate = rate;
+        simulator.addModule(conf);
+        simulator.setMode(0, Simulator::MODE_SLEEP);
+        simulator.start();
+        driver.openURI("serial://" + simulator.getDevicePath(0) + ":9600");
+        driver.setUARTRateCache(&cache);
+        driver.setProbeTimeout(base::Time::fromMilliseconds(10));
+    }
+};
+
+TEST_F(DriverUARTRateTest, it_finds_the_module_UART_rate) {
+    open(Configuration::RATE_57600);
+    ASSERT_EQ(Configuration::RATE_57600, driver.negotiateUARTRate());
+    ASSERT_TRUE(driver.hasCachedConfiguration());
+    ASSERT_EQ(Configuration::RATE_57600, driver.getLinkConfiguration().uart_rate);
+
+    Configuration::UARTRate cached;
+    ASSERT_TRUE(cache.get("serial://" + simulator.getDevicePath(0), cached));
+    ASSERT_EQ(Configuration::RATE_57600, cached);
+    ASSERT_EQ(Configuration::RATE_57600, driver.readConfiguration().uart_rate);
+}
+
+TEST_F(DriverUARTRateTest, a_cache_that_cannot_be_written_does_not_fail_the_negotiation) {
+    UARTRateCache unwritable("/nonexistent/uart_rate_cache");
+    open(Configuration::RATE_57600);
+    driver.setUARTRateCache(&unwritable);
+    ASSERT_EQ(Configuration::RATE_57600, driver.negotiateUARTRate());
+    driver.setUARTRateCache(nullptr);
+}
+
+TEST_F(DriverUARTRateTest, it_tries_the_cached_rate_first) {
+    open(Configuration::RATE_2400);
+    cache.set("serial://" + simulator.getDevicePath(0), Configuration::RATE_2400);
+    ASSERT_EQ(Configuration::RATE_2400, driver.negotiateUARTRate());
+    ASSERT_EQ(0u, simulator.getStatus(0).uart_errors);
+}
+
+TEST_F(DriverUARTRateTest, it_throws_if_the_module_does_not_reply) {
+    open(Configuration::RATE_9600);
+    simulator.setMode(0, Simulator::MODE_NORMAL);
+    ASSERT_THROW(driver.negotiateUARTRate(), iodrivers_base::TimeoutError);
+}
+
+TEST_F(DriverUARTRateTest, the_host_follows_UART_rate_changes_without_a_cached_configuration) {
+    open(Configuration::RATE_9600);
+    ASSERT_FALSE(driver.hasCachedConfiguration());
+
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    driver.writeConfiguration(conf);
+    ASSERT_EQ(Configuration::RATE_115200,
+              simulator.getStatus(0).configuration.uart_rate);
+    ASSERT_EQ(Configuration::RATE_115200, driver.readConfiguration().uart_rate);
+}
+
+TEST_F(DriverUARTRateTest, the_host_follows_UART_rate_changes) {
+    open(Configuration::RATE_9600);
+    driver.negotiateUARTRate();
+
+    driver.switchUARTRate(Configuration::RATE_115200);
+    ASSERT_EQ(Configuration::RATE_115200,
+              simulator.getStatus(0).configuration.uart_rate);
+    Configuration::UARTRate cached;
+    ASSERT_TRUE(cache.get("serial://" + simulator.getDevicePath(0), cached));
+    ASSERT_EQ(Configuration::RATE_115200, cached);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/FECLink.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <memory>
+#include <set>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct FECLinkTest : public ::testing::Test {
+    Simulator simulator;
+    Driver drivers[2];
+    /** Index of the sub-packets that the simulator drops, counting from 0 */
+    shared_ptr<set<int>> dropped = make_shared<set<int>>();
+    vector<uint8_t> packet;
+
+    FECLinkTest() {
+        Configuration conf;
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = Configuration::AIR_RATE_19200;
+        simulator.addModule(conf);
+        simulator.addModule(conf);
+        simulator.setTimeScale(10);
+        auto dropped = this->dropped;
+        auto count = make_shared<int>(0);
+        simulator.setLossModel([dropped, count](Configuration const&,
+                                                Configuration const&) {
+            return dropped->count((*count)++) ? 1.0 : 0.0;
+        });
+        for (int i = 0; i < 2; ++i) {
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(conf);
+        }
+        drivers[0].setAUXMonitor(&simulator.getAUX(0));
+        simulator.start();
+
+        for (int i = 0; i < 4 * FECLink::MAX_SHARD_SIZE - 2; ++i) {
+            packet.push_back(i);
+        }
+    }
+
+    vector<uint8_t> receive(FECLink& link,
+                            base::Time timeout = base::Time::fromSeconds(1)) {
+        uint8_t buffer[1024];
+        int size = link.receive(buffer, sizeof(buffer), timeout);
+        return vector<uint8_t>(buffer, buffer + size);
+    }
+};
+
+TEST_F(FECLinkTest, it_sends_each_full_shard_in_its_own_sub_packet) {
+    FECLink tx(drivers[0], 4, 2);
+    FECLink rx(drivers[1], 4, 2);
+    tx.send(packet.data(), packet.size());
+
+    ASSERT_EQ(packet, receive(rx));
+    ASSERT_EQ(6u, tx.getStatistics().sent_shards);
+    ASSERT_TRUE(simulator.getAUX(0).waitReady(base::Time::fromSeconds(1)));
+    ASSERT_EQ(6u, simulator.getStatus(0).sent_sub_packets);
+}
+
+TEST_F(FECLinkTest, it_recovers_lost_sub_packets) {
+    FECLink tx(drivers[0], 4, 2);
+    FECLink rx(drivers[1], 4, 2);
+    *dropped = { 0, 2 };
+    tx.send(packet.data(), packet.size());
+
+    ASSERT_EQ(packet, receive(rx));
+    ASSERT_EQ(2u, rx.getStatistics().recovered_shards);
+}
+
+TEST_F(FECLinkTest, it_loses_the_packet_if_more_sub_packets_than_the_parity_are_lost) {
+    FECLink tx(drivers[0], 4, 2);
+    FECLink rx(drivers[1], 4, 2);
+    *dropped = { 0, 2, 5 };
+    tx.send(packet.data(), packet.size());
+    ASSERT_THROW(receive(rx, base::Time::fromMilliseconds(200)),
+                 iodrivers_base::TimeoutError);
+
+    tx.send(packet.data(), 10);
+    ASSERT_EQ(vector<uint8_t>(packet.begin(), packet.begin() + 10), receive(rx));
+}
+
+TEST_F(FECLinkTest, the_receiver_follows_the_sender_shard_counts) {
+    FECLink tx(drivers[0], 4, 1);
+    FECLink rx(drivers[1], 2, 0);
+    tx.setParityShards(3);
+    *dropped = { 1, 2, 3 };
+    tx.send(packet.data(), packet.size());
+    ASSERT_EQ(packet, receive(rx));
+}
+
+TEST_F(FECLinkTest, it_measures_the_shard_loss_rate) {
+    FECLink tx(drivers[0], 2, 2);
+    FECLink rx(drivers[1], 2, 2);
+    // One shard out of four in each block
+    for (int i = 0; i < 2 * FECLink::RECEIVE_WINDOW; ++i) {
+        dropped->insert(i * 4 + 3);
+    }
+    for (int i = 0; i < FECLink::RECEIVE_WINDOW + 2; ++i) {
+        tx.send(packet.data(), 100);
+        ASSERT_EQ(100u, receive(rx).size());
+    }
+    // Let the last shard of the last block arrive
+    ASSERT_THROW(receive(rx, base::Time::fromMilliseconds(100)),
+                 iodrivers_base::TimeoutError);
+
+    auto stats = rx.getStatistics();
+    ASSERT_EQ(8u, stats.expected_shards);
+    ASSERT_DOUBLE_EQ(0.25, rx.getShardLossRate());
+    ASSERT_EQ(0u, stats.lost_blocks);
+}
+
+TEST_F(FECLinkTest, it_rejects_corrupted_frames) {
+    FECLink rx(drivers[1], 4, 2);
+    uint8_t frame[10] = { 0, 0, 0x30, 1, 2, 3, 4, 5, 0x12, 0x34 };
+    drivers[0].writeFrame(frame, 10);
+    ASSERT_THROW(receive(rx, base::Time::fromMilliseconds(200)),
+                 iodrivers_base::TimeoutError);
+    ASSERT_EQ(1u, rx.getStatistics().invalid_frames);
+}
+
+TEST_F(FECLinkTest, it_rejects_packets_that_do_not_fit) {
+    FECLink tx(drivers[0], 4, 2);
+    ASSERT_EQ(4 * FECLink::MAX_SHARD_SIZE - 2, tx.getMaxPacketSize());
+    vector<uint8_t> big(tx.getMaxPacketSize() + 1);
+    ASSERT_THROW(tx.send(big.data(), big.size()), std::invalid_argument);
+    ASSERT_THROW(FECLink(drivers[0], 17, 0), std::invalid_argument);
+    ASSERT_THROW(tx.setParityShards(16), std::invalid_argument);
+}
+
+struct FECLinkFixedTransmissionTest : public ::testing::Test,
+                                     public iodrivers_base::Fixture<Driver> {
+    FECLinkFixedTransmissionTest() {
+        driver.openURI("test://");
+    }
+};
+
+TEST_F(FECLinkFixedTransmissionTest, it_fits_each_full_shard_and_its_header_in_a_sub_packet) {
+    FECLink tx(driver, 4, 2);
+    ASSERT_EQ(4 * FECLink::MAX_FIXED_SHARD_SIZE - 2, tx.getMaxFixedPacketSize());
+    vector<uint8_t> packet(tx.getMaxFixedPacketSize(), 0x42);
+    tx.send(0x1234, 0x12, packet.data(), packet.size());
+
+    vector<uint8_t> written = readDataFromDriver();
+    ASSERT_EQ(6u * SUB_PACKET_SIZE, written.size());
+    for (int i = 0; i < 6; ++i) {
+        uint8_t const* frame = &written[i * SUB_PACKET_SIZE];
+        ASSERT_EQ(0x12, frame[0]);
+        ASSERT_EQ(0x34, frame[1]);
+        ASSERT_EQ(0x12, frame[2]);
+        ASSERT_EQ(Driver::FRAME_SYNC, frame[3]);
+    }
+
+    vector<uint8_t> big(tx.getMaxFixedPacketSize() + 1);
+    ASSERT_THROW(tx.send(0x1234, 0x12, big.data(), big.size()),
+                 std::invalid_argument);
+}
+
+TEST(FECLink, it_computes_the_parity_needed_for_a_loss_rate) {
+    ASSERT_EQ(0, FECLink::getRequiredParityShards(4, 0, 1e-3));
+    int parity = FECLink::getRequiredParityShards(4, 0.1, 1e-3);
+    ASSERT_GT(parity, 0);
+    ASSERT_LE(parity, FECLink::getRequiredParityShards(4, 0.2, 1e-3));
+    ASSERT_EQ(FECLink::MAX_PARITY_SHARDS,
+              FECLink::getRequiredParityShards(4, 0.9, 1e-9));
+}
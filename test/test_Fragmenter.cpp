@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/CRC.hpp>
+#include <comms_lora_ebyte_e32/Fragmenter.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+TEST(CRCTest, it_computes_the_CCITT_false_CRC) {
+    uint8_t data[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    ASSERT_EQ(0x29b1, crc16(data, 9));
+}
+
+TEST(FragmenterTest, it_splits_a_message_in_fragments) {
+    Fragmenter fragmenter(16);
+    ASSERT_EQ(10, fragmenter.getFragmentDataSize());
+
+    vector<uint8_t> message(25);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = i;
+    }
+    ASSERT_EQ(3, fragmenter.start(message.data(), message.size()));
+
+    uint8_t fragment[16];
+    vector<int> sizes;
+    while (fragmenter.hasNext()) {
+        sizes.push_back(fragmenter.next(fragment));
+    }
+    ASSERT_EQ(vector<int>({ 16, 16, 11 }), sizes);
+
+    ASSERT_EQ(0, fragment[0]);
+    ASSERT_EQ(2, fragment[1]);
+    ASSERT_EQ(3, fragment[2]);
+    ASSERT_EQ(10, fragment[3]);
+    ASSERT_EQ(vector<uint8_t>({ 20, 21, 22, 23, 24 }),
+              vector<uint8_t>(fragment + 4, fragment + 9));
+    uint16_t crc = crc16(fragment, 9);
+    ASSERT_EQ(crc >> 8, fragment[9]);
+    ASSERT_EQ(crc & 0xff, fragment[10]);
+}
+
+TEST(FragmenterTest, it_increments_the_message_ID) {
+    Fragmenter fragmenter;
+    uint8_t message[1] = { 0 };
+    fragmenter.start(message, 1);
+    ASSERT_EQ(0, fragmenter.getMessageID());
+    fragmenter.start(message, 1);
+    ASSERT_EQ(1, fragmenter.getMessageID());
+}
+
+TEST(FragmenterTest, it_rejects_messages_that_need_too_many_fragments) {
+    Fragmenter fragmenter(16);
+    vector<uint8_t> message(fragmenter.getMaxMessageSize() + 1);
+    ASSERT_THROW(fragmenter.start(message.data(), message.size()),
+                 std::invalid_argument);
+    ASSERT_EQ(255, fragmenter.start(message.data(), message.size() - 1));
+}
+
+TEST(FragmenterTest, it_regenerates_a_given_fragment) {
+    Fragmenter fragmenter(16);
+    vector<uint8_t> message(25, 0x42);
+    fragmenter.start(message.data(), message.size());
+
+    uint8_t first[16];
+    uint8_t second[16];
+    fragmenter.next(first);
+    fragmenter.next(second);
+    uint8_t again[16];
+    ASSERT_EQ(16, fragmenter.generate(again, 0));
+    ASSERT_EQ(vector<uint8_t>(first, first + 16), vector<uint8_t>(again, again + 16));
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/GF256.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Reference carry-less multiplication, reduced by the field polynomial */
+static uint8_t slowMultiply(uint8_t a, uint8_t b) {
+    int result = 0;
+    int x = a;
+    for (int bit = 0; bit < 8; ++bit) {
+        if (b & (1 << bit)) {
+            result ^= x;
+        }
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x11d;
+        }
+    }
+    return result;
+}
+
+TEST(GF256, it_multiplies_in_the_field) {
+    for (int a = 0; a < 256; ++a) {
+        for (int b = 0; b < 256; ++b) {
+            ASSERT_EQ(slowMultiply(a, b), gf256Multiply(a, b));
+        }
+    }
+}
+
+TEST(GF256, it_inverts_non_zero_elements) {
+    for (int a = 1; a < 256; ++a) {
+        ASSERT_EQ(1, gf256Multiply(a, gf256Inverse(a)));
+    }
+    ASSERT_THROW(gf256Inverse(0), std::invalid_argument);
+}
+
+TEST(GF256, it_adds_a_multiple_of_a_buffer) {
+    uint8_t src[256];
+    uint8_t dst[256];
+    for (int i = 0; i < 256; ++i) {
+        src[i] = i;
+        dst[i] = 255 - i;
+    }
+    for (int coefficient : { 0, 1, 2, 0x8e }) {
+        uint8_t expected[256];
+        for (int i = 0; i < 256; ++i) {
+            expected[i] = dst[i] ^ slowMultiply(coefficient, src[i]);
+        }
+        gf256MultiplyAdd(dst, src, coefficient, 256);
+        ASSERT_EQ(0, memcmp(expected, dst, 256));
+    }
+}
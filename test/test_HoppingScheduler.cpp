@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/HoppingScheduler.hpp>
+#include <comms_lora_ebyte_e32/MockAUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct HoppingSchedulerTest : public ::testing::Test,
+                              public iodrivers_base::Fixture<Driver> {
+    Configuration conf;
+    // Node 0 on channel 4, node 1 on channel 5, node 2 on channel 4
+    ChannelPlan plan = ChannelPlan(3, { 4, 5 });
+    base::Time epoch = base::Time::fromSeconds(1000);
+    uint8_t payload[10] = { 0 };
+
+    HoppingSchedulerTest() {
+        driver.openURI("test://");
+        conf.transparent_transmission = false;
+        conf.air_rate = Configuration::AIR_RATE_2400;
+        driver.setLinkConfiguration(conf);
+        driver.setFixedTransmissionGap(base::Time());
+    }
+
+    int findSlot(int node, int channel) {
+        for (int i = 0; i < plan.getSlotCount(); ++i) {
+            if (plan.getTransmitChannel(node, i) == channel) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+TEST_F(HoppingSchedulerTest, it_sends_only_in_the_slots_of_the_frame_channel) {
+    HoppingScheduler scheduler(driver, plan, 0);
+    scheduler.setEpoch(epoch);
+    scheduler.push(0x10, 5, payload, 10);
+
+    int slot = findSlot(0, 5);
+    base::Time duration = scheduler.getSlotDuration();
+    for (int i = 0; i < plan.getSlotCount(); ++i) {
+        if (i != slot) {
+            ASSERT_EQ(0, scheduler.update(epoch + duration * i));
+        }
+    }
+    ASSERT_EQ(1, scheduler.update(epoch + duration * slot));
+    ASSERT_EQ(vector<uint8_t>({ 0, 0x10, 5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }),
+              readDataFromDriver());
+}
+
+TEST_F(HoppingSchedulerTest, it_sends_one_frame_per_slot) {
+    HoppingScheduler scheduler(driver, plan, 0);
+    scheduler.setEpoch(epoch);
+    scheduler.push(0x10, 5, payload, 10);
+    scheduler.push(0x10, 5, payload, 10);
+
+    base::Time slot_start = epoch + scheduler.getSlotDuration() * findSlot(0, 5);
+    ASSERT_EQ(1, scheduler.update(slot_start));
+    ASSERT_EQ(0, scheduler.update(slot_start + base::Time::fromMilliseconds(1)));
+    ASSERT_EQ(1u, scheduler.getQueuedFrameCount());
+    ASSERT_EQ(slot_start + scheduler.getSuperframeDuration(),
+              scheduler.getNextSendTime(slot_start));
+}
+
+TEST_F(HoppingSchedulerTest, it_does_not_start_a_frame_that_would_overflow_its_slot) {
+    HoppingScheduler scheduler(driver, plan, 0);
+    scheduler.setEpoch(epoch);
+    scheduler.push(0x10, 5, payload, 10);
+
+    base::Time slot_end =
+        epoch + scheduler.getSlotDuration() * (findSlot(0, 5) + 1);
+    ASSERT_EQ(0, scheduler.update(slot_end - base::Time::fromMicroseconds(1)));
+    ASSERT_EQ(1u, scheduler.getStatistics().idle_slots);
+    ASSERT_EQ(1u, scheduler.getQueuedFrameCount());
+}
+
+TEST_F(HoppingSchedulerTest, it_sizes_the_slots_for_the_maximum_frame) {
+    HoppingScheduler small(driver, plan, 0, 10);
+    HoppingScheduler big(driver, plan, 0, 40);
+    ASSERT_LT(small.getSlotDuration(), big.getSlotDuration());
+    ASSERT_GT(small.getSlotDuration(), getAirtime(conf, 13));
+}
+
+TEST_F(HoppingSchedulerTest, it_rejects_frames_it_cannot_send) {
+    HoppingScheduler scheduler(driver, plan, 0, 10);
+    ASSERT_THROW(scheduler.push(0x10, 5, payload, 11), std::invalid_argument);
+    ASSERT_THROW(scheduler.push(0x10, 6, payload, 10), std::invalid_argument);
+}
+
+struct HoppingSchedulerFlowControlTest : public HoppingSchedulerTest {
+    MockAUXMonitor aux;
+    base::Time slot_start;
+
+    HoppingSchedulerFlowControlTest() {
+        conf.uart_rate = Configuration::RATE_115200;
+        driver.setLinkConfiguration(conf);
+        driver.setAUXMonitor(&aux);
+
+        // Leave 12 bytes in the module buffer, i.e. the header and 9 bytes
+        vector<uint8_t> filler(497, 0);
+        driver.writeRaw(1, 2, filler.data(), filler.size());
+        readDataFromDriver();
+        aux.setReady(false);
+
+        for (int i = 0; i < 10; ++i) {
+            payload[i] = i;
+        }
+    }
+};
+
+TEST_F(HoppingSchedulerFlowControlTest, it_continues_a_partially_written_frame) {
+    HoppingScheduler scheduler(driver, plan, 0);
+    scheduler.setEpoch(epoch);
+    slot_start = epoch + scheduler.getSlotDuration() * findSlot(0, 5);
+    scheduler.push(0x10, 5, payload, 10);
+
+    driver.setWriteTimeout(base::Time::fromMilliseconds(200));
+    thread drain([this]() {
+        this_thread::sleep_for(chrono::milliseconds(300));
+        aux.setReady(true);
+    });
+    int sent = scheduler.update(slot_start);
+    drain.join();
+
+    ASSERT_EQ(1, sent);
+    ASSERT_EQ(vector<uint8_t>({ 0, 0x10, 5, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }),
+              readDataFromDriver());
+    ASSERT_EQ(0u, scheduler.getQueuedFrameCount());
+    ASSERT_EQ(1u, scheduler.getStatistics().sent_frames);
+}
+
+TEST_F(HoppingSchedulerFlowControlTest, it_drops_a_frame_it_could_not_finish) {
+    HoppingScheduler scheduler(driver, plan, 0);
+    scheduler.setEpoch(epoch);
+    slot_start = epoch + scheduler.getSlotDuration() * findSlot(0, 5);
+    scheduler.push(0x10, 5, payload, 10);
+
+    driver.setWriteTimeout(base::Time::fromMilliseconds(10));
+    ASSERT_EQ(0, scheduler.update(slot_start));
+    ASSERT_EQ(12u, readDataFromDriver().size());
+    ASSERT_EQ(0u, scheduler.getQueuedFrameCount());
+    ASSERT_EQ(1u, scheduler.getStatistics().truncated_frames);
+}
+
+TEST(HoppingSchedulerSimulation, it_delivers_without_collisions) {
+    ChannelPlan plan(4, { 1, 2 });
+    Simulator simulator;
+    Driver drivers[4];
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    conf.transparent_transmission = false;
+    for (int i = 0; i < 4; ++i) {
+        conf.address = i + 1;
+        conf.channel = plan.getNodeChannel(i);
+        simulator.addModule(conf);
+        drivers[i].setFileDescriptor(simulator.openDevice(i));
+        drivers[i].setLinkConfiguration(conf);
+    }
+    simulator.start();
+
+    vector<unique_ptr<HoppingScheduler>> schedulers;
+    base::Time epoch = base::Time::now();
+    uint8_t payload[20] = { 0 };
+    for (int i = 0; i < 4; ++i) {
+        schedulers.emplace_back(new HoppingScheduler(drivers[i], plan, i, 20));
+        schedulers[i]->setEpoch(epoch);
+        for (int target = 0; target < 4; ++target) {
+            if (target != i) {
+                schedulers[i]->push(target + 1, plan.getNodeChannel(target),
+                                    payload, 20);
+            }
+        }
+    }
+
+    base::Time deadline = epoch + schedulers[0]->getSuperframeDuration() * 3;
+    size_t received[4] = { 0 };
+    while (base::Time::now() < deadline) {
+        for (int i = 0; i < 4; ++i) {
+            schedulers[i]->update();
+            uint8_t buffer[256];
+            try {
+                received[i] += drivers[i].readRaw(
+                    buffer, sizeof(buffer), base::Time(), base::Time()
+                );
+            }
+            catch (iodrivers_base::TimeoutError const&) {
+            }
+        }
+        usleep(500);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(0u, schedulers[i]->getQueuedFrameCount());
+        ASSERT_EQ(60u, received[i]);
+        ASSERT_EQ(0u, simulator.getStatus(i).collided_sub_packets);
+        ASSERT_EQ(0u, simulator.getStatus(i).missed_sub_packets);
+    }
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/KeyValueStore.hpp>
+#include <dirent.h>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct KeyValueStoreTest : public ::testing::Test {
+    string dir;
+    string path;
+
+    KeyValueStoreTest() {
+        char tmp[] = "/tmp/key_value_store_XXXXXX";
+        dir = mkdtemp(tmp);
+        path = dir + "/store";
+    }
+
+    ~KeyValueStoreTest() {
+        for (auto const& name : listDir()) {
+            unlink((dir + "/" + name).c_str());
+        }
+        rmdir(dir.c_str());
+    }
+
+    vector<string> listDir() const {
+        vector<string> names;
+        DIR* d = opendir(dir.c_str());
+        while (dirent* entry = readdir(d)) {
+            string name = entry->d_name;
+            if (name != "." && name != "..") {
+                names.push_back(name);
+            }
+        }
+        closedir(d);
+        return names;
+    }
+};
+
+TEST_F(KeyValueStoreTest, it_returns_false_for_an_unknown_key) {
+    KeyValueStore store;
+    string value;
+    ASSERT_FALSE(store.get("a", value));
+}
+
+TEST_F(KeyValueStoreTest, it_persists_the_values_in_its_file) {
+    {
+        KeyValueStore store(path);
+        ASSERT_TRUE(store.set("a", "1"));
+        ASSERT_TRUE(store.set("b", "2"));
+        ASSERT_TRUE(store.remove("a"));
+    }
+
+    ifstream file(path.c_str());
+    string line;
+    getline(file, line);
+    ASSERT_EQ("b 2", line);
+
+    KeyValueStore store(path);
+    string value;
+    ASSERT_FALSE(store.get("a", value));
+    ASSERT_TRUE(store.get("b", value));
+    ASSERT_EQ("2", value);
+}
+
+TEST_F(KeyValueStoreTest, it_leaves_no_temporary_file_behind) {
+    KeyValueStore store(path);
+    store.set("a", "1");
+    ASSERT_EQ(vector<string>({ "store" }), listDir());
+}
+
+TEST_F(KeyValueStoreTest, concurrent_writers_do_not_share_their_temporary_file) {
+    vector<thread> writers;
+    for (int i = 0; i < 4; ++i) {
+        writers.emplace_back([this, i]() {
+            KeyValueStore store(path);
+            for (int j = 0; j < 100; ++j) {
+                ASSERT_TRUE(store.set("writer" + to_string(i), to_string(j)));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    // The file holds the last complete write of one of the writers
+    ifstream file(path.c_str());
+    string line;
+    int lines = 0;
+    while (getline(file, line)) {
+        ASSERT_EQ(0u, line.find("writer"));
+        ASSERT_EQ(string::npos, line.find_first_not_of("0123456789 ", 7));
+        ++lines;
+    }
+    ASSERT_GE(lines, 1);
+    ASSERT_EQ(vector<string>({ "store" }), listDir());
+}
+
+TEST_F(KeyValueStoreTest, it_keeps_the_values_if_the_file_cannot_be_written) {
+    KeyValueStore store("/nonexistent/store");
+    ASSERT_FALSE(store.set("a", "1"));
+    string value;
+    ASSERT_TRUE(store.get("a", value));
+    ASSERT_EQ("1", value);
+}
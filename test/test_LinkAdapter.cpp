@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/LinkAdapter.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Channel whose link margin is 0dB at 9600 bps and 30dBm
+ *
+ * The receiver sensitivity improves by 3dB each time the air rate halves
+ */
+static double lossModel(Configuration const& from, Configuration const&) {
+    double power = 30 - 3 * from.transmission_power;
+    double margin = power + 3 * (Configuration::AIR_RATE_9600 - from.air_rate) - 30;
+    return 1 / (1 + exp(2 * margin));
+}
+
+struct LinkAdapterTest : public ::testing::Test {
+    Simulator simulator;
+    Driver drivers[2];
+    Configuration conf;
+
+    LinkAdapterTest() {
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = Configuration::AIR_RATE_2400;
+        for (int i = 0; i < 2; ++i) {
+            simulator.addModule(conf);
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+        }
+        simulator.setTimeScale(10);
+        simulator.setLossModel(lossModel);
+        simulator.start();
+    }
+
+    unique_ptr<LinkAdapter> makeAdapter(int i, LinkAdapter::Role role) {
+        unique_ptr<LinkAdapter> adapter(
+            new LinkAdapter(drivers[i], role, conf, RateController(0.2, 10, 1))
+        );
+        adapter->setModeSwitch([this, i](bool configuration_mode) {
+            simulator.setMode(i, configuration_mode ? Simulator::MODE_SLEEP
+                                                    : Simulator::MODE_NORMAL);
+        });
+        adapter->setReportPeriod(base::Time::fromMilliseconds(250));
+        adapter->setConfigurationDelay(base::Time::fromMilliseconds(5));
+        adapter->setHandshakeTimeout(base::Time::fromSeconds(1));
+        adapter->setLinkTimeout(base::Time::fromMilliseconds(1500));
+        return adapter;
+    }
+};
+
+TEST_F(LinkAdapterTest, it_converges_to_the_fastest_reliable_air_rate) {
+    auto master = makeAdapter(0, LinkAdapter::ROLE_MASTER);
+    auto slave = makeAdapter(1, LinkAdapter::ROLE_SLAVE);
+
+    // The slave is only accessed from its thread while it runs, it
+    // publishes its air rate for the convergence check
+    atomic<bool> done(false);
+    atomic<int> slave_air_rate(slave->getConfiguration().air_rate);
+    thread slave_thread([&]() {
+        while (!done) {
+            slave->process(base::Time::fromMilliseconds(10));
+            slave_air_rate = slave->getConfiguration().air_rate;
+        }
+    });
+
+    // Out of phase with the slave's reports, and with a period that is not
+    // harmonic with theirs, so that half-duplex collisions stay rare
+    master->process(base::Time::fromMilliseconds(50));
+
+    // Wait for the probe of 9600 bps to fail
+    auto converged = [&]() {
+        auto conf = master->getConfiguration();
+        return master->getStatistics().failed_switches > 0 &&
+               conf.air_rate == Configuration::AIR_RATE_4800 &&
+               conf.transmission_power == Configuration::POWER_30dBm &&
+               slave_air_rate == conf.air_rate;
+    };
+    uint8_t packet[10] = { 0 };
+    base::Time deadline = base::Time::now() + base::Time::fromSeconds(20);
+    while (!converged() && base::Time::now() < deadline) {
+        master->send(packet, 10);
+        master->process(base::Time::fromMilliseconds(170));
+    }
+    done = true;
+    slave_thread.join();
+
+    ASSERT_TRUE(converged());
+    for (int i = 0; i < 2; ++i) {
+        auto module_conf = simulator.getStatus(i).configuration;
+        ASSERT_EQ(Configuration::AIR_RATE_4800, module_conf.air_rate);
+        ASSERT_EQ(Configuration::POWER_30dBm, module_conf.transmission_power);
+    }
+    ASSERT_GE(master->getStatistics().switches, 1u);
+}
+
+TEST_F(LinkAdapterTest, it_returns_to_the_initial_configuration_when_the_peer_is_lost) {
+    auto master = makeAdapter(0, LinkAdapter::ROLE_MASTER);
+    auto slave = makeAdapter(1, LinkAdapter::ROLE_SLAVE);
+    master->setLinkTimeout(base::Time::fromMilliseconds(500));
+
+    thread slave_thread([&]() {
+        slave->process(base::Time::fromSeconds(2));
+    });
+    master->process(base::Time::fromMilliseconds(50));
+    uint8_t packet[10] = { 0 };
+    base::Time deadline = base::Time::now() + base::Time::fromSeconds(3);
+    while (master->getConfiguration().air_rate == Configuration::AIR_RATE_2400 &&
+           base::Time::now() < deadline) {
+        master->send(packet, 10);
+        master->process(base::Time::fromMilliseconds(100));
+    }
+    slave_thread.join();
+    ASSERT_NE(Configuration::AIR_RATE_2400, master->getConfiguration().air_rate);
+
+    master->process(base::Time::fromSeconds(1));
+    ASSERT_EQ(Configuration::AIR_RATE_2400, master->getConfiguration().air_rate);
+    ASSERT_EQ(1u, master->getStatistics().fallbacks);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/MessageLink.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct MessageLinkTest : public ::testing::Test {
+    Simulator simulator;
+    Driver drivers[2];
+    Configuration conf;
+
+    MessageLinkTest() {
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = Configuration::AIR_RATE_19200;
+        conf.transparent_transmission = false;
+        conf.address = 0x10;
+        conf.channel = 2;
+        simulator.addModule(conf);
+        simulator.addModule(conf);
+        simulator.setTimeScale(10);
+        for (int i = 0; i < 2; ++i) {
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(conf);
+        }
+        drivers[0].setAUXMonitor(&simulator.getAUX(0));
+        simulator.start();
+    }
+};
+
+TEST_F(MessageLinkTest, it_transfers_a_multi_kilobyte_message) {
+    MessageLink tx(drivers[0]);
+    MessageLink rx(drivers[1]);
+
+    vector<uint8_t> message(3000);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = i * 7;
+    }
+    tx.send(0x10, 2, message.data(), message.size());
+
+    vector<uint8_t> received(4096);
+    int size = rx.receive(received.data(), received.size(),
+                          base::Time::fromSeconds(5));
+    received.resize(size);
+    ASSERT_EQ(message, received);
+
+    auto tx_stats = tx.getStatistics();
+    ASSERT_EQ(1u, tx_stats.sent_messages);
+    ASSERT_EQ(64u, tx_stats.sent_fragments);
+    auto rx_stats = rx.getStatistics();
+    ASSERT_EQ(1u, rx_stats.reassembly.completed_messages);
+    ASSERT_EQ(3000u, rx_stats.reassembly.message_bytes);
+    ASSERT_GT(rx_stats.rx_goodput, 0);
+    ASSERT_EQ(19200.0 / 8, rx_stats.configured_air_throughput);
+}
+
+TEST_F(MessageLinkTest, it_drops_a_message_whose_fragment_was_lost) {
+    simulator.setPacketLoss(1);
+    MessageLink tx(drivers[0]);
+    MessageLink rx(drivers[1]);
+
+    vector<uint8_t> message(100, 0x42);
+    tx.send(0x10, 2, message.data(), message.size());
+    uint8_t received[4096];
+    ASSERT_THROW(rx.receive(received, 4096, base::Time::fromMilliseconds(200)),
+                 iodrivers_base::TimeoutError);
+}
+
+TEST_F(MessageLinkTest, it_throws_if_the_receive_buffer_is_too_small) {
+    MessageLink tx(drivers[0]);
+    MessageLink rx(drivers[1]);
+
+    vector<uint8_t> message(100, 0x42);
+    tx.send(0x10, 2, message.data(), message.size());
+    uint8_t received[50];
+    ASSERT_THROW(rx.receive(received, 50, base::Time::fromSeconds(2)),
+                 std::invalid_argument);
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/MockAUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/MockModePins.hpp>
+#include <comms_lora_ebyte_e32/ModeController.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <iodrivers_base/Exceptions.hpp>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct ModeControllerTest : public ::testing::Test {
+    MockModePins pins;
+    MockAUXMonitor aux;
+};
+
+TEST_F(ModeControllerTest, it_sets_the_pins_of_each_mode) {
+    ModeController controller(pins, nullptr);
+    controller.setFallbackDelay(base::Time());
+    ASSERT_FALSE(pins.getM0());
+    ASSERT_FALSE(pins.getM1());
+
+    controller.setMode(ModeController::MODE_WAKE_UP);
+    ASSERT_TRUE(pins.getM0());
+    ASSERT_FALSE(pins.getM1());
+    controller.setMode(ModeController::MODE_POWER_SAVING);
+    ASSERT_FALSE(pins.getM0());
+    ASSERT_TRUE(pins.getM1());
+    controller.setMode(ModeController::MODE_SLEEP);
+    ASSERT_TRUE(pins.getM0());
+    ASSERT_TRUE(pins.getM1());
+    ASSERT_EQ(ModeController::MODE_SLEEP, controller.getMode());
+}
+
+TEST_F(ModeControllerTest, it_does_not_switch_to_the_current_mode) {
+    ModeController controller(pins, &aux, ModeController::MODE_SLEEP);
+    int changes = pins.getChangeCount();
+    controller.setMode(ModeController::MODE_SLEEP);
+    ASSERT_EQ(changes, pins.getChangeCount());
+    ASSERT_EQ(0u, controller.getStatistics().switches);
+}
+
+TEST_F(ModeControllerTest, it_waits_for_aux_to_go_high_after_the_switch) {
+    ModeController controller(pins, &aux);
+    thread busy;
+    pins.setCallback([&](bool, bool) {
+        aux.setReady(false);
+        busy = thread([&]() {
+            this_thread::sleep_for(chrono::milliseconds(30));
+            aux.setReady(true);
+        });
+    });
+
+    controller.setMode(ModeController::MODE_SLEEP);
+    busy.join();
+    auto stats = controller.getStatistics();
+    ASSERT_EQ(1u, stats.switches);
+    ASSERT_GE(stats.last_switch_duration, base::Time::fromMilliseconds(30));
+    ASSERT_LT(stats.last_switch_duration, base::Time::fromMilliseconds(50));
+}
+
+TEST_F(ModeControllerTest, it_throws_if_aux_stays_low) {
+    ModeController controller(pins, &aux);
+    controller.setAUXTimeout(base::Time::fromMilliseconds(20));
+    aux.setReady(false);
+    ASSERT_THROW(controller.setMode(ModeController::MODE_SLEEP),
+                 iodrivers_base::TimeoutError);
+    // The module is busy, the pins must not have changed
+    ASSERT_FALSE(pins.getM0());
+}
+
+TEST_F(ModeControllerTest, it_falls_back_to_a_fixed_delay_without_aux) {
+    ModeController controller(pins, nullptr);
+    controller.setFallbackDelay(base::Time::fromMilliseconds(20));
+    controller.setMode(ModeController::MODE_SLEEP);
+    ASSERT_GE(controller.getStatistics().last_switch_duration,
+              base::Time::fromMilliseconds(20));
+}
+
+TEST_F(ModeControllerTest, a_transaction_restores_the_previous_mode) {
+    ModeController controller(pins, &aux, ModeController::MODE_POWER_SAVING);
+    {
+        ModeController::Transaction transaction(
+            &controller, ModeController::MODE_SLEEP
+        );
+        ASSERT_EQ(ModeController::MODE_SLEEP, controller.getMode());
+    }
+    ASSERT_EQ(ModeController::MODE_POWER_SAVING, controller.getMode());
+    ASSERT_EQ(2u, controller.getStatistics().switches);
+}
+
+TEST_F(ModeControllerTest, nested_transactions_share_the_mode_switch) {
+    ModeController controller(pins, &aux);
+    {
+        ModeController::Transaction outer(&controller, ModeController::MODE_SLEEP);
+        {
+            ModeController::Transaction inner(
+                &controller, ModeController::MODE_SLEEP
+            );
+        }
+        ASSERT_EQ(ModeController::MODE_SLEEP, controller.getMode());
+        ASSERT_EQ(1u, controller.getStatistics().switches);
+    }
+    ASSERT_EQ(ModeController::MODE_NORMAL, controller.getMode());
+    ASSERT_EQ(2u, controller.getStatistics().switches);
+}
+
+TEST_F(ModeControllerTest, a_transaction_does_not_throw_if_restoring_the_mode_fails) {
+    ModeController controller(pins, nullptr);
+    controller.setFallbackDelay(base::Time());
+    {
+        ModeController::Transaction transaction(
+            &controller, ModeController::MODE_SLEEP
+        );
+        pins.setCallback([](bool, bool) {
+            throw iodrivers_base::UnixError("failed to set the pins");
+        });
+    }
+    ASSERT_EQ(ModeController::MODE_SLEEP, controller.getMode());
+}
+
+TEST_F(ModeControllerTest, a_transaction_without_controller_does_nothing) {
+    ModeController::Transaction transaction(nullptr, ModeController::MODE_SLEEP);
+}
+
+struct ModeControllerSimulationTest : public ::testing::Test {
+    Simulator simulator;
+    Driver driver;
+    MockModePins pins;
+    Configuration conf;
+
+    ModeControllerSimulationTest() {
+        conf.uart_rate = Configuration::RATE_115200;
+        simulator.addModule(conf);
+        simulator.setModeSwitchTime(base::Time::fromMilliseconds(20));
+        driver.setFileDescriptor(simulator.openDevice(0));
+        driver.setLinkConfiguration(conf);
+        driver.setCommandTimeout(base::Time::fromMilliseconds(100));
+        pins.setCallback([this](bool m0, bool m1) {
+            simulator.setMode(0, m0 && m1 ? Simulator::MODE_SLEEP
+                                          : Simulator::MODE_NORMAL);
+        });
+        simulator.start();
+    }
+};
+
+TEST_F(ModeControllerSimulationTest, it_lets_the_driver_send_commands_in_normal_mode) {
+    ModeController controller(pins, &simulator.getAUX(0));
+    driver.setModeController(&controller);
+
+    conf.address = 0x1234;
+    driver.writeConfiguration(conf);
+    ASSERT_EQ(0x1234, driver.readConfiguration().address);
+    ASSERT_EQ(ModeController::MODE_NORMAL, controller.getMode());
+    ASSERT_EQ(0u, simulator.getStatus(0).ignored_bytes);
+    ASSERT_EQ(4u, controller.getStatistics().switches);
+    ASSERT_GE(controller.getStatistics().max_switch_duration,
+              base::Time::fromMilliseconds(20));
+}
+
+TEST_F(ModeControllerSimulationTest, a_configuration_transaction_spans_several_commands) {
+    ModeController controller(pins, &simulator.getAUX(0));
+    driver.setModeController(&controller);
+    {
+        auto transaction = driver.beginConfigurationTransaction();
+        conf.address = 0x1234;
+        driver.writeConfiguration(conf);
+        driver.readConfiguration();
+        driver.readVersion();
+    }
+    ASSERT_EQ(2u, controller.getStatistics().switches);
+    ASSERT_EQ(0u, simulator.getStatus(0).ignored_bytes);
+}
+
+TEST_F(ModeControllerSimulationTest, commands_sent_during_the_switch_are_lost) {
+    // A fixed delay shorter than the actual switch time
+    ModeController controller(pins, nullptr);
+    controller.setFallbackDelay(base::Time::fromMilliseconds(1));
+    driver.setModeController(&controller);
+    ASSERT_THROW(driver.readConfiguration(), iodrivers_base::TimeoutError);
+    ASSERT_GT(simulator.getStatus(0).ignored_bytes, 0u);
+}
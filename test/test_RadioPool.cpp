@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/RadioPool.hpp>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+/** Module side of a pty, to simulate several modules connected to a pool */
+struct SimulatedModule {
+    int master = -1;
+    int slave = -1;
+
+    SimulatedModule() {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        grantpt(master);
+        unlockpt(master);
+        slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+        for (int fd : { master, slave }) {
+            termios tio;
+            tcgetattr(fd, &tio);
+            cfmakeraw(&tio);
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+
+    ~SimulatedModule() {
+        close(master);
+    }
+
+    void write(vector<uint8_t> const& data) {
+        ASSERT_EQ(static_cast<ssize_t>(data.size()),
+                  ::write(master, data.data(), data.size()));
+    }
+
+    vector<uint8_t> read(size_t expected) {
+        vector<uint8_t> result;
+        uint8_t buffer[512];
+        while (result.size() < expected) {
+            pollfd pfd = { master, POLLIN, 0 };
+            if (::poll(&pfd, 1, 1000) <= 0) {
+                break;
+            }
+            int n = ::read(master, buffer, sizeof(buffer));
+            result.insert(result.end(), buffer, buffer + n);
+        }
+        return result;
+    }
+};
+
+struct RadioPoolTest : public ::testing::Test {
+    SimulatedModule modules[3];
+    RadioPool pool;
+
+    RadioPoolTest() {
+        for (int i = 0; i < 3; ++i) {
+            unique_ptr<Driver> driver(new Driver());
+            driver->setFileDescriptor(modules[i].slave);
+            Configuration conf;
+            conf.channel = i;
+            conf.uart_rate = Configuration::RATE_115200;
+            conf.air_rate = Configuration::AIR_RATE_19200;
+            driver->setLinkConfiguration(conf);
+            pool.add(std::move(driver));
+        }
+    }
+};
+
+TEST_F(RadioPoolTest, it_routes_frames_to_the_radio_on_the_frame_channel) {
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    ASSERT_EQ(2, pool.send(0x10, 2, payload, 4));
+    pool.poll(base::Time::fromMilliseconds(10));
+
+    ASSERT_EQ(vector<uint8_t>({ 0, 0x10, 2, 1, 2, 3, 4 }), modules[2].read(7));
+    ASSERT_EQ(1u, pool.getStatus(2).tx_frames);
+    ASSERT_EQ(7u, pool.getStatus(2).tx_bytes);
+}
+
+TEST_F(RadioPoolTest, it_routes_frames_to_the_least_loaded_radio_otherwise) {
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    ASSERT_EQ(0, pool.send(0x10, 10, payload, 4));
+    ASSERT_EQ(1, pool.send(0x10, 10, payload, 4));
+    ASSERT_EQ(2, pool.send(0x10, 10, payload, 4));
+    ASSERT_EQ(0, pool.send(0x10, 10, payload, 4));
+    ASSERT_EQ(2u, pool.getStatus(0).queue_depth);
+}
+
+TEST_F(RadioPoolTest, it_bounds_the_time_spent_writing_to_each_radio) {
+    for (size_t i = 0; i < pool.size(); ++i) {
+        ASSERT_EQ(RadioPool::MAX_WRITE_TIME_PER_PASS,
+                  pool.getScheduler(i).getMaxWriteTime());
+    }
+}
+
+TEST_F(RadioPoolTest, it_reports_received_data_with_the_radio_index) {
+    vector<pair<int, vector<uint8_t>>> received;
+    pool.setReceiveCallback([&](int radio, uint8_t const* data, int size) {
+        received.push_back(make_pair(radio, vector<uint8_t>(data, data + size)));
+    });
+
+    modules[1].write({ 1, 2 });
+    base::Time deadline = base::Time::now() + base::Time::fromSeconds(1);
+    while (received.empty() && base::Time::now() < deadline) {
+        pool.poll(base::Time::fromMilliseconds(100));
+    }
+
+    ASSERT_EQ(1u, received.size());
+    ASSERT_EQ(1, received[0].first);
+    ASSERT_EQ(vector<uint8_t>({ 1, 2 }), received[0].second);
+    ASSERT_EQ(2u, pool.getStatus(1).rx_bytes);
+}
+
+TEST_F(RadioPoolTest, it_runs_commands_on_all_radios_concurrently) {
+    int replies = 0;
+    for (int i = 0; i < 3; ++i) {
+        pool.getAsyncDriver(i).readVersion([&](Version const&) { ++replies; });
+    }
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(vector<uint8_t>({ 0xc3, 0xc3, 0xc3 }), modules[i].read(3));
+        modules[i].write({ 0xc3, 32, 1, 2 });
+    }
+
+    base::Time deadline = base::Time::now() + base::Time::fromSeconds(1);
+    while (replies < 3 && base::Time::now() < deadline) {
+        pool.poll(base::Time::fromMilliseconds(100));
+    }
+    ASSERT_EQ(3, replies);
+}
+
+TEST_F(RadioPoolTest, poll_waits_for_timeouts_shorter_than_a_millisecond) {
+    base::Time start = base::Time::now();
+    pool.poll(base::Time::fromMicroseconds(500));
+    ASSERT_GE(base::Time::now() - start, base::Time::fromMicroseconds(500));
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/RateController.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct RateControllerTest : public ::testing::Test {
+    RateController controller = RateController(0.1, 20, 2);
+    Configuration conf;
+
+    RateControllerTest() {
+        conf.air_rate = Configuration::AIR_RATE_2400;
+        conf.transmission_power = Configuration::POWER_24dBm;
+    }
+};
+
+TEST_F(RateControllerTest, it_waits_for_enough_samples) {
+    auto next = controller.update(conf, 10, 0);
+    ASSERT_EQ(Configuration::POWER_24dBm, next.transmission_power);
+    next = controller.update(conf, 10, 0);
+    ASSERT_EQ(Configuration::POWER_27dBm, next.transmission_power);
+}
+
+TEST_F(RateControllerTest, it_raises_the_power_first_when_the_loss_is_high) {
+    auto next = controller.update(conf, 20, 15);
+    ASSERT_EQ(Configuration::AIR_RATE_2400, next.air_rate);
+    ASSERT_EQ(Configuration::POWER_27dBm, next.transmission_power);
+}
+
+TEST_F(RateControllerTest, it_lowers_the_air_rate_at_the_maximum_power) {
+    conf.transmission_power = Configuration::POWER_30dBm;
+    auto next = controller.update(conf, 20, 15);
+    ASSERT_EQ(Configuration::AIR_RATE_1200, next.air_rate);
+    ASSERT_EQ(Configuration::POWER_30dBm, next.transmission_power);
+}
+
+TEST_F(RateControllerTest, it_keeps_the_configuration_between_half_and_the_target_loss) {
+    for (int i = 0; i < 5; ++i) {
+        auto next = controller.update(conf, 20, 18);
+        ASSERT_EQ(Configuration::AIR_RATE_2400, next.air_rate);
+        ASSERT_EQ(Configuration::POWER_24dBm, next.transmission_power);
+    }
+}
+
+TEST_F(RateControllerTest, it_probes_the_next_air_rate_after_good_evaluations) {
+    ASSERT_EQ(Configuration::AIR_RATE_2400, controller.update(conf, 20, 20).air_rate);
+    ASSERT_EQ(Configuration::AIR_RATE_4800, controller.update(conf, 20, 20).air_rate);
+}
+
+TEST_F(RateControllerTest, it_lowers_the_power_at_the_maximum_air_rate) {
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    controller.update(conf, 20, 20);
+    auto next = controller.update(conf, 20, 20);
+    ASSERT_EQ(Configuration::AIR_RATE_19200, next.air_rate);
+    ASSERT_EQ(Configuration::POWER_21dBm, next.transmission_power);
+}
+
+TEST_F(RateControllerTest, it_reverts_a_failed_probe_and_waits_longer_for_the_next) {
+    controller.update(conf, 20, 20);
+    auto probe = controller.update(conf, 20, 20);
+    ASSERT_EQ(Configuration::AIR_RATE_4800, probe.air_rate);
+
+    auto reverted = controller.update(probe, 20, 10);
+    ASSERT_EQ(Configuration::AIR_RATE_2400, reverted.air_rate);
+    ASSERT_EQ(Configuration::POWER_24dBm, reverted.transmission_power);
+
+    // The interval doubled from 2 to 4 evaluations
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(Configuration::AIR_RATE_2400,
+                  controller.update(reverted, 20, 20).air_rate);
+    }
+    ASSERT_EQ(Configuration::AIR_RATE_4800,
+              controller.update(reverted, 20, 20).air_rate);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Fragmenter.hpp>
+#include <comms_lora_ebyte_e32/Reassembler.hpp>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct ReassemblerTest : public ::testing::Test {
+    Fragmenter fragmenter;
+    Reassembler reassembler;
+    base::Time now = base::Time::fromSeconds(100);
+
+    ReassemblerTest()
+        : fragmenter(16)
+        , reassembler(2, 1024, base::Time::fromSeconds(1)) {
+    }
+
+    vector<vector<uint8_t>> fragment(vector<uint8_t> const& message) {
+        vector<vector<uint8_t>> fragments;
+        fragmenter.start(message.data(), message.size());
+        while (fragmenter.hasNext()) {
+            uint8_t buffer[16];
+            int size = fragmenter.next(buffer);
+            fragments.push_back(vector<uint8_t>(buffer, buffer + size));
+        }
+        return fragments;
+    }
+
+    Reassembler::Result push(vector<uint8_t> const& fragment) {
+        return reassembler.push(fragment.data(), fragment.size(), now);
+    }
+
+    vector<uint8_t> message() {
+        uint8_t const* data = reassembler.getMessage();
+        return vector<uint8_t>(data, data + reassembler.getMessageSize());
+    }
+};
+
+static vector<uint8_t> makeMessage(int size, uint8_t seed = 0) {
+    vector<uint8_t> message(size);
+    for (int i = 0; i < size; ++i) {
+        message[i] = seed + i;
+    }
+    return message;
+}
+
+TEST_F(ReassemblerTest, it_rebuilds_a_message) {
+    auto original = makeMessage(25);
+    auto fragments = fragment(original);
+    ASSERT_EQ(Reassembler::FRAGMENT_ACCEPTED, push(fragments[0]));
+    ASSERT_EQ(Reassembler::FRAGMENT_ACCEPTED, push(fragments[1]));
+    ASSERT_EQ(Reassembler::MESSAGE_COMPLETE, push(fragments[2]));
+    ASSERT_EQ(original, message());
+    ASSERT_EQ(0, reassembler.getPendingMessageCount());
+}
+
+TEST_F(ReassemblerTest, it_accepts_fragments_out_of_order) {
+    auto original = makeMessage(25);
+    auto fragments = fragment(original);
+    ASSERT_EQ(Reassembler::FRAGMENT_ACCEPTED, push(fragments[2]));
+    ASSERT_EQ(Reassembler::FRAGMENT_ACCEPTED, push(fragments[0]));
+    ASSERT_EQ(Reassembler::MESSAGE_COMPLETE, push(fragments[1]));
+    ASSERT_EQ(original, message());
+}
+
+TEST_F(ReassemblerTest, it_reassembles_interleaved_messages) {
+    auto first = makeMessage(25, 0);
+    auto second = makeMessage(15, 100);
+    auto first_fragments = fragment(first);
+    auto second_fragments = fragment(second);
+
+    push(first_fragments[0]);
+    push(second_fragments[0]);
+    push(first_fragments[1]);
+    ASSERT_EQ(Reassembler::MESSAGE_COMPLETE, push(second_fragments[1]));
+    ASSERT_EQ(second, message());
+    ASSERT_EQ(Reassembler::MESSAGE_COMPLETE, push(first_fragments[2]));
+    ASSERT_EQ(first, message());
+}
+
+TEST_F(ReassemblerTest, it_rejects_fragments_with_a_bad_CRC) {
+    auto fragments = fragment(makeMessage(5));
+    fragments[0][5] ^= 1;
+    ASSERT_EQ(Reassembler::FRAGMENT_INVALID, push(fragments[0]));
+    ASSERT_EQ(1u, reassembler.getStatistics().invalid_fragments);
+    ASSERT_EQ(0, reassembler.getPendingMessageCount());
+}
+
+TEST_F(ReassemblerTest, it_rejects_messages_larger_than_its_buffers) {
+    Reassembler small(1, 15);
+    auto fragments = fragment(makeMessage(26));
+    ASSERT_EQ(Reassembler::FRAGMENT_INVALID,
+              small.push(fragments[0].data(), fragments[0].size(), now));
+}
+
+TEST_F(ReassemblerTest, it_detects_duplicate_fragments) {
+    auto fragments = fragment(makeMessage(25));
+    push(fragments[0]);
+    ASSERT_EQ(Reassembler::FRAGMENT_DUPLICATE, push(fragments[0]));
+    ASSERT_EQ(1u, reassembler.getStatistics().duplicate_fragments);
+}
+
+TEST_F(ReassemblerTest, it_drops_messages_that_time_out) {
+    auto fragments = fragment(makeMessage(25));
+    push(fragments[0]);
+    push(fragments[1]);
+    now = now + base::Time::fromSeconds(2);
+    ASSERT_EQ(Reassembler::FRAGMENT_ACCEPTED, push(fragments[2]));
+    ASSERT_EQ(1u, reassembler.getStatistics().expired_messages);
+}
+
+TEST_F(ReassemblerTest, it_evicts_the_oldest_message_when_all_slots_are_used) {
+    auto first = fragment(makeMessage(25, 0));
+    auto second = fragment(makeMessage(25, 1));
+    auto third = fragment(makeMessage(25, 2));
+
+    push(first[0]);
+    now = now + base::Time::fromMilliseconds(10);
+    push(second[0]);
+    now = now + base::Time::fromMilliseconds(10);
+    push(third[0]);
+    ASSERT_EQ(1u, reassembler.getStatistics().evicted_messages);
+    ASSERT_EQ(2, reassembler.getPendingMessageCount());
+
+    push(second[1]);
+    ASSERT_EQ(Reassembler::MESSAGE_COMPLETE, push(second[2]));
+    ASSERT_EQ(Reassembler::FRAGMENT_ACCEPTED, push(first[1]));
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/ReedSolomon.hpp>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct ReedSolomonTest : public ::testing::Test {
+    static const int SHARD_SIZE = 20;
+    vector<vector<uint8_t>> shards;
+    vector<uint8_t*> pointers;
+
+    void encode(ReedSolomon const& codec) {
+        int data_shards = codec.getDataShards();
+        int total = data_shards + codec.getParityShards();
+        std::mt19937 rng(42);
+        shards.assign(total, vector<uint8_t>(SHARD_SIZE));
+        pointers.clear();
+        for (int i = 0; i < total; ++i) {
+            if (i < data_shards) {
+                for (auto& byte : shards[i]) {
+                    byte = rng();
+                }
+            }
+            pointers.push_back(shards[i].data());
+        }
+        codec.encode(pointers.data(), pointers.data() + data_shards, SHARD_SIZE);
+    }
+};
+
+TEST_F(ReedSolomonTest, it_recovers_from_any_combination_of_lost_shards) {
+    ReedSolomon codec(4, 2);
+    encode(codec);
+    auto expected = shards;
+
+    for (int a = 0; a < 6; ++a) {
+        for (int b = a; b < 6; ++b) {
+            vector<bool> present(6, true);
+            present[a] = false;
+            present[b] = false;
+            for (int i = 0; i < 6; ++i) {
+                if (!present[i]) {
+                    shards[i].assign(SHARD_SIZE, 0);
+                }
+            }
+            ASSERT_TRUE(codec.reconstruct(pointers.data(), present, SHARD_SIZE));
+            for (int i = 0; i < 4; ++i) {
+                ASSERT_EQ(expected[i], shards[i]);
+            }
+            shards = expected;
+        }
+    }
+}
+
+TEST_F(ReedSolomonTest, it_fails_if_more_shards_than_the_parity_are_lost) {
+    ReedSolomon codec(4, 2);
+    encode(codec);
+    vector<bool> present = { false, true, false, true, false, true };
+    ASSERT_FALSE(codec.reconstruct(pointers.data(), present, SHARD_SIZE));
+}
+
+TEST_F(ReedSolomonTest, it_handles_large_codes) {
+    ReedSolomon codec(200, 55);
+    encode(codec);
+    auto expected = shards;
+    vector<bool> present(255, true);
+    for (int i = 0; i < 55; ++i) {
+        present[i * 3] = false;
+        shards[i * 3].assign(SHARD_SIZE, 0);
+    }
+    ASSERT_TRUE(codec.reconstruct(pointers.data(), present, SHARD_SIZE));
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_EQ(expected[i], shards[i]);
+    }
+}
+
+TEST_F(ReedSolomonTest, it_rejects_invalid_shard_counts) {
+    ASSERT_THROW(ReedSolomon(0, 2), std::invalid_argument);
+    ASSERT_THROW(ReedSolomon(2, -1), std::invalid_argument);
+    ASSERT_THROW(ReedSolomon(200, 56), std::invalid_argument);
+}
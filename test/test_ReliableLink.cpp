@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/ReliableLink.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct ReliableLinkTest : public ::testing::Test {
+    Simulator simulator;
+    Driver drivers[2];
+
+    ReliableLinkTest() {
+        for (int i = 0; i < 2; ++i) {
+            Configuration conf;
+            conf.uart_rate = Configuration::RATE_115200;
+            conf.air_rate = Configuration::AIR_RATE_19200;
+            conf.transparent_transmission = false;
+            conf.address = i + 1;
+            conf.channel = 2;
+            simulator.addModule(conf);
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(conf);
+            drivers[i].setAUXMonitor(&simulator.getAUX(i));
+        }
+        simulator.setTimeScale(10);
+        simulator.start();
+    }
+
+    /** Send packets from drivers[0] to drivers[1] and return what was received */
+    vector<vector<uint8_t>> transfer(int window, int count) {
+        ReliableLink tx(drivers[0], 2, 2, window);
+        ReliableLink rx(drivers[1], 1, 2, window);
+
+        vector<vector<uint8_t>> received;
+        atomic<bool> done(false);
+        thread receiver([&]() {
+            uint8_t buffer[ReliableLink::DEFAULT_MAX_PACKET_SIZE];
+            while (!done) {
+                try {
+                    int size = rx.receive(buffer, sizeof(buffer),
+                                          base::Time::fromMilliseconds(50));
+                    received.push_back(vector<uint8_t>(buffer, buffer + size));
+                }
+                catch (iodrivers_base::TimeoutError const&) {
+                }
+            }
+            // Acknowledge the last frames
+            rx.process(base::Time::fromMilliseconds(200));
+        });
+
+        for (int i = 0; i < count; ++i) {
+            vector<uint8_t> packet(40, i);
+            EXPECT_TRUE(tx.send(packet.data(), packet.size()));
+        }
+        bool flushed = tx.flush(base::Time::fromSeconds(20));
+        done = true;
+        receiver.join();
+
+        EXPECT_TRUE(flushed);
+        tx_stats = tx.getStatistics();
+        rx_stats = rx.getStatistics();
+        tx_srtt = tx.getSRTT();
+        return received;
+    }
+
+    ReliableLink::Statistics tx_stats;
+    ReliableLink::Statistics rx_stats;
+    base::Time tx_srtt;
+};
+
+TEST_F(ReliableLinkTest, it_delivers_packets_in_order) {
+    auto received = transfer(8, 20);
+
+    ASSERT_EQ(20u, received.size());
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(vector<uint8_t>(40, i), received[i]);
+    }
+    ASSERT_EQ(20u, tx_stats.acknowledged_packets);
+    ASSERT_EQ(20u, rx_stats.delivered_packets);
+    ASSERT_EQ(800u, rx_stats.delivered_bytes);
+}
+
+TEST_F(ReliableLinkTest, it_recovers_lost_frames) {
+    simulator.setPacketLoss(0.2);
+    auto received = transfer(8, 30);
+
+    ASSERT_EQ(30u, received.size());
+    for (int i = 0; i < 30; ++i) {
+        ASSERT_EQ(vector<uint8_t>(40, i), received[i]);
+    }
+    ASSERT_GT(tx_stats.retransmissions, 0u);
+}
+
+TEST_F(ReliableLinkTest, it_works_as_stop_and_wait_with_a_window_of_one) {
+    simulator.setPacketLoss(0.2);
+    auto received = transfer(1, 10);
+
+    ASSERT_EQ(10u, received.size());
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(vector<uint8_t>(40, i), received[i]);
+    }
+}
+
+TEST_F(ReliableLinkTest, it_estimates_the_round_trip_time) {
+    transfer(1, 5);
+
+    ASSERT_GT(tx_srtt, base::Time());
+    ASSERT_LT(tx_srtt, base::Time::fromMilliseconds(500));
+}
+
+TEST_F(ReliableLinkTest, it_backs_off_once_per_timeout) {
+    simulator.setPacketLoss(1);
+    ReliableLink link(drivers[0], 2, 2, 8);
+    base::Time rto = link.getRTO();
+    vector<uint8_t> packet(40, 0);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(link.send(packet.data(), packet.size()));
+    }
+    link.process(rto * 1.5);
+    ASSERT_EQ(8u, link.getStatistics().retransmissions);
+    ASSERT_EQ((rto * 2.0).toMicroseconds(), link.getRTO().toMicroseconds());
+}
+
+TEST_F(ReliableLinkTest, it_rejects_packets_larger_than_the_maximum) {
+    ReliableLink link(drivers[0], 2, 2);
+    vector<uint8_t> packet(ReliableLink::DEFAULT_MAX_PACKET_SIZE + 1);
+    ASSERT_THROW(link.send(packet.data(), packet.size()), std::invalid_argument);
+}
+
+TEST_F(ReliableLinkTest, it_refuses_packets_when_the_queue_is_full) {
+    ReliableLink link(drivers[0], 2, 2);
+    link.setMaxQueueSize(2);
+    uint8_t packet[10] = { 0 };
+    ASSERT_TRUE(link.send(packet, 10));
+    ASSERT_TRUE(link.send(packet, 10));
+    ASSERT_FALSE(link.send(packet, 10));
+}
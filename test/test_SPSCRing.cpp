@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/SPSCRing.hpp>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+TEST(SPSCRing, it_pops_elements_in_the_order_they_were_pushed) {
+    SPSCRing<int> ring(3);
+    ASSERT_TRUE(ring.empty());
+    ASSERT_EQ(nullptr, ring.front());
+    ASSERT_TRUE(ring.push(1));
+    ASSERT_TRUE(ring.push(2));
+    ASSERT_EQ(2u, ring.size());
+
+    ASSERT_EQ(1, *ring.front());
+    ring.pop();
+    ASSERT_EQ(2, *ring.front());
+    ring.pop();
+    ASSERT_EQ(nullptr, ring.front());
+}
+
+TEST(SPSCRing, it_refuses_elements_when_full) {
+    SPSCRing<int> ring(2);
+    ASSERT_TRUE(ring.push(1));
+    ASSERT_TRUE(ring.push(2));
+    ASSERT_EQ(nullptr, ring.beginPush());
+    ASSERT_FALSE(ring.push(3));
+
+    ring.pop();
+    ASSERT_TRUE(ring.push(3));
+    ASSERT_EQ(2, *ring.front());
+}
+
+TEST(SPSCRing, it_fills_the_slots_in_place) {
+    SPSCRing<vector<int>> ring(2);
+    for (int i = 0; i < 5; ++i) {
+        auto* slot = ring.beginPush();
+        slot->assign(3, i);
+        ring.commitPush();
+        ASSERT_EQ(vector<int>(3, i), *ring.front());
+        ring.pop();
+    }
+}
+
+TEST(SPSCRing, it_tracks_the_high_water_mark) {
+    SPSCRing<int> ring(4);
+    ring.push(1);
+    ring.push(2);
+    ring.push(3);
+    ring.pop();
+    ring.pop();
+    ring.push(4);
+    ASSERT_EQ(2u, ring.size());
+    ASSERT_EQ(3u, ring.getHighWaterMark());
+    ring.resetHighWaterMark();
+    ring.push(5);
+    ASSERT_EQ(3u, ring.getHighWaterMark());
+}
+
+TEST(SPSCRing, it_transfers_elements_between_two_threads) {
+    SPSCRing<int> ring(8);
+    const int count = 100000;
+    thread producer([&ring] {
+        for (int i = 0; i < count; ++i) {
+            while (!ring.push(i)) {
+                this_thread::yield();
+            }
+        }
+    });
+
+    for (int i = 0; i < count; ++i) {
+        int* value;
+        while (!(value = ring.front())) {
+            this_thread::yield();
+        }
+        ASSERT_EQ(i, *value);
+        ring.pop();
+    }
+    producer.join();
+    ASSERT_LE(ring.getHighWaterMark(), 8u);
+}
+
+TEST(SPSCRing, it_rejects_an_empty_ring) {
+    ASSERT_THROW(SPSCRing<int>(0), std::invalid_argument);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/SavedConfigurationCache.hpp>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct SavedConfigurationCacheTest : public ::testing::Test {
+    string path;
+
+    SavedConfigurationCacheTest() {
+        char tmp[] = "/tmp/saved_configuration_cache_XXXXXX";
+        int fd = mkstemp(tmp);
+        close(fd);
+        path = tmp;
+        unlink(path.c_str());
+    }
+
+    ~SavedConfigurationCacheTest() {
+        unlink(path.c_str());
+    }
+};
+
+
+TEST_F(SavedConfigurationCacheTest, it_returns_false_for_an_unknown_device) {
+    SavedConfigurationCache cache;
+    Configuration conf;
+    ASSERT_FALSE(cache.get("serial:///dev/ttyUSB0", conf));
+    ASSERT_FALSE(cache.isSaved("serial:///dev/ttyUSB0", conf));
+}
+
+TEST_F(SavedConfigurationCacheTest, it_stores_configurations_per_device) {
+    SavedConfigurationCache cache;
+    Configuration a;
+    a.channel = 12;
+    Configuration b;
+    b.address = 0x1234;
+    cache.set("a", a);
+    cache.set("b", b);
+
+    ASSERT_TRUE(cache.isSaved("a", a));
+    ASSERT_FALSE(cache.isSaved("a", b));
+    Configuration conf;
+    ASSERT_TRUE(cache.get("b", conf));
+    ASSERT_EQ(0x1234, conf.address);
+
+    cache.remove("a");
+    ASSERT_FALSE(cache.get("a", conf));
+}
+
+TEST_F(SavedConfigurationCacheTest, it_persists_the_configurations_in_its_file) {
+    Configuration conf;
+    conf.address = 0x0102;
+    conf.channel = 0x14;
+    conf.uart_rate = Configuration::RATE_115200;
+    {
+        SavedConfigurationCache cache(path);
+        cache.set("serial:///dev/ttyUSB0", conf);
+    }
+
+    ifstream file(path.c_str());
+    string line;
+    getline(file, line);
+    ASSERT_EQ("serial:///dev/ttyUSB0 01023a1444", line);
+
+    SavedConfigurationCache cache(path);
+    ASSERT_TRUE(cache.isSaved("serial:///dev/ttyUSB0", conf));
+}
+
+TEST_F(SavedConfigurationCacheTest, it_keeps_the_entries_if_the_file_cannot_be_written) {
+    SavedConfigurationCache cache("/nonexistent/saved_configuration_cache");
+    Configuration conf;
+    conf.channel = 12;
+    ASSERT_FALSE(cache.set("a", conf));
+    ASSERT_TRUE(cache.isSaved("a", conf));
+    ASSERT_FALSE(cache.remove("a"));
+    ASSERT_FALSE(cache.get("a", conf));
+}
@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct SimulatorTest : public ::testing::Test {
+    Simulator simulator;
+    Driver drivers[2];
+    Configuration conf;
+
+    SimulatorTest() {
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = Configuration::AIR_RATE_19200;
+    }
+
+    void start(Configuration const& conf0, Configuration const& conf1) {
+        simulator.addModule(conf0);
+        simulator.addModule(conf1);
+        for (int i = 0; i < 2; ++i) {
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(i == 0 ? conf0 : conf1);
+        }
+        simulator.start();
+    }
+
+    vector<uint8_t> read(int module, int size,
+                         base::Time timeout = base::Time::fromSeconds(2)) {
+        vector<uint8_t> result(size);
+        try {
+            result.resize(drivers[module].readRaw(
+                result.data(), size, timeout, timeout
+            ));
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+            result.clear();
+        }
+        return result;
+    }
+};
+
+TEST_F(SimulatorTest, it_answers_the_version_command) {
+    Version version;
+    version.frequency = FREQ_868MHZ;
+    version.version = 0x14;
+    version.features = 0x2;
+    simulator.addModule(conf, version);
+    drivers[0].setFileDescriptor(simulator.openDevice(0));
+    simulator.setMode(0, Simulator::MODE_SLEEP);
+    simulator.start();
+
+    auto result = drivers[0].readVersion();
+    ASSERT_EQ(FREQ_868MHZ, result.frequency);
+    ASSERT_EQ(0x14, result.version);
+    ASSERT_EQ(0x2, result.features);
+}
+
+TEST_F(SimulatorTest, it_delays_its_replies_by_the_UART_transfer_time) {
+    conf.uart_rate = Configuration::RATE_1200;
+    simulator.addModule(conf);
+    drivers[0].setFileDescriptor(simulator.openDevice(0));
+    simulator.setMode(0, Simulator::MODE_SLEEP);
+    simulator.start();
+
+    base::Time start = base::Time::now();
+    drivers[0].readConfiguration();
+    ASSERT_GE(base::Time::now() - start, getUARTTransferTime(conf, 9));
+}
+
+TEST_F(SimulatorTest, it_reads_and_writes_the_configuration) {
+    start(conf, conf);
+    simulator.setMode(0, Simulator::MODE_SLEEP);
+
+    Configuration new_conf = conf;
+    new_conf.channel = 12;
+    drivers[0].writeConfiguration(new_conf, false);
+    ASSERT_EQ(12, drivers[0].readConfiguration().channel);
+
+    auto status = simulator.getStatus(0);
+    ASSERT_EQ(12, status.configuration.channel);
+    ASSERT_EQ(0, status.saved_configuration.channel);
+    ASSERT_EQ(0u, status.saves);
+
+    drivers[0].writeConfiguration(new_conf, true);
+    drivers[0].readConfiguration();
+    status = simulator.getStatus(0);
+    ASSERT_EQ(12, status.saved_configuration.channel);
+    ASSERT_EQ(1u, status.saves);
+}
+
+TEST_F(SimulatorTest, it_transmits_between_modules_in_transparent_mode) {
+    start(conf, conf);
+
+    uint8_t data[100];
+    for (int i = 0; i < 100; ++i) {
+        data[i] = i;
+    }
+    drivers[0].writePacket(data, 100);
+    ASSERT_EQ(vector<uint8_t>(data, data + 100), read(1, 100));
+
+    auto status = simulator.getStatus(0);
+    ASSERT_EQ(100u, status.uart_rx_bytes);
+    ASSERT_EQ(2u, status.sent_sub_packets);
+    ASSERT_EQ(2u, simulator.getStatus(1).received_sub_packets);
+}
+
+TEST_F(SimulatorTest, it_strips_the_header_in_fixed_mode) {
+    Configuration conf0 = conf;
+    conf0.transparent_transmission = false;
+    Configuration conf1 = conf0;
+    conf1.address = 0x1234;
+    conf1.channel = 5;
+    start(conf0, conf1);
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    ASSERT_EQ(4, drivers[0].writeRaw(0x1234, 5, data, 4));
+    ASSERT_EQ(vector<uint8_t>(data, data + 4), read(1, 4));
+}
+
+TEST_F(SimulatorTest, it_does_not_deliver_to_a_different_address) {
+    Configuration conf0 = conf;
+    conf0.transparent_transmission = false;
+    Configuration conf1 = conf0;
+    conf1.address = 0x1234;
+    start(conf0, conf1);
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    drivers[0].writeRaw(0x1235, 0, data, 4);
+    ASSERT_TRUE(read(1, 4, base::Time::fromMilliseconds(100)).empty());
+}
+
+TEST_F(SimulatorTest, it_does_not_deliver_to_a_different_channel) {
+    Configuration conf1 = conf;
+    conf1.channel = 1;
+    start(conf, conf1);
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    drivers[0].writePacket(data, 4);
+    ASSERT_TRUE(read(1, 4, base::Time::fromMilliseconds(100)).empty());
+}
+
+TEST_F(SimulatorTest, it_does_not_deliver_to_a_module_in_sleep_mode) {
+    start(conf, conf);
+    simulator.setMode(1, Simulator::MODE_SLEEP);
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    drivers[0].writePacket(data, 4);
+    ASSERT_TRUE(read(1, 4, base::Time::fromMilliseconds(100)).empty());
+}
+
+TEST_F(SimulatorTest, it_loses_sub_packets_that_overlap_on_the_same_channel) {
+    Driver third;
+    for (int i = 0; i < 3; ++i) {
+        simulator.addModule(conf);
+    }
+    for (int i = 0; i < 2; ++i) {
+        drivers[i].setFileDescriptor(simulator.openDevice(i));
+        drivers[i].setLinkConfiguration(conf);
+    }
+    third.setFileDescriptor(simulator.openDevice(2));
+    third.setLinkConfiguration(conf);
+    simulator.start();
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    drivers[0].writePacket(data, 4);
+    third.writePacket(data, 4);
+    ASSERT_TRUE(read(1, 4, base::Time::fromMilliseconds(100)).empty());
+    ASSERT_EQ(2u, simulator.getStatus(1).collided_sub_packets);
+}
+
+TEST_F(SimulatorTest, it_drops_sub_packets_according_to_the_loss_model) {
+    simulator.setPacketLoss(1);
+    start(conf, conf);
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    drivers[0].writePacket(data, 4);
+    ASSERT_TRUE(read(1, 4, base::Time::fromMilliseconds(100)).empty());
+    ASSERT_EQ(1u, simulator.getStatus(0).lost_sub_packets);
+}
+
+TEST_F(SimulatorTest, it_drops_the_bytes_that_do_not_fit_in_the_buffer) {
+    conf.air_rate = Configuration::AIR_RATE_300;
+    start(conf, conf);
+
+    uint8_t data[600] = { 0 };
+    drivers[0].writePacket(data, 600);
+    usleep(50000);
+    auto status = simulator.getStatus(0);
+    ASSERT_EQ(600u, status.uart_rx_bytes);
+    ASSERT_EQ(88u, status.dropped_bytes);
+    ASSERT_EQ(MODULE_BUFFER_SIZE, status.buffer_usage);
+}
+
+TEST_F(SimulatorTest, it_signals_transmissions_on_AUX) {
+    conf.air_rate = Configuration::AIR_RATE_300;
+    start(conf, conf);
+    ASSERT_TRUE(simulator.getAUX(0).isReady());
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    drivers[0].writePacket(data, 4);
+    usleep(20000);
+    ASSERT_FALSE(simulator.getAUX(0).isReady());
+    ASSERT_TRUE(simulator.getAUX(0).waitReady(base::Time::fromSeconds(2)));
+}
+
+TEST_F(SimulatorTest, it_runs_faster_than_real_time) {
+    conf.air_rate = Configuration::AIR_RATE_2400;
+    simulator.setTimeScale(100);
+    start(conf, conf);
+
+    uint8_t data[MODULE_BUFFER_SIZE] = { 0 };
+    base::Time start = base::Time::now();
+    drivers[0].writePacket(data, MODULE_BUFFER_SIZE);
+    ASSERT_EQ(MODULE_BUFFER_SIZE, static_cast<int>(read(1, MODULE_BUFFER_SIZE).size()));
+
+    base::Time airtime = getAirtime(conf, MODULE_BUFFER_SIZE);
+    ASSERT_LT(base::Time::now() - start, airtime / 10);
+    ASSERT_GE(simulator.now(), airtime);
+}
+
+TEST_F(SimulatorTest, it_draws_the_same_losses_for_the_same_seed) {
+    vector<uint64_t> received;
+    for (int run = 0; run < 2; ++run) {
+        Simulator simulator(42);
+        simulator.setPacketLoss(0.5);
+        simulator.addModule(conf);
+        simulator.addModule(conf);
+        simulator.setTimeScale(100);
+        Driver driver;
+        driver.setFileDescriptor(simulator.openDevice(0));
+        simulator.start();
+
+        uint8_t data[MODULE_BUFFER_SIZE] = { 0 };
+        driver.writePacket(data, MODULE_BUFFER_SIZE);
+        while (simulator.getStatus(0).uart_rx_bytes < MODULE_BUFFER_SIZE) {
+            usleep(1000);
+        }
+        ASSERT_TRUE(simulator.getAUX(0).waitReady(base::Time::fromSeconds(2)));
+        auto status = simulator.getStatus(1);
+        ASSERT_EQ(9u, simulator.getStatus(0).sent_sub_packets);
+        received.push_back(status.received_sub_packets);
+    }
+    ASSERT_GT(received[0], 0u);
+    ASSERT_LT(received[0], 9u);
+    ASSERT_EQ(received[0], received[1]);
+}
+
+TEST_F(SimulatorTest, it_only_wakes_up_power_saving_modules_with_a_preamble) {
+    simulator.setTimeScale(10);
+    start(conf, conf);
+    simulator.setMode(1, Simulator::MODE_POWER_SAVING);
+
+    uint8_t data[100] = { 0 };
+    drivers[0].writePacket(data, 4);
+    ASSERT_TRUE(read(1, 4, base::Time::fromMilliseconds(100)).empty());
+    ASSERT_EQ(1u, simulator.getStatus(1).asleep_sub_packets);
+
+    simulator.setMode(0, Simulator::MODE_WAKE_UP);
+    base::Time start = simulator.now();
+    drivers[0].writePacket(data, 100);
+    ASSERT_EQ(100u, read(1, 100).size());
+    ASSERT_GE(simulator.now() - start,
+              getWakeUpTime(conf) + getAirtime(conf, 100));
+
+    // The second sub-packet follows the first one without a preamble
+    auto status = simulator.getStatus(1);
+    ASSERT_EQ(1u, status.wake_ups);
+    ASSERT_EQ(2u, status.received_sub_packets);
+}
+
+TEST_F(SimulatorTest, it_ignores_the_UART_in_power_saving_mode) {
+    start(conf, conf);
+    simulator.setMode(0, Simulator::MODE_POWER_SAVING);
+
+    uint8_t data[4] = { 0 };
+    drivers[0].writePacket(data, 4);
+    ASSERT_TRUE(read(1, 4, base::Time::fromMilliseconds(100)).empty());
+    ASSERT_EQ(4u, simulator.getStatus(0).ignored_bytes);
+    ASSERT_EQ(0u, simulator.getStatus(0).sent_sub_packets);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/MockAUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/ThreadedDriver.hpp>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct ThreadedDriverTest : public ::testing::Test {
+    Simulator simulator;
+    Driver drivers[2];
+
+    ThreadedDriverTest() {
+        Configuration conf;
+        conf.uart_rate = Configuration::RATE_115200;
+        conf.air_rate = Configuration::AIR_RATE_19200;
+        conf.transparent_transmission = false;
+        for (int i = 0; i < 2; ++i) {
+            conf.address = i + 1;
+            simulator.addModule(conf);
+            drivers[i].setFileDescriptor(simulator.openDevice(i));
+            drivers[i].setLinkConfiguration(conf);
+        }
+        simulator.setTimeScale(10);
+        simulator.start();
+    }
+
+    vector<uint8_t> receive(ThreadedDriver& driver,
+                            base::Time timeout = base::Time::fromSeconds(1)) {
+        uint8_t buffer[256];
+        int size = driver.receive(buffer, sizeof(buffer), timeout);
+        return vector<uint8_t>(buffer, buffer + size);
+    }
+};
+
+TEST_F(ThreadedDriverTest, it_exchanges_frames_through_the_io_threads) {
+    ThreadedDriver tx(drivers[0]);
+    ThreadedDriver rx(drivers[1]);
+    tx.start();
+    rx.start();
+
+    vector<uint8_t> frames[3] = { { 1, 2, 3 }, { 4 }, vector<uint8_t>(100, 5) };
+    for (auto const& frame : frames) {
+        ASSERT_TRUE(tx.send(2, 0, frame.data(), frame.size()));
+    }
+    for (auto const& frame : frames) {
+        ASSERT_EQ(frame, receive(rx));
+    }
+
+    ASSERT_EQ(3u, tx.getStatistics().sent_frames);
+    ASSERT_EQ(3u, rx.getStatistics().received_frames);
+    ASSERT_EQ(0u, rx.getReceiveQueueSize());
+}
+
+TEST_F(ThreadedDriverTest, it_signals_received_frames_on_its_file_descriptor) {
+    ThreadedDriver tx(drivers[0]);
+    ThreadedDriver rx(drivers[1]);
+    tx.start();
+    rx.start();
+
+    pollfd pfd = { rx.getReceiveFileDescriptor(), POLLIN, 0 };
+    ASSERT_EQ(0, ::poll(&pfd, 1, 0));
+    uint8_t frame[] = { 1, 2, 3 };
+    tx.send(2, 0, frame, 3);
+    ASSERT_EQ(1, ::poll(&pfd, 1, 1000));
+    ASSERT_EQ(3u, receive(rx, base::Time()).size());
+}
+
+TEST_F(ThreadedDriverTest, it_times_out_if_no_frame_is_received) {
+    ThreadedDriver rx(drivers[1]);
+    rx.start();
+    ASSERT_THROW(receive(rx, base::Time::fromMilliseconds(50)),
+                 iodrivers_base::TimeoutError);
+    ASSERT_THROW(receive(rx, base::Time()), iodrivers_base::TimeoutError);
+}
+
+TEST_F(ThreadedDriverTest, it_drops_received_frames_when_the_ring_is_full) {
+    ThreadedDriver tx(drivers[0]);
+    ThreadedDriver rx(drivers[1], 2);
+    tx.start();
+    rx.start();
+
+    uint8_t frame[] = { 1, 2, 3 };
+    for (int i = 0; i < 4; ++i) {
+        frame[0] = i;
+        tx.send(2, 0, frame, 3);
+    }
+    while (rx.getStatistics().received_frames +
+           rx.getStatistics().dropped_frames < 4) {
+        ASSERT_TRUE(simulator.getAUX(0).waitReady(base::Time::fromSeconds(1)));
+        usleep(10000);
+    }
+
+    ASSERT_EQ(0, receive(rx)[0]);
+    ASSERT_EQ(1, receive(rx)[0]);
+    auto stats = rx.getStatistics();
+    ASSERT_EQ(2u, stats.received_frames);
+    ASSERT_EQ(2u, stats.dropped_frames);
+    ASSERT_EQ(2u, stats.rx_high_water_mark);
+}
+
+TEST_F(ThreadedDriverTest, it_refuses_frames_when_the_transmit_ring_is_full) {
+    ThreadedDriver tx(drivers[0], 16, 2);
+    uint8_t frame[] = { 1, 2, 3 };
+    ASSERT_TRUE(tx.send(2, 0, frame, 3));
+    ASSERT_TRUE(tx.send(2, 0, frame, 3));
+    ASSERT_FALSE(tx.send(2, 0, frame, 3));
+    ASSERT_EQ(1u, tx.getStatistics().rejected_frames);
+    ASSERT_EQ(2u, tx.getStatistics().tx_high_water_mark);
+
+    ThreadedDriver rx(drivers[1]);
+    rx.start();
+    tx.start();
+    receive(rx);
+    receive(rx);
+    ASSERT_EQ(0u, tx.getTransmitQueueSize());
+}
+
+TEST_F(ThreadedDriverTest, it_rejects_frames_that_the_driver_cannot_send) {
+    ThreadedDriver tx(drivers[0]);
+    uint8_t frame[256] = { 0 };
+    ASSERT_THROW(tx.send(frame, 0), std::invalid_argument);
+    ASSERT_THROW(tx.send(frame, 256), std::invalid_argument);
+}
+
+TEST_F(ThreadedDriverTest, it_retries_frames_refused_by_the_flow_control) {
+    MockAUXMonitor aux;
+    drivers[0].setAUXMonitor(&aux);
+    drivers[0].setWriteTimeout(base::Time::fromMilliseconds(10));
+    // Fill the module buffer, for an address nobody listens to
+    vector<uint8_t> payload(509, 0);
+    ASSERT_EQ(509, drivers[0].writeRaw(3, 0, payload.data(), 509));
+    aux.setReady(false);
+
+    ThreadedDriver tx(drivers[0]);
+    ThreadedDriver rx(drivers[1]);
+    tx.start();
+    rx.start();
+    uint8_t frame[] = { 1, 2, 3 };
+    tx.send(2, 0, frame, 3);
+    ASSERT_THROW(receive(rx, base::Time::fromMilliseconds(100)),
+                 iodrivers_base::TimeoutError);
+    ASSERT_GT(tx.getStatistics().write_retries, 0u);
+    ASSERT_EQ(1u, tx.getTransmitQueueSize());
+
+    aux.setReady(true);
+    ASSERT_EQ(vector<uint8_t>({ 1, 2, 3 }), receive(rx));
+    tx.stop();
+    drivers[0].setAUXMonitor(nullptr);
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+
+using namespace comms_lora_ebyte_e32;
+
+struct TimingTest : public ::testing::Test {
+    Configuration conf;
+};
+
+TEST_F(TimingTest, it_computes_the_UART_transfer_time) {
+    conf.uart_rate = Configuration::RATE_9600;
+    ASSERT_EQ(base::Time::fromMicroseconds(10416),
+              getUARTTransferTime(conf, 10));
+}
+
+TEST_F(TimingTest, it_accounts_for_the_parity_bit) {
+    conf.uart_rate = Configuration::RATE_9600;
+    conf.uart_parity = Configuration::PARITY_8E1;
+    ASSERT_EQ(base::Time::fromMicroseconds(11458),
+              getUARTTransferTime(conf, 10));
+}
+
+TEST_F(TimingTest, it_adds_the_overhead_of_each_sub_packet_to_the_airtime) {
+    conf.air_rate = Configuration::AIR_RATE_2400;
+    ASSERT_EQ(base::Time::fromMicroseconds((58 + 8) * 8 * 1e6 / 2400),
+              getAirtime(conf, 58));
+    ASSERT_EQ(base::Time::fromMicroseconds((59 + 16) * 8 * 1e6 / 2400),
+              getAirtime(conf, 59));
+}
+
+TEST_F(TimingTest, disabling_error_correction_shortens_the_airtime) {
+    conf.air_rate = Configuration::AIR_RATE_2400;
+    base::Time with_fec = getAirtime(conf, 100);
+    conf.error_correction_enabled = false;
+    ASSERT_LT(getAirtime(conf, 100), with_fec);
+}
+
+TEST_F(TimingTest, the_packet_gap_is_longer_than_a_sub_packet_airtime) {
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    ASSERT_GT(getPacketGap(conf), getAirtime(conf, SUB_PACKET_SIZE));
+}
+
+TEST_F(TimingTest, it_computes_the_wake_up_time) {
+    ASSERT_EQ(base::Time::fromMilliseconds(250), getWakeUpTime(conf));
+    conf.wireless_wake_up_time = 7;
+    ASSERT_EQ(base::Time::fromSeconds(2), getWakeUpTime(conf));
+}
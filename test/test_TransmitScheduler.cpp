@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/MockAUXMonitor.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <comms_lora_ebyte_e32/TransmitScheduler.hpp>
+#include <thread>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct TransmitSchedulerTest : public ::testing::Test,
+                               public iodrivers_base::Fixture<Driver> {
+    Configuration conf;
+    base::Time start = base::Time::fromSeconds(1000);
+    uint8_t payload[10] = { 0 };
+    base::Time frame_airtime;
+
+    TransmitSchedulerTest() {
+        driver.openURI("test://");
+        conf.air_rate = Configuration::AIR_RATE_2400;
+        driver.setLinkConfiguration(conf);
+        frame_airtime = getAirtime(conf, 13);
+    }
+};
+
+TEST_F(TransmitSchedulerTest, it_sends_frames_up_to_the_burst_time) {
+    TransmitScheduler scheduler(driver);
+    scheduler.setBurstTime(frame_airtime * 2);
+    for (int i = 0; i < 3; ++i) {
+        scheduler.push(0, 1, 2, payload, 10, start);
+    }
+
+    ASSERT_EQ(1, scheduler.update(start));
+    ASSERT_EQ(1, scheduler.update(scheduler.getNextSendTime()));
+    ASSERT_EQ(26u, readDataFromDriver().size());
+    ASSERT_EQ(1u, scheduler.getQueueSize(0));
+}
+
+TEST_F(TransmitSchedulerTest, it_leaves_the_UART_idle_between_frames) {
+    TransmitScheduler scheduler(driver);
+    driver.setFixedTransmissionGap(base::Time::fromMilliseconds(5));
+    scheduler.push(0, 1, 2, payload, 10, start);
+    scheduler.push(0, 1, 2, payload, 10, start);
+
+    ASSERT_EQ(1, scheduler.update(start));
+    base::Time next = start + getUARTTransferTime(conf, 13) +
+                      base::Time::fromMilliseconds(5);
+    ASSERT_EQ(next, scheduler.getNextSendTime());
+    ASSERT_EQ(0, scheduler.update(next - base::Time::fromMicroseconds(1)));
+    ASSERT_EQ(1, scheduler.update(next));
+}
+
+TEST_F(TransmitSchedulerTest, it_paces_frames_at_their_airtime) {
+    TransmitScheduler scheduler(driver);
+    scheduler.setBurstTime(frame_airtime);
+    scheduler.push(0, 1, 2, payload, 10, start);
+    scheduler.push(0, 1, 2, payload, 10, start);
+
+    ASSERT_EQ(1, scheduler.update(start));
+    ASSERT_EQ(start + frame_airtime, scheduler.getNextSendTime());
+    ASSERT_EQ(0, scheduler.update(start + frame_airtime / 2));
+    ASSERT_EQ(1, scheduler.update(start + frame_airtime));
+}
+
+TEST_F(TransmitSchedulerTest, it_serves_higher_priorities_first) {
+    TransmitScheduler scheduler(driver);
+    scheduler.setBurstTime(frame_airtime);
+    uint8_t bulk[10] = { 1 };
+    uint8_t control[10] = { 2 };
+    scheduler.push(1, 1, 2, bulk, 10, start);
+    scheduler.push(1, 1, 2, bulk, 10, start);
+    scheduler.push(0, 1, 2, control, 10, start);
+
+    ASSERT_EQ(1, scheduler.update(start));
+    auto data = readDataFromDriver();
+    ASSERT_EQ(2, data[3]);
+    ASSERT_EQ(2u, scheduler.getQueueSize(1));
+}
+
+TEST_F(TransmitSchedulerTest, it_rejects_frames_when_the_queue_is_full) {
+    TransmitScheduler scheduler(driver);
+    scheduler.setMaxQueueSize(1);
+    ASSERT_TRUE(scheduler.push(1, 1, 2, payload, 10, start));
+    ASSERT_FALSE(scheduler.push(1, 1, 2, payload, 10, start));
+    ASSERT_TRUE(scheduler.push(0, 1, 2, payload, 10, start));
+    ASSERT_EQ(1u, scheduler.getStatistics().rejected_frames[1]);
+}
+
+TEST_F(TransmitSchedulerTest, it_rejects_invalid_priority_levels) {
+    ASSERT_THROW(TransmitScheduler(driver, 0), std::invalid_argument);
+    ASSERT_THROW(TransmitScheduler(driver, -1), std::invalid_argument);
+}
+
+struct TransmitSchedulerFlowControlTest : public TransmitSchedulerTest {
+    MockAUXMonitor aux;
+
+    TransmitSchedulerFlowControlTest() {
+        conf.uart_rate = Configuration::RATE_115200;
+        driver.setLinkConfiguration(conf);
+        driver.setAUXMonitor(&aux);
+
+        // Leave 12 bytes in the module buffer, i.e. the header and 9 bytes
+        vector<uint8_t> filler(497, 0);
+        driver.writeRaw(1, 2, filler.data(), filler.size());
+        readDataFromDriver();
+        aux.setReady(false);
+
+        for (int i = 0; i < 10; ++i) {
+            payload[i] = i;
+        }
+    }
+};
+
+TEST_F(TransmitSchedulerFlowControlTest, it_continues_a_partially_written_frame) {
+    TransmitScheduler scheduler(driver);
+    scheduler.push(0, 0x10, 5, payload, 10, start);
+
+    driver.setWriteTimeout(base::Time::fromMilliseconds(200));
+    thread drain([this]() {
+        this_thread::sleep_for(chrono::milliseconds(300));
+        aux.setReady(true);
+    });
+    int sent = scheduler.update(start);
+    drain.join();
+
+    ASSERT_EQ(1, sent);
+    ASSERT_EQ(vector<uint8_t>({ 0, 0x10, 5, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }),
+              readDataFromDriver());
+    ASSERT_EQ(0u, scheduler.getQueueSize(0));
+    ASSERT_EQ(1u, scheduler.getStatistics().sent_frames[0]);
+}
+
+TEST_F(TransmitSchedulerFlowControlTest, it_drops_a_frame_it_could_not_finish) {
+    TransmitScheduler scheduler(driver);
+    scheduler.push(0, 0x10, 5, payload, 10, start);
+
+    driver.setWriteTimeout(base::Time::fromMilliseconds(10));
+    ASSERT_EQ(0, scheduler.update(start));
+    ASSERT_EQ(12u, readDataFromDriver().size());
+    ASSERT_EQ(0u, scheduler.getQueueSize(0));
+    ASSERT_EQ(0u, scheduler.getStatistics().sent_frames[0]);
+    ASSERT_EQ(1u, scheduler.getStatistics().truncated_frames[0]);
+}
+
+TEST_F(TransmitSchedulerFlowControlTest, it_bounds_the_time_spent_writing) {
+    TransmitScheduler scheduler(driver);
+    scheduler.setMaxWriteTime(base::Time::fromMilliseconds(20));
+    scheduler.push(0, 0x10, 5, payload, 10, start);
+    scheduler.push(0, 0x10, 5, payload, 10, start);
+
+    driver.setWriteTimeout(base::Time::fromSeconds(1));
+    base::Time before = base::Time::now();
+    ASSERT_EQ(0, scheduler.update(start));
+    ASSERT_LT(base::Time::now() - before, base::Time::fromMilliseconds(500));
+    ASSERT_EQ(1u, scheduler.getStatistics().truncated_frames[0]);
+    ASSERT_EQ(1u, scheduler.getQueueSize(0));
+}
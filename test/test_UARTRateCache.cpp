@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/UARTRateCache.hpp>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct UARTRateCacheTest : public ::testing::Test {
+    string path;
+
+    UARTRateCacheTest() {
+        char tmp[] = "/tmp/uart_rate_cache_XXXXXX";
+        int fd = mkstemp(tmp);
+        close(fd);
+        path = tmp;
+        unlink(path.c_str());
+    }
+
+    ~UARTRateCacheTest() {
+        unlink(path.c_str());
+    }
+};
+
+TEST_F(UARTRateCacheTest, it_removes_the_baud_rate_from_serial_uris) {
+    ASSERT_EQ("serial:///dev/ttyUSB0",
+              UARTRateCache::getDeviceKey("serial:///dev/ttyUSB0:9600"));
+    ASSERT_EQ("serial:///dev/ttyUSB0",
+              UARTRateCache::getDeviceKey("serial:///dev/ttyUSB0"));
+    ASSERT_EQ("tcp://localhost:4000",
+              UARTRateCache::getDeviceKey("tcp://localhost:4000"));
+}
+
+TEST_F(UARTRateCacheTest, it_returns_false_for_an_unknown_device) {
+    UARTRateCache cache;
+    Configuration::UARTRate rate;
+    ASSERT_FALSE(cache.get("serial:///dev/ttyUSB0", rate));
+}
+
+TEST_F(UARTRateCacheTest, it_stores_rates_per_device) {
+    UARTRateCache cache;
+    cache.set("a", Configuration::RATE_115200);
+    cache.set("b", Configuration::RATE_1200);
+
+    Configuration::UARTRate rate;
+    ASSERT_TRUE(cache.get("a", rate));
+    ASSERT_EQ(Configuration::RATE_115200, rate);
+    ASSERT_TRUE(cache.get("b", rate));
+    ASSERT_EQ(Configuration::RATE_1200, rate);
+
+    cache.remove("a");
+    ASSERT_FALSE(cache.get("a", rate));
+}
+
+TEST_F(UARTRateCacheTest, it_persists_the_rates_in_its_file) {
+    {
+        UARTRateCache cache(path);
+        cache.set("serial:///dev/ttyUSB0", Configuration::RATE_57600);
+    }
+
+    ifstream file(path.c_str());
+    string line;
+    getline(file, line);
+    ASSERT_EQ("serial:///dev/ttyUSB0 57600", line);
+
+    UARTRateCache cache(path);
+    Configuration::UARTRate rate;
+    ASSERT_TRUE(cache.get("serial:///dev/ttyUSB0", rate));
+    ASSERT_EQ(Configuration::RATE_57600, rate);
+}
+
+TEST_F(UARTRateCacheTest, it_keeps_the_rates_if_the_file_cannot_be_written) {
+    UARTRateCache cache("/nonexistent/uart_rate_cache");
+    ASSERT_FALSE(cache.set("a", Configuration::RATE_57600));
+    Configuration::UARTRate rate;
+    ASSERT_TRUE(cache.get("a", rate));
+    ASSERT_EQ(Configuration::RATE_57600, rate);
+    ASSERT_FALSE(cache.remove("a"));
+    ASSERT_FALSE(cache.get("a", rate));
+}
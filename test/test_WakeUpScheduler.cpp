@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <comms_lora_ebyte_e32/Driver.hpp>
+#include <comms_lora_ebyte_e32/MockModePins.hpp>
+#include <comms_lora_ebyte_e32/ModeController.hpp>
+#include <comms_lora_ebyte_e32/Simulator.hpp>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <comms_lora_ebyte_e32/WakeUpScheduler.hpp>
+#include <unistd.h>
+
+using namespace std;
+using namespace comms_lora_ebyte_e32;
+
+struct WakeUpSchedulerTest : public ::testing::Test,
+                             public iodrivers_base::Fixture<Driver> {
+    Configuration conf;
+    MockModePins pins;
+    ModeController controller{ pins, nullptr };
+    base::Time t0 = base::Time::fromSeconds(1000);
+    uint8_t payload[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    WakeUpSchedulerTest() {
+        driver.openURI("test://");
+        conf.transparent_transmission = false;
+        conf.wireless_wake_up_time = 1;
+        driver.setLinkConfiguration(conf);
+        driver.setFixedTransmissionGap(base::Time());
+        controller.setFallbackDelay(base::Time());
+    }
+};
+
+TEST_F(WakeUpSchedulerTest, it_waits_for_the_wake_up_time_by_default) {
+    WakeUpScheduler scheduler(driver, controller);
+    ASSERT_EQ(base::Time::fromMilliseconds(500), scheduler.getMaxLatency());
+}
+
+TEST_F(WakeUpSchedulerTest, it_sends_the_messages_of_a_target_in_one_batch) {
+    WakeUpScheduler scheduler(driver, controller);
+    scheduler.push(0x10, 5, payload, 2, t0);
+    scheduler.push(0x20, 5, payload, 2, t0);
+    scheduler.push(0x10, 5, payload + 2, 3, t0 + base::Time::fromMilliseconds(100));
+
+    base::Time due = t0 + scheduler.getMaxLatency();
+    ASSERT_EQ(due, scheduler.getNextSendTime(t0));
+    ASSERT_EQ(0, scheduler.update(due - base::Time::fromMicroseconds(1)));
+    ASSERT_EQ(2, scheduler.update(due));
+    ASSERT_EQ(vector<uint8_t>({ 0, 0x10, 5,
+                                Driver::FRAME_SYNC, 2, 1, 2,
+                                Driver::FRAME_SYNC, 3, 3, 4, 5 }),
+              readDataFromDriver());
+    ASSERT_EQ(ModeController::MODE_WAKE_UP, controller.getMode());
+    ASSERT_EQ(1u, scheduler.getQueuedMessageCount());
+    ASSERT_EQ(1u, scheduler.getStatistics().sent_batches);
+    ASSERT_EQ(2u, scheduler.getStatistics().sent_messages);
+}
+
+TEST_F(WakeUpSchedulerTest, it_waits_for_the_previous_batch_to_be_over_the_air) {
+    WakeUpScheduler scheduler(driver, controller);
+    scheduler.push(0x10, 5, payload, 2, t0);
+    scheduler.push(0x20, 5, payload, 2, t0);
+
+    base::Time due = t0 + scheduler.getMaxLatency();
+    ASSERT_EQ(1, scheduler.update(due));
+    base::Time next = due + scheduler.getBatchDuration(4);
+    ASSERT_EQ(next, scheduler.getNextSendTime(due));
+    ASSERT_EQ(0, scheduler.update(next - base::Time::fromMicroseconds(1)));
+    ASSERT_EQ(1, scheduler.update(next));
+    ASSERT_EQ(2u, scheduler.getStatistics().sent_batches);
+}
+
+TEST_F(WakeUpSchedulerTest, it_sends_a_full_batch_right_away) {
+    WakeUpScheduler scheduler(driver, controller);
+    scheduler.setMaxBatchSize(24);
+    for (int i = 0; i < 3; ++i) {
+        scheduler.push(0x10, 5, payload, 10, t0);
+    }
+
+    ASSERT_EQ(t0, scheduler.getNextSendTime(t0));
+    ASSERT_EQ(2, scheduler.update(t0));
+    ASSERT_EQ(1u, scheduler.getQueuedMessageCount());
+}
+
+TEST_F(WakeUpSchedulerTest, it_sends_a_message_alone_if_the_batch_size_shrank_below_it) {
+    WakeUpScheduler scheduler(driver, controller);
+    scheduler.push(0x10, 5, payload, 10, t0);
+    scheduler.push(0x10, 5, payload, 2, t0);
+    scheduler.setMaxBatchSize(8);
+
+    ASSERT_EQ(1, scheduler.update(t0));
+    ASSERT_EQ(vector<uint8_t>({ 0, 0x10, 5, Driver::FRAME_SYNC, 10,
+                                1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }),
+              readDataFromDriver());
+    ASSERT_EQ(1u, scheduler.getQueuedMessageCount());
+}
+
+TEST_F(WakeUpSchedulerTest, it_estimates_the_duration_of_a_batch) {
+    WakeUpScheduler scheduler(driver, controller);
+    ASSERT_GT(scheduler.getBatchDuration(100),
+              getWakeUpTime(conf) + getAirtime(conf, 100));
+}
+
+TEST_F(WakeUpSchedulerTest, it_rejects_messages_that_do_not_fit) {
+    WakeUpScheduler scheduler(driver, controller);
+    scheduler.setMaxBatchSize(24);
+    scheduler.setMaxQueueSize(1);
+    ASSERT_THROW(scheduler.push(0x10, 5, payload, 0), std::invalid_argument);
+    ASSERT_THROW(scheduler.push(0x10, 0x20, payload, 1), std::invalid_argument);
+    uint8_t big[23] = { 0 };
+    ASSERT_THROW(scheduler.push(0x10, 5, big, 23), std::invalid_argument);
+
+    ASSERT_TRUE(scheduler.push(0x10, 5, payload, 1));
+    ASSERT_FALSE(scheduler.push(0x10, 5, payload, 1));
+    ASSERT_EQ(1u, scheduler.getStatistics().rejected_messages);
+}
+
+static Simulator::Mode toSimulatorMode(bool m0, bool m1) {
+    if (m0 && m1) {
+        return Simulator::MODE_SLEEP;
+    }
+    else if (m0) {
+        return Simulator::MODE_WAKE_UP;
+    }
+    else if (m1) {
+        return Simulator::MODE_POWER_SAVING;
+    }
+    return Simulator::MODE_NORMAL;
+}
+
+TEST(WakeUpSchedulerSimulation, it_reaches_a_receiver_in_power_saving_mode) {
+    Simulator simulator;
+    Driver drivers[2];
+    Configuration conf;
+    conf.uart_rate = Configuration::RATE_115200;
+    conf.air_rate = Configuration::AIR_RATE_19200;
+    conf.transparent_transmission = false;
+    for (int i = 0; i < 2; ++i) {
+        conf.address = i + 1;
+        simulator.addModule(conf);
+        drivers[i].setFileDescriptor(simulator.openDevice(i));
+        drivers[i].setLinkConfiguration(conf);
+    }
+    drivers[1].setPacketMode(Driver::PACKET_MODE_LENGTH_PREFIXED);
+    simulator.setMode(1, Simulator::MODE_POWER_SAVING);
+    simulator.start();
+
+    MockModePins pins;
+    pins.setCallback([&simulator](bool m0, bool m1) {
+        simulator.setMode(0, toSimulatorMode(m0, m1));
+    });
+    ModeController controller(pins, &simulator.getAUX(0));
+    WakeUpScheduler scheduler(drivers[0], controller);
+    scheduler.setMaxLatency(base::Time());
+    uint8_t payload[20] = { 0 };
+    for (int i = 0; i < 5; ++i) {
+        scheduler.push(2, conf.channel, payload, 20);
+    }
+    ASSERT_EQ(5, scheduler.update());
+
+    uint8_t buffer[Driver::MAX_PACKET_SIZE];
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(22, drivers[1].readPacket(buffer, Driver::MAX_PACKET_SIZE,
+                                            base::Time::fromSeconds(1)));
+    }
+    auto status = simulator.getStatus(1);
+    ASSERT_EQ(1u, status.wake_ups);
+    ASSERT_EQ(0u, status.asleep_sub_packets);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <comms_lora_ebyte_e32/Timing.hpp>
+#include <comms_lora_ebyte_e32/WakeUpTradeoff.hpp>
+
+using namespace comms_lora_ebyte_e32;
+
+struct WakeUpTradeoffTest : public ::testing::Test {
+    Configuration conf;
+    PowerModel model;
+
+    WakeUpTradeoffTest() {
+        conf.air_rate = Configuration::AIR_RATE_2400;
+    }
+};
+
+TEST_F(WakeUpTradeoffTest, the_preamble_adds_to_the_latency_and_transmit_charge) {
+    conf.wireless_wake_up_time = 3;
+    auto tradeoff = computeWakeUpTradeoff(conf, 100, base::Time::fromSeconds(60),
+                                          model);
+    base::Time airtime = getAirtime(conf, 100);
+    ASSERT_EQ(3, tradeoff.wireless_wake_up_time);
+    ASSERT_EQ(base::Time::fromSeconds(1), tradeoff.wake_up_time);
+    ASSERT_GT(tradeoff.latency, base::Time::fromSeconds(1) + airtime);
+    ASSERT_NEAR(model.transmit_current * (1 + airtime.toSeconds()),
+                tradeoff.transmit_charge, 1e-3);
+}
+
+TEST_F(WakeUpTradeoffTest, the_receiver_listens_once_per_wake_up_time) {
+    auto tradeoff = computeWakeUpTradeoff(conf, 100, base::Time(), model);
+    double listening = model.listen_time.toSeconds() / 0.25;
+    ASSERT_NEAR(listening * model.receive_current +
+                (1 - listening) * model.sleep_current,
+                tradeoff.idle_current, 1e-9);
+}
+
+TEST_F(WakeUpTradeoffTest, it_covers_every_setting) {
+    auto tradeoffs =
+        computeWakeUpTradeoffs(conf, 100, base::Time::fromSeconds(60), model);
+    ASSERT_EQ(8u, tradeoffs.size());
+    for (size_t i = 1; i < tradeoffs.size(); ++i) {
+        ASSERT_EQ(i, tradeoffs[i].wireless_wake_up_time);
+        ASSERT_GT(tradeoffs[i].latency, tradeoffs[i - 1].latency);
+        ASSERT_GT(tradeoffs[i].transmit_charge, tradeoffs[i - 1].transmit_charge);
+        ASSERT_LT(tradeoffs[i].idle_current, tradeoffs[i - 1].idle_current);
+    }
+}
+
+TEST_F(WakeUpTradeoffTest, frequent_traffic_favors_short_wake_up_times) {
+    auto rare = computeWakeUpTradeoffs(conf, 100, base::Time::fromSeconds(600),
+                                       model);
+    auto frequent = computeWakeUpTradeoffs(conf, 100, base::Time::fromSeconds(5),
+                                           model);
+    // With rare traffic, the idle listening dominates
+    ASSERT_LT(rare[7].average_current, rare[0].average_current);
+    // With frequent traffic, listening to the preambles dominates
+    ASSERT_GT(frequent[7].average_current, frequent[0].average_current);
+}